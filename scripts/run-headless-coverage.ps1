@@ -21,19 +21,9 @@ function Clear-ShaderCache {
 		[string]$Config
 	)
 
-	$shader_files = @("mesh_vs.cso", "mesh_ps.cso")
-	$cache_dirs = @(
-		(Join-Path $RepoRoot "src/shaders"),
-		(Join-Path $RepoRoot "bin/$Config/shaders")
-	)
-
-	foreach ($cache_dir in $cache_dirs) {
-		foreach ($shader_file in $shader_files) {
-			$cache_path = Join-Path $cache_dir $shader_file
-			if (Test-Path $cache_path) {
-				Remove-Item $cache_path -Force
-			}
-		}
+	$cache_path = Join-Path $RepoRoot "bin/$Config/shaders.pack"
+	if (Test-Path $cache_path) {
+		Remove-Item $cache_path -Force
 	}
 }
 
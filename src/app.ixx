@@ -1,323 +1,400 @@
 module;
 
+#ifdef _WIN32
 #include <windows.h>
+#endif
 
 #include <chrono>
 #include <cstring>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include "app_logging.h"
+#include "capture_clock.h"
 #include "debug_log.h"
 #include "encoder/bitstream_file_writer.h"
-#include "encoder/frame_encoder.h"
-#include "encoder/nvenc_session.h"
-#include "graphics/device.h"
-#include "graphics/frame_resources.h"
-#include "graphics/mesh.h"
-#include "graphics/pipeline.h"
-#include "graphics/swap_chain.h"
+#include "encoder/encoder_config.h"
+#include "encoder/frame_pacing.h"
+#include "encoder/keyframe_cache.h"
+#include "encoder/rtp_sender.h"
+#include "encoder/shared_frame_ring.h"
+#include "encoder/ts_file_writer.h"
+#include "encoder/ts_sender.h"
+#include "encoder/y4m_file.h"
+#include "event_loop.h"
+#include "graphics/render_backend.h"
+#include "graphics/render_graph.h"
+#include "graphics/resource_state_tracker.h"
+#include "job_system.h"
+#include "platform_thread.h"
+#include "startup_graph.h"
+#include "thread_placement.h"
+#include "stream_pipeline.h"
 #include "try.h"
 
 export module App;
 
-constexpr auto BUFFER_COUNT			= 3u;
-constexpr auto RENDER_TARGET_FORMAT = DXGI_FORMAT_B8G8R8A8_UNORM;
-constexpr auto MVP_BUFFER_ALIGNMENT = 256u;
-
-struct MvpConstantBuffer {
-	struct MvpConstants {
-		float mvp[16];
-	}
-	static constexpr  IDENTITY{
-			.mvp = {
-				1.0f, 0.0f, 0.0f, 0.0f,
-				0.0f, 1.0f, 0.0f, 0.0f,
-				0.0f, 0.0f, 1.0f, 0.0f,
-				0.0f, 0.0f, 0.0f, 1.0f,
-			},
-		};
-
-	ComPtr<ID3D12Resource> resource;
-	uint8_t* mapped = nullptr;
+constexpr auto SCENE_DRAW_COUNT		   = 1u;
+constexpr auto FRAME_EXPORT_CAPACITY   = 16ull * 1024 * 1024;
+constexpr auto FRAME_EXPORT_SLOT_COUNT = 256u;
 
-	explicit MvpConstantBuffer(ID3D12Device* device) {
-		auto mvp_buffer_size = (UINT)((sizeof(MvpConstants) + MVP_BUFFER_ALIGNMENT - 1)
-									  & ~(MVP_BUFFER_ALIGNMENT - 1));
+#ifdef _WIN32
+using WindowHandle = HWND;
+#else
+using WindowHandle = void*;
+#endif
 
-		D3D12_HEAP_PROPERTIES cb_heap_properties{
-			.Type = D3D12_HEAP_TYPE_UPLOAD,
-		};
+struct FrameDump {
+	TextureFootprint footprint;
+	RenderReadbackBuffer buffer;
+	BitstreamFileWriter writer;
+	bool y4m;
+	std::vector<uint8_t> staging;
+	std::vector<uint32_t> pending_slots	 = std::vector<uint32_t>(BUFFER_COUNT);
+	std::vector<uint64_t> pending_values = std::vector<uint64_t>(BUFFER_COUNT);
+	uint32_t pending_head				 = 0;
+	uint32_t pending_count				 = 0;
+	uint64_t dumped_frames				 = 0;
+
+	FrameDump(RenderDevice& device, const char* path, const EncoderConfig& config)
+		: footprint(GetTextureFootprint(config.width, config.height, RENDER_TARGET_FORMAT))
+		, buffer(device, (uint32_t)(footprint.size * BUFFER_COUNT))
+		, writer(path, footprint.size)
+		, y4m(std::string_view{path}.ends_with(".y4m")) {
+		if (!y4m)
+			return;
+		AppendY4mHeader(staging, Y4mHeader{.width		   = config.width,
+										   .height		   = config.height,
+										   .frame_rate_num = config.frame_rate_num,
+										   .frame_rate_den = config.frame_rate_den});
+		writer.WriteFrame(staging.data(), (uint32_t)staging.size());
+	}
 
-		D3D12_RESOURCE_DESC cb_resource_desc{
-			.Dimension		  = D3D12_RESOURCE_DIMENSION_BUFFER,
-			.Width			  = mvp_buffer_size,
-			.Height			  = 1,
-			.DepthOrArraySize = 1,
-			.MipLevels		  = 1,
-			.SampleDesc		  = {.Count = 1},
-			.Layout			  = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
-		};
+	void Record(RenderCommandList& command_list, RenderTexture* source, uint32_t slot,
+				uint64_t fence_value) {
+		if (pending_count == BUFFER_COUNT)
+			throw;
+		command_list.CopyTextureToBuffer(buffer, source, GetSlotFootprint(slot));
+		auto pending			= (pending_head + pending_count) % BUFFER_COUNT;
+		pending_slots[pending]	= slot;
+		pending_values[pending] = fence_value;
+		++pending_count;
+	}
 
-		Try
-			| device->CreateCommittedResource(&cb_heap_properties, D3D12_HEAP_FLAG_NONE,
-											  &cb_resource_desc, D3D12_RESOURCE_STATE_GENERIC_READ,
-											  nullptr, IID_PPV_ARGS(&resource));
+	void WriteCompletedFrames(std::span<RenderFence* const> fences) {
+		while (pending_count) {
+			auto slot = pending_slots[pending_head];
+			if (fences[slot]->GetCompletedValue() < pending_values[pending_head])
+				break;
 
-		D3D12_RANGE range{.Begin = 0, .End = 0};
-		Try | resource->Map(0, &range, (void**)&mapped);
-	}
+			staging.clear();
+			if (y4m)
+				AppendY4mFrame(staging, buffer.mapped, GetSlotFootprint(slot));
+			else
+				AppendRawFrame(staging, buffer.mapped, GetSlotFootprint(slot));
+			writer.WriteFrame(staging.data(), (uint32_t)staging.size());
 
-	~MvpConstantBuffer() {
-		if (resource && mapped) {
-			resource->Unmap(0, nullptr);
-			mapped = nullptr;
+			pending_head = (pending_head + 1) % BUFFER_COUNT;
+			--pending_count;
+			++dumped_frames;
 		}
 	}
 
-	D3D12_GPU_VIRTUAL_ADDRESS GetGpuVirtualAddress() const {
-		return resource->GetGPUVirtualAddress();
-	}
-
-	void WriteIdentity() {
-		if (!mapped)
-			return;
-
-		memcpy(mapped, &IDENTITY, sizeof(IDENTITY));
+	TextureFootprint GetSlotFootprint(uint32_t slot) const {
+		return GetTextureFootprint(footprint.width, footprint.height, footprint.format,
+								   slot * footprint.size);
 	}
 };
 
-struct Renderer {
-	D3D12Device& d;
-
-	MvpConstantBuffer mvp_constant_buffer{*&d.device};
-	D3D12FrameResources frames{*&d.device, BUFFER_COUNT};
-	D3D12Pipeline pipeline{*&d.device, RENDER_TARGET_FORMAT};
-	D3D12Mesh mesh{*&d.device};
+struct FrameReplayUpload {
+	Y4mReplaySource& source;
+	TextureFootprint footprint;
+	RenderUploadBuffer buffer;
 
-	Renderer(D3D12Device& d) : d(d) {
+	FrameReplayUpload(RenderDevice& device, Y4mReplaySource& source, const EncoderConfig& config)
+		: source(source)
+		, footprint(GetTextureFootprint(config.width, config.height, RENDER_TARGET_FORMAT))
+		, buffer(device, (uint32_t)(footprint.size * BUFFER_COUNT)) {
 	}
 
-	void WriteToCommandList(ID3D12GraphicsCommandList* command_list,
-							D3D12_CPU_DESCRIPTOR_HANDLE rtv, uint32_t width, uint32_t height) {
-		command_list->OMSetRenderTargets(1, &rtv, FALSE, nullptr);
-
-		D3D12_VIEWPORT viewport{.TopLeftX = 0.0f,
-								.TopLeftY = 0.0f,
-								.Width	  = (float)width,
-								.Height	  = (float)height,
-								.MinDepth = 0.0f,
-								.MaxDepth = 1.0f};
-		D3D12_RECT scissor{.left = 0, .top = 0, .right = (LONG)width, .bottom = (LONG)height};
-		command_list->RSSetViewports(1, &viewport);
-		command_list->RSSetScissorRects(1, &scissor);
-
-		command_list->SetGraphicsRootSignature(pipeline.GetRootSignature());
-		command_list->SetPipelineState(pipeline.GetPipelineState());
-		command_list->SetGraphicsRootConstantBufferView(0,
-														mvp_constant_buffer.GetGpuVirtualAddress());
-
-		float clear_color[]{0.0f, 0.0f, 0.0f, 1.0f};
-		command_list->ClearRenderTargetView(rtv, clear_color, 0, nullptr);
-
-		mesh.Draw(command_list);
+	void Record(RenderCommandList& command_list, RenderTexture* destination, uint32_t slot) {
+		auto slot_footprint = GetTextureFootprint(footprint.width, footprint.height,
+												  footprint.format, slot * footprint.size);
+		source.ReadFrame(buffer.mapped, slot_footprint);
+		command_list.CopyBufferToTexture(destination, buffer, slot_footprint);
 	}
 };
 
-export class App {
-	HWND hwnd;
+export struct AppOptions {
 	bool headless;
+	uint32_t frame_count;
+	const char* dump_path;
+	const char* mesh_path;
+	const char* export_name;
+	const char* rtp_host;
+	uint16_t rtp_port;
+	const char* ts_path;
+	const char* ts_host;
+	uint16_t ts_port;
+	Y4mReplaySource* replay_source;
+	BackpressurePolicy backpressure_policy;
+	bool capture_clock;
+	PipelinePlacement placement;
+};
+
+export class App {
+	std::chrono::time_point<std::chrono::steady_clock> startup_time
+		= std::chrono::steady_clock::now();
+	WindowHandle hwnd;
+	AppOptions options;
 	uint32_t width;
 	uint32_t height;
-	D3D12Device device;
+	JobSystem job_system{{.thread_count = GetLogicalCoreCount(),
+						  .pin_threads	= false,
+						  .placement	= options.placement.workers}};
+	RenderDevice device;
 	EncoderConfig encoder_config{.codec		   = EncoderCodec::H264,
 								 .preset	   = EncoderPreset::Fastest,
 								 .rate_control = RateControlMode::VariableBitrate,
 								 .width		   = width,
 								 .height	   = height};
-	NvencSession nvenc_session{*&device.device, encoder_config};
-	D3D12SwapChain swap_chain{*&device.device, *&device.factory, *&device.command_queue, hwnd,
-							  SwapChainConfig{.buffer_count			= BUFFER_COUNT,
-											  .render_target_format = RENDER_TARGET_FORMAT}};
-	Renderer renderer{device};
-	ComPtr<ID3D12DescriptorHeap> offscreen_rtv_heap;
-	uint32_t offscreen_rtv_descriptor_size;
-	ComPtr<ID3D12CommandAllocator> allocator;
-	RenderTextureArray offscreen_render_targets{*&device.device, BUFFER_COUNT, width, height,
-												RENDER_TARGET_FORMAT};
-	BitstreamFileWriter bitstream_writer{"output.h264"};
-	FrameEncoder frame_encoder{nvenc_session, *&device.device, BUFFER_COUNT,
-							   width * height * 4 * 2};
+	SwapChainConfig swap_chain_config{.buffer_count			= BUFFER_COUNT,
+									  .render_target_format = RENDER_TARGET_FORMAT};
+#ifdef GOBLIN_CPU_BACKEND
+	std::optional<CpuSwapChain> swap_chain;
+#else
+	std::optional<NvencSession> nvenc_session;
+	std::optional<D3D12SwapChain> swap_chain;
+#endif
+	std::optional<Renderer> renderer;
+	std::optional<RenderTextureArray> offscreen_render_targets;
+	ResourceStateTracker<RenderTexture> state_tracker;
+	RenderGraph frame_graph;
+	StreamPipelineConfig stream_config{.output_path = "output.h264",
+									   .node		= options.placement.render.node,
+									   .pacing		= {.policy = options.backpressure_policy}};
+	std::optional<FrameDump> frame_dump;
+	std::optional<FrameReplayUpload> replay_upload;
+	std::optional<KeyframeCache> keyframe_cache;
+	std::optional<SharedFrameRing> frame_export;
+	std::optional<RtpSender> rtp_sender;
+	std::optional<TsFileWriter> ts_writer;
+	std::optional<TsSender> ts_sender;
+	std::optional<CaptureClock> capture_clock;
+	std::optional<StreamPipeline> stream;
 
   public:
-	App(HWND hwnd, bool headless, uint32_t width, uint32_t height)
-		: hwnd(hwnd), headless(headless), width(width), height(height) {
-		D3D12_DESCRIPTOR_HEAP_DESC rtv_heap_desc{
-			.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
-			.NumDescriptors = BUFFER_COUNT,
+	App(WindowHandle hwnd, const AppOptions& options, uint32_t width, uint32_t height)
+		: hwnd(hwnd), options(options), width(width), height(height) {
+		if (options.replay_source) {
+			encoder_config.frame_rate_num = options.replay_source->header.frame_rate_num;
+			encoder_config.frame_rate_den = options.replay_source->header.frame_rate_den;
+		}
+
+#ifdef GOBLIN_CPU_BACKEND
+		auto create_swap_chain = [&] {
+			swap_chain.emplace(device, width, height, swap_chain_config);
+		};
+		auto create_frame_encoder = [&] {
+			stream.emplace(encoder_config, stream_config, encoder_config, BUFFER_COUNT);
+		};
+#else
+		auto create_swap_chain = [&] {
+			swap_chain.emplace(*&device.device, *&device.factory, *&device.command_queue, hwnd,
+							   swap_chain_config);
+		};
+		auto create_nvenc_session = [&] { nvenc_session.emplace(*&device.device, encoder_config); };
+		auto create_frame_encoder = [&] {
+			stream.emplace(encoder_config, stream_config, *nvenc_session, device, BUFFER_COUNT,
+						   width * height * 4 * 2, encoder_config.min_idr_interval);
+		};
+#endif
+		auto create_renderer = [&] {
+			renderer.emplace(device, job_system, options.mesh_path);
 		};
-		Try
-			| device.device->CreateDescriptorHeap(&rtv_heap_desc,
-												  IID_PPV_ARGS(&offscreen_rtv_heap));
-		offscreen_rtv_descriptor_size
-			= device.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
-
-		Try
-			| device.device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
-													IID_PPV_ARGS(&allocator));
-
-		for (auto j = 0u; j < BUFFER_COUNT; ++j)
-			frame_encoder.RegisterTexture(*&offscreen_render_targets.textures[j], width, height,
-										  DxgiFormatToNvencFormat(RENDER_TARGET_FORMAT),
-										  renderer.frames.fences[j]);
-
-		auto offscreen_rtv_for = [this](uint32_t index) {
-			auto rtv = offscreen_rtv_heap->GetCPUDescriptorHandleForHeapStart();
-			rtv.ptr += index * offscreen_rtv_descriptor_size;
-			return rtv;
+		auto create_render_targets = [&] {
+			offscreen_render_targets.emplace(device, BUFFER_COUNT, width, height,
+											 RENDER_TARGET_FORMAT);
+		};
+		auto create_capture = [&] {
+			if (options.dump_path)
+				frame_dump.emplace(device, options.dump_path, encoder_config);
+			if (options.replay_source)
+				replay_upload.emplace(device, *options.replay_source, encoder_config);
+		};
+		auto create_keyframe_cache = [&] { keyframe_cache.emplace(encoder_config.codec); };
+		auto create_frame_export = [&] {
+			if (options.export_name)
+				frame_export.emplace(options.export_name, encoder_config, FRAME_EXPORT_CAPACITY,
+									 FRAME_EXPORT_SLOT_COUNT);
+		};
+		auto create_rtp_sender = [&] {
+			if (options.rtp_host)
+				rtp_sender.emplace(options.rtp_host, options.rtp_port, encoder_config, RtpConfig{},
+								   options.placement.writer);
+		};
+		auto create_ts_output = [&] {
+			if (options.ts_path)
+				ts_writer.emplace(options.ts_path, encoder_config);
+			if (options.ts_host)
+				ts_sender.emplace(options.ts_host, options.ts_port, encoder_config, TsMuxerConfig{},
+								  options.placement.writer);
+		};
+		auto register_textures = [&] {
+			for (auto j = 0u; j < BUFFER_COUNT; ++j) {
+				stream->encoder.RegisterTexture(*&offscreen_render_targets->textures[j], width,
+												height,
+												TextureFormatToNvencFormat(RENDER_TARGET_FORMAT),
+												renderer->frames.fences[j]);
+				state_tracker.RegisterTexture(*&offscreen_render_targets->textures[j],
+											  ResourceState::Common);
+				state_tracker.RegisterTexture(*&swap_chain->render_targets[j],
+											  ResourceState::Present);
+			}
 		};
 
-		auto record_frame_command_list
-			= [this](uint32_t index, D3D12_CPU_DESCRIPTOR_HANDLE cmd_rtv) {
-				  auto command_list				= renderer.frames.command_lists[index];
-				  auto render_target			= *&offscreen_render_targets.textures[index];
-				  auto swap_chain_render_target = *&swap_chain.render_targets[index];
-
-				  auto apply_transition_barriers = [command_list](auto... transitions) {
-					  D3D12_RESOURCE_BARRIER barriers[]{{
-						  .Type		  = D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
-						  .Transition = transitions,
-					  }...};
-					  command_list->ResourceBarrier((UINT)sizeof...(transitions), barriers);
-				  };
-
-				  command_list->Reset(*&allocator, nullptr);
-				  apply_transition_barriers(D3D12_RESOURCE_TRANSITION_BARRIER{
-					  .pResource   = render_target,
-					  .StateBefore = D3D12_RESOURCE_STATE_COMMON,
-					  .StateAfter  = D3D12_RESOURCE_STATE_RENDER_TARGET,
-				  });
-
-				  renderer.WriteToCommandList(command_list, cmd_rtv, this->width, this->height);
-
-				  apply_transition_barriers(
-					  D3D12_RESOURCE_TRANSITION_BARRIER{
-						  .pResource   = render_target,
-						  .StateBefore = D3D12_RESOURCE_STATE_RENDER_TARGET,
-						  .StateAfter  = D3D12_RESOURCE_STATE_COPY_SOURCE,
-					  },
-					  D3D12_RESOURCE_TRANSITION_BARRIER{
-						  .pResource   = swap_chain_render_target,
-						  .StateBefore = D3D12_RESOURCE_STATE_PRESENT,
-						  .StateAfter  = D3D12_RESOURCE_STATE_COPY_DEST,
-					  });
-
-				  command_list->CopyResource(swap_chain_render_target, render_target);
-
-				  apply_transition_barriers(
-					  D3D12_RESOURCE_TRANSITION_BARRIER{
-						  .pResource   = swap_chain_render_target,
-						  .StateBefore = D3D12_RESOURCE_STATE_COPY_DEST,
-						  .StateAfter  = D3D12_RESOURCE_STATE_PRESENT,
-					  },
-					  D3D12_RESOURCE_TRANSITION_BARRIER{
-						  .pResource   = render_target,
-						  .StateBefore = D3D12_RESOURCE_STATE_COPY_SOURCE,
-						  .StateAfter  = D3D12_RESOURCE_STATE_COMMON,
-					  });
-
-				  command_list->Close();
-			  };
-
-		for (auto k = 0u; k < BUFFER_COUNT; ++k) {
-			auto cmd_rtv = offscreen_rtv_for(k);
-			device.device->CreateRenderTargetView(*&offscreen_render_targets.textures[k], nullptr,
-												  cmd_rtv);
-			record_frame_command_list(k, cmd_rtv);
+		StartupGraph startup;
+		auto swap_chain_task	 = startup.AddMainThreadTask("swap_chain", create_swap_chain);
+		auto renderer_task		 = startup.AddTask("renderer", create_renderer);
+		auto render_targets_task = startup.AddTask("render_targets", create_render_targets);
+#ifdef GOBLIN_CPU_BACKEND
+		auto frame_encoder_task = startup.AddTask("frame_encoder", create_frame_encoder);
+#else
+		auto nvenc_session_task = startup.AddTask("nvenc_session", create_nvenc_session);
+		auto frame_encoder_task
+			= startup.AddTask("frame_encoder", create_frame_encoder, {nvenc_session_task});
+#endif
+		startup.AddTask("capture", create_capture);
+		startup.AddTask("keyframe_cache", create_keyframe_cache);
+		startup.AddTask("frame_export", create_frame_export);
+		startup.AddTask("rtp_sender", create_rtp_sender);
+		startup.AddTask("ts_output", create_ts_output);
+		startup.AddTask("register_textures", register_textures,
+						{swap_chain_task, renderer_task, render_targets_task, frame_encoder_task});
+		startup.Run(job_system);
+		AppLogging::LogStartupGraph(startup.GetTimings(), startup.GetStats());
+
+		stream->encoder.AddOutput(KeyframeCache::UpdateFrame, &*keyframe_cache);
+		if (frame_export) {
+			stream->encoder.AddOutput(SharedFrameRing::PublishFrame, &*frame_export);
+			frame_export->SetKeyframeRequestHandler(
+				StreamEncoder::RequestEncoderKeyframe, &stream->encoder);
 		}
+		if (rtp_sender)
+			stream->encoder.AddOutput(RtpSender::SendFrame, &*rtp_sender);
+		if (ts_writer)
+			stream->encoder.AddOutput(TsFileWriter::WriteFrame, &*ts_writer);
+		if (ts_sender)
+			stream->encoder.AddOutput(TsSender::SendFrame, &*ts_sender);
 	}
 
 	int Run() && {
-		bool running			   = true;
+		AppLogging::LogThreadPlacement("render", ApplyThreadPlacement(options.placement.render));
+		bool running = true;
+		if (options.capture_clock)
+			capture_clock.emplace(encoder_config.frame_rate_num, encoder_config.frame_rate_den);
+
+		EventLoop loop;
+		loop.Spawn(RenderLoop(loop, running));
+		if (capture_clock)
+			loop.Spawn(CaptureLoop(loop));
+		while (running) {
+			loop.RunOnce(INFINITE_TIMEOUT);
+			PumpMessages(running);
+		}
+
+		DrainAndWait();
+		AppLogging::LogEventLoopStats(loop.GetStats());
+		return 0;
+	}
+
+  private:
+	struct PresentedFrame {
+		uint32_t back_buffer_index;
+		uint64_t signaled_value;
+		uint32_t frame;
+	};
+
+	PresentedFrame presented_frame{};
+
+	EventTask RenderLoop(EventLoop& loop, bool& running) {
 		uint32_t frames_submitted  = 0;
-		uint32_t back_buffer_index = swap_chain.swap_chain->GetCurrentBackBufferIndex();
-		HRESULT present_result	   = S_OK;
+		uint32_t back_buffer_index = swap_chain->GetCurrentBackBufferIndex();
+		auto present_result		   = PresentResult::Presented;
 		auto last_frame_time	   = std::chrono::steady_clock::now();
 
 		while (running) {
 			auto frame_log = AppLogging::BuildFrameLogContext(frames_submitted, last_frame_time);
-			AppLogging::LogFrameLoopStart(frame_log, frame_encoder.GetStats());
+			AppLogging::LogFrameLoopStart(frame_log, stream->encoder.GetStats());
 
-			if (frame_wait_coordinator.Wait(*this, frame_log.frame, frame_log.cpu_ms)
-				== FrameLoopAction::Continue) {
-				PumpMessages(running);
-				continue;
-			}
+			FRAME_LOG("frame=%u cpu_ms=%.3f wait_for_frame begin", frame_log.frame,
+					  frame_log.cpu_ms);
+			co_await loop.Wait(swap_chain->frame_latency_waitable);
 
 			uint64_t completed_value = 0;
-			if (!IsFrameReady(renderer.frames, back_buffer_index, frame_log.frame, completed_value))
-				continue;
+			while (!IsFrameReady(renderer->frames, back_buffer_index, frame_log.frame,
+								 completed_value))
+				co_await loop.Wait(renderer->frames.fence_events[back_buffer_index]);
 
 			AppLogging::LogFenceCompletion(frame_log, completed_value);
 			AppLogging::LogPresentStatus(frame_log, present_result);
 
-			renderer.mvp_constant_buffer.WriteIdentity();
-
 			auto signaled_value = frame_log.frame + 1;
 
-			if (SUCCEEDED(present_result)) {
-				auto command_list_to_execute
-					= (ID3D12CommandList*)renderer.frames.command_lists[back_buffer_index];
-				device.command_queue->ExecuteCommandLists(1, &command_list_to_execute);
+			if (present_result == PresentResult::Presented) {
+				renderer->BeginFrame();
+				if (frame_dump)
+					frame_dump->WriteCompletedFrames(renderer->frames.fences);
+				RecordFrameCommandList(back_buffer_index, signaled_value);
+				device.Execute(renderer->frames.GetCommandLists(back_buffer_index));
+				renderer->EndFrame(back_buffer_index, signaled_value);
 			}
 
-			present_result = PresentAndSignal(*&device.command_queue, *&swap_chain.swap_chain,
-											  renderer.frames, back_buffer_index, signaled_value);
-			if (present_result == DXGI_ERROR_WAS_STILL_DRAWING) {
+			present_result = PresentAndSignal(renderer->frames, back_buffer_index, signaled_value);
+			if (present_result == PresentResult::StillDrawing) {
 				AppLogging::LogPresentStillDrawing(frame_log);
 				continue;
 			}
 
-			if (SUCCEEDED(present_result))
-				frame_encoder.EncodeFrame(back_buffer_index, signaled_value, frame_log.frame);
+			if (present_result == PresentResult::Presented) {
+				if (!frames_submitted)
+					AppLogging::LogTimeToFirstFrame(startup_time);
+				if (capture_clock) {
+					presented_frame = PresentedFrame{
+						.back_buffer_index = back_buffer_index,
+						.signaled_value	   = signaled_value,
+						.frame			   = frame_log.frame,
+					};
+					capture_clock->OnFramePresented();
+				}
+				else
+					stream->EncodeFrame(loop, back_buffer_index, signaled_value, frame_log.frame,
+										frame_log.frame);
+			}
 
-			auto new_back_buffer_index = swap_chain.swap_chain->GetCurrentBackBufferIndex();
+			auto new_back_buffer_index = swap_chain->GetCurrentBackBufferIndex();
 			AppLogging::LogFrameSubmitResult(frame_log, back_buffer_index, signaled_value,
 											 new_back_buffer_index);
 			back_buffer_index = new_back_buffer_index;
 			++frames_submitted;
 
-			if (headless && frames_submitted >= 500)
-				break;
+			if (options.headless && frames_submitted >= options.frame_count)
+				running = false;
 		}
-
-		DrainAndWait();
-		return 0;
 	}
 
-  private:
-	enum class FrameLoopAction {
-		Continue,
-		Proceed,
-	};
-
-	class FrameWaitCoordinator {
-	  public:
-		enum class WaitableComponent {
-			FrameLatency,
-			BitstreamWrite,
-			EncoderOutput,
-		};
-
-		FrameLoopAction Wait(App& app, uint32_t frames_submitted, double cpu_ms);
-
-	  private:
-		static FrameLoopAction Complete(App& app, WaitableComponent component);
-	};
-
-	FrameWaitCoordinator frame_wait_coordinator;
+	EventTask CaptureLoop(EventLoop& loop) {
+		while (true) {
+			co_await loop.Wait(capture_clock->GetEvent());
+			CaptureFrame(loop);
+		}
+	}
 
 	void PumpMessages(bool& running) const {
+#ifdef _WIN32
 		for (MSG msg{}; PeekMessage(&msg, nullptr, 0, 0, PM_REMOVE);) {
 			if (msg.message == WM_QUIT) {
 				running = false;
@@ -326,94 +403,141 @@ export class App {
 			TranslateMessage(&msg);
 			DispatchMessage(&msg);
 		}
+#else
+		(void)running;
+#endif
 	}
 
-	bool IsFrameReady(const D3D12FrameResources& resources, uint32_t back_buffer_index,
+	bool IsFrameReady(const RenderFrameResources& resources, uint32_t back_buffer_index,
 					  uint32_t frames_submitted, uint64_t& completed_value) {
 		completed_value = resources.fences[back_buffer_index]->GetCompletedValue();
 		return completed_value + resources.fences.size() >= frames_submitted + 1;
 	}
 
-	HRESULT PresentAndSignal(ID3D12CommandQueue* command_queue, IDXGISwapChain4* swap_chain_handle,
-							 D3D12FrameResources& frame_resources, uint32_t back_buffer_index,
-							 uint64_t signaled_value) {
-		auto present_result = swap_chain_handle->Present(1, DXGI_PRESENT_DO_NOT_WAIT);
-		Try | command_queue->Signal(frame_resources.fences[back_buffer_index], signaled_value)
-			| frame_resources.fences[back_buffer_index]->SetEventOnCompletion(
-				signaled_value, frame_resources.fence_events[back_buffer_index]);
-		return present_result;
-	}
+	void RecordFrameCommandList(uint32_t index, uint64_t fence_value) {
+		auto command_lists			  = renderer->frames.GetCommandLists(index);
+		auto render_target_view		  = offscreen_render_targets->render_target_views[index];
+		auto render_target			  = *&offscreen_render_targets->textures[index];
+		auto swap_chain_render_target = *&swap_chain->render_targets[index];
+		RenderTexture* graph_textures[]{render_target, swap_chain_render_target};
+
+		frame_graph.Reset();
+		auto scene_target = frame_graph.ImportTexture(ResourceState::Common);
+		auto back_buffer  = frame_graph.ImportTexture(ResourceState::Present);
+		auto scene_pass	  = frame_graph.AddPass();
+		auto scene_state  = replay_upload ? ResourceState::CopyDest : ResourceState::RenderTarget;
+		frame_graph.Write(scene_pass, scene_target, scene_state, true);
+		auto copy_pass = frame_graph.AddPass();
+		frame_graph.Read(copy_pass, scene_target, ResourceState::CopySource);
+		frame_graph.Write(copy_pass, back_buffer, ResourceState::CopyDest, true);
+		frame_graph.Compile();
+
+		auto command_list = &command_lists.front();
+		command_list->Reset();
+		for (auto pass : frame_graph.GetPassOrder()) {
+			ApplyGraphTransitions(*command_list, graph_textures,
+								  frame_graph.GetPassTransitions(pass));
+			if (pass == scene_pass && replay_upload)
+				replay_upload->Record(*command_list, render_target, index);
+			else if (pass == scene_pass) {
+				renderer->ClearRenderTarget(*command_list, render_target_view);
+				command_list->Close();
+				renderer->RecordDraws(command_lists.subspan(1, DRAW_COMMAND_LIST_COUNT),
+									  render_target_view, width, height, SCENE_DRAW_COUNT);
+				command_list = &command_lists.back();
+				command_list->Reset();
+			}
+			else if (pass == copy_pass) {
+				command_list->Copy(swap_chain_render_target, render_target);
+				if (frame_dump)
+					frame_dump->Record(*command_list, render_target, index, fence_value);
+			}
+		}
+		ApplyGraphTransitions(*command_list, graph_textures, frame_graph.GetFinalTransitions());
 
-	void DrainAndWait() {
-		frame_encoder.ProcessCompletedFrames(bitstream_writer, true);
-		WaitForMultipleObjects((DWORD)renderer.frames.fences.size(),
-							   renderer.frames.fence_events.data(), TRUE, INFINITE);
-		frame_encoder.ProcessCompletedFrames(bitstream_writer, true);
-		auto stats = frame_encoder.GetStats();
-		FRAME_LOG("encoder_drain submitted=%llu completed=%llu pending=%llu waits=%llu",
-				  stats.submitted_frames, stats.completed_frames, stats.pending_frames,
-				  stats.wait_count);
+		command_list->Close();
 	}
-};
 
-App::FrameLoopAction App::FrameWaitCoordinator::Complete(App& app, WaitableComponent component) {
-	switch (component) {
-		case WaitableComponent::FrameLatency:
-			return FrameLoopAction::Proceed;
-		case WaitableComponent::BitstreamWrite:
-			app.bitstream_writer.DrainCompleted();
-			return FrameLoopAction::Continue;
-		case WaitableComponent::EncoderOutput:
-			app.frame_encoder.ProcessCompletedFrames(app.bitstream_writer);
-			return FrameLoopAction::Continue;
+	void ApplyGraphTransitions(RenderCommandList& command_list,
+							   std::span<RenderTexture* const> graph_textures,
+							   std::span<const RenderGraphTransition> transitions) {
+		for (auto& transition : transitions)
+			if (transition.split == BarrierSplit::Begin)
+				state_tracker.BeginSplitTransition(graph_textures[transition.texture],
+												   transition.state);
+			else
+				state_tracker.Transition(graph_textures[transition.texture], transition.state);
+		state_tracker.Flush(command_list);
 	}
-	throw;
-}
-
-App::FrameLoopAction App::FrameWaitCoordinator::Wait(App& app, uint32_t frames_submitted,
-													 double cpu_ms) {
-	HANDLE handles[3];
-	WaitableComponent components[3];
-	DWORD component_count = 0;
 
-	auto add_waitable
-		= [&handles, &components, &component_count](HANDLE handle, WaitableComponent component) {
-			  handles[component_count]	  = handle;
-			  components[component_count] = component;
-			  ++component_count;
-		  };
-
-	add_waitable(app.swap_chain.frame_latency_waitable, WaitableComponent::FrameLatency);
-
-	if (app.bitstream_writer.HasPendingWrites())
-		add_waitable(app.bitstream_writer.NextWriteEvent(), WaitableComponent::BitstreamWrite);
+	PresentResult PresentAndSignal(RenderFrameResources& frame_resources,
+								   uint32_t back_buffer_index, uint64_t signaled_value) {
+		auto present_result = swap_chain->Present();
+		device.Signal(frame_resources.fences[back_buffer_index], signaled_value,
+					  frame_resources.fence_events[back_buffer_index]);
+		return present_result;
+	}
 
-	if (app.frame_encoder.HasPendingOutputs())
-		add_waitable(app.frame_encoder.NextOutputEvent(), WaitableComponent::EncoderOutput);
+	void CaptureFrame(EventLoop& loop) {
+		uint64_t timestamp = 0;
+		auto action		   = capture_clock->OnTick(timestamp);
+		FRAME_LOG("frame=%u capture_tick timestamp=%llu action=%d", presented_frame.frame,
+				  timestamp, (int)action);
+		if (action != CaptureAction::None)
+			stream->EncodeFrame(loop, presented_frame.back_buffer_index,
+								presented_frame.signaled_value, presented_frame.frame, timestamp);
+	}
 
-#ifndef ENABLE_FRAME_DEBUG_LOG
-	(void)frames_submitted;
-	(void)cpu_ms;
+	void DrainAndWait() {
+		stream->Drain();
+#ifdef GOBLIN_CPU_BACKEND
+		CpuFence idle_fence;
+		device.command_queue.Signal(&idle_fence, 1);
+		idle_fence.Wait(1);
+#else
+		WaitForMultipleObjects((DWORD)renderer->frames.fences.size(),
+							   renderer->frames.fence_events.data(), TRUE, INFINITE);
 #endif
-	FRAME_LOG("frame=%u cpu_ms=%.3f wait_for_frame begin", frames_submitted, cpu_ms);
-
-	DWORD wait_result
-		= MsgWaitForMultipleObjects(component_count, handles, FALSE, INFINITE, QS_ALLINPUT);
-	FRAME_LOG("frame=%u cpu_ms=%.3f wait_for_frame result=%lu component_count=%lu",
-			  frames_submitted, cpu_ms, wait_result, component_count);
-	if (wait_result == WAIT_FAILED) {
-		auto wait_error = GetLastError();
-		FRAME_LOG("frame=%u cpu_ms=%.3f wait_for_frame failed error=%lu", frames_submitted, cpu_ms,
-				  wait_error);
+		stream->Drain();
+		if (frame_dump)
+			frame_dump->WriteCompletedFrames(renderer->frames.fences);
+		auto stats = stream->encoder.GetStats();
 #ifndef ENABLE_FRAME_DEBUG_LOG
-		(void)wait_error;
+		(void)stats;
+#endif
+		FRAME_LOG("encoder_drain submitted=%llu completed=%llu pending=%llu waits=%llu",
+				  stats.submitted_frames, stats.completed_frames, stats.pending_frames,
+				  stats.wait_count);
+		AppLogging::LogUploadRingStats(renderer->upload_ring.ring.GetStats());
+		AppLogging::LogResourceStateStats(state_tracker.GetStats());
+		AppLogging::LogRenderGraphStats(frame_graph.GetStats());
+		AppLogging::LogCommandRecorderStats(renderer->recorder.GetStats());
+		AppLogging::LogJobSystemStats(job_system.GetStats());
+		if (frame_dump || replay_upload)
+			AppLogging::LogCaptureStats(frame_dump ? frame_dump->dumped_frames : 0,
+										replay_upload ? replay_upload->source.GetStats()
+													  : Y4mReplayStats{});
+		AppLogging::LogKeyframeStats(keyframe_cache->GetStats(),
+									 stream->encoder.GetKeyframeRequestStats());
+		if (frame_export)
+			AppLogging::LogFrameExportStats(frame_export->GetStats());
+		if (rtp_sender)
+			AppLogging::LogRtpSenderStats(rtp_sender->GetStats(), rtp_sender->GetPacketizerStats());
+		if (ts_writer)
+			AppLogging::LogTsOutputStats(ts_writer->GetStats(), PacedSenderStats{});
+		if (ts_sender)
+			AppLogging::LogTsOutputStats(ts_sender->GetMuxerStats(), ts_sender->GetStats());
+		AppLogging::LogFramePacingStats(stream->pacer.GetStats());
+		AppLogging::LogBufferPoolStats("bitstream", stream->writer.GetPoolStats());
+		if (frame_dump)
+			AppLogging::LogBufferPoolStats("frame_dump", frame_dump->writer.GetPoolStats());
+		if (capture_clock)
+			AppLogging::LogCaptureClockStats(capture_clock->GetStats());
+#ifdef GOBLIN_CPU_BACKEND
+		AppLogging::LogRasterizerStats(device.rasterizer.GetStats());
+#else
+		AppLogging::LogHeapStats(device.heap_allocator.GetStats());
+		AppLogging::LogPipelineCacheStats(renderer->pipeline.GetCacheStats());
 #endif
-		throw;
-	}
-
-	if (wait_result >= WAIT_OBJECT_0 && wait_result < WAIT_OBJECT_0 + component_count) {
-		auto component_index = wait_result - WAIT_OBJECT_0;
-		return Complete(app, components[component_index]);
 	}
-	return FrameLoopAction::Continue;
-}
+};
@@ -2,6 +2,8 @@
 
 #include "debug_log.h"
 
+constexpr const char* PAGE_BACKING_NAMES[]{"small", "transparent", "huge"};
+
 AppLogging::FrameLogContext AppLogging::BuildFrameLogContext(
 	uint32_t frames_submitted,
 	std::chrono::time_point<std::chrono::steady_clock>& last_frame_time) {
@@ -11,8 +13,7 @@ AppLogging::FrameLogContext AppLogging::BuildFrameLogContext(
 	return FrameLogContext{.frame = frames_submitted, .cpu_ms = cpu_ms};
 }
 
-void AppLogging::LogFrameLoopStart(const FrameLogContext& frame_log,
-								   const FrameEncoder::Stats& stats) {
+void AppLogging::LogFrameLoopStart(const FrameLogContext& frame_log, const EncoderStats& stats) {
 #ifndef ENABLE_FRAME_DEBUG_LOG
 	(void)frame_log;
 	(void)stats;
@@ -33,13 +34,14 @@ void AppLogging::LogFenceCompletion(const FrameLogContext& frame_log, uint64_t c
 			  completed_value);
 }
 
-void AppLogging::LogPresentStatus(const FrameLogContext& frame_log, HRESULT present_result) {
+void AppLogging::LogPresentStatus(const FrameLogContext& frame_log,
+								  PresentResult present_result) {
 #ifndef ENABLE_FRAME_DEBUG_LOG
 	(void)frame_log;
 	(void)present_result;
 #endif
-	FRAME_LOG("frame=%u cpu_ms=%.3f present_result=%ld", frame_log.frame, frame_log.cpu_ms,
-			  present_result);
+	FRAME_LOG("frame=%u cpu_ms=%.3f present_result=%d", frame_log.frame, frame_log.cpu_ms,
+			  (int)present_result);
 }
 
 void AppLogging::LogPresentStillDrawing(const FrameLogContext& frame_log) {
@@ -50,6 +52,36 @@ void AppLogging::LogPresentStillDrawing(const FrameLogContext& frame_log) {
 			  frame_log.cpu_ms);
 }
 
+void AppLogging::LogStartupGraph(std::span<const StartupTaskTiming> timings,
+								 const StartupGraphStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)timings;
+	(void)stats;
+#else
+	for (auto& timing : timings)
+		FRAME_LOG("startup_task name=%s thread=%s start_ms=%.3f duration_ms=%.3f", timing.name,
+				  timing.main_thread ? "main" : "worker", timing.start_nanoseconds / 1e6,
+				  (timing.end_nanoseconds - timing.start_nanoseconds) / 1e6);
+#endif
+	FRAME_LOG("startup_graph tasks=%u wall_ms=%.3f serial_ms=%.3f critical_path_ms=%.3f",
+			  stats.task_count, stats.wall_nanoseconds / 1e6, stats.serial_nanoseconds / 1e6,
+			  stats.critical_path_nanoseconds / 1e6);
+}
+
+void AppLogging::LogTimeToFirstFrame(
+	std::chrono::time_point<std::chrono::steady_clock> startup_time) {
+	auto elapsed	= std::chrono::steady_clock::now() - startup_time;
+	auto elapsed_ms = std::chrono::duration<double, std::milli>(elapsed).count();
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)elapsed_ms;
+#endif
+#ifdef GOBLIN_EMBED_SHADERS
+	FRAME_LOG("time_to_first_frame_ms=%.3f shaders=embedded", elapsed_ms);
+#else
+	FRAME_LOG("time_to_first_frame_ms=%.3f shaders=pack", elapsed_ms);
+#endif
+}
+
 void AppLogging::LogFrameSubmitResult(const FrameLogContext& frame_log, uint32_t back_buffer_index,
 									  uint32_t signaled_value, uint32_t new_back_buffer_index) {
 #ifndef ENABLE_FRAME_DEBUG_LOG
@@ -63,3 +95,201 @@ void AppLogging::LogFrameSubmitResult(const FrameLogContext& frame_log, uint32_t
 	FRAME_LOG("frame=%u cpu_ms=%.3f new_back_buffer_index=%u", frame_log.frame, frame_log.cpu_ms,
 			  new_back_buffer_index);
 }
+
+void AppLogging::LogRasterizerStats(const RasterizerStats& stats) {
+	auto raster_ms		  = (double)stats.raster_nanoseconds / 1.0e6;
+	auto megapixels_per_s = raster_ms > 0.0 ? (double)stats.shaded_pixels / raster_ms / 1.0e3 : 0.0;
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)raster_ms;
+	(void)megapixels_per_s;
+#endif
+	FRAME_LOG("rasterizer_stats threads=%u draws=%llu triangles=%llu binned_tiles=%llu "
+			  "shaded_pixels=%llu raster_ms=%.3f mpixels_per_s=%.1f",
+			  stats.thread_count, stats.draw_count, stats.triangle_count, stats.binned_tile_count,
+			  stats.shaded_pixels, raster_ms, megapixels_per_s);
+}
+
+void AppLogging::LogHeapStats(const HeapPoolStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("heap_stats blocks=%u empty_blocks=%u reserved=%llu used=%llu peak=%llu "
+			  "allocations=%u free_ranges=%u largest_free=%llu fragmentation=%.3f",
+			  stats.block_count, stats.empty_block_count, stats.reserved_bytes, stats.used_bytes,
+			  stats.peak_used_bytes, stats.allocation_count, stats.free_range_count,
+			  stats.largest_free_range, stats.fragmentation);
+}
+
+void AppLogging::LogUploadRingStats(const UploadRingStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("upload_ring_stats capacity=%llu used=%llu peak=%llu allocations=%llu wraps=%llu "
+			  "pending_frames=%u",
+			  stats.capacity, stats.used_bytes, stats.peak_used_bytes, stats.allocation_count,
+			  stats.wrap_count, stats.pending_frame_count);
+}
+
+void AppLogging::LogResourceStateStats(const ResourceStateTrackerStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("resource_state_stats requested=%llu barriers=%llu elided=%llu split=%llu "
+			  "flushes=%llu",
+			  stats.requested_transitions, stats.emitted_barriers, stats.elided_transitions,
+			  stats.split_barriers, stats.flushes);
+}
+
+void AppLogging::LogRenderGraphStats(const RenderGraphStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("render_graph_stats passes=%u live=%u transients=%u aliasing=%u heap=%llu "
+			  "unaliased=%llu",
+			  stats.pass_count, stats.live_pass_count, stats.transient_count, stats.aliasing_count,
+			  stats.transient_heap_size, stats.unaliased_transient_size);
+}
+
+void AppLogging::LogCommandRecorderStats(const CommandRecorderStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("command_recorder_stats threads=%u dispatches=%llu jobs=%llu items=%llu ns=%llu",
+			  stats.thread_count, stats.dispatch_count, stats.job_count, stats.recorded_items,
+			  stats.record_nanoseconds);
+}
+
+void AppLogging::LogJobSystemStats(const JobSystemStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("job_system_stats threads=%u submitted=%llu executed=%llu inline=%llu "
+			  "steal_attempts=%llu steals=%llu sleeps=%llu blocked_waits=%llu idle_ns=%llu",
+			  stats.thread_count, stats.submitted_jobs, stats.executed_jobs, stats.inline_jobs,
+			  stats.steal_attempts, stats.steals, stats.sleeps, stats.blocked_waits,
+			  stats.idle_nanoseconds);
+}
+
+void AppLogging::LogPipelineCacheStats(const PipelineCacheStats& stats) {
+	auto resolved = stats.library_hits + stats.created_pipelines;
+	auto hit_rate = resolved ? (double)stats.library_hits / resolved : 0.0;
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+	(void)hit_rate;
+#endif
+	FRAME_LOG("pipeline_cache_stats requested=%u library_hits=%u created=%u prewarmed=%u "
+			  "writes=%u hit_rate=%.3f hash_ns=%llu create_ns=%llu",
+			  stats.requested_pipelines, stats.library_hits, stats.created_pipelines,
+			  stats.prewarmed_pipelines, stats.cache_writes, hit_rate, stats.hash_nanoseconds,
+			  stats.create_nanoseconds);
+}
+
+void AppLogging::LogCaptureStats(uint64_t dumped_frames, const Y4mReplayStats& replay_stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)dumped_frames;
+	(void)replay_stats;
+#endif
+	FRAME_LOG("capture_stats dumped=%llu replayed=%llu replay_bytes=%llu loops=%llu "
+			  "convert_ns=%llu",
+			  dumped_frames, replay_stats.read_frames, replay_stats.read_bytes,
+			  replay_stats.loop_count, replay_stats.convert_nanoseconds);
+}
+
+void AppLogging::LogKeyframeStats(const KeyframeCacheStats& stats,
+								  const KeyframeRequestStats& request_stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+	(void)request_stats;
+#endif
+	FRAME_LOG("keyframes cached=%llu bytes=%llu parameter_sets=%llu copied=%llu requests=%llu "
+			  "forced=%llu coalesced=%llu",
+			  stats.keyframes, stats.keyframe_bytes, stats.parameter_set_updates,
+			  stats.copied_keyframes, request_stats.requests, request_stats.forced_keyframes,
+			  request_stats.coalesced_requests);
+}
+
+void AppLogging::LogFrameExportStats(const SharedFrameRingStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("frame_export published=%llu bytes=%llu dropped=%llu keyframe_requests=%llu",
+			  stats.published_frames, stats.published_bytes, stats.dropped_frames,
+			  stats.keyframe_requests);
+}
+
+void AppLogging::LogRtpSenderStats(const PacedSenderStats& stats,
+								   const RtpPacketizerStats& packetizer_stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+	(void)packetizer_stats;
+#endif
+	FRAME_LOG("rtp_sender frames=%llu packets=%llu bytes=%llu send_calls=%llu failed=%llu "
+			  "paced_bursts=%llu max_queue=%llu nal_units=%llu single=%llu fragments=%llu",
+			  stats.frames, stats.datagrams, stats.bytes, stats.send_calls, stats.failed_datagrams,
+			  stats.paced_bursts, stats.max_queued_frames, packetizer_stats.nal_units,
+			  packetizer_stats.single_packets, packetizer_stats.fragment_packets);
+}
+
+void AppLogging::LogTsOutputStats(const TsMuxerStats& stats, const PacedSenderStats& sender_stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+	(void)sender_stats;
+#endif
+	FRAME_LOG("ts_output frames=%llu packets=%llu psi=%llu pcr=%llu null=%llu bytes=%llu "
+			  "datagrams=%llu send_calls=%llu failed=%llu max_queue=%llu",
+			  stats.frames, stats.packets, stats.psi_packets, stats.pcr_packets, stats.null_packets,
+			  stats.bytes, sender_stats.datagrams, sender_stats.send_calls,
+			  sender_stats.failed_datagrams, sender_stats.max_queued_frames);
+}
+
+void AppLogging::LogFramePacingStats(const FramePacingStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("frame_pacing frames=%llu encoded=%llu blocked=%llu encoder_drops=%llu "
+			  "writer_drops=%llu non_reference_drops=%llu bitrate_reductions=%llu "
+			  "bitrate_restores=%llu bitrate_percent=%u max_encoder_depth=%u max_writer_depth=%u",
+			  stats.frames, stats.encoded_frames, stats.blocked_frames, stats.encoder_queue_drops,
+			  stats.writer_queue_drops, stats.non_reference_drops, stats.bitrate_reductions,
+			  stats.bitrate_restores, stats.bitrate_percent, stats.max_encoder_depth,
+			  stats.max_writer_depth);
+}
+
+void AppLogging::LogCaptureClockStats(const CaptureClockStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("capture_clock ticks=%llu missed=%llu captured=%llu duplicated=%llu skipped=%llu",
+			  stats.ticks, stats.missed_ticks, stats.captured_frames, stats.duplicated_frames,
+			  stats.skipped_frames);
+}
+
+void AppLogging::LogEventLoopStats(const EventLoopStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)stats;
+#endif
+	FRAME_LOG("event_loop tasks=%llu/%llu awaits=%llu resumes=%llu polls=%llu registrations=%llu",
+			  stats.completed_tasks, stats.spawned_tasks, stats.awaits, stats.resumes, stats.polls,
+			  stats.registrations);
+}
+
+void AppLogging::LogThreadPlacement(const char* role, const AppliedPlacement& placement) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)role;
+	(void)placement;
+#endif
+	FRAME_LOG("thread_placement role=%s node=%u cores=%u pinned=%d priority_set=%d", role,
+			  placement.node, placement.core_count, placement.pinned, placement.priority_set);
+}
+
+void AppLogging::LogBufferPoolStats(const char* name, const BufferPoolStats& stats) {
+#ifndef ENABLE_FRAME_DEBUG_LOG
+	(void)name;
+	(void)stats;
+#endif
+	FRAME_LOG("buffer_pool name=%s backing=%s slab=%llu acquired=%llu exhausted=%llu "
+			  "max_buffers=%u max_bytes=%llu max_acquire=%llu",
+			  name, PAGE_BACKING_NAMES[(int)stats.backing], stats.slab_size,
+			  stats.acquired_buffers, stats.exhausted_acquires, stats.max_buffers_in_use,
+			  stats.max_bytes_in_use, stats.max_acquire_size);
+}
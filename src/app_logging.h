@@ -1,11 +1,31 @@
 #pragma once
 
-#include <windows.h>
-
 #include <chrono>
 #include <cstdint>
+#include <span>
 
-#include "encoder/frame_encoder.h"
+#include "buffer_pool.h"
+#include "capture_clock.h"
+#include "encoder/encoder_config.h"
+#include "encoder/frame_pacing.h"
+#include "encoder/keyframe_cache.h"
+#include "encoder/keyframe_request.h"
+#include "encoder/rtp_sender.h"
+#include "encoder/shared_frame_ring.h"
+#include "encoder/ts_muxer.h"
+#include "encoder/y4m_file.h"
+#include "event_loop.h"
+#include "graphics/command_recorder.h"
+#include "graphics/cpu_rasterizer.h"
+#include "graphics/pipeline_cache.h"
+#include "graphics/render_graph.h"
+#include "graphics/render_types.h"
+#include "graphics/resource_state_tracker.h"
+#include "graphics/tlsf_allocator.h"
+#include "graphics/upload_ring.h"
+#include "job_system.h"
+#include "startup_graph.h"
+#include "thread_placement.h"
 
 struct AppLogging {
 	struct FrameLogContext {
@@ -16,11 +36,34 @@ struct AppLogging {
 	static FrameLogContext BuildFrameLogContext(
 		uint32_t frames_submitted,
 		std::chrono::time_point<std::chrono::steady_clock>& last_frame_time);
-	static void LogFrameLoopStart(const FrameLogContext& frame_log,
-								  const FrameEncoder::Stats& stats);
+	static void LogFrameLoopStart(const FrameLogContext& frame_log, const EncoderStats& stats);
 	static void LogFenceCompletion(const FrameLogContext& frame_log, uint64_t completed_value);
-	static void LogPresentStatus(const FrameLogContext& frame_log, HRESULT present_result);
+	static void LogPresentStatus(const FrameLogContext& frame_log, PresentResult present_result);
 	static void LogPresentStillDrawing(const FrameLogContext& frame_log);
+	static void LogStartupGraph(std::span<const StartupTaskTiming> timings,
+								const StartupGraphStats& stats);
+	static void LogTimeToFirstFrame(
+		std::chrono::time_point<std::chrono::steady_clock> startup_time);
 	static void LogFrameSubmitResult(const FrameLogContext& frame_log, uint32_t back_buffer_index,
 									 uint32_t signaled_value, uint32_t new_back_buffer_index);
+	static void LogRasterizerStats(const RasterizerStats& stats);
+	static void LogHeapStats(const HeapPoolStats& stats);
+	static void LogUploadRingStats(const UploadRingStats& stats);
+	static void LogResourceStateStats(const ResourceStateTrackerStats& stats);
+	static void LogRenderGraphStats(const RenderGraphStats& stats);
+	static void LogCommandRecorderStats(const CommandRecorderStats& stats);
+	static void LogJobSystemStats(const JobSystemStats& stats);
+	static void LogPipelineCacheStats(const PipelineCacheStats& stats);
+	static void LogCaptureStats(uint64_t dumped_frames, const Y4mReplayStats& replay_stats);
+	static void LogKeyframeStats(const KeyframeCacheStats& stats,
+								 const KeyframeRequestStats& request_stats);
+	static void LogFrameExportStats(const SharedFrameRingStats& stats);
+	static void LogRtpSenderStats(const PacedSenderStats& stats,
+								  const RtpPacketizerStats& packetizer_stats);
+	static void LogTsOutputStats(const TsMuxerStats& stats, const PacedSenderStats& sender_stats);
+	static void LogFramePacingStats(const FramePacingStats& stats);
+	static void LogCaptureClockStats(const CaptureClockStats& stats);
+	static void LogEventLoopStats(const EventLoopStats& stats);
+	static void LogThreadPlacement(const char* role, const AppliedPlacement& placement);
+	static void LogBufferPoolStats(const char* name, const BufferPoolStats& stats);
 };
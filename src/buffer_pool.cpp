@@ -0,0 +1,171 @@
+#include "buffer_pool.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "node_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+constexpr size_t BUFFER_ALIGNMENT = 4096;
+
+static size_t AlignUp(size_t value, size_t alignment) {
+	return (value + alignment - 1) / alignment * alignment;
+}
+
+#ifdef _WIN32
+
+static bool EnableLockMemoryPrivilege() {
+	HANDLE token = nullptr;
+	if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &token))
+		return false;
+
+	TOKEN_PRIVILEGES privileges{.PrivilegeCount = 1,
+								.Privileges		= {{.Attributes = SE_PRIVILEGE_ENABLED}}};
+	auto enabled = LookupPrivilegeValueA(nullptr, "SeLockMemoryPrivilege",
+										 &privileges.Privileges[0].Luid)
+				&& AdjustTokenPrivileges(token, FALSE, &privileges, 0, nullptr, nullptr)
+				&& GetLastError() == ERROR_SUCCESS;
+	CloseHandle(token);
+	return enabled;
+}
+
+static uint8_t* MapSlab(size_t& size, const BufferPoolConfig& config, PageBacking& backing) {
+	auto node			 = config.node == ANY_NUMA_NODE ? NUMA_NO_PREFERRED_NODE : config.node;
+	auto large_page_size = GetLargePageMinimum();
+	if (config.huge_pages && large_page_size && EnableLockMemoryPrivilege()) {
+		auto large_size = AlignUp(size, large_page_size);
+		auto slab		= (uint8_t*)VirtualAllocExNuma(GetCurrentProcess(), nullptr, large_size,
+													   MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES,
+													   PAGE_READWRITE, node);
+		if (slab) {
+			size	= large_size;
+			backing = PageBacking::Huge;
+			return slab;
+		}
+	}
+
+	auto slab = (uint8_t*)VirtualAllocExNuma(GetCurrentProcess(), nullptr, size,
+											 MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+	if (!slab)
+		throw;
+	return slab;
+}
+
+static void UnmapSlab(uint8_t* slab, size_t) {
+	VirtualFree(slab, 0, MEM_RELEASE);
+}
+
+#else
+
+static uint8_t* MapAnonymous(size_t size, int flags) {
+	auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | flags,
+						-1, 0);
+	return mapping == MAP_FAILED ? nullptr : (uint8_t*)mapping;
+}
+
+static uint8_t* MapHugeAligned(size_t size) {
+	auto mapping = MapAnonymous(size + HUGE_PAGE_SIZE, 0);
+	if (!mapping)
+		throw;
+
+	auto slab = (uint8_t*)AlignUp((size_t)mapping, HUGE_PAGE_SIZE);
+	if (slab != mapping)
+		munmap(mapping, slab - mapping);
+	munmap(slab + size, mapping + HUGE_PAGE_SIZE - slab);
+	return slab;
+}
+
+static uint8_t* MapSlab(size_t& size, const BufferPoolConfig& config, PageBacking& backing) {
+	uint8_t* slab = nullptr;
+	if (config.huge_pages) {
+		size = AlignUp(size, HUGE_PAGE_SIZE);
+		slab = MapAnonymous(size, MAP_HUGETLB);
+		if (slab)
+			backing = PageBacking::Huge;
+		else {
+			slab = MapHugeAligned(size);
+			if (madvise(slab, size, MADV_HUGEPAGE) == 0)
+				backing = PageBacking::Transparent;
+		}
+	}
+	else {
+		slab = MapAnonymous(size, 0);
+		if (!slab)
+			throw;
+		madvise(slab, size, MADV_NOHUGEPAGE);
+	}
+
+	if (config.node != ANY_NUMA_NODE)
+		BindNumaNode(slab, size, config.node);
+	return slab;
+}
+
+static void UnmapSlab(uint8_t* slab, size_t size) {
+	munmap(slab, size);
+}
+
+#endif
+
+BufferPool::BufferPool(const BufferPoolConfig& config)
+	: capacity(AlignUp(config.buffer_capacity, BUFFER_ALIGNMENT))
+	, buffer_sizes(config.buffer_count) {
+	if (!capacity || !config.buffer_count)
+		throw;
+
+	slab_size = capacity * config.buffer_count;
+	slab	  = MapSlab(slab_size, config, stats.backing);
+	memset(slab, 0, slab_size);
+	stats.slab_size = slab_size;
+
+	free_buffers.reserve(config.buffer_count);
+	for (auto index = config.buffer_count; index > 0; --index)
+		free_buffers.push_back(index - 1);
+}
+
+BufferPool::~BufferPool() {
+	UnmapSlab(slab, slab_size);
+}
+
+uint8_t* BufferPool::Acquire(size_t size) {
+	if (size > capacity)
+		throw;
+	if (free_buffers.empty()) {
+		++stats.exhausted_acquires;
+		return nullptr;
+	}
+
+	auto index = free_buffers.back();
+	free_buffers.pop_back();
+	++stats.buffers_in_use;
+	stats.bytes_in_use += size;
+	buffer_sizes[index]		 = size;
+	stats.max_buffers_in_use = std::max(stats.max_buffers_in_use, stats.buffers_in_use);
+	stats.max_bytes_in_use	 = std::max(stats.max_bytes_in_use, stats.bytes_in_use);
+	stats.max_acquire_size	 = std::max(stats.max_acquire_size, (uint64_t)size);
+	++stats.acquired_buffers;
+	return slab + index * capacity;
+}
+
+void BufferPool::Release(uint8_t* buffer) {
+	if (!buffer)
+		return;
+
+	auto index = (uint32_t)((size_t)(buffer - slab) / capacity);
+	free_buffers.push_back(index);
+	stats.bytes_in_use -= buffer_sizes[index];
+	--stats.buffers_in_use;
+	++stats.released_buffers;
+}
+
+size_t BufferPool::GetCapacity() const {
+	return capacity;
+}
+
+BufferPoolStats BufferPool::GetStats() const {
+	return stats;
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "thread_placement.h"
+
+constexpr size_t HUGE_PAGE_SIZE = 2 * 1024 * 1024;
+
+enum class PageBacking { Small, Transparent, Huge };
+
+struct BufferPoolConfig {
+	size_t buffer_capacity = HUGE_PAGE_SIZE;
+	uint32_t buffer_count  = 8;
+	bool huge_pages		   = true;
+	uint32_t node		   = ANY_NUMA_NODE;
+};
+
+struct BufferPoolStats {
+	uint64_t acquired_buffers;
+	uint64_t released_buffers;
+	uint64_t exhausted_acquires;
+	uint32_t buffers_in_use;
+	uint32_t max_buffers_in_use;
+	uint64_t bytes_in_use;
+	uint64_t max_bytes_in_use;
+	uint64_t max_acquire_size;
+	uint64_t slab_size;
+	PageBacking backing;
+};
+
+class BufferPool {
+  public:
+	explicit BufferPool(const BufferPoolConfig& config);
+	~BufferPool();
+
+	BufferPool(const BufferPool&)			 = delete;
+	BufferPool& operator=(const BufferPool&) = delete;
+
+	uint8_t* Acquire(size_t size);
+	void Release(uint8_t* buffer);
+	size_t GetCapacity() const;
+	BufferPoolStats GetStats() const;
+
+  private:
+	size_t capacity;
+	uint8_t* slab	 = nullptr;
+	size_t slab_size = 0;
+	std::vector<uint32_t> free_buffers;
+	std::vector<size_t> buffer_sizes;
+	BufferPoolStats stats{};
+};
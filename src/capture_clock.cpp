@@ -0,0 +1,126 @@
+#include "capture_clock.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/timerfd.h>
+#include <unistd.h>
+#endif
+
+constexpr uint64_t NANOSECONDS_PER_SECOND = 1'000'000'000;
+
+#ifdef _WIN32
+
+using TimerDuration = std::chrono::duration<int64_t, std::ratio<1, 10'000'000>>;
+
+CaptureClock::CaptureClock(uint32_t frame_rate_num, uint32_t frame_rate_den)
+	: frame_rate_num(frame_rate_num), frame_rate_den(frame_rate_den) {
+	if (!frame_rate_num || !frame_rate_den)
+		throw;
+
+	timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION,
+								   TIMER_ALL_ACCESS);
+	if (!timer)
+		throw;
+	Arm();
+}
+
+CaptureClock::~CaptureClock() {
+	CancelWaitableTimer(timer);
+	CloseHandle(timer);
+}
+
+void CaptureClock::Arm() {
+	auto delay = std::chrono::duration_cast<TimerDuration>(GetTickTime(stats.ticks)
+														   - std::chrono::steady_clock::now());
+	LARGE_INTEGER due_time{.QuadPart = -std::max<int64_t>(delay.count(), 1)};
+	if (!SetWaitableTimer(timer, &due_time, 0, nullptr, nullptr, FALSE))
+		throw;
+}
+
+#else
+
+CaptureClock::CaptureClock(uint32_t frame_rate_num, uint32_t frame_rate_den)
+	: frame_rate_num(frame_rate_num), frame_rate_den(frame_rate_den) {
+	if (!frame_rate_num || !frame_rate_den)
+		throw;
+
+	timer = timerfd_create(CLOCK_MONOTONIC, TFD_CLOEXEC | TFD_NONBLOCK);
+	if (timer < 0)
+		throw;
+	Arm();
+}
+
+CaptureClock::~CaptureClock() {
+	close(timer);
+}
+
+void CaptureClock::Arm() {
+	auto deadline = std::chrono::duration_cast<std::chrono::nanoseconds>(
+						GetTickTime(stats.ticks).time_since_epoch())
+						.count();
+	itimerspec spec{.it_value = {.tv_sec  = (time_t)(deadline / NANOSECONDS_PER_SECOND),
+								 .tv_nsec = (long)(deadline % NANOSECONDS_PER_SECOND)}};
+	if (timerfd_settime(timer, TFD_TIMER_ABSTIME, &spec, nullptr) != 0)
+		throw;
+}
+
+#endif
+
+std::chrono::steady_clock::time_point CaptureClock::GetTickTime(uint64_t tick) const {
+	auto scaled	 = tick * frame_rate_den;
+	auto seconds = scaled / frame_rate_num;
+	auto nanoseconds
+		= seconds * NANOSECONDS_PER_SECOND
+		+ scaled % frame_rate_num * NANOSECONDS_PER_SECOND / frame_rate_num;
+	return start
+		 + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+			   std::chrono::nanoseconds(nanoseconds));
+}
+
+void CaptureClock::OnFramePresented() {
+	if (has_new_frame)
+		++stats.skipped_frames;
+	has_new_frame = true;
+	++presented_frames;
+}
+
+CaptureAction CaptureClock::OnTick(uint64_t& timestamp) {
+#ifndef _WIN32
+	uint64_t expirations = 0;
+	if (read(timer, &expirations, sizeof(expirations)) != sizeof(expirations))
+		expirations = 0;
+#endif
+	auto now   = std::chrono::steady_clock::now();
+	auto ticks = stats.ticks;
+	while (GetTickTime(ticks) <= now)
+		++ticks;
+	auto elapsed = ticks - stats.ticks;
+	stats.ticks	 = ticks;
+	Arm();
+	if (!elapsed)
+		return CaptureAction::None;
+
+	stats.missed_ticks += elapsed - 1;
+	timestamp = ticks - 1;
+	if (!presented_frames)
+		return CaptureAction::None;
+
+	if (!has_new_frame) {
+		++stats.duplicated_frames;
+		return CaptureAction::Duplicate;
+	}
+	has_new_frame = false;
+	++stats.captured_frames;
+	return CaptureAction::Capture;
+}
+
+EventHandle CaptureClock::GetEvent() const {
+	return timer;
+}
+
+CaptureClockStats CaptureClock::GetStats() const {
+	return stats;
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#include "platform_event.h"
+
+enum class CaptureAction { None, Capture, Duplicate };
+
+struct CaptureClockStats {
+	uint64_t ticks;
+	uint64_t missed_ticks;
+	uint64_t captured_frames;
+	uint64_t duplicated_frames;
+	uint64_t skipped_frames;
+};
+
+class CaptureClock {
+  public:
+	CaptureClock(uint32_t frame_rate_num, uint32_t frame_rate_den);
+	~CaptureClock();
+
+	CaptureClock(const CaptureClock&)			 = delete;
+	CaptureClock& operator=(const CaptureClock&) = delete;
+
+	void OnFramePresented();
+	CaptureAction OnTick(uint64_t& timestamp);
+	std::chrono::steady_clock::time_point GetTickTime(uint64_t tick) const;
+	EventHandle GetEvent() const;
+	CaptureClockStats GetStats() const;
+
+  private:
+	void Arm();
+
+	uint32_t frame_rate_num;
+	uint32_t frame_rate_den;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	EventHandle timer;
+	uint64_t presented_frames = 0;
+	bool has_new_frame		  = false;
+	CaptureClockStats stats{};
+};
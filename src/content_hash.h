@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string_view>
+
+constexpr uint64_t CONTENT_HASH_SEED  = 0xcbf29ce484222325ull;
+constexpr uint64_t CONTENT_HASH_PRIME = 0x100000001b3ull;
+
+constexpr uint64_t HashBytes(uint64_t hash, std::span<const uint8_t> bytes) {
+	for (auto byte : bytes)
+		hash = (hash ^ byte) * CONTENT_HASH_PRIME;
+	return hash;
+}
+
+constexpr uint64_t HashString(uint64_t hash, std::string_view text) {
+	for (auto character : text)
+		hash = (hash ^ (uint8_t)character) * CONTENT_HASH_PRIME;
+	return (hash ^ 0xff) * CONTENT_HASH_PRIME;
+}
+
+constexpr uint64_t HashValue(uint64_t hash, uint64_t value) {
+	for (auto i = 0; i < 8; ++i)
+		hash = (hash ^ ((value >> (i * 8)) & 0xff)) * CONTENT_HASH_PRIME;
+	return hash;
+}
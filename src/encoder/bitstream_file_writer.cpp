@@ -1,10 +1,22 @@
 #include "bitstream_file_writer.h"
 
+#include <algorithm>
+#include <cstring>
 #include <stdexcept>
 
-BitstreamFileWriter::BitstreamFileWriter(const char* path)
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+BitstreamFileWriter::BitstreamFileWriter(const char* path, size_t buffer_capacity, uint32_t node)
 	: file_handle(CreateFileA(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
-							  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr)) {
+							  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr))
+	, pool(BufferPoolConfig{.buffer_capacity = buffer_capacity,
+							.buffer_count	 = WRITE_SLOT_COUNT,
+							.node			 = node}) {
 	if (file_handle == INVALID_HANDLE_VALUE)
 		throw;
 
@@ -30,10 +42,6 @@ BitstreamFileWriter::~BitstreamFileWriter() {
 		CloseHandle(file_handle);
 }
 
-HANDLE BitstreamFileWriter::NextWriteEvent() const {
-	return slots[head].event;
-}
-
 void BitstreamFileWriter::DrainCompleted() {
 	while (pending_count > 0) {
 		auto& slot	= slots[head];
@@ -43,30 +51,22 @@ void BitstreamFileWriter::DrainCompleted() {
 				break;
 			throw std::runtime_error("DrainCompleted: GetOverlappedResult failed");
 		}
-		head = (head + 1) % WRITE_SLOT_COUNT;
-		--pending_count;
+		RetireHead();
 	}
 }
 
-bool BitstreamFileWriter::HasPendingWrites() const {
-	return pending_count > 0;
-}
-
-void BitstreamFileWriter::WriteFrame(const void* data, uint32_t size) {
-	if (!data || size == 0 || file_handle == INVALID_HANDLE_VALUE)
-		return;
-
+void BitstreamFileWriter::WriteChunk(const uint8_t* data, uint32_t size) {
 	if (pending_count == WRITE_SLOT_COUNT) {
 		DWORD bytes = 0;
 		GetOverlappedResult(file_handle, &slots[head].overlapped, &bytes, TRUE);
-		head = (head + 1) % WRITE_SLOT_COUNT;
-		--pending_count;
+		RetireHead();
 	}
 
 	uint32_t slot_index = (head + pending_count) % WRITE_SLOT_COUNT;
 	auto& slot			= slots[slot_index];
 
-	slot.buffer.assign((const uint8_t*)data, (const uint8_t*)data + size);
+	slot.buffer = pool.Acquire(size);
+	memcpy(slot.buffer, data, size);
 	ResetEvent(slot.event);
 	slot.overlapped			   = {};
 	slot.overlapped.Offset	   = (DWORD)(file_offset & 0xFFFFFFFF);
@@ -74,9 +74,128 @@ void BitstreamFileWriter::WriteFrame(const void* data, uint32_t size) {
 	slot.overlapped.hEvent	   = slot.event;
 	file_offset += size;
 
-	if (!WriteFile(file_handle, slot.buffer.data(), (DWORD)size, nullptr, &slot.overlapped)
+	if (!WriteFile(file_handle, slot.buffer, (DWORD)size, nullptr, &slot.overlapped)
 		&& GetLastError() != ERROR_IO_PENDING)
 		throw;
 
 	++pending_count;
 }
+
+#else
+
+BitstreamFileWriter::BitstreamFileWriter(const char* path, size_t buffer_capacity, uint32_t node)
+	: file_descriptor(open(path, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644))
+	, pool(BufferPoolConfig{.buffer_capacity = buffer_capacity,
+							.buffer_count	 = WRITE_SLOT_COUNT,
+							.node			 = node}) {
+	if (file_descriptor < 0)
+		throw;
+
+	for (auto& slot : slots)
+		slot.event = CreateAutoResetEvent(true);
+	writer = std::thread{&BitstreamFileWriter::RunWriter, this};
+}
+
+BitstreamFileWriter::~BitstreamFileWriter() {
+	{
+		std::lock_guard lock(mutex);
+		stopping = true;
+	}
+	submitted.notify_one();
+	writer.join();
+
+	for (auto& slot : slots)
+		CloseEventHandle(slot.event);
+	close(file_descriptor);
+}
+
+void BitstreamFileWriter::RunWriter() {
+	for (uint64_t written = 0;; ++written) {
+		{
+			std::unique_lock lock(mutex);
+			submitted.wait(lock, [&] { return stopping || submitted_count > written; });
+			if (submitted_count == written)
+				return;
+		}
+
+		auto& slot	= slots[written % WRITE_SLOT_COUNT];
+		auto result = pwrite(file_descriptor, slot.buffer, slot.size, (off_t)slot.offset);
+		slot.failed = result != (ssize_t)slot.size;
+		slot.completed.store(true, std::memory_order_release);
+		slot.completed.notify_one();
+		SignalAutoResetEvent(slot.event);
+	}
+}
+
+void BitstreamFileWriter::DrainCompleted() {
+	while (pending_count > 0) {
+		auto& slot = slots[head];
+		if (!slot.completed.load(std::memory_order_acquire))
+			break;
+		if (slot.failed)
+			throw std::runtime_error("DrainCompleted: pwrite failed");
+		RetireHead();
+	}
+}
+
+void BitstreamFileWriter::WriteChunk(const uint8_t* data, uint32_t size) {
+	if (pending_count == WRITE_SLOT_COUNT) {
+		slots[head].completed.wait(false, std::memory_order_acquire);
+		RetireHead();
+	}
+
+	uint32_t slot_index = (head + pending_count) % WRITE_SLOT_COUNT;
+	auto& slot			= slots[slot_index];
+
+	slot.buffer = pool.Acquire(size);
+	memcpy(slot.buffer, data, size);
+	slot.offset = file_offset;
+	slot.size	= size;
+	slot.completed.store(false, std::memory_order_relaxed);
+	file_offset += size;
+
+	{
+		std::lock_guard lock(mutex);
+		++submitted_count;
+	}
+	submitted.notify_one();
+
+	++pending_count;
+}
+
+#endif
+
+EventHandle BitstreamFileWriter::NextWriteEvent() const {
+	return slots[head].event;
+}
+
+bool BitstreamFileWriter::HasPendingWrites() const {
+	return pending_count > 0;
+}
+
+uint32_t BitstreamFileWriter::GetPendingCount() const {
+	return pending_count;
+}
+
+BufferPoolStats BitstreamFileWriter::GetPoolStats() const {
+	return pool.GetStats();
+}
+
+void BitstreamFileWriter::RetireHead() {
+	pool.Release(slots[head].buffer);
+	slots[head].buffer = nullptr;
+	head			   = (head + 1) % WRITE_SLOT_COUNT;
+	--pending_count;
+}
+
+void BitstreamFileWriter::WriteFrame(const void* data, uint32_t size) {
+	if (!data || size == 0)
+		return;
+
+	auto bytes = (const uint8_t*)data;
+	for (uint32_t offset = 0; offset < size;) {
+		auto chunk_size = (uint32_t)std::min<size_t>(size - offset, pool.GetCapacity());
+		WriteChunk(bytes + offset, chunk_size);
+		offset += chunk_size;
+	}
+}
@@ -1,32 +1,68 @@
 #pragma once
 
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#endif
 
 #include <cstdint>
-#include <vector>
+
+#include "buffer_pool.h"
+#include "platform_event.h"
 
 class BitstreamFileWriter {
   public:
-	explicit BitstreamFileWriter(const char* path);
+	explicit BitstreamFileWriter(const char* path, size_t buffer_capacity = HUGE_PAGE_SIZE,
+								 uint32_t node = ANY_NUMA_NODE);
 	~BitstreamFileWriter();
 
 	void WriteFrame(const void* data, uint32_t size);
 	void DrainCompleted();
 	bool HasPendingWrites() const;
-	HANDLE NextWriteEvent() const;
+	uint32_t GetPendingCount() const;
+	EventHandle NextWriteEvent() const;
+	BufferPoolStats GetPoolStats() const;
 
   private:
 	static constexpr uint32_t WRITE_SLOT_COUNT = 4;
 
 	struct WriteSlot {
-		HANDLE event;
+		EventHandle event;
+#ifdef _WIN32
 		OVERLAPPED overlapped;
-		std::vector<uint8_t> buffer;
+#else
+		uint64_t offset;
+		uint32_t size;
+		bool failed;
+		std::atomic<bool> completed = true;
+#endif
+		uint8_t* buffer = nullptr;
 	};
 
-	HANDLE file_handle	 = INVALID_HANDLE_VALUE;
+	void WriteChunk(const uint8_t* data, uint32_t size);
+	void RetireHead();
+
+#ifdef _WIN32
+	HANDLE file_handle = INVALID_HANDLE_VALUE;
+#else
+	void RunWriter();
+
+	int file_descriptor = -1;
+#endif
 	uint64_t file_offset = 0;
+	BufferPool pool;
 	WriteSlot slots[WRITE_SLOT_COUNT];
 	uint32_t head		   = 0;
 	uint32_t pending_count = 0;
+#ifndef _WIN32
+	std::mutex mutex;
+	std::condition_variable submitted;
+	uint64_t submitted_count = 0;
+	bool stopping			 = false;
+	std::thread writer;
+#endif
 };
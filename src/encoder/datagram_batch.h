@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct Datagram {
+	uint32_t offset;
+	uint32_t size;
+};
+
+struct DatagramBatch {
+	std::vector<uint8_t> data;
+	std::vector<Datagram> datagrams;
+
+	void Clear() {
+		data.clear();
+		datagrams.clear();
+	}
+
+	uint8_t* Append(uint32_t size) {
+		auto offset = (uint32_t)data.size();
+		data.resize(offset + size);
+		datagrams.push_back(Datagram{.offset = offset, .size = size});
+		return data.data() + offset;
+	}
+
+	std::span<const uint8_t> Get(uint32_t index) const {
+		return std::span{data}.subspan(datagrams[index].offset, datagrams[index].size);
+	}
+};
@@ -0,0 +1,17 @@
+#include "encoder/encoder_config.h"
+
+NV_ENC_BUFFER_FORMAT TextureFormatToNvencFormat(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::B8G8R8A8Unorm:
+			return NV_ENC_BUFFER_FORMAT_ARGB;
+		case TextureFormat::R8G8B8A8Unorm:
+			return NV_ENC_BUFFER_FORMAT_ABGR;
+		case TextureFormat::R10G10B10A2Unorm:
+			return NV_ENC_BUFFER_FORMAT_ABGR10;
+		case TextureFormat::NV12:
+			return NV_ENC_BUFFER_FORMAT_NV12;
+		case TextureFormat::P010:
+			return NV_ENC_BUFFER_FORMAT_YUV420_10BIT;
+	}
+	return NV_ENC_BUFFER_FORMAT_ARGB;
+}
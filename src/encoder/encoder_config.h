@@ -0,0 +1,59 @@
+#pragma once
+
+#include <nvenc/nvEncodeAPI.h>
+
+#include <cstdint>
+
+#include "graphics/render_types.h"
+
+enum class EncoderCodec { H264, HEVC, AV1 };
+
+enum class EncoderPreset { Fastest, Fast, Medium, Slow, Slowest };
+
+enum class RateControlMode { ConstantQP, VariableBitrate, ConstantBitrate };
+
+struct EncoderConfig {
+	EncoderCodec codec			 = EncoderCodec::H264;
+	EncoderPreset preset		 = EncoderPreset::Medium;
+	RateControlMode rate_control = RateControlMode::ConstantBitrate;
+
+	uint32_t width;
+	uint32_t height;
+	uint32_t frame_rate_num = 60;
+	uint32_t frame_rate_den = 1;
+
+	uint32_t bitrate		  = 8000000;
+	uint32_t max_bitrate	  = 12000000;
+	uint32_t gop_length		  = 120;
+	uint32_t min_idr_interval = 30;
+	uint32_t b_frames		  = 0;
+
+	uint32_t qp = 23;
+
+	bool low_latency = true;
+};
+
+struct EncoderStats {
+	uint64_t submitted_frames;
+	uint64_t completed_frames;
+	uint64_t pending_frames;
+	uint64_t wait_count;
+};
+
+struct EncodedFrame {
+	const uint8_t* data;
+	uint32_t size;
+	uint32_t frame_index;
+	uint64_t timestamp;
+	bool keyframe;
+};
+
+using EncodedFrameSink	 = void (*)(void* context, const EncodedFrame& frame);
+using EncodedFrameFilter = bool (*)(void* context, const EncodedFrame& frame);
+
+struct EncodedFrameOutput {
+	EncodedFrameSink sink;
+	void* context;
+};
+
+NV_ENC_BUFFER_FORMAT TextureFormatToNvencFormat(TextureFormat format);
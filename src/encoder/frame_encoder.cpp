@@ -2,51 +2,37 @@
 
 #include "try.h"
 
-FrameEncoder::FrameEncoder(NvencSession& sess, ID3D12Device* device, uint32_t count,
-						   uint32_t output_buffer_size)
-	: session(sess), buffer_count(count) {
+constexpr uint32_t FORCE_IDR_FLAGS = NV_ENC_PIC_FLAG_FORCEIDR | NV_ENC_PIC_FLAG_OUTPUT_SPSPPS;
+
+FrameEncoder::FrameEncoder(NvencSession& sess, D3D12Device& device, uint32_t count,
+						   uint32_t output_buffer_size, uint32_t min_idr_interval)
+	: session(sess), buffer_count(count), keyframe_requests(min_idr_interval) {
 	textures.reserve(count);
 	pending_ring.resize(count);
 
-	output_d3d12_buffers.resize(count);
+	output_buffers.reserve(count);
 	output_registered_ptrs.resize(count);
 	output_fences.resize(count);
 
 	void* encoder = session.encoder;
 
-	D3D12_HEAP_PROPERTIES readback_heap{
-		.Type = D3D12_HEAP_TYPE_READBACK,
-	};
-
-	D3D12_RESOURCE_DESC buffer_desc{
-		.Dimension		  = D3D12_RESOURCE_DIMENSION_BUFFER,
-		.Width			  = output_buffer_size,
-		.Height			  = 1,
-		.DepthOrArraySize = 1,
-		.MipLevels		  = 1,
-		.Format			  = DXGI_FORMAT_UNKNOWN,
-		.SampleDesc		  = {.Count = 1, .Quality = 0},
-		.Layout			  = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
-	};
-
 	for (auto i = 0u; i < count; ++i) {
 		pending_ring[i].event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 		if (!pending_ring[i].event)
 			throw;
 
-		Try | device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&output_fences[i]));
+		Try | device.device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&output_fences[i]));
 
-		Try
-			| device->CreateCommittedResource(&readback_heap, D3D12_HEAP_FLAG_NONE, &buffer_desc,
-											  D3D12_RESOURCE_STATE_COPY_DEST, nullptr,
-											  IID_PPV_ARGS(&output_d3d12_buffers[i]));
+		auto& output_buffer = output_buffers.emplace_back(device.CreateResource(
+			GetBufferDesc(output_buffer_size), D3D12_HEAP_TYPE_READBACK,
+			D3D12_RESOURCE_STATE_COPY_DEST));
 
 		NV_ENC_REGISTER_RESOURCE register_params{
 			.version			= NV_ENC_REGISTER_RESOURCE_VER,
 			.resourceType		= NV_ENC_INPUT_RESOURCE_TYPE_DIRECTX,
 			.width				= output_buffer_size,
 			.height				= 1,
-			.resourceToRegister = output_d3d12_buffers[i],
+			.resourceToRegister = *&output_buffer.resource,
 			.bufferFormat		= NV_ENC_BUFFER_FORMAT_U8,
 			.bufferUsage		= NV_ENC_OUTPUT_BITSTREAM,
 		};
@@ -67,11 +53,6 @@ FrameEncoder::~FrameEncoder() {
 			session.nvEncUnregisterResource(encoder, output_registered_ptrs[i]);
 	}
 
-	for (auto buffer : output_d3d12_buffers) {
-		if (buffer)
-			buffer->Release();
-	}
-
 	for (auto fence : output_fences) {
 		if (fence)
 			fence->Release();
@@ -222,11 +203,15 @@ void FrameEncoder::UnmapInputTexture(uint32_t index) {
 }
 
 void FrameEncoder::EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value,
-							   uint32_t frame_index) {
+							   uint32_t frame_index, uint64_t timestamp) {
 	if (texture_index >= buffer_count || texture_index >= textures.size())
 		return;
 
-	void* encoder = session.encoder;
+	if (pending_count == buffer_count)
+		throw;
+
+	void* encoder	= session.encoder;
+	auto ring_index = (pending_head + pending_count) % buffer_count;
 
 	RegisteredTexture& texture = textures[texture_index];
 	NV_ENC_FENCE_POINT_D3D12 input_fence_point{
@@ -242,21 +227,23 @@ void FrameEncoder::EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value
 	};
 	NV_ENC_FENCE_POINT_D3D12 output_fence_point{
 		.version	 = NV_ENC_FENCE_POINT_D3D12_VER,
-		.pFence		 = output_fences[texture_index],
-		.signalValue = frame_index + 1,
+		.pFence		 = output_fences[ring_index],
+		.signalValue = submitted_frames + 1,
 		.bSignal	 = 1,
 	};
 	NV_ENC_OUTPUT_RESOURCE_D3D12 output_resource{
 		.version		  = NV_ENC_OUTPUT_RESOURCE_D3D12_VER,
-		.pOutputBuffer	  = output_registered_ptrs[texture_index],
+		.pOutputBuffer	  = output_registered_ptrs[ring_index],
 		.outputFencePoint = output_fence_point,
 	};
+	auto forced_keyframe = keyframe_requests.ShouldForce();
 	NV_ENC_PIC_PARAMS pic_params{
 		.version		 = NV_ENC_PIC_PARAMS_VER,
 		.inputWidth		 = texture.width,
 		.inputHeight	 = texture.height,
 		.inputPitch		 = texture.width * 4,
-		.inputTimeStamp	 = frame_index,
+		.encodePicFlags	 = forced_keyframe ? FORCE_IDR_FLAGS : 0u,
+		.inputTimeStamp	 = timestamp,
 		.inputBuffer	 = &input_resource,
 		.outputBitstream = &output_resource,
 		.bufferFmt		 = texture.buffer_format,
@@ -265,11 +252,12 @@ void FrameEncoder::EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value
 
 	Try | session.nvEncEncodePicture(encoder, &pic_params);
 
-	uint32_t ring_index = (pending_head + pending_count) % buffer_count;
-	auto& slot			= pending_ring[ring_index];
-	slot.output_buffer	= output_registered_ptrs[texture_index];
-	slot.output_fence	= output_fences[texture_index];
-	slot.fence_value	= frame_index + 1;
+	auto& slot			 = pending_ring[ring_index];
+	slot.output_buffer	 = output_registered_ptrs[ring_index];
+	slot.output_fence	 = output_fences[ring_index];
+	slot.fence_value	 = submitted_frames + 1;
+	slot.frame_index	 = frame_index;
+	slot.forced_keyframe = forced_keyframe;
 	Try | slot.output_fence->SetEventOnCompletion(slot.fence_value, slot.event);
 	++pending_count;
 	++submitted_frames;
@@ -309,8 +297,21 @@ void FrameEncoder::ProcessCompletedFrames(BitstreamFileWriter& writer, bool wait
 
 		Try | session.nvEncLockBitstream(encoder, &lock_params);
 
-		if (lock_params.bitstreamBufferPtr && lock_params.bitstreamSizeInBytes > 0)
-			writer.WriteFrame(lock_params.bitstreamBufferPtr, lock_params.bitstreamSizeInBytes);
+		if (lock_params.bitstreamBufferPtr && lock_params.bitstreamSizeInBytes > 0) {
+			EncodedFrame frame{
+				.data		 = (const uint8_t*)lock_params.bitstreamBufferPtr,
+				.size		 = lock_params.bitstreamSizeInBytes,
+				.frame_index = slot.frame_index,
+				.timestamp	 = lock_params.outputTimeStamp,
+				.keyframe	 = lock_params.pictureType == NV_ENC_PIC_TYPE_IDR,
+			};
+			if (!write_filter || write_filter(write_filter_context, frame))
+				writer.WriteFrame(lock_params.bitstreamBufferPtr, lock_params.bitstreamSizeInBytes);
+			if (frame.keyframe && !slot.forced_keyframe)
+				keyframe_requests.OnKeyframe();
+			for (auto& output : outputs)
+				output.sink(output.context, frame);
+		}
 
 		Try | session.nvEncUnlockBitstream(encoder, &output_resource);
 		pending_head = (pending_head + 1) % buffer_count;
@@ -319,8 +320,29 @@ void FrameEncoder::ProcessCompletedFrames(BitstreamFileWriter& writer, bool wait
 	}
 }
 
-FrameEncoder::Stats FrameEncoder::GetStats() const {
-	return Stats{
+void FrameEncoder::AddOutput(EncodedFrameSink sink, void* context) {
+	outputs.push_back(EncodedFrameOutput{.sink = sink, .context = context});
+}
+
+void FrameEncoder::SetWriteFilter(EncodedFrameFilter filter, void* context) {
+	write_filter		 = filter;
+	write_filter_context = context;
+}
+
+void FrameEncoder::SetBitrate(uint32_t bitrate, uint32_t max_bitrate) {
+	session.SetBitrate(bitrate, max_bitrate);
+}
+
+void FrameEncoder::RequestKeyframe() {
+	keyframe_requests.Request();
+}
+
+void FrameEncoder::RequestEncoderKeyframe(void* encoder) {
+	((FrameEncoder*)encoder)->RequestKeyframe();
+}
+
+EncoderStats FrameEncoder::GetStats() const {
+	return EncoderStats{
 		.submitted_frames = submitted_frames,
 		.completed_frames = completed_frames,
 		.pending_frames	  = pending_count,
@@ -328,6 +350,10 @@ FrameEncoder::Stats FrameEncoder::GetStats() const {
 	};
 }
 
+KeyframeRequestStats FrameEncoder::GetKeyframeRequestStats() const {
+	return keyframe_requests.GetStats();
+}
+
 bool FrameEncoder::HasPendingOutputs() const {
 	return pending_count > 0;
 }
@@ -335,20 +361,3 @@ bool FrameEncoder::HasPendingOutputs() const {
 HANDLE FrameEncoder::NextOutputEvent() const {
 	return pending_ring[pending_head].event;
 }
-
-NV_ENC_BUFFER_FORMAT DxgiFormatToNvencFormat(DXGI_FORMAT format) {
-	switch (format) {
-		case DXGI_FORMAT_B8G8R8A8_UNORM:
-			return NV_ENC_BUFFER_FORMAT_ARGB;
-		case DXGI_FORMAT_R8G8B8A8_UNORM:
-			return NV_ENC_BUFFER_FORMAT_ABGR;
-		case DXGI_FORMAT_R10G10B10A2_UNORM:
-			return NV_ENC_BUFFER_FORMAT_ABGR10;
-		case DXGI_FORMAT_NV12:
-			return NV_ENC_BUFFER_FORMAT_NV12;
-		case DXGI_FORMAT_P010:
-			return NV_ENC_BUFFER_FORMAT_YUV420_10BIT;
-		default:
-			return NV_ENC_BUFFER_FORMAT_ARGB;
-	}
-}
@@ -8,6 +8,8 @@
 #include <vector>
 
 #include "bitstream_file_writer.h"
+#include "encoder/keyframe_request.h"
+#include "graphics/device.h"
 #include "nvenc_session.h"
 
 struct RegisteredTexture {
@@ -29,15 +31,8 @@ struct BitstreamBuffer {
 
 class FrameEncoder {
   public:
-	struct Stats {
-		uint64_t submitted_frames;
-		uint64_t completed_frames;
-		uint64_t pending_frames;
-		uint64_t wait_count;
-	};
-
-	FrameEncoder(NvencSession& session, ID3D12Device* device, uint32_t buffer_count,
-				 uint32_t output_buffer_size);
+	FrameEncoder(NvencSession& session, D3D12Device& device, uint32_t buffer_count,
+				 uint32_t output_buffer_size, uint32_t min_idr_interval);
 	~FrameEncoder();
 
 	void RegisterTexture(ID3D12Resource* texture, uint32_t width, uint32_t height,
@@ -49,9 +44,17 @@ class FrameEncoder {
 	void UnregisterBitstreamBuffer(uint32_t index);
 	void UnregisterAllBitstreamBuffers();
 
-	void EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value, uint32_t frame_index);
+	void EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value, uint32_t frame_index,
+					 uint64_t timestamp);
 	void ProcessCompletedFrames(BitstreamFileWriter& writer, bool wait_for_all = false);
-	Stats GetStats() const;
+	void AddOutput(EncodedFrameSink sink, void* context);
+	void SetWriteFilter(EncodedFrameFilter filter, void* context);
+	void SetBitrate(uint32_t bitrate, uint32_t max_bitrate);
+	void RequestKeyframe();
+	EncoderStats GetStats() const;
+	KeyframeRequestStats GetKeyframeRequestStats() const;
+
+	static void RequestEncoderKeyframe(void* encoder);
 
 	bool HasPendingOutputs() const;
 	HANDLE NextOutputEvent() const;
@@ -61,7 +64,7 @@ class FrameEncoder {
 
   private:
 	NvencSession& session;
-	std::vector<ID3D12Resource*> output_d3d12_buffers;
+	std::vector<D3D12PlacedResource> output_buffers;
 	std::vector<NV_ENC_REGISTERED_PTR> output_registered_ptrs;
 	std::vector<ID3D12Fence*> output_fences;
 	uint32_t buffer_count;
@@ -69,7 +72,9 @@ class FrameEncoder {
 		NV_ENC_REGISTERED_PTR output_buffer;
 		ID3D12Fence* output_fence;
 		uint64_t fence_value;
+		uint32_t frame_index;
 		HANDLE event;
+		bool forced_keyframe;
 	};
 
 	RegisteredTexture BuildRegisteredTexture(ID3D12Resource* texture, uint32_t width,
@@ -78,11 +83,13 @@ class FrameEncoder {
 	void UnmapInputTexture(uint32_t index);
 
 	std::vector<PendingOutput> pending_ring;
-	uint32_t pending_head	  = 0;
-	uint32_t pending_count	  = 0;
-	uint64_t submitted_frames = 0;
-	uint64_t completed_frames = 0;
-	uint64_t wait_count		  = 0;
+	std::vector<EncodedFrameOutput> outputs;
+	KeyframeRequestLimiter keyframe_requests;
+	EncodedFrameFilter write_filter = nullptr;
+	void* write_filter_context		= nullptr;
+	uint32_t pending_head			= 0;
+	uint32_t pending_count			= 0;
+	uint64_t submitted_frames		= 0;
+	uint64_t completed_frames		= 0;
+	uint64_t wait_count				= 0;
 };
-
-NV_ENC_BUFFER_FORMAT DxgiFormatToNvencFormat(DXGI_FORMAT format);
@@ -0,0 +1,89 @@
+#include "encoder/frame_pacing.h"
+
+#include <algorithm>
+
+#include "encoder/nal_parser.h"
+
+constexpr uint32_t FULL_BITRATE_PERCENT = 100;
+
+FramePacer::FramePacer(const FramePacingConfig& config, EncoderCodec codec)
+	: config(config), codec(codec), frames_since_bitrate_change(config.bitrate_hold_frames) {
+	stats.bitrate_percent = FULL_BITRATE_PERCENT;
+}
+
+FrameAction FramePacer::BeforeEncode(uint32_t encoder_depth, uint32_t writer_depth) {
+	++stats.frames;
+	stats.max_encoder_depth = std::max(stats.max_encoder_depth, encoder_depth);
+	stats.max_writer_depth	= std::max(stats.max_writer_depth, writer_depth);
+
+	auto encoder_behind = encoder_depth >= config.encoder_high_watermark;
+	writer_behind		= writer_depth >= config.writer_high_watermark;
+	if (config.policy == BackpressurePolicy::LowerBitrate)
+		UpdateBitrate(encoder_behind || writer_behind);
+
+	if (config.policy == BackpressurePolicy::DropNewest && (encoder_behind || writer_behind)) {
+		if (encoder_behind)
+			++stats.encoder_queue_drops;
+		else
+			++stats.writer_queue_drops;
+		return FrameAction::Drop;
+	}
+
+	if (!encoder_behind && !(writer_behind && config.policy == BackpressurePolicy::Block)) {
+		++stats.encoded_frames;
+		return FrameAction::Encode;
+	}
+	++stats.blocked_frames;
+	return FrameAction::Wait;
+}
+
+void FramePacer::UpdateBitrate(bool behind) {
+	clean_frames = behind ? 0 : std::min(clean_frames + 1, config.bitrate_hold_frames);
+	frames_since_bitrate_change =
+		std::min(frames_since_bitrate_change + 1, config.bitrate_hold_frames);
+	if (frames_since_bitrate_change < config.bitrate_hold_frames)
+		return;
+
+	auto& percent = stats.bitrate_percent;
+	if (behind && percent > config.min_bitrate_percent) {
+		percent = percent > config.min_bitrate_percent + config.bitrate_step_percent
+					? percent - config.bitrate_step_percent
+					: config.min_bitrate_percent;
+		++stats.bitrate_reductions;
+	}
+	else if (clean_frames >= config.bitrate_hold_frames && percent < FULL_BITRATE_PERCENT) {
+		percent = std::min(percent + config.bitrate_step_percent, FULL_BITRATE_PERCENT);
+		++stats.bitrate_restores;
+	}
+	else
+		return;
+
+	frames_since_bitrate_change = 0;
+	bitrate_changed				= true;
+}
+
+bool FramePacer::TakeBitrateChange(uint32_t& bitrate_percent) {
+	if (!bitrate_changed)
+		return false;
+
+	bitrate_changed = false;
+	bitrate_percent = stats.bitrate_percent;
+	return true;
+}
+
+bool FramePacer::ShouldWriteFrame(const EncodedFrame& frame) {
+	if (config.policy != BackpressurePolicy::DropNonReference || !writer_behind || frame.keyframe
+		|| IsReferenceAccessUnit(codec, std::span{frame.data, frame.size}))
+		return true;
+
+	++stats.non_reference_drops;
+	return false;
+}
+
+FramePacingStats FramePacer::GetStats() const {
+	return stats;
+}
+
+bool FramePacer::FilterWrite(void* pacer, const EncodedFrame& frame) {
+	return ((FramePacer*)pacer)->ShouldWriteFrame(frame);
+}
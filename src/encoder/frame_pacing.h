@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+
+#include "encoder/encoder_config.h"
+
+enum class BackpressurePolicy { Block, DropNewest, DropNonReference, LowerBitrate };
+
+enum class FrameAction { Encode, Wait, Drop };
+
+struct FramePacingConfig {
+	BackpressurePolicy policy		= BackpressurePolicy::Block;
+	uint32_t encoder_high_watermark	= 2;
+	uint32_t writer_high_watermark	= 3;
+	uint32_t bitrate_hold_frames	= 30;
+	uint32_t bitrate_step_percent	= 20;
+	uint32_t min_bitrate_percent	= 40;
+};
+
+struct FramePacingStats {
+	uint64_t frames;
+	uint64_t encoded_frames;
+	uint64_t blocked_frames;
+	uint64_t encoder_queue_drops;
+	uint64_t writer_queue_drops;
+	uint64_t non_reference_drops;
+	uint64_t bitrate_reductions;
+	uint64_t bitrate_restores;
+	uint32_t bitrate_percent;
+	uint32_t max_encoder_depth;
+	uint32_t max_writer_depth;
+};
+
+class FramePacer {
+  public:
+	FramePacer(const FramePacingConfig& config, EncoderCodec codec);
+
+	FrameAction BeforeEncode(uint32_t encoder_depth, uint32_t writer_depth);
+	bool TakeBitrateChange(uint32_t& bitrate_percent);
+	bool ShouldWriteFrame(const EncodedFrame& frame);
+	FramePacingStats GetStats() const;
+
+	static bool FilterWrite(void* pacer, const EncodedFrame& frame);
+
+  private:
+	void UpdateBitrate(bool behind);
+
+	FramePacingConfig config;
+	EncoderCodec codec;
+	uint32_t frames_since_bitrate_change;
+	uint32_t clean_frames = 0;
+	bool bitrate_changed  = false;
+	bool writer_behind	  = false;
+	FramePacingStats stats{};
+};
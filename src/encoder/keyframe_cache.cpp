@@ -0,0 +1,89 @@
+#include "encoder/keyframe_cache.h"
+
+#include <algorithm>
+#include <span>
+
+#include "encoder/nal_parser.h"
+
+constexpr uint32_t H264_NAL_SPS = 7;
+constexpr uint32_t H264_NAL_PPS = 8;
+constexpr uint32_t HEVC_NAL_VPS = 32;
+constexpr uint32_t HEVC_NAL_PPS = 34;
+constexpr uint8_t START_CODE[]	= {0, 0, 0, 1};
+
+static int32_t GetParameterSetIndex(EncoderCodec codec, uint32_t type) {
+	if (codec == EncoderCodec::HEVC)
+		return type >= HEVC_NAL_VPS && type <= HEVC_NAL_PPS ? (int32_t)(type - HEVC_NAL_VPS) : -1;
+	return type >= H264_NAL_SPS && type <= H264_NAL_PPS ? (int32_t)(type - H264_NAL_SPS + 1) : -1;
+}
+
+KeyframeCache::KeyframeCache(EncoderCodec codec) : codec(codec) {
+	if (codec == EncoderCodec::AV1)
+		throw;
+}
+
+void KeyframeCache::Update(const EncodedFrame& frame) {
+	if (!frame.keyframe)
+		return;
+
+	std::lock_guard lock{mutex};
+	auto stream				= std::span{frame.data, frame.size};
+	auto has_parameter_sets = false;
+	std::span<const uint8_t> nal_unit;
+	while (NextNalUnit(stream, nal_unit)) {
+		auto type = GetNalUnitType(codec, nal_unit);
+		if (IsVclNalUnit(codec, type))
+			break;
+		auto index = GetParameterSetIndex(codec, type);
+		if (index < 0)
+			continue;
+		has_parameter_sets = true;
+		auto& cached	   = parameter_sets[index];
+		if (cached.size() == sizeof(START_CODE) + nal_unit.size()
+			&& std::equal(nal_unit.begin(), nal_unit.end(), cached.begin() + sizeof(START_CODE)))
+			continue;
+		cached.assign(std::begin(START_CODE), std::end(START_CODE));
+		cached.insert(cached.end(), nal_unit.begin(), nal_unit.end());
+		++stats.parameter_set_updates;
+	}
+
+	keyframe.clear();
+	if (!has_parameter_sets)
+		for (auto& parameter_set : parameter_sets)
+			keyframe.insert(keyframe.end(), parameter_set.begin(), parameter_set.end());
+	keyframe.insert(keyframe.end(), frame.data, frame.data + frame.size);
+	keyframe_info = frame;
+	has_keyframe  = true;
+	++stats.keyframes;
+	stats.keyframe_bytes += keyframe.size();
+}
+
+bool KeyframeCache::CopyKeyframe(std::vector<uint8_t>& access_unit, EncodedFrame& frame) {
+	std::lock_guard lock{mutex};
+	if (!has_keyframe)
+		return false;
+
+	access_unit.assign(keyframe.begin(), keyframe.end());
+	frame	   = keyframe_info;
+	frame.data = access_unit.data();
+	frame.size = (uint32_t)access_unit.size();
+	++stats.copied_keyframes;
+	return true;
+}
+
+bool KeyframeCache::CopyParameterSets(std::vector<uint8_t>& output) const {
+	std::lock_guard lock{mutex};
+	output.clear();
+	for (auto& parameter_set : parameter_sets)
+		output.insert(output.end(), parameter_set.begin(), parameter_set.end());
+	return !output.empty();
+}
+
+KeyframeCacheStats KeyframeCache::GetStats() const {
+	std::lock_guard lock{mutex};
+	return stats;
+}
+
+void KeyframeCache::UpdateFrame(void* cache, const EncodedFrame& frame) {
+	((KeyframeCache*)cache)->Update(frame);
+}
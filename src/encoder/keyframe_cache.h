@@ -0,0 +1,37 @@
+#pragma once
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+
+struct KeyframeCacheStats {
+	uint64_t keyframes;
+	uint64_t keyframe_bytes;
+	uint64_t parameter_set_updates;
+	uint64_t copied_keyframes;
+};
+
+class KeyframeCache {
+  public:
+	explicit KeyframeCache(EncoderCodec codec);
+
+	void Update(const EncodedFrame& frame);
+	bool CopyKeyframe(std::vector<uint8_t>& access_unit, EncodedFrame& frame);
+	bool CopyParameterSets(std::vector<uint8_t>& output) const;
+	KeyframeCacheStats GetStats() const;
+
+	static void UpdateFrame(void* cache, const EncodedFrame& frame);
+
+  private:
+	static constexpr uint32_t PARAMETER_SET_COUNT = 3;
+
+	EncoderCodec codec;
+	mutable std::mutex mutex;
+	std::vector<uint8_t> parameter_sets[PARAMETER_SET_COUNT];
+	std::vector<uint8_t> keyframe;
+	EncodedFrame keyframe_info{};
+	bool has_keyframe = false;
+	KeyframeCacheStats stats{};
+};
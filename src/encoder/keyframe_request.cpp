@@ -0,0 +1,35 @@
+#include "encoder/keyframe_request.h"
+
+KeyframeRequestLimiter::KeyframeRequestLimiter(uint32_t min_interval)
+	: min_interval(min_interval), frames_since_keyframe(min_interval) {}
+
+void KeyframeRequestLimiter::Request() {
+	requests.fetch_add(1, std::memory_order_relaxed);
+	if (pending.exchange(true, std::memory_order_acq_rel))
+		coalesced_requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+bool KeyframeRequestLimiter::ShouldForce() {
+	if (frames_since_keyframe < min_interval)
+		++frames_since_keyframe;
+	if (frames_since_keyframe < min_interval || !pending.exchange(false, std::memory_order_acq_rel))
+		return false;
+
+	frames_since_keyframe = 0;
+	++forced_keyframes;
+	return true;
+}
+
+void KeyframeRequestLimiter::OnKeyframe() {
+	frames_since_keyframe = 0;
+	if (pending.exchange(false, std::memory_order_acq_rel))
+		coalesced_requests.fetch_add(1, std::memory_order_relaxed);
+}
+
+KeyframeRequestStats KeyframeRequestLimiter::GetStats() const {
+	return KeyframeRequestStats{
+		.requests			= requests.load(std::memory_order_relaxed),
+		.forced_keyframes	= forced_keyframes,
+		.coalesced_requests = coalesced_requests.load(std::memory_order_relaxed),
+	};
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct KeyframeRequestStats {
+	uint64_t requests;
+	uint64_t forced_keyframes;
+	uint64_t coalesced_requests;
+};
+
+class KeyframeRequestLimiter {
+  public:
+	explicit KeyframeRequestLimiter(uint32_t min_interval);
+
+	void Request();
+	bool ShouldForce();
+	void OnKeyframe();
+	KeyframeRequestStats GetStats() const;
+
+  private:
+	uint32_t min_interval;
+	uint32_t frames_since_keyframe;
+	uint64_t forced_keyframes				 = 0;
+	std::atomic<bool> pending				 = false;
+	std::atomic<uint64_t> requests			 = 0;
+	std::atomic<uint64_t> coalesced_requests = 0;
+};
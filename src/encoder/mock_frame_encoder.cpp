@@ -0,0 +1,156 @@
+#include "encoder/mock_frame_encoder.h"
+
+constexpr uint32_t H264_NAL_SLICE	= 1;
+constexpr uint32_t H264_NAL_IDR		= 5;
+constexpr uint32_t H264_NAL_SPS		= 7;
+constexpr uint32_t H264_NAL_PPS		= 8;
+constexpr uint32_t HEVC_NAL_TRAIL_N	= 0;
+constexpr uint32_t HEVC_NAL_TRAIL_R	= 1;
+constexpr uint32_t HEVC_NAL_IDR		= 19;
+constexpr uint32_t HEVC_NAL_VPS		= 32;
+constexpr uint32_t HEVC_NAL_SPS		= 33;
+constexpr uint32_t HEVC_NAL_PPS		= 34;
+
+MockFrameEncoder::MockFrameEncoder(const EncoderConfig& config, uint32_t count)
+	: config(config), buffer_count(count), keyframe_requests(config.min_idr_interval) {
+	if (config.codec == EncoderCodec::AV1 || config.gop_length == 0)
+		throw;
+
+	textures.reserve(count);
+	pending_ring.resize(count);
+	for (auto& slot : pending_ring)
+		slot.event = CreateAutoResetEvent(false);
+}
+
+MockFrameEncoder::~MockFrameEncoder() {
+	for (auto& slot : pending_ring)
+		CloseEventHandle(slot.event);
+}
+
+void MockFrameEncoder::RegisterTexture(CpuTexture* texture, uint32_t width, uint32_t height,
+									   NV_ENC_BUFFER_FORMAT format, CpuFence* fence) {
+	if (!texture || !fence || texture->width != width || texture->height != height
+		|| TextureFormatToNvencFormat(texture->format) != format)
+		throw;
+
+	textures.push_back(MockTexture{.texture = texture, .fence = fence});
+}
+
+void MockFrameEncoder::EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value,
+								   uint32_t frame_index, uint64_t timestamp) {
+	if (texture_index >= buffer_count || texture_index >= textures.size())
+		return;
+
+	if (pending_count == buffer_count)
+		throw;
+
+	auto forced	  = keyframe_requests.ShouldForce();
+	auto keyframe = forced || gop_position == 0;
+	if (keyframe && !forced)
+		keyframe_requests.OnKeyframe();
+	auto position = keyframe ? 0 : gop_position;
+	gop_position  = (position + 1) % config.gop_length;
+
+	auto& slot		 = pending_ring[(pending_head + pending_count) % buffer_count];
+	slot.fence		 = textures[texture_index].fence;
+	slot.fence_value = fence_wait_value;
+	slot.frame_index = frame_index;
+	slot.timestamp	 = timestamp;
+	slot.keyframe	 = keyframe;
+	slot.reference	 = position % (config.b_frames + 1) == 0;
+	slot.fence->SetEventOnCompletion(slot.fence_value, slot.event);
+	++pending_count;
+	++submitted_frames;
+}
+
+void MockFrameEncoder::AddOutput(EncodedFrameSink sink, void* context) {
+	outputs.push_back(EncodedFrameOutput{.sink = sink, .context = context});
+}
+
+void MockFrameEncoder::SetWriteFilter(EncodedFrameFilter filter, void* context) {
+	write_filter		 = filter;
+	write_filter_context = context;
+}
+
+void MockFrameEncoder::SetBitrate(uint32_t bitrate, uint32_t max_bitrate) {
+	config.bitrate	   = bitrate;
+	config.max_bitrate = max_bitrate;
+}
+
+void MockFrameEncoder::RequestKeyframe() {
+	keyframe_requests.Request();
+}
+
+void MockFrameEncoder::RequestEncoderKeyframe(void* encoder) {
+	((MockFrameEncoder*)encoder)->RequestKeyframe();
+}
+
+void MockFrameEncoder::AppendNalUnit(uint32_t nal_type, uint32_t frame_index, bool reference) {
+	access_unit.insert(access_unit.end(), {0, 0, 0, 1});
+	if (config.codec == EncoderCodec::HEVC)
+		access_unit.insert(access_unit.end(), {(uint8_t)(nal_type << 1), 1});
+	else
+		access_unit.push_back((uint8_t)((reference ? 0x60 : 0) | nal_type));
+
+	uint8_t payload[]{
+		(uint8_t)(frame_index >> 24),
+		(uint8_t)(frame_index >> 16),
+		(uint8_t)(frame_index >> 8),
+		(uint8_t)frame_index,
+		(uint8_t)(config.width >> 8),
+		(uint8_t)config.width,
+		(uint8_t)(config.height >> 8),
+		(uint8_t)config.height,
+	};
+
+	auto zero_run = 0u;
+	for (auto byte : payload) {
+		if (zero_run >= 2 && byte <= 3) {
+			access_unit.push_back(3);
+			zero_run = 0;
+		}
+		access_unit.push_back(byte);
+		zero_run = byte == 0 ? zero_run + 1 : 0;
+	}
+	access_unit.push_back(0x80);
+}
+
+void MockFrameEncoder::BuildAccessUnit(uint32_t frame_index, bool keyframe, bool reference) {
+	access_unit.clear();
+	auto is_hevc = config.codec == EncoderCodec::HEVC;
+
+	if (keyframe) {
+		if (is_hevc)
+			AppendNalUnit(HEVC_NAL_VPS, frame_index);
+		AppendNalUnit(is_hevc ? HEVC_NAL_SPS : H264_NAL_SPS, frame_index);
+		AppendNalUnit(is_hevc ? HEVC_NAL_PPS : H264_NAL_PPS, frame_index);
+		AppendNalUnit(is_hevc ? HEVC_NAL_IDR : H264_NAL_IDR, frame_index);
+		return;
+	}
+
+	if (is_hevc)
+		AppendNalUnit(reference ? HEVC_NAL_TRAIL_R : HEVC_NAL_TRAIL_N, frame_index);
+	else
+		AppendNalUnit(H264_NAL_SLICE, frame_index, reference);
+}
+
+EncoderStats MockFrameEncoder::GetStats() const {
+	return EncoderStats{
+		.submitted_frames = submitted_frames,
+		.completed_frames = completed_frames,
+		.pending_frames	  = pending_count,
+		.wait_count		  = wait_count,
+	};
+}
+
+KeyframeRequestStats MockFrameEncoder::GetKeyframeRequestStats() const {
+	return keyframe_requests.GetStats();
+}
+
+bool MockFrameEncoder::HasPendingOutputs() const {
+	return pending_count > 0;
+}
+
+EventHandle MockFrameEncoder::NextOutputEvent() const {
+	return pending_ring[pending_head].event;
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <nvenc/nvEncodeAPI.h>
+
+#include <cstdint>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "encoder/keyframe_request.h"
+#include "graphics/cpu_frame_resources.h"
+#include "platform_event.h"
+
+class MockFrameEncoder {
+  public:
+	MockFrameEncoder(const EncoderConfig& config, uint32_t buffer_count);
+	~MockFrameEncoder();
+
+	void RegisterTexture(CpuTexture* texture, uint32_t width, uint32_t height,
+						 NV_ENC_BUFFER_FORMAT format, CpuFence* fence);
+	void EncodeFrame(uint32_t texture_index, uint64_t fence_wait_value, uint32_t frame_index,
+					 uint64_t timestamp);
+	void AddOutput(EncodedFrameSink sink, void* context);
+	void SetWriteFilter(EncodedFrameFilter filter, void* context);
+	void SetBitrate(uint32_t bitrate, uint32_t max_bitrate);
+	void RequestKeyframe();
+	EncoderStats GetStats() const;
+	KeyframeRequestStats GetKeyframeRequestStats() const;
+
+	static void RequestEncoderKeyframe(void* encoder);
+
+	template <typename Writer>
+	void ProcessCompletedFrames(Writer& writer, bool wait_for_all = false) {
+		while (pending_count > 0) {
+			auto& slot = pending_ring[pending_head];
+			if (slot.fence->GetCompletedValue() < slot.fence_value) {
+				if (!wait_for_all)
+					break;
+				slot.fence->Wait(slot.fence_value);
+				++wait_count;
+			}
+
+			BuildAccessUnit(slot.frame_index, slot.keyframe, slot.reference);
+			EncodedFrame frame{
+				.data		 = access_unit.data(),
+				.size		 = (uint32_t)access_unit.size(),
+				.frame_index = slot.frame_index,
+				.timestamp	 = slot.timestamp,
+				.keyframe	 = slot.keyframe,
+			};
+			if (!write_filter || write_filter(write_filter_context, frame))
+				writer.WriteFrame(access_unit.data(), (uint32_t)access_unit.size());
+			for (auto& output : outputs)
+				output.sink(output.context, frame);
+
+			pending_head = (pending_head + 1) % buffer_count;
+			--pending_count;
+			++completed_frames;
+		}
+	}
+
+	bool HasPendingOutputs() const;
+	EventHandle NextOutputEvent() const;
+
+  private:
+	struct MockTexture {
+		CpuTexture* texture;
+		CpuFence* fence;
+	};
+
+	struct PendingOutput {
+		CpuFence* fence;
+		uint64_t fence_value;
+		uint32_t frame_index;
+		uint64_t timestamp;
+		bool keyframe;
+		bool reference;
+		EventHandle event;
+	};
+
+	void AppendNalUnit(uint32_t nal_type, uint32_t frame_index, bool reference = true);
+	void BuildAccessUnit(uint32_t frame_index, bool keyframe, bool reference);
+
+	EncoderConfig config;
+	uint32_t buffer_count;
+	KeyframeRequestLimiter keyframe_requests;
+	std::vector<MockTexture> textures;
+	std::vector<EncodedFrameOutput> outputs;
+	std::vector<PendingOutput> pending_ring;
+	std::vector<uint8_t> access_unit;
+	EncodedFrameFilter write_filter = nullptr;
+	void* write_filter_context		= nullptr;
+	uint32_t pending_head			= 0;
+	uint32_t pending_count			= 0;
+	uint32_t gop_position			= 0;
+	uint64_t submitted_frames		= 0;
+	uint64_t completed_frames		= 0;
+	uint64_t wait_count				= 0;
+};
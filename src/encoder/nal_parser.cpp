@@ -0,0 +1,113 @@
+#include "encoder/nal_parser.h"
+
+constexpr size_t START_CODE_SIZE = 3;
+
+constexpr uint32_t H264_NAL_SLICE		   = 1;
+constexpr uint32_t H264_NAL_IDR			   = 5;
+constexpr uint32_t H264_NAL_SEI			   = 6;
+constexpr uint32_t H264_NAL_PREFIX		   = 14;
+constexpr uint32_t H264_NAL_RESERVED_END   = 18;
+constexpr uint32_t HEVC_NAL_IRAP_BEGIN	   = 16;
+constexpr uint32_t HEVC_NAL_VCL_END		   = 31;
+constexpr uint32_t HEVC_NAL_VPS			   = 32;
+constexpr uint32_t HEVC_NAL_PREFIX_SEI	   = 39;
+constexpr uint32_t HEVC_NAL_RESERVED_BEGIN = 41;
+constexpr uint32_t HEVC_NAL_RESERVED_END   = 44;
+constexpr uint32_t HEVC_NAL_UNSPEC_BEGIN   = 48;
+constexpr uint32_t HEVC_NAL_UNSPEC_END	   = 55;
+
+static size_t FindStartCode(std::span<const uint8_t> stream, size_t offset) {
+	auto data = stream.data();
+	for (auto i = offset; i + START_CODE_SIZE <= stream.size();) {
+		if (data[i + 2] > 1)
+			i += 3;
+		else if (data[i + 2] == 1 && data[i + 1] == 0 && data[i] == 0)
+			return i;
+		else
+			++i;
+	}
+	return stream.size();
+}
+
+bool NextNalUnit(std::span<const uint8_t>& stream, std::span<const uint8_t>& nal_unit) {
+	while (true) {
+		auto start = FindStartCode(stream, 0);
+		if (start == stream.size()) {
+			stream = {};
+			return false;
+		}
+
+		auto begin = start + START_CODE_SIZE;
+		auto next  = FindStartCode(stream, begin);
+		auto end   = next;
+		while (end > begin && stream[end - 1] == 0)
+			--end;
+		nal_unit = stream.subspan(begin, end - begin);
+		stream	 = stream.subspan(next);
+		if (!nal_unit.empty())
+			return true;
+	}
+}
+
+uint32_t GetNalUnitType(EncoderCodec codec, std::span<const uint8_t> nal_unit) {
+	return codec == EncoderCodec::HEVC ? nal_unit[0] >> 1 & 0x3F : nal_unit[0] & 0x1F;
+}
+
+bool IsVclNalUnit(EncoderCodec codec, uint32_t type) {
+	return codec == EncoderCodec::HEVC ? type <= HEVC_NAL_VCL_END
+									   : type >= H264_NAL_SLICE && type <= H264_NAL_IDR;
+}
+
+static bool StartsAccessUnit(EncoderCodec codec, std::span<const uint8_t> nal_unit) {
+	auto type = GetNalUnitType(codec, nal_unit);
+	if (codec == EncoderCodec::HEVC) {
+		if (type <= HEVC_NAL_VCL_END)
+			return nal_unit.size() > 2 && nal_unit[2] & 0x80;
+		return (type >= HEVC_NAL_VPS && type <= HEVC_NAL_PREFIX_SEI)
+			|| (type >= HEVC_NAL_RESERVED_BEGIN && type <= HEVC_NAL_RESERVED_END)
+			|| (type >= HEVC_NAL_UNSPEC_BEGIN && type <= HEVC_NAL_UNSPEC_END);
+	}
+	if (type == H264_NAL_SLICE || type == H264_NAL_IDR)
+		return nal_unit.size() > 1 && nal_unit[1] & 0x80;
+	return (type >= H264_NAL_SEI && type <= H264_NAL_ACCESS_UNIT_DELIMITER)
+		|| (type >= H264_NAL_PREFIX && type <= H264_NAL_RESERVED_END);
+}
+
+bool NextAccessUnit(EncoderCodec codec, std::span<const uint8_t>& stream,
+					std::span<const uint8_t>& access_unit) {
+	auto begin	   = stream.data();
+	auto end	   = stream.data() + stream.size();
+	auto remaining = stream;
+	auto has_nal   = false;
+	auto has_vcl   = false;
+	std::span<const uint8_t> nal_unit;
+	auto nal_end = begin;
+	while (NextNalUnit(remaining, nal_unit)) {
+		if (has_vcl && StartsAccessUnit(codec, nal_unit)) {
+			end = nal_end;
+			break;
+		}
+		has_nal = true;
+		has_vcl = has_vcl || IsVclNalUnit(codec, GetNalUnitType(codec, nal_unit));
+		nal_end = nal_unit.data() + nal_unit.size();
+	}
+
+	stream = std::span{end, (size_t)(stream.data() + stream.size() - end)};
+	if (!has_nal)
+		return false;
+	access_unit = std::span{begin, (size_t)(end - begin)};
+	return true;
+}
+
+bool IsReferenceAccessUnit(EncoderCodec codec, std::span<const uint8_t> access_unit) {
+	std::span<const uint8_t> nal_unit;
+	while (NextNalUnit(access_unit, nal_unit)) {
+		auto type = GetNalUnitType(codec, nal_unit);
+		if (!IsVclNalUnit(codec, type))
+			continue;
+		if (codec == EncoderCodec::HEVC)
+			return type >= HEVC_NAL_IRAP_BEGIN || type & 1;
+		return nal_unit[0] & 0x60;
+	}
+	return true;
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "encoder/encoder_config.h"
+
+constexpr uint32_t H264_NAL_ACCESS_UNIT_DELIMITER = 9;
+constexpr uint32_t HEVC_NAL_ACCESS_UNIT_DELIMITER = 35;
+
+bool NextNalUnit(std::span<const uint8_t>& stream, std::span<const uint8_t>& nal_unit);
+bool NextAccessUnit(EncoderCodec codec, std::span<const uint8_t>& stream,
+					std::span<const uint8_t>& access_unit);
+uint32_t GetNalUnitType(EncoderCodec codec, std::span<const uint8_t> nal_unit);
+bool IsVclNalUnit(EncoderCodec codec, uint32_t type);
+bool IsReferenceAccessUnit(EncoderCodec codec, std::span<const uint8_t> access_unit);
@@ -144,8 +144,8 @@ NvencSession::NvencSession(void* d3d12_device, const EncoderConfig& config) {
 
 	Try | nvEncGetEncodePresetConfigEx(encoder, codec_guid, preset_guid, tuning, &preset_cfg);
 
-	auto encode_config = preset_cfg.presetCfg;
-	NV_ENC_INITIALIZE_PARAMS init_params{
+	encode_config = preset_cfg.presetCfg;
+	init_params	  = NV_ENC_INITIALIZE_PARAMS{
 		.version		   = NV_ENC_INITIALIZE_PARAMS_VER,
 		.encodeGUID		   = codec_guid,
 		.presetGUID		   = preset_guid,
@@ -174,6 +174,20 @@ NvencSession::NvencSession(void* d3d12_device, const EncoderConfig& config) {
 	Try | nvEncInitializeEncoder(encoder, &init_params);
 }
 
+void NvencSession::SetBitrate(uint32_t bitrate, uint32_t max_bitrate) {
+	NV_ENC_RC_PARAMS& rc = encode_config.rcParams;
+	if (rc.rateControlMode == NV_ENC_PARAMS_RC_CONSTQP)
+		return;
+
+	rc.averageBitRate = bitrate;
+	rc.maxBitRate	  = rc.rateControlMode == NV_ENC_PARAMS_RC_CBR ? bitrate : max_bitrate;
+	NV_ENC_RECONFIGURE_PARAMS reconfigure_params{
+		.version			= NV_ENC_RECONFIGURE_PARAMS_VER,
+		.reInitEncodeParams = init_params,
+	};
+	Try | nvEncReconfigureEncoder(encoder, &reconfigure_params);
+}
+
 NvencSession::~NvencSession() {
 	if (encoder)
 		nvEncDestroyEncoder(encoder);
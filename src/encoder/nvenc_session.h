@@ -6,39 +6,19 @@
 #include <cstdint>
 #include <vector>
 
-enum class EncoderCodec { H264, HEVC, AV1 };
-
-enum class EncoderPreset { Fastest, Fast, Medium, Slow, Slowest };
-
-enum class RateControlMode { ConstantQP, VariableBitrate, ConstantBitrate };
-
-struct EncoderConfig {
-	EncoderCodec codec			 = EncoderCodec::H264;
-	EncoderPreset preset		 = EncoderPreset::Medium;
-	RateControlMode rate_control = RateControlMode::ConstantBitrate;
-
-	uint32_t width;
-	uint32_t height;
-	uint32_t frame_rate_num = 60;
-	uint32_t frame_rate_den = 1;
-
-	uint32_t bitrate	 = 8000000;
-	uint32_t max_bitrate = 12000000;
-	uint32_t gop_length	 = 120;
-	uint32_t b_frames	 = 0;
-
-	uint32_t qp = 23;
-
-	bool low_latency = true;
-};
+#include "encoder/encoder_config.h"
 
 struct NvencSession : public NV_ENCODE_API_FUNCTION_LIST {
   public:
 	NvencSession(void* d3d12_device, const EncoderConfig& config);
 	~NvencSession();
 
+	void SetBitrate(uint32_t bitrate, uint32_t max_bitrate);
+
 	void* encoder = nullptr;
 
   private:
 	HMODULE nvenc_module = nullptr;
+	NV_ENC_CONFIG encode_config{};
+	NV_ENC_INITIALIZE_PARAMS init_params{};
 };
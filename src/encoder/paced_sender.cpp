@@ -0,0 +1,106 @@
+#include "encoder/paced_sender.h"
+
+#include <algorithm>
+
+constexpr uint32_t PACING_BURST_DATAGRAMS = 16;
+constexpr uint64_t PACING_WINDOW_PERCENT  = 75;
+
+static std::chrono::nanoseconds GetPacingWindow(const EncoderConfig& config) {
+	if (!config.frame_rate_num)
+		throw;
+	auto frame_interval = 1'000'000'000ull * config.frame_rate_den / config.frame_rate_num;
+	return std::chrono::nanoseconds(frame_interval * PACING_WINDOW_PERCENT / 100);
+}
+
+PacedSender::PacedSender(const char* host, uint16_t port, const EncoderConfig& config,
+						 const ThreadPlacement& placement)
+	: socket(host, port), pacing_window(GetPacingWindow(config)), placement(placement) {}
+
+PacedSender::~PacedSender() {
+	{
+		std::lock_guard lock{mutex};
+		stopping = true;
+	}
+	queued.notify_one();
+	worker.join();
+}
+
+DatagramBatch PacedSender::AcquireBatch() {
+	DatagramBatch batch{};
+	{
+		std::lock_guard lock{mutex};
+		if (!free_batches.empty()) {
+			batch = std::move(free_batches.back());
+			free_batches.pop_back();
+		}
+	}
+	batch.Clear();
+	return batch;
+}
+
+void PacedSender::Submit(DatagramBatch batch) {
+	{
+		std::lock_guard lock{mutex};
+		batches.push_back(std::move(batch));
+		stats.max_queued_frames = std::max(stats.max_queued_frames, (uint64_t)batches.size());
+	}
+	queued.notify_one();
+}
+
+void PacedSender::Flush() {
+	std::unique_lock lock{mutex};
+	drained.wait(lock, [&] { return batches.empty() && !sending; });
+}
+
+void PacedSender::SendBatch(const DatagramBatch& batch, bool backlog) {
+	auto start			= std::chrono::steady_clock::now();
+	auto datagram_count = (uint32_t)batch.datagrams.size();
+	auto burst_count	= (datagram_count + PACING_BURST_DATAGRAMS - 1) / PACING_BURST_DATAGRAMS;
+	auto sent			= 0u;
+	for (auto burst = 0u; burst < burst_count; ++burst) {
+		if (burst > 0 && !backlog)
+			std::this_thread::sleep_until(start + pacing_window * burst / burst_count);
+
+		datagrams.clear();
+		auto end = std::min(datagram_count, (burst + 1) * PACING_BURST_DATAGRAMS);
+		for (auto i = burst * PACING_BURST_DATAGRAMS; i < end; ++i)
+			datagrams.push_back(batch.Get(i));
+		sent += socket.Send(datagrams);
+	}
+
+	std::lock_guard lock{mutex};
+	++stats.frames;
+	stats.datagrams += sent;
+	stats.bytes += batch.data.size();
+	stats.send_calls = socket.send_calls;
+	stats.failed_datagrams += datagram_count - sent;
+	if (!backlog && burst_count > 1)
+		stats.paced_bursts += burst_count - 1;
+}
+
+void PacedSender::RunWorker() {
+	ApplyThreadPlacement(placement);
+	std::unique_lock lock{mutex};
+	while (true) {
+		queued.wait(lock, [&] { return stopping || !batches.empty(); });
+		if (batches.empty())
+			return;
+
+		auto batch = std::move(batches.front());
+		batches.pop_front();
+		auto backlog = stopping || !batches.empty();
+		sending		 = true;
+		lock.unlock();
+		SendBatch(batch, backlog);
+		lock.lock();
+		sending = false;
+		free_batches.push_back(std::move(batch));
+		if (batches.empty())
+			drained.notify_all();
+	}
+}
+
+PacedSenderStats PacedSender::GetStats() const {
+	std::lock_guard lock{mutex};
+	return stats;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "encoder/datagram_batch.h"
+#include "encoder/encoder_config.h"
+#include "thread_placement.h"
+#include "udp_socket.h"
+
+struct PacedSenderStats {
+	uint64_t frames;
+	uint64_t datagrams;
+	uint64_t bytes;
+	uint64_t send_calls;
+	uint64_t failed_datagrams;
+	uint64_t paced_bursts;
+	uint64_t max_queued_frames;
+};
+
+class PacedSender {
+  public:
+	PacedSender(const char* host, uint16_t port, const EncoderConfig& config,
+				const ThreadPlacement& placement = {});
+	~PacedSender();
+
+	DatagramBatch AcquireBatch();
+	void Submit(DatagramBatch batch);
+	void Flush();
+	PacedSenderStats GetStats() const;
+
+  private:
+	void RunWorker();
+	void SendBatch(const DatagramBatch& batch, bool backlog);
+
+	UdpSocket socket;
+	std::chrono::nanoseconds pacing_window;
+	std::vector<std::span<const uint8_t>> datagrams;
+	mutable std::mutex mutex;
+	std::condition_variable queued;
+	std::condition_variable drained;
+	std::deque<DatagramBatch> batches;
+	std::vector<DatagramBatch> free_batches;
+	PacedSenderStats stats{};
+	bool sending  = false;
+	bool stopping = false;
+	ThreadPlacement placement;
+	std::thread worker{&PacedSender::RunWorker, this};
+};
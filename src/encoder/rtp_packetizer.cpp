@@ -0,0 +1,235 @@
+#include "encoder/rtp_packetizer.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "encoder/nal_parser.h"
+
+constexpr uint8_t RTP_VERSION			= 2;
+constexpr uint8_t RTP_MARKER			= 0x80;
+constexpr uint8_t FRAGMENT_START		= 0x80;
+constexpr uint8_t FRAGMENT_END			= 0x40;
+constexpr uint8_t H264_STAP_A			= 24;
+constexpr uint8_t H264_FU_A				= 28;
+constexpr uint8_t HEVC_AGGREGATION		= 48;
+constexpr uint8_t HEVC_FRAGMENTATION	= 49;
+constexpr uint8_t START_CODE[]			= {0, 0, 0, 1};
+constexpr uint32_t MIN_FRAGMENT_PAYLOAD	= 16;
+
+static void WriteBigEndian16(uint8_t* data, uint16_t value) {
+	data[0] = (uint8_t)(value >> 8);
+	data[1] = (uint8_t)value;
+}
+
+static void WriteBigEndian32(uint8_t* data, uint32_t value) {
+	data[0] = (uint8_t)(value >> 24);
+	data[1] = (uint8_t)(value >> 16);
+	data[2] = (uint8_t)(value >> 8);
+	data[3] = (uint8_t)value;
+}
+
+static uint16_t ReadBigEndian16(const uint8_t* data) {
+	return (uint16_t)(data[0] << 8 | data[1]);
+}
+
+static uint32_t ReadBigEndian32(const uint8_t* data) {
+	return (uint32_t)data[0] << 24 | (uint32_t)data[1] << 16 | (uint32_t)data[2] << 8 | data[3];
+}
+
+RtpPacketizer::RtpPacketizer(const EncoderConfig& config, const RtpConfig& rtp_config)
+	: codec(config.codec)
+	, rtp_config(rtp_config)
+	, frame_rate_num(config.frame_rate_num)
+	, frame_rate_den(config.frame_rate_den) {
+	if (codec == EncoderCodec::AV1 || !frame_rate_num
+		|| rtp_config.max_packet_size < RTP_HEADER_SIZE + 3 + MIN_FRAGMENT_PAYLOAD)
+		throw;
+}
+
+uint8_t* RtpPacketizer::AppendPacket(DatagramBatch& batch, uint32_t payload_size,
+									 uint32_t timestamp) {
+	auto size	= RTP_HEADER_SIZE + payload_size;
+	auto packet = batch.Append(size);
+	packet[0]	= RTP_VERSION << 6;
+	packet[1]	= rtp_config.payload_type & 0x7F;
+	WriteBigEndian16(packet + 2, sequence++);
+	WriteBigEndian32(packet + 4, timestamp);
+	WriteBigEndian32(packet + 8, rtp_config.ssrc);
+	stats.bytes += size;
+	return packet + RTP_HEADER_SIZE;
+}
+
+void RtpPacketizer::PacketizeNalUnit(DatagramBatch& batch, std::span<const uint8_t> nal_unit,
+									 uint32_t timestamp) {
+	++stats.nal_units;
+	auto max_payload = rtp_config.max_packet_size - RTP_HEADER_SIZE;
+	if (nal_unit.size() <= max_payload) {
+		auto payload = AppendPacket(batch, (uint32_t)nal_unit.size(), timestamp);
+		memcpy(payload, nal_unit.data(), nal_unit.size());
+		++stats.single_packets;
+		return;
+	}
+
+	auto is_hevc			  = codec == EncoderCodec::HEVC;
+	auto nal_header_size	  = is_hevc ? 2u : 1u;
+	auto fragment_header_size = nal_header_size + 1;
+	auto payload			  = nal_unit.subspan(nal_header_size);
+	auto max_fragment		  = max_payload - fragment_header_size;
+	auto fragment_count		  = (payload.size() + max_fragment - 1) / max_fragment;
+	auto fragment_size		  = (payload.size() + fragment_count - 1) / fragment_count;
+	for (size_t offset = 0; offset < payload.size(); offset += fragment_size) {
+		auto size	= (uint32_t)std::min(fragment_size, payload.size() - offset);
+		auto flags	= (uint8_t)((offset == 0 ? FRAGMENT_START : 0)
+								| (offset + size == payload.size() ? FRAGMENT_END : 0));
+		auto packet = AppendPacket(batch, fragment_header_size + size, timestamp);
+		if (is_hevc) {
+			packet[0] = (uint8_t)((nal_unit[0] & 0x81) | HEVC_FRAGMENTATION << 1);
+			packet[1] = nal_unit[1];
+			packet[2] = (uint8_t)(flags | (nal_unit[0] >> 1 & 0x3F));
+		}
+		else {
+			packet[0] = (uint8_t)((nal_unit[0] & 0xE0) | H264_FU_A);
+			packet[1] = (uint8_t)(flags | (nal_unit[0] & 0x1F));
+		}
+		memcpy(packet + fragment_header_size, payload.data() + offset, size);
+		++stats.fragment_packets;
+	}
+}
+
+void RtpPacketizer::Packetize(const EncodedFrame& frame, DatagramBatch& batch) {
+	auto timestamp
+		= (uint32_t)(frame.timestamp * RTP_CLOCK_RATE * frame_rate_den / frame_rate_num);
+	auto first_packet = batch.datagrams.size();
+	std::span<const uint8_t> stream{frame.data, frame.size};
+	std::span<const uint8_t> nal_unit;
+	while (NextNalUnit(stream, nal_unit))
+		PacketizeNalUnit(batch, nal_unit, timestamp);
+	if (batch.datagrams.size() > first_packet)
+		batch.data[batch.datagrams.back().offset + 1] |= RTP_MARKER;
+	++stats.frames;
+}
+
+RtpPacketizerStats RtpPacketizer::GetStats() const {
+	return stats;
+}
+
+RtpDepacketizer::RtpDepacketizer(EncoderCodec codec) : codec(codec) {
+	if (codec == EncoderCodec::AV1)
+		throw;
+}
+
+void RtpDepacketizer::AppendNalUnit(std::span<const uint8_t> nal_unit) {
+	access_unit.insert(access_unit.end(), std::begin(START_CODE), std::end(START_CODE));
+	access_unit.insert(access_unit.end(), nal_unit.begin(), nal_unit.end());
+}
+
+bool RtpDepacketizer::AppendAggregate(std::span<const uint8_t> payload) {
+	while (!payload.empty()) {
+		if (payload.size() < 2)
+			return false;
+		auto size = ReadBigEndian16(payload.data());
+		payload	  = payload.subspan(2);
+		if (!size || size > payload.size())
+			return false;
+		AppendNalUnit(payload.first(size));
+		payload = payload.subspan(size);
+	}
+	return true;
+}
+
+bool RtpDepacketizer::AppendPayload(std::span<const uint8_t> payload) {
+	auto is_hevc		 = codec == EncoderCodec::HEVC;
+	auto nal_header_size = is_hevc ? 2u : 1u;
+	if (payload.size() < nal_header_size)
+		return false;
+
+	auto type = is_hevc ? payload[0] >> 1 & 0x3F : payload[0] & 0x1F;
+	if (type == (is_hevc ? HEVC_AGGREGATION : H264_STAP_A))
+		return !in_fragment && AppendAggregate(payload.subspan(nal_header_size));
+	if (type != (is_hevc ? HEVC_FRAGMENTATION : H264_FU_A)) {
+		if (in_fragment || type > (is_hevc ? HEVC_AGGREGATION : H264_STAP_A))
+			return false;
+		AppendNalUnit(payload);
+		return true;
+	}
+
+	if (payload.size() <= nal_header_size + 1)
+		return false;
+	auto flags = payload[nal_header_size];
+	if (flags & FRAGMENT_START) {
+		if (in_fragment)
+			return false;
+		access_unit.insert(access_unit.end(), std::begin(START_CODE), std::end(START_CODE));
+		if (is_hevc)
+			access_unit.insert(access_unit.end(),
+							   {(uint8_t)((payload[0] & 0x81) | (flags & 0x3F) << 1), payload[1]});
+		else
+			access_unit.push_back((uint8_t)((payload[0] & 0xE0) | (flags & 0x1F)));
+		in_fragment = true;
+	}
+	else if (!in_fragment)
+		return false;
+
+	auto fragment = payload.subspan(nal_header_size + 1);
+	access_unit.insert(access_unit.end(), fragment.begin(), fragment.end());
+	if (flags & FRAGMENT_END)
+		in_fragment = false;
+	return true;
+}
+
+void RtpDepacketizer::Discard() {
+	if (!access_unit.empty() || corrupted)
+		++stats.discarded_frames;
+	access_unit.clear();
+	corrupted	= false;
+	in_fragment = false;
+}
+
+bool RtpDepacketizer::Push(std::span<const uint8_t> packet) {
+	if (completed) {
+		access_unit.clear();
+		completed = false;
+	}
+	if (packet.size() < RTP_HEADER_SIZE || packet[0] >> 6 != RTP_VERSION)
+		return false;
+
+	++stats.packets;
+	stats.bytes += packet.size();
+	auto header_size = RTP_HEADER_SIZE + 4 * (packet[0] & 0x0F);
+	auto payload_end = packet.size();
+	if (packet[0] & 0x20)
+		payload_end -= std::min<size_t>(packet.back(), payload_end);
+	if (packet[0] & 0x10)
+		header_size = header_size + 4 <= payload_end
+						  ? header_size + 4 + 4 * ReadBigEndian16(packet.data() + header_size + 2)
+						  : payload_end;
+
+	auto sequence		  = ReadBigEndian16(packet.data() + 2);
+	auto packet_timestamp = ReadBigEndian32(packet.data() + 4);
+	auto lost			  = has_sequence && sequence != expected_sequence;
+	if (lost)
+		stats.lost_packets += (uint16_t)(sequence - expected_sequence);
+	expected_sequence = (uint16_t)(sequence + 1);
+	has_sequence	  = true;
+
+	if (packet_timestamp != timestamp && (!access_unit.empty() || corrupted))
+		Discard();
+	timestamp = packet_timestamp;
+	corrupted = corrupted || lost || header_size >= payload_end;
+	if (!corrupted)
+		corrupted = !AppendPayload(packet.subspan(header_size, payload_end - header_size));
+	if (!(packet[1] & RTP_MARKER))
+		return false;
+
+	if (corrupted || in_fragment || access_unit.empty()) {
+		Discard();
+		return false;
+	}
+	completed = true;
+	++stats.frames;
+	return true;
+}
+
+RtpDepacketizerStats RtpDepacketizer::GetStats() const {
+	return stats;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "encoder/datagram_batch.h"
+#include "encoder/encoder_config.h"
+
+constexpr uint32_t RTP_HEADER_SIZE = 12;
+constexpr uint32_t RTP_CLOCK_RATE  = 90000;
+
+struct RtpConfig {
+	uint32_t max_packet_size = 1200;
+	uint8_t payload_type	 = 96;
+	uint32_t ssrc			 = 0x474F424C;
+};
+
+struct RtpPacketizerStats {
+	uint64_t frames;
+	uint64_t nal_units;
+	uint64_t single_packets;
+	uint64_t fragment_packets;
+	uint64_t bytes;
+};
+
+class RtpPacketizer {
+  public:
+	RtpPacketizer(const EncoderConfig& config, const RtpConfig& rtp_config);
+
+	void Packetize(const EncodedFrame& frame, DatagramBatch& batch);
+	RtpPacketizerStats GetStats() const;
+
+  private:
+	uint8_t* AppendPacket(DatagramBatch& batch, uint32_t payload_size, uint32_t timestamp);
+	void PacketizeNalUnit(DatagramBatch& batch, std::span<const uint8_t> nal_unit,
+						  uint32_t timestamp);
+
+	EncoderCodec codec;
+	RtpConfig rtp_config;
+	uint32_t frame_rate_num;
+	uint32_t frame_rate_den;
+	uint16_t sequence = 0;
+	RtpPacketizerStats stats{};
+};
+
+struct RtpDepacketizerStats {
+	uint64_t packets;
+	uint64_t frames;
+	uint64_t lost_packets;
+	uint64_t discarded_frames;
+	uint64_t bytes;
+};
+
+class RtpDepacketizer {
+  public:
+	explicit RtpDepacketizer(EncoderCodec codec);
+
+	bool Push(std::span<const uint8_t> packet);
+	RtpDepacketizerStats GetStats() const;
+
+	std::vector<uint8_t> access_unit;
+	uint32_t timestamp = 0;
+
+  private:
+	void AppendNalUnit(std::span<const uint8_t> nal_unit);
+	bool AppendAggregate(std::span<const uint8_t> payload);
+	bool AppendPayload(std::span<const uint8_t> payload);
+	void Discard();
+
+	EncoderCodec codec;
+	uint16_t expected_sequence = 0;
+	bool has_sequence		   = false;
+	bool completed			   = false;
+	bool corrupted			   = false;
+	bool in_fragment		   = false;
+	RtpDepacketizerStats stats{};
+};
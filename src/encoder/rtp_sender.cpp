@@ -0,0 +1,27 @@
+#include "encoder/rtp_sender.h"
+
+RtpSender::RtpSender(const char* host, uint16_t port, const EncoderConfig& config,
+					 const RtpConfig& rtp_config, const ThreadPlacement& placement)
+	: packetizer(config, rtp_config), sender(host, port, config, placement) {}
+
+void RtpSender::Send(const EncodedFrame& frame) {
+	auto batch = sender.AcquireBatch();
+	packetizer.Packetize(frame, batch);
+	sender.Submit(std::move(batch));
+}
+
+void RtpSender::Flush() {
+	sender.Flush();
+}
+
+PacedSenderStats RtpSender::GetStats() const {
+	return sender.GetStats();
+}
+
+RtpPacketizerStats RtpSender::GetPacketizerStats() const {
+	return packetizer.GetStats();
+}
+
+void RtpSender::SendFrame(void* sender, const EncodedFrame& frame) {
+	((RtpSender*)sender)->Send(frame);
+}
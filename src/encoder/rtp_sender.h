@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "encoder/encoder_config.h"
+#include "encoder/paced_sender.h"
+#include "encoder/rtp_packetizer.h"
+
+class RtpSender {
+  public:
+	RtpSender(const char* host, uint16_t port, const EncoderConfig& config,
+			  const RtpConfig& rtp_config = {}, const ThreadPlacement& placement = {});
+
+	void Send(const EncodedFrame& frame);
+	void Flush();
+	PacedSenderStats GetStats() const;
+	RtpPacketizerStats GetPacketizerStats() const;
+
+	static void SendFrame(void* sender, const EncodedFrame& frame);
+
+  private:
+	RtpPacketizer packetizer;
+	PacedSender sender;
+};
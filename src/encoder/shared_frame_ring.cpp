@@ -0,0 +1,202 @@
+#include "encoder/shared_frame_ring.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+constexpr uint64_t SHARED_FRAME_DATA_ALIGNMENT = 4096;
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint64_t GetSlotsOffset() {
+	return AlignUp(sizeof(SharedFrameRingHeader), SHARED_FRAME_ALIGNMENT);
+}
+
+static uint64_t GetDataOffset(uint32_t slot_count) {
+	return AlignUp(GetSlotsOffset() + (uint64_t)slot_count * sizeof(SharedFrameSlot),
+				   SHARED_FRAME_DATA_ALIGNMENT);
+}
+
+SharedFrameRing::SharedFrameRing(const char* name, const EncoderConfig& config,
+								 uint64_t data_capacity, uint32_t slot_count)
+	: memory(name, (size_t)(GetDataOffset(slot_count) + data_capacity)) {
+	if (!slot_count || !data_capacity)
+		throw;
+
+	header = new (memory.data) SharedFrameRingHeader{};
+	slots  = (SharedFrameSlot*)(memory.data + GetSlotsOffset());
+	data   = memory.data + GetDataOffset(slot_count);
+	for (auto i = 0u; i < slot_count; ++i)
+		new (&slots[i]) SharedFrameSlot{};
+
+	header->version		   = SHARED_FRAME_RING_VERSION;
+	header->slot_count	   = slot_count;
+	header->frame_rate_num = config.frame_rate_num;
+	header->frame_rate_den = config.frame_rate_den;
+	header->width		   = config.width;
+	header->height		   = config.height;
+	header->codec		   = (uint32_t)config.codec;
+	header->data_capacity  = data_capacity;
+	header->data_offset	   = GetDataOffset(slot_count);
+	header->magic.store(SHARED_FRAME_RING_MAGIC, std::memory_order_release);
+}
+
+void SharedFrameRing::Publish(const EncodedFrame& frame) {
+	auto requests = header->keyframe_requests.load(std::memory_order_relaxed);
+	if (requests != keyframe_requests) {
+		keyframe_requests = requests;
+		++stats.keyframe_requests;
+		if (keyframe_request_handler)
+			keyframe_request_handler(keyframe_request_context);
+	}
+
+	auto capacity = header->data_capacity;
+	if (frame.size > capacity) {
+		++stats.dropped_frames;
+		return;
+	}
+
+	auto offset = write_position % capacity;
+	if (offset + frame.size > capacity)
+		write_position += capacity - offset;
+	auto end = write_position + frame.size;
+	if (end > capacity)
+		reclaimed_position = std::max(reclaimed_position, end - capacity);
+
+	auto sequence = stats.published_frames;
+	auto& slot	  = slots[sequence % header->slot_count];
+	slot.sequence.store(0, std::memory_order_relaxed);
+	header->reclaimed_position.store(reclaimed_position, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	memcpy(data + write_position % capacity, frame.data, frame.size);
+	slot.position.store(write_position, std::memory_order_relaxed);
+	slot.timestamp.store(frame.timestamp, std::memory_order_relaxed);
+	slot.size.store(frame.size, std::memory_order_relaxed);
+	slot.frame_index.store(frame.frame_index, std::memory_order_relaxed);
+	slot.flags.store(frame.keyframe ? SHARED_FRAME_KEYFRAME : 0, std::memory_order_relaxed);
+	slot.sequence.store(sequence + 1, std::memory_order_release);
+	if (frame.keyframe)
+		header->latest_keyframe.store(sequence + 1, std::memory_order_release);
+	header->published_count.store(sequence + 1, std::memory_order_release);
+
+	write_position = AlignUp(end, SHARED_FRAME_ALIGNMENT);
+	++stats.published_frames;
+	stats.published_bytes += frame.size;
+}
+
+void SharedFrameRing::SetKeyframeRequestHandler(KeyframeRequestHandler handler, void* context) {
+	keyframe_request_handler = handler;
+	keyframe_request_context = context;
+}
+
+SharedFrameRingStats SharedFrameRing::GetStats() const {
+	return stats;
+}
+
+void SharedFrameRing::PublishFrame(void* ring, const EncodedFrame& frame) {
+	((SharedFrameRing*)ring)->Publish(frame);
+}
+
+SharedFrameRingReader::SharedFrameRingReader(const char* name) : memory(name) {
+	if (memory.size < sizeof(SharedFrameRingHeader))
+		throw;
+
+	header = (const SharedFrameRingHeader*)memory.data;
+	if (header->magic.load(std::memory_order_acquire) != SHARED_FRAME_RING_MAGIC
+		|| header->version != SHARED_FRAME_RING_VERSION || !header->slot_count
+		|| header->data_offset != GetDataOffset(header->slot_count)
+		|| header->data_capacity > memory.size - header->data_offset)
+		throw;
+
+	slots			  = (const SharedFrameSlot*)(memory.data + GetSlotsOffset());
+	data			  = memory.data + header->data_offset;
+	keyframe_requests = &((SharedFrameRingHeader*)memory.data)->keyframe_requests;
+	SeekToLatestKeyframe();
+}
+
+void SharedFrameRingReader::SeekToLatestKeyframe() {
+	auto latest	   = header->latest_keyframe.load(std::memory_order_acquire);
+	auto published = header->published_count.load(std::memory_order_acquire);
+	next_sequence  = published;
+	synchronized   = false;
+	if (!latest || published - (latest - 1) > header->slot_count) {
+		RequestKeyframe();
+		return;
+	}
+
+	auto& slot = slots[(latest - 1) % header->slot_count];
+	if (slot.sequence.load(std::memory_order_acquire) == latest
+		&& slot.position.load(std::memory_order_relaxed)
+			   >= header->reclaimed_position.load(std::memory_order_relaxed))
+		next_sequence = latest - 1;
+	else
+		RequestKeyframe();
+}
+
+void SharedFrameRingReader::RequestKeyframe() {
+	keyframe_requests->fetch_add(1, std::memory_order_relaxed);
+	++stats.keyframe_requests;
+}
+
+SharedFrameReadResult SharedFrameRingReader::Read(std::vector<uint8_t>& buffer,
+												  SharedFrameInfo& info) {
+	while (true) {
+		auto published = header->published_count.load(std::memory_order_acquire);
+		if (next_sequence >= published)
+			return SharedFrameReadResult::Empty;
+
+		auto& slot	   = slots[next_sequence % header->slot_count];
+		auto sequence  = slot.sequence.load(std::memory_order_acquire);
+		auto position  = slot.position.load(std::memory_order_relaxed);
+		auto timestamp = slot.timestamp.load(std::memory_order_relaxed);
+		auto size	   = slot.size.load(std::memory_order_relaxed);
+		auto index	   = slot.frame_index.load(std::memory_order_relaxed);
+		auto keyframe  = (slot.flags.load(std::memory_order_relaxed) & SHARED_FRAME_KEYFRAME) != 0;
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (published - next_sequence > header->slot_count || sequence != next_sequence + 1
+			|| slot.sequence.load(std::memory_order_relaxed) != sequence
+			|| position % header->data_capacity + size > header->data_capacity) {
+			++stats.overruns;
+			SeekToLatestKeyframe();
+			return SharedFrameReadResult::Overrun;
+		}
+
+		if (!synchronized && !keyframe) {
+			++next_sequence;
+			++stats.skipped_frames;
+			continue;
+		}
+
+		buffer.resize(size);
+		memcpy(buffer.data(), data + position % header->data_capacity, size);
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.sequence.load(std::memory_order_relaxed) != sequence
+			|| header->reclaimed_position.load(std::memory_order_relaxed) > position) {
+			++stats.overruns;
+			SeekToLatestKeyframe();
+			return SharedFrameReadResult::Overrun;
+		}
+
+		info = SharedFrameInfo{
+			.sequence	 = next_sequence,
+			.timestamp	 = timestamp,
+			.frame_index = index,
+			.size		 = size,
+			.keyframe	 = keyframe,
+		};
+		synchronized = true;
+		++next_sequence;
+		++stats.read_frames;
+		stats.read_bytes += size;
+		return SharedFrameReadResult::Frame;
+	}
+}
+
+SharedFrameReaderStats SharedFrameRingReader::GetStats() const {
+	return stats;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "shared_memory.h"
+
+constexpr uint32_t SHARED_FRAME_RING_MAGIC	 = 0x52464753;
+constexpr uint32_t SHARED_FRAME_RING_VERSION = 2;
+constexpr uint32_t SHARED_FRAME_KEYFRAME	 = 1;
+constexpr uint32_t SHARED_FRAME_ALIGNMENT	 = 64;
+
+using KeyframeRequestHandler = void (*)(void* context);
+
+struct SharedFrameRingHeader {
+	std::atomic<uint32_t> magic;
+	uint32_t version;
+	uint32_t slot_count;
+	uint32_t frame_rate_num;
+	uint32_t frame_rate_den;
+	uint32_t width;
+	uint32_t height;
+	uint32_t codec;
+	uint64_t data_capacity;
+	uint64_t data_offset;
+	alignas(SHARED_FRAME_ALIGNMENT) std::atomic<uint64_t> published_count;
+	std::atomic<uint64_t> reclaimed_position;
+	std::atomic<uint64_t> latest_keyframe;
+	alignas(SHARED_FRAME_ALIGNMENT) std::atomic<uint64_t> keyframe_requests;
+};
+
+struct alignas(SHARED_FRAME_ALIGNMENT) SharedFrameSlot {
+	std::atomic<uint64_t> sequence;
+	std::atomic<uint64_t> position;
+	std::atomic<uint64_t> timestamp;
+	std::atomic<uint32_t> size;
+	std::atomic<uint32_t> frame_index;
+	std::atomic<uint32_t> flags;
+};
+
+struct SharedFrameInfo {
+	uint64_t sequence;
+	uint64_t timestamp;
+	uint32_t frame_index;
+	uint32_t size;
+	bool keyframe;
+};
+
+struct SharedFrameRingStats {
+	uint64_t published_frames;
+	uint64_t published_bytes;
+	uint64_t dropped_frames;
+	uint64_t keyframe_requests;
+};
+
+struct SharedFrameReaderStats {
+	uint64_t read_frames;
+	uint64_t read_bytes;
+	uint64_t overruns;
+	uint64_t skipped_frames;
+	uint64_t keyframe_requests;
+};
+
+enum class SharedFrameReadResult {
+	Frame,
+	Empty,
+	Overrun,
+};
+
+class SharedFrameRing {
+  public:
+	SharedFrameRing(const char* name, const EncoderConfig& config, uint64_t data_capacity,
+					uint32_t slot_count);
+
+	void Publish(const EncodedFrame& frame);
+	void SetKeyframeRequestHandler(KeyframeRequestHandler handler, void* context);
+	SharedFrameRingStats GetStats() const;
+
+	static void PublishFrame(void* ring, const EncodedFrame& frame);
+
+  private:
+	SharedMemory memory;
+	SharedFrameRingHeader* header					= nullptr;
+	SharedFrameSlot* slots							= nullptr;
+	uint8_t* data									= nullptr;
+	uint64_t write_position							= 0;
+	uint64_t reclaimed_position						= 0;
+	uint64_t keyframe_requests						= 0;
+	KeyframeRequestHandler keyframe_request_handler = nullptr;
+	void* keyframe_request_context					= nullptr;
+	SharedFrameRingStats stats{};
+};
+
+class SharedFrameRingReader {
+  public:
+	explicit SharedFrameRingReader(const char* name);
+
+	SharedFrameReadResult Read(std::vector<uint8_t>& buffer, SharedFrameInfo& info);
+	void SeekToLatestKeyframe();
+	SharedFrameReaderStats GetStats() const;
+
+	const SharedFrameRingHeader* header = nullptr;
+
+  private:
+	void RequestKeyframe();
+
+	SharedMemory memory;
+	const SharedFrameSlot* slots			 = nullptr;
+	const uint8_t* data						 = nullptr;
+	uint64_t next_sequence					 = 0;
+	bool synchronized						 = false;
+	std::atomic<uint64_t>* keyframe_requests = nullptr;
+	SharedFrameReaderStats stats{};
+};
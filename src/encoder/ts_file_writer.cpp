@@ -0,0 +1,19 @@
+#include "encoder/ts_file_writer.h"
+
+TsFileWriter::TsFileWriter(const char* path, const EncoderConfig& config,
+						   const TsMuxerConfig& ts_config)
+	: muxer(config, ts_config), writer(path) {}
+
+void TsFileWriter::Write(const EncodedFrame& frame) {
+	buffer.clear();
+	muxer.Mux(frame, buffer);
+	writer.WriteFrame(buffer.data(), (uint32_t)buffer.size());
+}
+
+TsMuxerStats TsFileWriter::GetStats() const {
+	return muxer.GetStats();
+}
+
+void TsFileWriter::WriteFrame(void* writer, const EncodedFrame& frame) {
+	((TsFileWriter*)writer)->Write(frame);
+}
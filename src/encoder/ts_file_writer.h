@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "encoder/bitstream_file_writer.h"
+#include "encoder/encoder_config.h"
+#include "encoder/ts_muxer.h"
+
+class TsFileWriter {
+  public:
+	TsFileWriter(const char* path, const EncoderConfig& config,
+				 const TsMuxerConfig& ts_config = {});
+
+	void Write(const EncodedFrame& frame);
+	TsMuxerStats GetStats() const;
+
+	static void WriteFrame(void* writer, const EncodedFrame& frame);
+
+  private:
+	TsMuxer muxer;
+	BitstreamFileWriter writer;
+	std::vector<uint8_t> buffer;
+};
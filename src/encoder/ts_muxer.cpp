@@ -0,0 +1,212 @@
+#include "encoder/ts_muxer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <initializer_list>
+
+#include "encoder/nal_parser.h"
+
+constexpr uint8_t TS_SYNC_BYTE		   = 0x47;
+constexpr uint32_t TS_HEADER_SIZE	   = 4;
+constexpr uint32_t TS_PAYLOAD_SIZE	   = TS_PACKET_SIZE - TS_HEADER_SIZE;
+constexpr uint32_t PCR_ADAPTATION_SIZE = 8;
+constexpr uint32_t PES_HEADER_SIZE	   = 14;
+constexpr uint32_t SECTION_HEADER_SIZE = 8;
+constexpr uint32_t SECTION_CRC_SIZE	   = 4;
+constexpr uint16_t PAT_PID			   = 0;
+constexpr uint16_t NULL_PID			   = 0x1FFF;
+constexpr uint16_t TRANSPORT_STREAM_ID = 1;
+constexpr uint8_t PAT_TABLE_ID		   = 0x00;
+constexpr uint8_t PMT_TABLE_ID		   = 0x02;
+constexpr uint8_t STREAM_TYPE_H264	   = 0x1B;
+constexpr uint8_t STREAM_TYPE_HEVC	   = 0x24;
+constexpr uint8_t PES_VIDEO_STREAM_ID  = 0xE0;
+constexpr uint8_t RANDOM_ACCESS_FLAG   = 0x40;
+constexpr uint8_t PCR_FLAG			   = 0x10;
+constexpr uint32_t TS_CLOCK_RATE	   = 90000;
+constexpr uint64_t TS_TIMESTAMP_MASK   = (1ull << 33) - 1;
+constexpr uint64_t TABLE_INTERVAL	   = TS_CLOCK_RATE / 10;
+constexpr uint64_t PTS_DELAY_FRAMES	   = 2;
+constexpr uint8_t H264_AUD[]		   = {0, 0, 0, 1, 0x09, 0xF0};
+constexpr uint8_t HEVC_AUD[]		   = {0, 0, 0, 1, 0x46, 0x01, 0x50};
+
+static uint32_t ComputeCrc32(std::span<const uint8_t> data) {
+	auto crc = 0xFFFFFFFFu;
+	for (auto byte : data) {
+		crc ^= (uint32_t)byte << 24;
+		for (auto bit = 0; bit < 8; ++bit)
+			crc = crc & 0x80000000u ? crc << 1 ^ 0x04C11DB7u : crc << 1;
+	}
+	return crc;
+}
+
+static std::vector<uint8_t> BuildSection(uint8_t table_id, uint16_t id,
+										 std::initializer_list<uint8_t> body) {
+	auto length = (uint32_t)(SECTION_HEADER_SIZE + body.size() + SECTION_CRC_SIZE - 3);
+	std::vector<uint8_t> section;
+	section.reserve(SECTION_HEADER_SIZE + body.size() + SECTION_CRC_SIZE);
+	section.push_back(table_id);
+	section.push_back((uint8_t)(0xB0 | length >> 8));
+	section.push_back((uint8_t)length);
+	section.push_back((uint8_t)(id >> 8));
+	section.push_back((uint8_t)id);
+	section.push_back(0xC1);
+	section.push_back(0);
+	section.push_back(0);
+	for (auto byte : body)
+		section.push_back(byte);
+
+	auto crc = ComputeCrc32(section);
+	for (auto shift = 24; shift >= 0; shift -= 8)
+		section.push_back((uint8_t)(crc >> shift));
+	return section;
+}
+
+static void WriteTimestamp(uint8_t* data, uint64_t timestamp) {
+	data[0] = (uint8_t)(0x21 | (timestamp >> 29 & 0x0E));
+	data[1] = (uint8_t)(timestamp >> 22);
+	data[2] = (uint8_t)(timestamp >> 14 | 0x01);
+	data[3] = (uint8_t)(timestamp >> 7);
+	data[4] = (uint8_t)(timestamp << 1 | 0x01);
+}
+
+static void WritePcr(uint8_t* data, uint64_t pcr_base) {
+	data[0] = (uint8_t)(pcr_base >> 25);
+	data[1] = (uint8_t)(pcr_base >> 17);
+	data[2] = (uint8_t)(pcr_base >> 9);
+	data[3] = (uint8_t)(pcr_base >> 1);
+	data[4] = (uint8_t)(pcr_base << 7 | 0x7E);
+	data[5] = 0;
+}
+
+TsMuxer::TsMuxer(const EncoderConfig& config, const TsMuxerConfig& ts_config)
+	: codec(config.codec)
+	, ts_config(ts_config)
+	, frame_rate_num(config.frame_rate_num)
+	, frame_rate_den(config.frame_rate_den) {
+	if (codec == EncoderCodec::AV1 || !frame_rate_num)
+		throw;
+
+	auto program	 = ts_config.program_number;
+	auto pmt_pid	 = ts_config.pmt_pid;
+	auto video_pid	 = ts_config.video_pid;
+	auto stream_type = codec == EncoderCodec::HEVC ? STREAM_TYPE_HEVC : STREAM_TYPE_H264;
+
+	pat = BuildSection(PAT_TABLE_ID, TRANSPORT_STREAM_ID,
+					   {(uint8_t)(program >> 8), (uint8_t)program, (uint8_t)(0xE0 | pmt_pid >> 8),
+						(uint8_t)pmt_pid});
+	pmt = BuildSection(PMT_TABLE_ID, program,
+					   {(uint8_t)(0xE0 | video_pid >> 8), (uint8_t)video_pid, 0xF0, 0, stream_type,
+						(uint8_t)(0xE0 | video_pid >> 8), (uint8_t)video_pid, 0xF0, 0});
+}
+
+uint8_t* TsMuxer::AppendPacket(std::vector<uint8_t>& output, uint16_t pid, bool payload_start,
+							   uint32_t adaptation_size, uint8_t& continuity) {
+	auto offset = output.size();
+	output.resize(offset + TS_PACKET_SIZE);
+	auto packet	= output.data() + offset;
+	packet[0]	= TS_SYNC_BYTE;
+	packet[1]	= (uint8_t)((payload_start ? 0x40 : 0) | (pid >> 8 & 0x1F));
+	packet[2]	= (uint8_t)pid;
+	packet[3]	= (uint8_t)((adaptation_size ? 0x30 : 0x10) | (continuity++ & 0x0F));
+	++stats.packets;
+	return packet;
+}
+
+void TsMuxer::WriteSection(std::vector<uint8_t>& output, uint16_t pid,
+						   std::span<const uint8_t> section, uint8_t& continuity) {
+	auto packet = AppendPacket(output, pid, true, 0, continuity);
+	packet[TS_HEADER_SIZE] = 0;
+	memcpy(packet + TS_HEADER_SIZE + 1, section.data(), section.size());
+	memset(packet + TS_HEADER_SIZE + 1 + section.size(), 0xFF,
+		   TS_PAYLOAD_SIZE - 1 - section.size());
+	++stats.psi_packets;
+}
+
+void TsMuxer::WritePes(std::vector<uint8_t>& output, std::span<const uint8_t> header,
+					   std::span<const uint8_t> data, uint64_t pcr_base, bool keyframe) {
+	auto remaining = header.size() + data.size();
+	auto first	   = true;
+	while (remaining) {
+		auto capacity		 = first ? TS_PAYLOAD_SIZE - PCR_ADAPTATION_SIZE : TS_PAYLOAD_SIZE;
+		auto payload_size	 = std::min<size_t>(remaining, capacity);
+		auto adaptation_size = TS_PAYLOAD_SIZE - (uint32_t)payload_size;
+		auto packet			 = AppendPacket(output, ts_config.video_pid, first, adaptation_size,
+											video_continuity);
+		if (adaptation_size) {
+			packet[TS_HEADER_SIZE] = (uint8_t)(adaptation_size - 1);
+			if (adaptation_size > 1) {
+				auto stuffing_offset	   = TS_HEADER_SIZE + 2;
+				packet[TS_HEADER_SIZE + 1] = 0;
+				if (first) {
+					packet[TS_HEADER_SIZE + 1] = (keyframe ? RANDOM_ACCESS_FLAG : 0) | PCR_FLAG;
+					WritePcr(packet + stuffing_offset, pcr_base);
+					stuffing_offset += 6;
+					++stats.pcr_packets;
+				}
+				memset(packet + stuffing_offset, 0xFF,
+					   TS_HEADER_SIZE + adaptation_size - stuffing_offset);
+			}
+		}
+
+		auto payload = packet + TS_PACKET_SIZE - payload_size;
+		if (!header.empty()) {
+			auto size = std::min(header.size(), payload_size);
+			memcpy(payload, header.data(), size);
+			header = header.subspan(size);
+			payload += size;
+			payload_size -= size;
+			remaining -= size;
+		}
+		memcpy(payload, data.data(), payload_size);
+		data = data.subspan(payload_size);
+		remaining -= payload_size;
+		first = false;
+	}
+}
+
+void TsMuxer::Mux(const EncodedFrame& frame, std::vector<uint8_t>& output) {
+	auto start		 = output.size();
+	auto frame_ticks = (uint64_t)TS_CLOCK_RATE * frame_rate_den / frame_rate_num;
+	auto pcr_base	 = frame.timestamp * TS_CLOCK_RATE * frame_rate_den / frame_rate_num;
+	if (!has_tables || frame.keyframe || pcr_base - table_pcr_base >= TABLE_INTERVAL) {
+		WriteSection(output, PAT_PID, pat, pat_continuity);
+		WriteSection(output, ts_config.pmt_pid, pmt, pmt_continuity);
+		table_pcr_base = pcr_base;
+		has_tables	   = true;
+	}
+
+	auto data = std::span{frame.data, frame.size};
+	auto head = data;
+	std::span<const uint8_t> nal_unit;
+	auto aud_type = codec == EncoderCodec::HEVC ? HEVC_NAL_ACCESS_UNIT_DELIMITER
+												: H264_NAL_ACCESS_UNIT_DELIMITER;
+	auto has_aud  = NextNalUnit(head, nal_unit) && GetNalUnitType(codec, nal_unit) == aud_type;
+
+	uint8_t header[PES_HEADER_SIZE + sizeof(HEVC_AUD)]{0, 0, 1, PES_VIDEO_STREAM_ID, 0, 0,
+													   0x80, 0x80, 5};
+	WriteTimestamp(header + 9, (pcr_base + frame_ticks * PTS_DELAY_FRAMES) & TS_TIMESTAMP_MASK);
+	auto header_size = PES_HEADER_SIZE;
+	if (!has_aud) {
+		auto aud = codec == EncoderCodec::HEVC ? std::span<const uint8_t>{HEVC_AUD}
+											   : std::span<const uint8_t>{H264_AUD};
+		memcpy(header + header_size, aud.data(), aud.size());
+		header_size += (uint32_t)aud.size();
+	}
+	WritePes(output, std::span{header, header_size}, data, pcr_base & TS_TIMESTAMP_MASK,
+			 frame.keyframe);
+
+	uint8_t null_continuity = 0;
+	while ((output.size() - start) % TS_DATAGRAM_SIZE) {
+		auto packet = AppendPacket(output, NULL_PID, false, 0, null_continuity);
+		memset(packet + TS_HEADER_SIZE, 0xFF, TS_PAYLOAD_SIZE);
+		++stats.null_packets;
+	}
+
+	++stats.frames;
+	stats.bytes += output.size() - start;
+}
+
+TsMuxerStats TsMuxer::GetStats() const {
+	return stats;
+}
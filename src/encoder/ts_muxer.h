@@ -0,0 +1,55 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+
+constexpr uint32_t TS_PACKET_SIZE	   = 188;
+constexpr uint32_t TS_DATAGRAM_PACKETS = 7;
+constexpr uint32_t TS_DATAGRAM_SIZE	   = TS_PACKET_SIZE * TS_DATAGRAM_PACKETS;
+
+struct TsMuxerConfig {
+	uint16_t program_number = 1;
+	uint16_t pmt_pid		= 0x1000;
+	uint16_t video_pid		= 0x100;
+};
+
+struct TsMuxerStats {
+	uint64_t frames;
+	uint64_t packets;
+	uint64_t psi_packets;
+	uint64_t pcr_packets;
+	uint64_t null_packets;
+	uint64_t bytes;
+};
+
+class TsMuxer {
+  public:
+	TsMuxer(const EncoderConfig& config, const TsMuxerConfig& ts_config = {});
+
+	void Mux(const EncodedFrame& frame, std::vector<uint8_t>& output);
+	TsMuxerStats GetStats() const;
+
+  private:
+	uint8_t* AppendPacket(std::vector<uint8_t>& output, uint16_t pid, bool payload_start,
+						  uint32_t adaptation_size, uint8_t& continuity);
+	void WriteSection(std::vector<uint8_t>& output, uint16_t pid, std::span<const uint8_t> section,
+					  uint8_t& continuity);
+	void WritePes(std::vector<uint8_t>& output, std::span<const uint8_t> header,
+				  std::span<const uint8_t> data, uint64_t pcr_base, bool keyframe);
+
+	EncoderCodec codec;
+	TsMuxerConfig ts_config;
+	uint32_t frame_rate_num;
+	uint32_t frame_rate_den;
+	std::vector<uint8_t> pat;
+	std::vector<uint8_t> pmt;
+	uint8_t pat_continuity	 = 0;
+	uint8_t pmt_continuity	 = 0;
+	uint8_t video_continuity = 0;
+	uint64_t table_pcr_base	 = 0;
+	bool has_tables			 = false;
+	TsMuxerStats stats{};
+};
@@ -0,0 +1,29 @@
+#include "encoder/ts_sender.h"
+
+TsSender::TsSender(const char* host, uint16_t port, const EncoderConfig& config,
+				   const TsMuxerConfig& ts_config, const ThreadPlacement& placement)
+	: muxer(config, ts_config), sender(host, port, config, placement) {}
+
+void TsSender::Send(const EncodedFrame& frame) {
+	auto batch = sender.AcquireBatch();
+	muxer.Mux(frame, batch.data);
+	for (uint32_t offset = 0; offset < batch.data.size(); offset += TS_DATAGRAM_SIZE)
+		batch.datagrams.push_back(Datagram{.offset = offset, .size = TS_DATAGRAM_SIZE});
+	sender.Submit(std::move(batch));
+}
+
+void TsSender::Flush() {
+	sender.Flush();
+}
+
+PacedSenderStats TsSender::GetStats() const {
+	return sender.GetStats();
+}
+
+TsMuxerStats TsSender::GetMuxerStats() const {
+	return muxer.GetStats();
+}
+
+void TsSender::SendFrame(void* sender, const EncodedFrame& frame) {
+	((TsSender*)sender)->Send(frame);
+}
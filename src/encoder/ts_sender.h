@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstdint>
+
+#include "encoder/encoder_config.h"
+#include "encoder/paced_sender.h"
+#include "encoder/ts_muxer.h"
+
+class TsSender {
+  public:
+	TsSender(const char* host, uint16_t port, const EncoderConfig& config,
+			 const TsMuxerConfig& ts_config = {}, const ThreadPlacement& placement = {});
+
+	void Send(const EncodedFrame& frame);
+	void Flush();
+	PacedSenderStats GetStats() const;
+	TsMuxerStats GetMuxerStats() const;
+
+	static void SendFrame(void* sender, const EncodedFrame& frame);
+
+  private:
+	TsMuxer muxer;
+	PacedSender sender;
+};
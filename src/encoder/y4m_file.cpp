@@ -0,0 +1,285 @@
+#include "encoder/y4m_file.h"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+constexpr std::string_view Y4M_SIGNATURE = "YUV4MPEG2";
+constexpr std::string_view Y4M_FRAME_TAG = "FRAME";
+
+constexpr std::string_view Y4M_420_COLORSPACES[]{"420", "420jpeg", "420mpeg2", "420paldv"};
+
+static uint64_t GetElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+static uint32_t ParseNumber(std::string_view text) {
+	uint32_t value = 0;
+	auto result	   = std::from_chars(text.data(), text.data() + text.size(), value);
+	if (result.ec != std::errc{} || result.ptr != text.data() + text.size())
+		throw;
+	return value;
+}
+
+static uint8_t ClampByte(int32_t value) {
+	return (uint8_t)std::clamp(value, 0, 255);
+}
+
+static void ConvertYuvRow(uint32_t* row, const uint8_t* luma, const uint8_t* u, const uint8_t* v,
+						  uint32_t width, bool bgra) {
+	auto red_shift	= bgra ? 16 : 0;
+	auto blue_shift = bgra ? 0 : 16;
+	for (auto x = 0u; x < width; x += 2) {
+		auto d			= u[x / 2] - 128;
+		auto e			= v[x / 2] - 128;
+		auto red_term	= 409 * e;
+		auto green_term = -100 * d - 208 * e;
+		auto blue_term	= 516 * d;
+		for (auto i = x; i < std::min(x + 2, width); ++i) {
+			auto c	   = (luma[i] - 16) * 298 + 128;
+			auto red   = (uint32_t)ClampByte((c + red_term) >> 8);
+			auto green = (uint32_t)ClampByte((c + green_term) >> 8);
+			auto blue  = (uint32_t)ClampByte((c + blue_term) >> 8);
+			row[i]	   = red << red_shift | green << 8 | blue << blue_shift | 0xFFu << 24;
+		}
+	}
+}
+
+static void UnpackPixel(uint32_t pixel, bool bgra, int32_t rgb[3]) {
+	auto first	= (int32_t)(pixel & 0xFF);
+	auto second = (int32_t)(pixel >> 16 & 0xFF);
+	rgb[0]		= bgra ? second : first;
+	rgb[1]		= (int32_t)(pixel >> 8 & 0xFF);
+	rgb[2]		= bgra ? first : second;
+}
+
+static uint8_t RgbToY(const int32_t rgb[3]) {
+	return (uint8_t)(((66 * rgb[0] + 129 * rgb[1] + 25 * rgb[2] + 128) >> 8) + 16);
+}
+
+static uint8_t RgbToU(const int32_t rgb[3]) {
+	return (uint8_t)(((-38 * rgb[0] - 74 * rgb[1] + 112 * rgb[2] + 128) >> 8) + 128);
+}
+
+static uint8_t RgbToV(const int32_t rgb[3]) {
+	return (uint8_t)(((112 * rgb[0] - 94 * rgb[1] - 18 * rgb[2] + 128) >> 8) + 128);
+}
+
+static void CopyRows(uint8_t* destination, size_t destination_pitch, const uint8_t* source,
+					 size_t source_pitch, size_t row_size, uint32_t row_count) {
+	for (auto y = 0u; y < row_count; ++y)
+		memcpy(destination + y * destination_pitch, source + y * source_pitch, row_size);
+}
+
+Y4mReplaySource::Y4mReplaySource(const char* path) : file(path) {
+	ParseHeader();
+	file.Prefetch(frame_offsets.front(), GetFrameSize());
+}
+
+uint64_t Y4mReplaySource::GetFrameSize() const {
+	auto chroma_size = (uint64_t)((header.width + 1) / 2) * ((header.height + 1) / 2);
+	return (uint64_t)header.width * header.height + 2 * chroma_size;
+}
+
+void Y4mReplaySource::ParseHeader() {
+	std::string_view text{(const char*)file.data, file.size};
+	auto header_end = text.find('\n');
+	if (header_end == std::string_view::npos || !text.starts_with(Y4M_SIGNATURE))
+		throw;
+
+	header.frame_rate_num = 30;
+	header.frame_rate_den = 1;
+	auto parameters		  = text.substr(Y4M_SIGNATURE.size(), header_end - Y4M_SIGNATURE.size());
+	while (!parameters.empty()) {
+		auto token = parameters.substr(0, parameters.find(' '));
+		parameters.remove_prefix(std::min(token.size() + 1, parameters.size()));
+		if (token.empty())
+			continue;
+
+		auto value = token.substr(1);
+		switch (token.front()) {
+			case 'W':
+				header.width = ParseNumber(value);
+				break;
+			case 'H':
+				header.height = ParseNumber(value);
+				break;
+			case 'F': {
+				auto separator = value.find(':');
+				if (separator == std::string_view::npos)
+					throw;
+				header.frame_rate_num = ParseNumber(value.substr(0, separator));
+				header.frame_rate_den = ParseNumber(value.substr(separator + 1));
+				break;
+			}
+			case 'C':
+				if (std::ranges::find(Y4M_420_COLORSPACES, value) == std::end(Y4M_420_COLORSPACES))
+					throw;
+				break;
+		}
+	}
+	if (!header.width || !header.height || !header.frame_rate_num || !header.frame_rate_den)
+		throw;
+
+	auto frame_size = GetFrameSize();
+	auto offset		= (uint64_t)header_end + 1;
+	while (offset < file.size) {
+		auto frame_header = text.substr(offset);
+		auto frame_end	  = frame_header.find('\n');
+		if (!frame_header.starts_with(Y4M_FRAME_TAG) || frame_end == std::string_view::npos)
+			break;
+		auto payload = offset + frame_end + 1;
+		if (frame_size > file.size - payload)
+			break;
+		frame_offsets.push_back(payload);
+		offset = payload + frame_size;
+	}
+	if (frame_offsets.empty())
+		throw;
+	frame_count = (uint32_t)frame_offsets.size();
+}
+
+void Y4mReplaySource::ReadFrame(uint8_t* buffer, const TextureFootprint& footprint) {
+	if (footprint.width != header.width || footprint.height != header.height)
+		throw;
+
+	auto start		   = std::chrono::steady_clock::now();
+	auto width		   = header.width;
+	auto height		   = header.height;
+	auto chroma_width  = (width + 1) / 2;
+	auto chroma_height = (height + 1) / 2;
+	auto luma		   = file.data + frame_offsets[next_frame];
+	auto u			   = luma + (size_t)width * height;
+	auto v			   = u + (size_t)chroma_width * chroma_height;
+	auto destination   = buffer + footprint.offset;
+
+	switch (footprint.format) {
+		case TextureFormat::NV12:
+			CopyRows(destination, footprint.row_pitch, luma, width, width, height);
+			for (auto y = 0u; y < chroma_height; ++y) {
+				auto row = destination + footprint.chroma_offset + (size_t)y * footprint.row_pitch;
+				for (auto x = 0u; x < chroma_width; ++x) {
+					row[2 * x]	   = u[(size_t)y * chroma_width + x];
+					row[2 * x + 1] = v[(size_t)y * chroma_width + x];
+				}
+			}
+			break;
+		case TextureFormat::B8G8R8A8Unorm:
+		case TextureFormat::R8G8B8A8Unorm: {
+			auto bgra = footprint.format == TextureFormat::B8G8R8A8Unorm;
+			for (auto y = 0u; y < height; ++y) {
+				auto chroma_row = (size_t)(y / 2) * chroma_width;
+				ConvertYuvRow((uint32_t*)(destination + (size_t)y * footprint.row_pitch),
+							  luma + (size_t)y * width, u + chroma_row, v + chroma_row, width,
+							  bgra);
+			}
+			break;
+		}
+		case TextureFormat::R10G10B10A2Unorm:
+		case TextureFormat::P010:
+			throw;
+	}
+
+	++stats.read_frames;
+	stats.read_bytes += GetFrameSize();
+	stats.convert_nanoseconds += GetElapsedNanoseconds(start);
+	next_frame = (next_frame + 1) % frame_count;
+	if (!next_frame)
+		++stats.loop_count;
+	file.Prefetch(frame_offsets[next_frame], GetFrameSize());
+}
+
+Y4mReplayStats Y4mReplaySource::GetStats() const {
+	return stats;
+}
+
+void AppendY4mHeader(std::vector<uint8_t>& output, const Y4mHeader& header) {
+	auto text = std::string{Y4M_SIGNATURE} + " W" + std::to_string(header.width) + " H"
+				+ std::to_string(header.height) + " F" + std::to_string(header.frame_rate_num)
+				+ ":" + std::to_string(header.frame_rate_den) + " Ip A1:1 C420jpeg\n";
+	output.insert(output.end(), text.begin(), text.end());
+}
+
+void AppendY4mFrame(std::vector<uint8_t>& output, const uint8_t* buffer,
+					const TextureFootprint& footprint) {
+	auto width		   = footprint.width;
+	auto height		   = footprint.height;
+	auto chroma_width  = (width + 1) / 2;
+	auto chroma_height = (height + 1) / 2;
+	auto source		   = buffer + footprint.offset;
+
+	output.insert(output.end(), Y4M_FRAME_TAG.begin(), Y4M_FRAME_TAG.end());
+	output.push_back('\n');
+	auto frame_offset = output.size();
+	output.resize(frame_offset + (size_t)width * height
+				  + 2 * (size_t)chroma_width * chroma_height);
+	auto luma = output.data() + frame_offset;
+	auto u	  = luma + (size_t)width * height;
+	auto v	  = u + (size_t)chroma_width * chroma_height;
+
+	switch (footprint.format) {
+		case TextureFormat::NV12:
+			CopyRows(luma, width, source, footprint.row_pitch, width, height);
+			for (auto y = 0u; y < chroma_height; ++y) {
+				auto row = source + footprint.chroma_offset + (size_t)y * footprint.row_pitch;
+				for (auto x = 0u; x < chroma_width; ++x) {
+					u[(size_t)y * chroma_width + x] = row[2 * x];
+					v[(size_t)y * chroma_width + x] = row[2 * x + 1];
+				}
+			}
+			return;
+		case TextureFormat::B8G8R8A8Unorm:
+		case TextureFormat::R8G8B8A8Unorm:
+			break;
+		case TextureFormat::R10G10B10A2Unorm:
+		case TextureFormat::P010:
+			throw;
+	}
+
+	auto bgra	   = footprint.format == TextureFormat::B8G8R8A8Unorm;
+	auto get_pixel = [&](uint32_t x, uint32_t y, int32_t rgb[3]) {
+		auto row = (const uint32_t*)(source + (size_t)y * footprint.row_pitch);
+		UnpackPixel(row[x], bgra, rgb);
+	};
+	for (auto y = 0u; y < height; ++y)
+		for (auto x = 0u; x < width; ++x) {
+			int32_t rgb[3];
+			get_pixel(x, y, rgb);
+			luma[(size_t)y * width + x] = RgbToY(rgb);
+		}
+
+	for (auto y = 0u; y < chroma_height; ++y)
+		for (auto x = 0u; x < chroma_width; ++x) {
+			int32_t sum[3]{};
+			for (auto sample = 0u; sample < 4; ++sample) {
+				int32_t rgb[3];
+				get_pixel(std::min(2 * x + sample % 2, width - 1),
+						  std::min(2 * y + sample / 2, height - 1), rgb);
+				for (auto channel = 0; channel < 3; ++channel)
+					sum[channel] += rgb[channel];
+			}
+			for (auto& channel : sum)
+				channel = (channel + 2) / 4;
+			u[(size_t)y * chroma_width + x] = RgbToU(sum);
+			v[(size_t)y * chroma_width + x] = RgbToV(sum);
+		}
+}
+
+void AppendRawFrame(std::vector<uint8_t>& output, const uint8_t* buffer,
+					const TextureFootprint& footprint) {
+	auto row_size	   = (size_t)footprint.width * GetTextureSampleSize(footprint.format);
+	auto chroma_height = IsPlanarFormat(footprint.format) ? (footprint.height + 1) / 2 : 0;
+	auto chroma_size   = ((footprint.width + 1) / 2) * 2 * GetTextureSampleSize(footprint.format);
+	auto frame_offset  = output.size();
+	output.resize(frame_offset + row_size * footprint.height + (size_t)chroma_size * chroma_height);
+
+	auto source = buffer + footprint.offset;
+	CopyRows(output.data() + frame_offset, row_size, source, footprint.row_pitch, row_size,
+			 footprint.height);
+	CopyRows(output.data() + frame_offset + row_size * footprint.height, chroma_size,
+			 source + footprint.chroma_offset, footprint.row_pitch, chroma_size, chroma_height);
+}
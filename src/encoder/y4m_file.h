@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/render_types.h"
+#include "mapped_file.h"
+
+struct Y4mHeader {
+	uint32_t width;
+	uint32_t height;
+	uint32_t frame_rate_num;
+	uint32_t frame_rate_den;
+};
+
+struct Y4mReplayStats {
+	uint64_t read_frames;
+	uint64_t read_bytes;
+	uint64_t loop_count;
+	uint64_t convert_nanoseconds;
+};
+
+class Y4mReplaySource {
+  public:
+	explicit Y4mReplaySource(const char* path);
+
+	void ReadFrame(uint8_t* buffer, const TextureFootprint& footprint);
+	Y4mReplayStats GetStats() const;
+
+	MappedFile file;
+	Y4mHeader header{};
+	uint32_t frame_count = 0;
+
+  private:
+	uint64_t GetFrameSize() const;
+	void ParseHeader();
+
+	std::vector<uint64_t> frame_offsets;
+	uint32_t next_frame = 0;
+	Y4mReplayStats stats{};
+};
+
+void AppendY4mHeader(std::vector<uint8_t>& output, const Y4mHeader& header);
+void AppendY4mFrame(std::vector<uint8_t>& output, const uint8_t* buffer,
+					const TextureFootprint& footprint);
+void AppendRawFrame(std::vector<uint8_t>& output, const uint8_t* buffer,
+					const TextureFootprint& footprint);
@@ -0,0 +1,153 @@
+#include "event_loop.h"
+
+#include <algorithm>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <sys/epoll.h>
+#include <unistd.h>
+#endif
+
+void EventAwaiter::await_suspend(std::coroutine_handle<> handle) {
+	loop.Suspend(event, handle);
+}
+
+#ifdef _WIN32
+
+EventLoop::EventLoop() {}
+
+EventLoop::~EventLoop() {
+	for (auto task : tasks)
+		task.destroy();
+}
+
+void EventLoop::Arm(EventWaiters& entry) {
+	entry.registered = true;
+	entry.armed		 = true;
+}
+
+bool EventLoop::RunOnce(uint32_t timeout_milliseconds) {
+	HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+	DWORD count = 0;
+	for (auto& entry : waiters) {
+		if (!entry.armed)
+			continue;
+		if (count == MAXIMUM_WAIT_OBJECTS - 1)
+			throw;
+		handles[count++] = entry.event;
+	}
+
+	++stats.polls;
+	auto result
+		= MsgWaitForMultipleObjects(count, handles, FALSE, timeout_milliseconds, QS_ALLINPUT);
+	if (result == WAIT_FAILED)
+		throw;
+	if (result >= WAIT_OBJECT_0 + count)
+		return false;
+
+	ResumeWaiters(handles[result - WAIT_OBJECT_0]);
+	ReapTasks();
+	return true;
+}
+
+#else
+
+EventLoop::EventLoop() {
+	epoll_descriptor = epoll_create1(EPOLL_CLOEXEC);
+	if (epoll_descriptor < 0)
+		throw;
+}
+
+EventLoop::~EventLoop() {
+	for (auto task : tasks)
+		task.destroy();
+	close(epoll_descriptor);
+}
+
+void EventLoop::Arm(EventWaiters& entry) {
+	epoll_event event{.events = EPOLLIN | EPOLLONESHOT, .data = {.fd = entry.event}};
+	if (!entry.registered || epoll_ctl(epoll_descriptor, EPOLL_CTL_MOD, entry.event, &event) != 0) {
+		if (entry.registered && errno != ENOENT)
+			throw;
+		if (epoll_ctl(epoll_descriptor, EPOLL_CTL_ADD, entry.event, &event) != 0)
+			throw;
+		++stats.registrations;
+	}
+	entry.registered = true;
+	entry.armed		 = true;
+}
+
+bool EventLoop::RunOnce(uint32_t timeout_milliseconds) {
+	epoll_event events[MAX_READY_EVENTS];
+	++stats.polls;
+	auto count = epoll_wait(epoll_descriptor, events, MAX_READY_EVENTS, (int)timeout_milliseconds);
+	if (count < 0 && errno != EINTR)
+		throw;
+
+	for (auto i = 0; i < count; ++i) {
+		uint64_t value = 0;
+		if (read(events[i].data.fd, &value, sizeof(value)) < 0 && errno != EAGAIN)
+			throw;
+		ResumeWaiters(events[i].data.fd);
+	}
+	ReapTasks();
+	return count > 0;
+}
+
+#endif
+
+void EventLoop::Spawn(EventTask task) {
+	auto handle = std::exchange(task.handle, nullptr);
+	tasks.push_back(handle);
+	++stats.spawned_tasks;
+	handle.resume();
+	ReapTasks();
+}
+
+EventAwaiter EventLoop::Wait(EventHandle event) {
+	return EventAwaiter{.loop = *this, .event = event};
+}
+
+void EventLoop::Suspend(EventHandle event, std::coroutine_handle<> handle) {
+	++stats.awaits;
+	auto entry = std::ranges::find(waiters, event, &EventWaiters::event);
+	if (entry == waiters.end())
+		entry = waiters.insert(entry, EventWaiters{.event = event});
+	entry->handles.push_back(handle);
+	if (!entry->armed)
+		Arm(*entry);
+}
+
+void EventLoop::ResumeWaiters(EventHandle event) {
+	auto entry = std::ranges::find(waiters, event, &EventWaiters::event);
+	if (entry == waiters.end())
+		return;
+
+	entry->armed = false;
+	resuming.clear();
+	resuming.swap(entry->handles);
+	for (auto handle : resuming) {
+		++stats.resumes;
+		handle.resume();
+	}
+}
+
+void EventLoop::ReapTasks() {
+	std::erase_if(tasks, [this](std::coroutine_handle<EventTask::promise_type> task) {
+		if (!task.done())
+			return false;
+		task.destroy();
+		++stats.completed_tasks;
+		return true;
+	});
+}
+
+bool EventLoop::HasTasks() const {
+	return !tasks.empty();
+}
+
+EventLoopStats EventLoop::GetStats() const {
+	return stats;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <coroutine>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "platform_event.h"
+
+class EventLoop;
+
+class EventTask {
+  public:
+	struct promise_type {
+		EventTask get_return_object() {
+			return EventTask{std::coroutine_handle<promise_type>::from_promise(*this)};
+		}
+		std::suspend_always initial_suspend() noexcept {
+			return {};
+		}
+		std::suspend_always final_suspend() noexcept {
+			return {};
+		}
+		void return_void() {}
+		void unhandled_exception() {
+			throw;
+		}
+	};
+
+	explicit EventTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+	EventTask(EventTask&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+	~EventTask() {
+		if (handle)
+			handle.destroy();
+	}
+
+	EventTask(const EventTask&)			   = delete;
+	EventTask& operator=(const EventTask&) = delete;
+	EventTask& operator=(EventTask&&)	   = delete;
+
+	bool IsDone() const {
+		return !handle || handle.done();
+	}
+
+  private:
+	friend class EventLoop;
+
+	std::coroutine_handle<promise_type> handle;
+};
+
+struct EventAwaiter {
+	EventLoop& loop;
+	EventHandle event;
+
+	bool await_ready() const noexcept {
+		return false;
+	}
+	void await_suspend(std::coroutine_handle<> handle);
+	void await_resume() const noexcept {}
+};
+
+struct EventLoopStats {
+	uint64_t spawned_tasks;
+	uint64_t completed_tasks;
+	uint64_t awaits;
+	uint64_t resumes;
+	uint64_t polls;
+	uint64_t registrations;
+};
+
+class EventLoop {
+  public:
+	EventLoop();
+	~EventLoop();
+
+	EventLoop(const EventLoop&)			   = delete;
+	EventLoop& operator=(const EventLoop&) = delete;
+
+	void Spawn(EventTask task);
+	EventAwaiter Wait(EventHandle event);
+	bool RunOnce(uint32_t timeout_milliseconds);
+	bool HasTasks() const;
+	EventLoopStats GetStats() const;
+
+  private:
+	friend struct EventAwaiter;
+
+	static constexpr uint32_t MAX_READY_EVENTS = 64;
+
+	struct EventWaiters {
+		EventHandle event;
+		bool registered;
+		bool armed;
+		std::vector<std::coroutine_handle<>> handles;
+	};
+
+	void Suspend(EventHandle event, std::coroutine_handle<> handle);
+	void Arm(EventWaiters& waiters);
+	void ResumeWaiters(EventHandle event);
+	void ReapTasks();
+
+	std::vector<std::coroutine_handle<EventTask::promise_type>> tasks;
+	std::vector<EventWaiters> waiters;
+	std::vector<std::coroutine_handle<>> resuming;
+	EventLoopStats stats{};
+#ifndef _WIN32
+	int epoll_descriptor = -1;
+#endif
+};
@@ -0,0 +1,33 @@
+#include "graphics/command_recorder.h"
+
+#include <chrono>
+
+ParallelCommandRecorder::ParallelCommandRecorder(JobSystem& job_system)
+	: job_system(job_system) {
+}
+
+void ParallelCommandRecorder::Dispatch(uint32_t count, uint32_t item_count, void* context,
+									   JobFunction function) {
+	auto start = std::chrono::steady_clock::now();
+
+	JobCounter counter;
+	job_system.SubmitBatch(function, context, count, &counter);
+	job_system.Wait(counter);
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	record_nanoseconds
+		+= (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+	++dispatch_count;
+	job_count += count;
+	recorded_items += item_count;
+}
+
+CommandRecorderStats ParallelCommandRecorder::GetStats() const {
+	return CommandRecorderStats{
+		.thread_count		= job_system.thread_count,
+		.dispatch_count		= dispatch_count,
+		.job_count			= job_count,
+		.recorded_items		= recorded_items,
+		.record_nanoseconds = record_nanoseconds,
+	};
+}
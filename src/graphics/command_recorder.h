@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "job_system.h"
+
+struct CommandRecorderStats {
+	uint32_t thread_count;
+	uint64_t dispatch_count;
+	uint64_t job_count;
+	uint64_t recorded_items;
+	uint64_t record_nanoseconds;
+};
+
+class ParallelCommandRecorder {
+  public:
+	explicit ParallelCommandRecorder(JobSystem& job_system);
+
+	template <typename CommandList, typename RecordJob>
+	void Record(std::span<CommandList> command_lists, uint32_t item_count,
+				const RecordJob& record_job) {
+		auto list_count = (uint32_t)command_lists.size();
+
+		auto job = [&](uint32_t index) {
+			auto begin		   = (uint32_t)((uint64_t)item_count * index / list_count);
+			auto end		   = (uint32_t)((uint64_t)item_count * (index + 1) / list_count);
+			auto& command_list = command_lists[index];
+			command_list.Reset();
+			record_job(command_list, begin, end);
+			command_list.Close();
+		};
+		Dispatch(list_count, item_count, (void*)&job, [](void* context, uint32_t index) {
+			(*(const decltype(job)*)context)(index);
+		});
+	}
+
+	CommandRecorderStats GetStats() const;
+
+  private:
+	void Dispatch(uint32_t count, uint32_t item_count, void* context, JobFunction function);
+
+	JobSystem& job_system;
+	uint64_t dispatch_count		= 0;
+	uint64_t job_count			= 0;
+	uint64_t recorded_items		= 0;
+	uint64_t record_nanoseconds = 0;
+};
@@ -0,0 +1,104 @@
+#include "graphics/cpu_device.h"
+
+#include "graphics/cpu_frame_resources.h"
+
+uint64_t CpuFence::GetCompletedValue() const {
+	return completed_value.load(std::memory_order_acquire);
+}
+
+void CpuFence::SetEventOnCompletion(uint64_t value, EventHandle event) {
+	std::lock_guard lock{mutex};
+	if (completed_value.load(std::memory_order_relaxed) >= value) {
+		SignalAutoResetEvent(event);
+		return;
+	}
+	pending_events.push_back(PendingEvent{.value = value, .event = event});
+}
+
+void CpuFence::Wait(uint64_t value) {
+	std::unique_lock lock{mutex};
+	completed.wait(lock, [this, value] {
+		return completed_value.load(std::memory_order_relaxed) >= value;
+	});
+}
+
+void CpuFence::Complete(uint64_t value) {
+	std::lock_guard lock{mutex};
+	completed_value.store(value, std::memory_order_release);
+	std::erase_if(pending_events, [value](const PendingEvent& pending) {
+		if (pending.value > value)
+			return false;
+		SignalAutoResetEvent(pending.event);
+		return true;
+	});
+	completed.notify_all();
+}
+
+CpuCommandQueue::CpuCommandQueue(CpuRasterizer& rasterizer) : rasterizer(rasterizer) {
+}
+
+CpuCommandQueue::~CpuCommandQueue() {
+	{
+		std::lock_guard lock{mutex};
+		stopping = true;
+	}
+	submitted.notify_one();
+	worker.join();
+}
+
+void CpuCommandQueue::Execute(const CpuCommandList& command_list) {
+	Submit(Submission{.type = SubmissionType::CommandList, .command_list = &command_list});
+}
+
+void CpuCommandQueue::Signal(CpuFence* fence, uint64_t value) {
+	Submit(Submission{.type = SubmissionType::Signal, .fence = fence, .fence_value = value});
+}
+
+void CpuCommandQueue::Present(EventHandle frame_latency_semaphore) {
+	Submit(Submission{.type					   = SubmissionType::Present,
+					  .frame_latency_semaphore = frame_latency_semaphore});
+}
+
+void CpuCommandQueue::Submit(const Submission& submission) {
+	{
+		std::lock_guard lock{mutex};
+		submissions.push_back(submission);
+	}
+	submitted.notify_one();
+}
+
+void CpuCommandQueue::RunWorker() {
+	for (;;) {
+		Submission submission;
+		{
+			std::unique_lock lock{mutex};
+			submitted.wait(lock, [this] { return stopping || !submissions.empty(); });
+			if (submissions.empty())
+				return;
+			submission = submissions.front();
+			submissions.pop_front();
+		}
+
+		switch (submission.type) {
+			case SubmissionType::CommandList:
+				submission.command_list->Execute(rasterizer);
+				break;
+			case SubmissionType::Signal:
+				submission.fence->Complete(submission.fence_value);
+				break;
+			case SubmissionType::Present:
+				ReleaseCountingSemaphore(submission.frame_latency_semaphore);
+				break;
+		}
+	}
+}
+
+void CpuDevice::Execute(std::span<const CpuCommandList> command_lists) {
+	for (auto& command_list : command_lists)
+		command_queue.Execute(command_list);
+}
+
+void CpuDevice::Signal(CpuFence* fence, uint64_t value, EventHandle event) {
+	fence->SetEventOnCompletion(value, event);
+	command_queue.Signal(fence, value);
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "graphics/cpu_rasterizer.h"
+#include "platform_event.h"
+
+class CpuCommandList;
+
+class CpuFence {
+  public:
+	uint64_t GetCompletedValue() const;
+	void SetEventOnCompletion(uint64_t value, EventHandle event);
+	void Wait(uint64_t value);
+	void Complete(uint64_t value);
+
+  private:
+	struct PendingEvent {
+		uint64_t value;
+		EventHandle event;
+	};
+
+	std::atomic<uint64_t> completed_value = 0;
+	std::mutex mutex;
+	std::condition_variable completed;
+	std::vector<PendingEvent> pending_events;
+};
+
+class CpuCommandQueue {
+  public:
+	explicit CpuCommandQueue(CpuRasterizer& rasterizer);
+	~CpuCommandQueue();
+
+	void Execute(const CpuCommandList& command_list);
+	void Signal(CpuFence* fence, uint64_t value);
+	void Present(EventHandle frame_latency_semaphore);
+
+  private:
+	enum class SubmissionType {
+		CommandList,
+		Signal,
+		Present,
+	};
+
+	struct Submission {
+		SubmissionType type;
+		const CpuCommandList* command_list;
+		CpuFence* fence;
+		uint64_t fence_value;
+		EventHandle frame_latency_semaphore;
+	};
+
+	void Submit(const Submission& submission);
+	void RunWorker();
+
+	CpuRasterizer& rasterizer;
+	std::mutex mutex;
+	std::condition_variable submitted;
+	std::deque<Submission> submissions;
+	bool stopping = false;
+	std::thread worker{&CpuCommandQueue::RunWorker, this};
+};
+
+class CpuDevice {
+  public:
+	CpuRasterizer rasterizer{std::thread::hardware_concurrency()};
+	CpuCommandQueue command_queue{rasterizer};
+
+	void Execute(std::span<const CpuCommandList> command_lists);
+	void Signal(CpuFence* fence, uint64_t value, EventHandle event);
+};
@@ -0,0 +1,228 @@
+#include "graphics/cpu_frame_resources.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "graphics/cpu_mesh.h"
+
+static uint32_t ToUnorm(float value, uint32_t max) {
+	return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * (float)max + 0.5f);
+}
+
+static uint32_t PackColor(TextureFormat format, const float* color) {
+	switch (format) {
+		case TextureFormat::B8G8R8A8Unorm:
+			return ToUnorm(color[2], 255) | ToUnorm(color[1], 255) << 8
+				   | ToUnorm(color[0], 255) << 16 | ToUnorm(color[3], 255) << 24;
+		case TextureFormat::R8G8B8A8Unorm:
+			return ToUnorm(color[0], 255) | ToUnorm(color[1], 255) << 8
+				   | ToUnorm(color[2], 255) << 16 | ToUnorm(color[3], 255) << 24;
+		case TextureFormat::R10G10B10A2Unorm:
+			return ToUnorm(color[0], 1023) | ToUnorm(color[1], 1023) << 10
+				   | ToUnorm(color[2], 1023) << 20 | ToUnorm(color[3], 3) << 30;
+		case TextureFormat::NV12:
+		case TextureFormat::P010:
+			break;
+	}
+	throw;
+}
+
+static size_t GetRowSize(uint32_t width, TextureFormat format) {
+	return (size_t)width * GetTextureSampleSize(format);
+}
+
+static size_t GetChromaRowSize(uint32_t width, TextureFormat format) {
+	return IsPlanarFormat(format) ? GetRowSize((width + 1) / 2 * 2, format) : 0;
+}
+
+static uint32_t GetChromaHeight(uint32_t height, TextureFormat format) {
+	return IsPlanarFormat(format) ? (height + 1) / 2 : 0;
+}
+
+static void CopyTextureData(uint8_t* texture, uint8_t* buffer, const TextureFootprint& footprint,
+							bool upload) {
+	auto copy_plane = [&](uint8_t* texture_rows, uint8_t* buffer_rows, size_t row_size,
+						  uint32_t row_count) {
+		for (auto y = 0u; y < row_count; ++y) {
+			auto texture_row = texture_rows + y * row_size;
+			auto buffer_row	 = buffer_rows + (size_t)y * footprint.row_pitch;
+			if (upload)
+				memcpy(texture_row, buffer_row, row_size);
+			else
+				memcpy(buffer_row, texture_row, row_size);
+		}
+	};
+
+	auto row_size = GetRowSize(footprint.width, footprint.format);
+	copy_plane(texture, buffer + footprint.offset, row_size, footprint.height);
+	copy_plane(texture + row_size * footprint.height,
+			   buffer + footprint.offset + footprint.chroma_offset,
+			   GetChromaRowSize(footprint.width, footprint.format),
+			   GetChromaHeight(footprint.height, footprint.format));
+}
+
+static bool MatchesFootprint(const CpuTexture& texture, const TextureFootprint& footprint) {
+	return texture.width == footprint.width && texture.height == footprint.height
+		   && texture.format == footprint.format;
+}
+
+CpuTexture::CpuTexture(uint32_t width, uint32_t height, TextureFormat format)
+	: width(width), height(height), format(format) {
+	auto size = GetRowSize(width, format) * height
+				+ GetChromaRowSize(width, format) * GetChromaHeight(height, format);
+	pixels.resize((size + sizeof(uint32_t) - 1) / sizeof(uint32_t));
+}
+
+CpuTextureArray::CpuTextureArray(CpuDevice&, uint32_t count, uint32_t width, uint32_t height,
+								 TextureFormat format) {
+	for (auto i = 0u; i < count; ++i)
+		textures.push_back(new CpuTexture{width, height, format});
+	render_target_views = textures;
+}
+
+CpuTextureArray::~CpuTextureArray() {
+	for (auto texture : textures)
+		delete texture;
+}
+
+CpuUploadBuffer::CpuUploadBuffer(CpuDevice&, uint32_t size)
+	: storage(size), mapped(storage.data()) {
+}
+
+CpuReadbackBuffer::CpuReadbackBuffer(CpuDevice&, uint32_t size)
+	: storage(size), mapped(storage.data()) {
+}
+
+void CpuCommandList::Reset() {
+	commands.clear();
+	render_target = nullptr;
+	pipeline	  = nullptr;
+	constants	  = nullptr;
+	closed		  = false;
+}
+
+void CpuCommandList::Barrier(std::span<const TextureTransition<CpuTexture>> transitions) {
+	if (closed || transitions.empty())
+		throw;
+}
+
+void CpuCommandList::SetRenderTarget(CpuTexture* render_target_view, uint32_t width,
+									 uint32_t height) {
+	if (width > render_target_view->width || height > render_target_view->height)
+		throw;
+	render_target = render_target_view;
+}
+
+void CpuCommandList::SetPipeline(const CpuPipeline& bound_pipeline) {
+	pipeline = &bound_pipeline;
+}
+
+void CpuCommandList::SetConstants(uint64_t address) {
+	constants = (const float*)address;
+}
+
+void CpuCommandList::Clear(CpuTexture* render_target_view, const float* color) {
+	commands.push_back(Command{
+		.type		 = CommandType::Clear,
+		.destination = render_target_view,
+		.clear_value = PackColor(render_target_view->format, color),
+	});
+}
+
+void CpuCommandList::Draw(const CpuMesh& mesh) {
+	if (!render_target || !pipeline || !constants)
+		throw;
+
+	commands.push_back(Command{
+		.type		 = CommandType::Draw,
+		.destination = render_target,
+		.pipeline	 = pipeline,
+		.mesh		 = &mesh,
+		.constants	 = constants,
+	});
+}
+
+void CpuCommandList::Copy(CpuTexture* destination, CpuTexture* source) {
+	if (destination->width != source->width || destination->height != source->height
+		|| destination->format != source->format)
+		throw;
+
+	commands.push_back(Command{
+		.type		 = CommandType::Copy,
+		.destination = destination,
+		.source		 = source,
+	});
+}
+
+void CpuCommandList::CopyBufferToTexture(CpuTexture* destination, const CpuUploadBuffer& source,
+										 const TextureFootprint& footprint) {
+	if (!MatchesFootprint(*destination, footprint) || footprint.size > source.storage.size()
+		|| footprint.offset > source.storage.size() - footprint.size)
+		throw;
+
+	commands.push_back(Command{
+		.type		 = CommandType::CopyBufferToTexture,
+		.destination = destination,
+		.buffer		 = source.mapped,
+		.footprint	 = footprint,
+	});
+}
+
+void CpuCommandList::CopyTextureToBuffer(CpuReadbackBuffer& destination, CpuTexture* source,
+										 const TextureFootprint& footprint) {
+	if (!MatchesFootprint(*source, footprint) || footprint.size > destination.storage.size()
+		|| footprint.offset > destination.storage.size() - footprint.size)
+		throw;
+
+	commands.push_back(Command{
+		.type	   = CommandType::CopyTextureToBuffer,
+		.source	   = source,
+		.buffer	   = destination.mapped,
+		.footprint = footprint,
+	});
+}
+
+void CpuCommandList::Close() {
+	closed = true;
+}
+
+void CpuCommandList::Execute(CpuRasterizer& rasterizer) const {
+	for (auto& command : commands) {
+		switch (command.type) {
+			case CommandType::Clear:
+				std::ranges::fill(command.destination->pixels, command.clear_value);
+				break;
+			case CommandType::Draw:
+				rasterizer.Draw(*command.destination, command.mesh->vertices, command.constants);
+				break;
+			case CommandType::Copy:
+				std::ranges::copy(command.source->pixels, command.destination->pixels.begin());
+				break;
+			case CommandType::CopyBufferToTexture:
+				CopyTextureData((uint8_t*)command.destination->pixels.data(), command.buffer,
+								command.footprint, true);
+				break;
+			case CommandType::CopyTextureToBuffer:
+				CopyTextureData((uint8_t*)command.source->pixels.data(), command.buffer,
+								command.footprint, false);
+				break;
+		}
+	}
+}
+
+CpuFrameResources::CpuFrameResources(CpuDevice&, uint32_t count, uint32_t lists_per_frame)
+	: lists_per_frame(lists_per_frame) {
+	command_lists.resize((size_t)count * lists_per_frame);
+	for (auto i = 0u; i < count; ++i) {
+		fences.push_back(new CpuFence);
+		fence_events.push_back(CreateAutoResetEvent(false));
+	}
+}
+
+CpuFrameResources::~CpuFrameResources() {
+	for (auto fence : fences)
+		delete fence;
+
+	for (auto fence_event : fence_events)
+		CloseEventHandle(fence_event);
+}
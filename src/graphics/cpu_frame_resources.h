@@ -0,0 +1,110 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/cpu_device.h"
+#include "graphics/render_types.h"
+#include "platform_event.h"
+
+struct CpuMesh;
+struct CpuPipeline;
+
+struct CpuTexture {
+	uint32_t width;
+	uint32_t height;
+	TextureFormat format;
+	std::vector<uint32_t> pixels;
+
+	CpuTexture(uint32_t width, uint32_t height, TextureFormat format);
+};
+
+struct CpuTextureArray {
+	std::vector<CpuTexture*> textures;
+	std::vector<CpuTexture*> render_target_views;
+
+	CpuTextureArray(CpuDevice& device, uint32_t count, uint32_t width, uint32_t height,
+					TextureFormat format);
+	~CpuTextureArray();
+};
+
+struct CpuUploadBuffer {
+	std::vector<uint8_t> storage;
+	uint8_t* mapped;
+
+	CpuUploadBuffer(CpuDevice& device, uint32_t size);
+
+	uint64_t GetGpuVirtualAddress() const {
+		return (uint64_t)mapped;
+	}
+};
+
+struct CpuReadbackBuffer {
+	std::vector<uint8_t> storage;
+	uint8_t* mapped;
+
+	CpuReadbackBuffer(CpuDevice& device, uint32_t size);
+};
+
+class CpuCommandList {
+  public:
+	void Reset();
+	void Barrier(std::span<const TextureTransition<CpuTexture>> transitions);
+	void SetRenderTarget(CpuTexture* render_target_view, uint32_t width, uint32_t height);
+	void SetPipeline(const CpuPipeline& pipeline);
+	void SetConstants(uint64_t address);
+	void Clear(CpuTexture* render_target_view, const float* color);
+	void Draw(const CpuMesh& mesh);
+	void Copy(CpuTexture* destination, CpuTexture* source);
+	void CopyBufferToTexture(CpuTexture* destination, const CpuUploadBuffer& source,
+							 const TextureFootprint& footprint);
+	void CopyTextureToBuffer(CpuReadbackBuffer& destination, CpuTexture* source,
+							 const TextureFootprint& footprint);
+	void Close();
+
+	void Execute(CpuRasterizer& rasterizer) const;
+
+  private:
+	enum class CommandType {
+		Clear,
+		Draw,
+		Copy,
+		CopyBufferToTexture,
+		CopyTextureToBuffer,
+	};
+
+	struct Command {
+		CommandType type;
+		CpuTexture* destination;
+		CpuTexture* source;
+		const CpuPipeline* pipeline;
+		const CpuMesh* mesh;
+		const float* constants;
+		uint32_t clear_value;
+		uint8_t* buffer;
+		TextureFootprint footprint;
+	};
+
+	std::vector<Command> commands;
+	CpuTexture* render_target	= nullptr;
+	const CpuPipeline* pipeline = nullptr;
+	const float* constants		= nullptr;
+	bool closed					= true;
+};
+
+class CpuFrameResources {
+  public:
+	CpuFrameResources(CpuDevice& device, uint32_t count, uint32_t lists_per_frame = 1);
+	~CpuFrameResources();
+
+	std::span<CpuCommandList> GetCommandLists(uint32_t frame) {
+		return std::span{command_lists}.subspan((size_t)frame * lists_per_frame, lists_per_frame);
+	}
+
+	uint32_t lists_per_frame;
+
+	std::vector<CpuCommandList> command_lists;
+	std::vector<CpuFence*> fences;
+	std::vector<EventHandle> fence_events;
+};
@@ -0,0 +1,51 @@
+#include "graphics/cpu_mesh.h"
+
+#include <cstring>
+
+static const MeshStreamDesc* FindStream(const MeshFile& mesh_file, MeshStreamType type) {
+	for (auto& stream : mesh_file.streams)
+		if (stream.type == type)
+			return &stream;
+	return nullptr;
+}
+
+static void ReadPosition(const MeshFile& mesh_file, const MeshStreamDesc& stream,
+						 uint32_t vertex_index, float position[3]) {
+	auto source = mesh_file.GetStreamData(stream).data() + (size_t)vertex_index * stream.stride;
+	if (stream.format == MeshStreamFormat::Unorm16x4)
+		DequantizePosition((const uint16_t*)source, mesh_file.header.bounds, position);
+	else
+		memcpy(position, source, sizeof(float[3]));
+}
+
+static uint32_t ReadIndex(const MeshFile& mesh_file, uint32_t index) {
+	auto indices = mesh_file.GetIndexData().data();
+	if (mesh_file.GetIndexStride() == 4)
+		return ((const uint32_t*)indices)[index];
+	return ((const uint16_t*)indices)[index];
+}
+
+CpuMesh::CpuMesh(CpuDevice&, const MeshFile& mesh_file) {
+	auto position_stream = FindStream(mesh_file, MeshStreamType::Position);
+	auto color_stream	 = FindStream(mesh_file, MeshStreamType::Color);
+	if (!position_stream)
+		throw;
+
+	vertices.clear();
+	for (auto& submesh : mesh_file.submeshes) {
+		for (auto i = 0u; i < submesh.index_count; ++i) {
+			auto vertex_index = ReadIndex(mesh_file, submesh.index_offset + i);
+			if (vertex_index >= mesh_file.header.vertex_count)
+				throw;
+
+			MeshVertex vertex{.color = {1.0f, 1.0f, 1.0f}};
+			ReadPosition(mesh_file, *position_stream, vertex_index, vertex.position);
+			if (color_stream && color_stream->format == MeshStreamFormat::Float3)
+				memcpy(vertex.color,
+					   mesh_file.GetStreamData(*color_stream).data()
+						   + (size_t)vertex_index * color_stream->stride,
+					   sizeof(vertex.color));
+			vertices.push_back(vertex);
+		}
+	}
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <iterator>
+#include <vector>
+
+#include "graphics/cpu_device.h"
+#include "graphics/mesh_file.h"
+#include "graphics/render_types.h"
+
+struct CpuMesh {
+	std::vector<MeshVertex> vertices{std::begin(TRIANGLE_VERTICES), std::end(TRIANGLE_VERTICES)};
+
+	explicit CpuMesh(CpuDevice&) {
+	}
+
+	CpuMesh(CpuDevice& device, const MeshFile& mesh_file);
+
+	MeshStreamFormat GetPositionFormat() const {
+		return MeshStreamFormat::Float3;
+	}
+};
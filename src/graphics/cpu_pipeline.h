@@ -0,0 +1,15 @@
+#pragma once
+
+#include "graphics/cpu_device.h"
+#include "graphics/mesh_file.h"
+#include "graphics/render_types.h"
+#include "job_system.h"
+
+struct CpuPipeline {
+	TextureFormat render_target_format;
+
+	CpuPipeline(CpuDevice&, JobSystem&, TextureFormat render_target_format,
+				MeshStreamFormat = MeshStreamFormat::Float3)
+		: render_target_format(render_target_format) {
+	}
+};
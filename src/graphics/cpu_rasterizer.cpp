@@ -0,0 +1,357 @@
+#include "graphics/cpu_rasterizer.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+
+#include "graphics/cpu_frame_resources.h"
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+struct ChannelLayout {
+	float color_max;
+	float alpha_max;
+	uint32_t red_shift;
+	uint32_t green_shift;
+	uint32_t blue_shift;
+	uint32_t alpha_shift;
+};
+
+static ChannelLayout GetChannelLayout(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::B8G8R8A8Unorm:
+			return ChannelLayout{.color_max	  = 255.0f,
+								 .alpha_max	  = 255.0f,
+								 .red_shift	  = 16,
+								 .green_shift = 8,
+								 .blue_shift  = 0,
+								 .alpha_shift = 24};
+		case TextureFormat::R8G8B8A8Unorm:
+			return ChannelLayout{.color_max	  = 255.0f,
+								 .alpha_max	  = 255.0f,
+								 .red_shift	  = 0,
+								 .green_shift = 8,
+								 .blue_shift  = 16,
+								 .alpha_shift = 24};
+		case TextureFormat::R10G10B10A2Unorm:
+			return ChannelLayout{.color_max	  = 1023.0f,
+								 .alpha_max	  = 3.0f,
+								 .red_shift	  = 0,
+								 .green_shift = 10,
+								 .blue_shift  = 20,
+								 .alpha_shift = 30};
+		case TextureFormat::NV12:
+		case TextureFormat::P010:
+			break;
+	}
+	throw;
+}
+
+#ifdef __AVX2__
+static constexpr uint32_t LANE_COUNT = 8;
+
+static __m256i PackChannel(__m256 value, float max, uint32_t shift) {
+	auto clamped = _mm256_min_ps(_mm256_max_ps(value, _mm256_setzero_ps()), _mm256_set1_ps(1.0f));
+	auto scaled	 = _mm256_fmadd_ps(clamped, _mm256_set1_ps(max), _mm256_set1_ps(0.5f));
+	return _mm256_sllv_epi32(_mm256_cvttps_epi32(scaled), _mm256_set1_epi32((int)shift));
+}
+
+static uint32_t ShadeSpan(const auto& triangle, const ChannelLayout& layout, uint32_t* row,
+						  uint32_t x, uint32_t y, uint32_t count) {
+	auto px = _mm256_add_ps(_mm256_set1_ps((float)x),
+							_mm256_setr_ps(0.5f, 1.5f, 2.5f, 3.5f, 4.5f, 5.5f, 6.5f, 7.5f));
+	auto py = _mm256_set1_ps((float)y + 0.5f);
+
+	auto inside = _mm256_cmpgt_epi32(_mm256_set1_epi32((int)count),
+									 _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+	__m256 weights[3];
+	for (auto i = 0; i < 3; ++i) {
+		auto edge = _mm256_fmadd_ps(
+			_mm256_set1_ps(triangle.edge_a[i]), px,
+			_mm256_fmadd_ps(_mm256_set1_ps(triangle.edge_b[i]), py,
+							_mm256_set1_ps(triangle.edge_c[i])));
+		auto covered = _mm256_cmp_ps(edge, _mm256_setzero_ps(), _CMP_GT_OQ);
+		if (triangle.top_left[i])
+			covered = _mm256_or_ps(covered, _mm256_cmp_ps(edge, _mm256_setzero_ps(), _CMP_EQ_OQ));
+		inside	   = _mm256_and_si256(inside, _mm256_castps_si256(covered));
+		weights[i] = _mm256_mul_ps(edge, _mm256_set1_ps(triangle.inverse_w[i]));
+	}
+
+	auto mask = (uint32_t)_mm256_movemask_ps(_mm256_castsi256_ps(inside));
+	if (!mask)
+		return 0;
+
+	auto weight_sum = _mm256_add_ps(_mm256_add_ps(weights[0], weights[1]), weights[2]);
+	auto normalize	= _mm256_div_ps(_mm256_set1_ps(1.0f), weight_sum);
+	__m256 channels[3];
+	for (auto c = 0; c < 3; ++c) {
+		auto sum	= _mm256_mul_ps(weights[0], _mm256_set1_ps(triangle.color[0][c]));
+		sum			= _mm256_fmadd_ps(weights[1], _mm256_set1_ps(triangle.color[1][c]), sum);
+		sum			= _mm256_fmadd_ps(weights[2], _mm256_set1_ps(triangle.color[2][c]), sum);
+		channels[c] = _mm256_mul_ps(sum, normalize);
+	}
+
+	auto pixels = _mm256_or_si256(
+		_mm256_or_si256(PackChannel(channels[0], layout.color_max, layout.red_shift),
+						PackChannel(channels[1], layout.color_max, layout.green_shift)),
+		_mm256_or_si256(PackChannel(channels[2], layout.color_max, layout.blue_shift),
+						PackChannel(_mm256_set1_ps(1.0f), layout.alpha_max, layout.alpha_shift)));
+	_mm256_maskstore_epi32((int*)(row + x), inside, pixels);
+	return (uint32_t)std::popcount(mask);
+}
+#else
+static constexpr uint32_t LANE_COUNT = 1;
+
+static uint32_t PackChannel(float value, float max, uint32_t shift) {
+	return (uint32_t)(std::clamp(value, 0.0f, 1.0f) * max + 0.5f) << shift;
+}
+
+static uint32_t ShadeSpan(const auto& triangle, const ChannelLayout& layout, uint32_t* row,
+						  uint32_t x, uint32_t y, uint32_t) {
+	auto px = (float)x + 0.5f;
+	auto py = (float)y + 0.5f;
+
+	float weights[3];
+	for (auto i = 0; i < 3; ++i) {
+		auto edge = triangle.edge_a[i] * px + triangle.edge_b[i] * py + triangle.edge_c[i];
+		if (edge < 0.0f || (edge == 0.0f && !triangle.top_left[i]))
+			return 0;
+		weights[i] = edge * triangle.inverse_w[i];
+	}
+
+	auto normalize = 1.0f / (weights[0] + weights[1] + weights[2]);
+	float channels[3];
+	for (auto c = 0; c < 3; ++c)
+		channels[c] = (weights[0] * triangle.color[0][c] + weights[1] * triangle.color[1][c]
+					   + weights[2] * triangle.color[2][c])
+					  * normalize;
+
+	row[x] = PackChannel(channels[0], layout.color_max, layout.red_shift)
+			 | PackChannel(channels[1], layout.color_max, layout.green_shift)
+			 | PackChannel(channels[2], layout.color_max, layout.blue_shift)
+			 | PackChannel(1.0f, layout.alpha_max, layout.alpha_shift);
+	return 1;
+}
+#endif
+
+CpuRasterizer::CpuRasterizer(uint32_t thread_count) {
+	for (auto i = 1u; i < std::max(thread_count, 1u); ++i)
+		workers.emplace_back(&CpuRasterizer::RunWorker, this);
+}
+
+CpuRasterizer::~CpuRasterizer() {
+	{
+		std::lock_guard lock{mutex};
+		stopping = true;
+	}
+	dispatched.notify_all();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+void CpuRasterizer::Draw(CpuTexture& render_target, std::span<const MeshVertex> vertices,
+						 const float* mvp) {
+	auto start = std::chrono::steady_clock::now();
+
+	if (target != &render_target || tiles.empty()) {
+		target	= &render_target;
+		tiles_x = (render_target.width + TILE_SIZE - 1) / TILE_SIZE;
+		tiles_y = (render_target.height + TILE_SIZE - 1) / TILE_SIZE;
+		tiles.resize((size_t)tiles_x * tiles_y);
+		for (auto ty = 0u; ty < tiles_y; ++ty)
+			for (auto tx = 0u; tx < tiles_x; ++tx)
+				tiles[(size_t)ty * tiles_x + tx] = Tile{
+					.min_x = tx * TILE_SIZE,
+					.min_y = ty * TILE_SIZE,
+					.max_x = std::min((tx + 1) * TILE_SIZE, render_target.width),
+					.max_y = std::min((ty + 1) * TILE_SIZE, render_target.height),
+				};
+	}
+
+	SetupTriangles(vertices, mvp);
+	BinTriangles();
+
+	{
+		std::lock_guard lock{mutex};
+		next_tile.store(0, std::memory_order_relaxed);
+		busy_workers = (uint32_t)workers.size();
+		++dispatch_generation;
+	}
+	dispatched.notify_all();
+
+	RasterizeTiles();
+
+	{
+		std::unique_lock lock{mutex};
+		finished.wait(lock, [this] { return busy_workers == 0; });
+	}
+
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	raster_nanoseconds.fetch_add(
+		(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+		std::memory_order_relaxed);
+	draw_count.fetch_add(1, std::memory_order_relaxed);
+	triangle_count.fetch_add(triangles.size(), std::memory_order_relaxed);
+}
+
+RasterizerStats CpuRasterizer::GetStats() const {
+	return RasterizerStats{
+		.thread_count		= (uint32_t)workers.size() + 1,
+		.draw_count			= draw_count.load(std::memory_order_relaxed),
+		.triangle_count		= triangle_count.load(std::memory_order_relaxed),
+		.binned_tile_count	= binned_tile_count.load(std::memory_order_relaxed),
+		.shaded_pixels		= shaded_pixels.load(std::memory_order_relaxed),
+		.raster_nanoseconds = raster_nanoseconds.load(std::memory_order_relaxed),
+	};
+}
+
+void CpuRasterizer::SetupTriangles(std::span<const MeshVertex> vertices, const float* mvp) {
+	triangles.clear();
+
+	auto width	= (float)target->width;
+	auto height = (float)target->height;
+
+	for (size_t first = 0; first + 3 <= vertices.size(); first += 3) {
+		float screen_x[3];
+		float screen_y[3];
+		RasterTriangle triangle{};
+
+		auto visible = true;
+		for (auto i = 0; i < 3; ++i) {
+			auto& vertex = vertices[first + i];
+			float clip[4];
+			for (auto r = 0; r < 4; ++r)
+				clip[r] = mvp[r] * vertex.position[0] + mvp[4 + r] * vertex.position[1]
+						  + mvp[8 + r] * vertex.position[2] + mvp[12 + r];
+
+			if (clip[3] <= 0.0f) {
+				visible = false;
+				break;
+			}
+
+			triangle.inverse_w[i] = 1.0f / clip[3];
+			screen_x[i]			  = (clip[0] * triangle.inverse_w[i] * 0.5f + 0.5f) * width;
+			screen_y[i]			  = (0.5f - clip[1] * triangle.inverse_w[i] * 0.5f) * height;
+			std::ranges::copy(vertex.color, triangle.color[i]);
+		}
+		if (!visible)
+			continue;
+
+		auto area = (screen_x[1] - screen_x[0]) * (screen_y[2] - screen_y[0])
+					- (screen_y[1] - screen_y[0]) * (screen_x[2] - screen_x[0]);
+		if (area <= 0.0f)
+			continue;
+
+		for (auto i = 0; i < 3; ++i) {
+			auto j				 = (i + 1) % 3;
+			auto k				 = (i + 2) % 3;
+			triangle.edge_a[i]	 = screen_y[j] - screen_y[k];
+			triangle.edge_b[i]	 = screen_x[k] - screen_x[j];
+			triangle.edge_c[i]	 = screen_y[k] * screen_x[j] - screen_x[k] * screen_y[j];
+			triangle.top_left[i] = triangle.edge_a[i] > 0.0f
+								   || (triangle.edge_a[i] == 0.0f && triangle.edge_b[i] > 0.0f);
+		}
+
+		auto [min_x, max_x] = std::ranges::minmax(screen_x);
+		auto [min_y, max_y] = std::ranges::minmax(screen_y);
+		triangle.min_x		= (uint32_t)std::clamp(std::floor(min_x), 0.0f, width);
+		triangle.min_y		= (uint32_t)std::clamp(std::floor(min_y), 0.0f, height);
+		triangle.max_x		= (uint32_t)std::clamp(std::ceil(max_x), 0.0f, width);
+		triangle.max_y		= (uint32_t)std::clamp(std::ceil(max_y), 0.0f, height);
+		if (triangle.min_x >= triangle.max_x || triangle.min_y >= triangle.max_y)
+			continue;
+
+		triangles.push_back(triangle);
+	}
+}
+
+void CpuRasterizer::BinTriangles() {
+	for (auto& tile : tiles)
+		tile.triangles.clear();
+
+	uint64_t binned = 0;
+	for (auto index = 0u; index < (uint32_t)triangles.size(); ++index) {
+		auto& triangle = triangles[index];
+		for (auto ty = triangle.min_y / TILE_SIZE; ty <= (triangle.max_y - 1) / TILE_SIZE; ++ty) {
+			for (auto tx = triangle.min_x / TILE_SIZE; tx <= (triangle.max_x - 1) / TILE_SIZE;
+				 ++tx) {
+				auto& tile = tiles[(size_t)ty * tiles_x + tx];
+				if (!TriangleTouchesTile(triangle, tile))
+					continue;
+
+				tile.triangles.push_back(index);
+				++binned;
+			}
+		}
+	}
+	binned_tile_count.fetch_add(binned, std::memory_order_relaxed);
+}
+
+bool CpuRasterizer::TriangleTouchesTile(const RasterTriangle& triangle, const Tile& tile) const {
+	for (auto i = 0; i < 3; ++i) {
+		auto corner_x = (float)(triangle.edge_a[i] > 0.0f ? tile.max_x : tile.min_x);
+		auto corner_y = (float)(triangle.edge_b[i] > 0.0f ? tile.max_y : tile.min_y);
+		auto edge	  = triangle.edge_a[i] * corner_x + triangle.edge_b[i] * corner_y
+					+ triangle.edge_c[i];
+		if (edge < 0.0f)
+			return false;
+	}
+	return true;
+}
+
+void CpuRasterizer::RasterizeTiles() {
+	for (;;) {
+		auto index = next_tile.fetch_add(1, std::memory_order_relaxed);
+		if (index >= tiles.size())
+			return;
+		if (!tiles[index].triangles.empty())
+			RasterizeTile(tiles[index]);
+	}
+}
+
+void CpuRasterizer::RasterizeTile(const Tile& tile) {
+	auto layout		= GetChannelLayout(target->format);
+	uint64_t shaded	= 0;
+
+	for (auto index : tile.triangles) {
+		auto& triangle = triangles[index];
+		auto min_x	   = std::max(tile.min_x, triangle.min_x);
+		auto max_x	   = std::min(tile.max_x, triangle.max_x);
+		auto min_y	   = std::max(tile.min_y, triangle.min_y);
+		auto max_y	   = std::min(tile.max_y, triangle.max_y);
+
+		for (auto y = min_y; y < max_y; ++y) {
+			auto row = target->pixels.data() + (size_t)y * target->width;
+			for (auto x = min_x; x < max_x; x += LANE_COUNT)
+				shaded += ShadeSpan(triangle, layout, row, x, y, max_x - x);
+		}
+	}
+
+	shaded_pixels.fetch_add(shaded, std::memory_order_relaxed);
+}
+
+void CpuRasterizer::RunWorker() {
+	uint64_t seen_generation = 0;
+	for (;;) {
+		{
+			std::unique_lock lock{mutex};
+			dispatched.wait(lock, [this, seen_generation] {
+				return stopping || dispatch_generation != seen_generation;
+			});
+			if (stopping)
+				return;
+			seen_generation = dispatch_generation;
+		}
+
+		RasterizeTiles();
+
+		{
+			std::lock_guard lock{mutex};
+			if (--busy_workers == 0)
+				finished.notify_one();
+		}
+	}
+}
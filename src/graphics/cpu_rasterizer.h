@@ -0,0 +1,83 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include "graphics/render_types.h"
+
+struct CpuTexture;
+
+struct RasterizerStats {
+	uint32_t thread_count;
+	uint64_t draw_count;
+	uint64_t triangle_count;
+	uint64_t binned_tile_count;
+	uint64_t shaded_pixels;
+	uint64_t raster_nanoseconds;
+};
+
+class CpuRasterizer {
+  public:
+	static constexpr uint32_t TILE_SIZE = 64;
+
+	explicit CpuRasterizer(uint32_t thread_count);
+	~CpuRasterizer();
+
+	void Draw(CpuTexture& target, std::span<const MeshVertex> vertices, const float* mvp);
+	RasterizerStats GetStats() const;
+
+  private:
+	struct RasterTriangle {
+		float edge_a[3];
+		float edge_b[3];
+		float edge_c[3];
+		bool top_left[3];
+		float inverse_w[3];
+		float color[3][3];
+		uint32_t min_x;
+		uint32_t min_y;
+		uint32_t max_x;
+		uint32_t max_y;
+	};
+
+	struct Tile {
+		uint32_t min_x;
+		uint32_t min_y;
+		uint32_t max_x;
+		uint32_t max_y;
+		std::vector<uint32_t> triangles;
+	};
+
+	void SetupTriangles(std::span<const MeshVertex> vertices, const float* mvp);
+	void BinTriangles();
+	bool TriangleTouchesTile(const RasterTriangle& triangle, const Tile& tile) const;
+	void RasterizeTiles();
+	void RasterizeTile(const Tile& tile);
+	void RunWorker();
+
+	CpuTexture* target = nullptr;
+	uint32_t tiles_x   = 0;
+	uint32_t tiles_y   = 0;
+	std::vector<RasterTriangle> triangles;
+	std::vector<Tile> tiles;
+
+	std::atomic<uint32_t> next_tile			 = 0;
+	std::atomic<uint64_t> shaded_pixels		 = 0;
+	std::atomic<uint64_t> draw_count		 = 0;
+	std::atomic<uint64_t> triangle_count	 = 0;
+	std::atomic<uint64_t> binned_tile_count	 = 0;
+	std::atomic<uint64_t> raster_nanoseconds = 0;
+
+	std::mutex mutex;
+	std::condition_variable dispatched;
+	std::condition_variable finished;
+	uint64_t dispatch_generation = 0;
+	uint32_t busy_workers		 = 0;
+	bool stopping				 = false;
+	std::vector<std::thread> workers;
+};
@@ -0,0 +1,26 @@
+#include "graphics/cpu_swap_chain.h"
+
+CpuSwapChain::CpuSwapChain(CpuDevice& dev, uint32_t width, uint32_t height,
+						   const SwapChainConfig& config)
+	: frame_latency_waitable(CreateCountingSemaphore(config.buffer_count, config.buffer_count))
+	, device(dev)
+	, buffer_count(config.buffer_count) {
+	for (auto i = 0u; i < buffer_count; ++i)
+		render_targets.push_back(new CpuTexture{width, height, config.render_target_format});
+}
+
+CpuSwapChain::~CpuSwapChain() {
+	for (auto render_target : render_targets)
+		delete render_target;
+	CloseEventHandle(frame_latency_waitable);
+}
+
+PresentResult CpuSwapChain::Present() {
+	device.command_queue.Present(frame_latency_waitable);
+	back_buffer_index = (back_buffer_index + 1) % buffer_count;
+	return PresentResult::Presented;
+}
+
+uint32_t CpuSwapChain::GetCurrentBackBufferIndex() const {
+	return back_buffer_index;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+#include "graphics/render_types.h"
+#include "platform_event.h"
+
+class CpuSwapChain {
+  public:
+	CpuSwapChain(CpuDevice& device, uint32_t width, uint32_t height, const SwapChainConfig& config);
+	~CpuSwapChain();
+
+	PresentResult Present();
+	uint32_t GetCurrentBackBufferIndex() const;
+
+	EventHandle frame_latency_waitable;
+	std::vector<CpuTexture*> render_targets;
+
+  private:
+	CpuDevice& device;
+	uint32_t buffer_count;
+	uint32_t back_buffer_index = 0;
+};
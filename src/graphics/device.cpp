@@ -1,5 +1,6 @@
 #include "device.h"
 
+#include "graphics/frame_resources.h"
 #include "try.h"
 
 D3D12Device::D3D12Device() {
@@ -38,3 +39,66 @@ void D3D12Device::CreateCommandQueue() {
 	Try | device->CreateCommandQueue(&queue_desc, IID_PPV_ARGS(&command_queue));
 }
 
+void D3D12Device::Execute(std::span<const D3D12CommandList> command_lists) {
+	submitted_command_lists.clear();
+	for (auto& command_list : command_lists)
+		submitted_command_lists.push_back((ID3D12CommandList*)command_list.command_list.Get());
+	command_queue->ExecuteCommandLists((UINT)submitted_command_lists.size(),
+									   submitted_command_lists.data());
+}
+
+void D3D12Device::Signal(ID3D12Fence* fence, uint64_t value, HANDLE event) {
+	Try | command_queue->Signal(fence, value) | fence->SetEventOnCompletion(value, event);
+}
+
+D3D12PlacedResource D3D12Device::CreateResource(const D3D12_RESOURCE_DESC& desc,
+												D3D12_HEAP_TYPE heap_type,
+												D3D12_RESOURCE_STATES initial_state,
+												const D3D12_CLEAR_VALUE* clear_value) {
+	return heap_allocator.CreateResource(*&device, desc, heap_type, initial_state, clear_value);
+}
+
+DXGI_FORMAT ToDxgiFormat(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::B8G8R8A8Unorm:
+			return DXGI_FORMAT_B8G8R8A8_UNORM;
+		case TextureFormat::R8G8B8A8Unorm:
+			return DXGI_FORMAT_R8G8B8A8_UNORM;
+		case TextureFormat::R10G10B10A2Unorm:
+			return DXGI_FORMAT_R10G10B10A2_UNORM;
+		case TextureFormat::NV12:
+			return DXGI_FORMAT_NV12;
+		case TextureFormat::P010:
+			return DXGI_FORMAT_P010;
+	}
+	throw;
+}
+
+D3D12_RESOURCE_STATES ToResourceStates(ResourceState state) {
+	switch (state) {
+		case ResourceState::Common:
+			return D3D12_RESOURCE_STATE_COMMON;
+		case ResourceState::RenderTarget:
+			return D3D12_RESOURCE_STATE_RENDER_TARGET;
+		case ResourceState::CopySource:
+			return D3D12_RESOURCE_STATE_COPY_SOURCE;
+		case ResourceState::CopyDest:
+			return D3D12_RESOURCE_STATE_COPY_DEST;
+		case ResourceState::Present:
+			return D3D12_RESOURCE_STATE_PRESENT;
+	}
+	throw;
+}
+
+D3D12_RESOURCE_DESC GetBufferDesc(uint64_t size) {
+	return D3D12_RESOURCE_DESC{
+		.Dimension		  = D3D12_RESOURCE_DIMENSION_BUFFER,
+		.Width			  = size,
+		.Height			  = 1,
+		.DepthOrArraySize = 1,
+		.MipLevels		  = 1,
+		.Format			  = DXGI_FORMAT_UNKNOWN,
+		.SampleDesc		  = {.Count = 1},
+		.Layout			  = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
+	};
+}
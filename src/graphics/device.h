@@ -5,19 +5,39 @@
 #include <wrl/client.h>
 
 #include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/heap_allocator.h"
+#include "graphics/render_types.h"
 
 using Microsoft::WRL::ComPtr;
 
+class D3D12CommandList;
+
 class D3D12Device {
   public:
 	D3D12Device();
 
+	void Execute(std::span<const D3D12CommandList> command_lists);
+	void Signal(ID3D12Fence* fence, uint64_t value, HANDLE event);
+	D3D12PlacedResource CreateResource(const D3D12_RESOURCE_DESC& desc, D3D12_HEAP_TYPE heap_type,
+									   D3D12_RESOURCE_STATES initial_state,
+									   const D3D12_CLEAR_VALUE* clear_value = nullptr);
+
 	ComPtr<IDXGIFactory7> factory;
 	ComPtr<IDXGIAdapter4> adapter;
 	ComPtr<ID3D12Device> device;
 	ComPtr<ID3D12CommandQueue> command_queue;
+	D3D12HeapAllocator heap_allocator;
 
   private:
 	void CreateDevice();
 	void CreateCommandQueue();
+
+	std::vector<ID3D12CommandList*> submitted_command_lists;
 };
+
+DXGI_FORMAT ToDxgiFormat(TextureFormat format);
+D3D12_RESOURCE_STATES ToResourceStates(ResourceState state);
+D3D12_RESOURCE_DESC GetBufferDesc(uint64_t size);
@@ -0,0 +1,10 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+struct EmbeddedShader {
+	std::span<const uint8_t> bytecode;
+	uint64_t source_hash;
+	uint64_t bytecode_hash;
+};
@@ -2,37 +2,207 @@
 
 #include <wrl/client.h>
 
+#include <algorithm>
+
+#include "graphics/mesh.h"
+#include "graphics/pipeline.h"
 #include "try.h"
 
 using Microsoft::WRL::ComPtr;
 
-D3D12FrameResources::D3D12FrameResources(ID3D12Device* device, uint32_t count) {
-	command_lists.resize(count);
+D3D12UploadBuffer::D3D12UploadBuffer(D3D12Device& device, uint32_t size)
+	: placed(device.CreateResource(GetBufferDesc(size), D3D12_HEAP_TYPE_UPLOAD,
+								   D3D12_RESOURCE_STATE_GENERIC_READ)) {
+	D3D12_RANGE range{.Begin = 0, .End = 0};
+	Try | placed.resource->Map(0, &range, (void**)&mapped);
+}
+
+D3D12UploadBuffer::~D3D12UploadBuffer() {
+	if (placed.resource && mapped)
+		placed.resource->Unmap(0, nullptr);
+}
+
+D3D12ReadbackBuffer::D3D12ReadbackBuffer(D3D12Device& device, uint32_t size)
+	: placed(device.CreateResource(GetBufferDesc(size), D3D12_HEAP_TYPE_READBACK,
+								   D3D12_RESOURCE_STATE_COPY_DEST)) {
+	Try | placed.resource->Map(0, nullptr, (void**)&mapped);
+}
+
+D3D12ReadbackBuffer::~D3D12ReadbackBuffer() {
+	if (placed.resource && mapped) {
+		D3D12_RANGE range{.Begin = 0, .End = 0};
+		placed.resource->Unmap(0, &range);
+	}
+}
+
+D3D12CommandList::D3D12CommandList(ID3D12Device4* device, ID3D12CommandAllocator* allocator)
+	: allocator(allocator) {
+	Try
+		| device->CreateCommandList1(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
+									 D3D12_COMMAND_LIST_FLAG_NONE, IID_PPV_ARGS(&command_list));
+}
+
+void D3D12CommandList::Reset() {
+	Try | allocator->Reset() | command_list->Reset(allocator, nullptr);
+}
+
+static D3D12_RESOURCE_BARRIER_FLAGS ToBarrierFlags(BarrierSplit split) {
+	switch (split) {
+		case BarrierSplit::None:
+			return D3D12_RESOURCE_BARRIER_FLAG_NONE;
+		case BarrierSplit::Begin:
+			return D3D12_RESOURCE_BARRIER_FLAG_BEGIN_ONLY;
+		case BarrierSplit::End:
+			return D3D12_RESOURCE_BARRIER_FLAG_END_ONLY;
+	}
+	throw;
+}
+
+void D3D12CommandList::Barrier(std::span<const TextureTransition<ID3D12Resource>> transitions) {
+	D3D12_RESOURCE_BARRIER barriers[MAX_BATCHED_BARRIERS];
+	while (!transitions.empty()) {
+		auto batch = transitions.first(std::min(transitions.size(), (size_t)MAX_BATCHED_BARRIERS));
+		for (auto i = 0u; i < batch.size(); ++i)
+			barriers[i] = D3D12_RESOURCE_BARRIER{
+				.Type		= D3D12_RESOURCE_BARRIER_TYPE_TRANSITION,
+				.Flags		= ToBarrierFlags(batch[i].split),
+				.Transition = {
+					.pResource	 = batch[i].texture,
+					.Subresource = batch[i].subresource,
+					.StateBefore = ToResourceStates(batch[i].before),
+					.StateAfter	 = ToResourceStates(batch[i].after),
+				},
+			};
+		command_list->ResourceBarrier((UINT)batch.size(), barriers);
+		transitions = transitions.subspan(batch.size());
+	}
+}
+
+void D3D12CommandList::AliasingBarrier(ID3D12Resource* before, ID3D12Resource* after) {
+	D3D12_RESOURCE_BARRIER barrier{
+		.Type	  = D3D12_RESOURCE_BARRIER_TYPE_ALIASING,
+		.Flags	  = D3D12_RESOURCE_BARRIER_FLAG_NONE,
+		.Aliasing = {.pResourceBefore = before, .pResourceAfter = after},
+	};
+	command_list->ResourceBarrier(1, &barrier);
+}
+
+void D3D12CommandList::SetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE render_target_view,
+									   uint32_t width, uint32_t height) {
+	command_list->OMSetRenderTargets(1, &render_target_view, FALSE, nullptr);
+
+	D3D12_VIEWPORT viewport{.TopLeftX = 0.0f,
+							.TopLeftY = 0.0f,
+							.Width	  = (float)width,
+							.Height	  = (float)height,
+							.MinDepth = 0.0f,
+							.MaxDepth = 1.0f};
+	D3D12_RECT scissor{.left = 0, .top = 0, .right = (LONG)width, .bottom = (LONG)height};
+	command_list->RSSetViewports(1, &viewport);
+	command_list->RSSetScissorRects(1, &scissor);
+}
+
+void D3D12CommandList::SetPipeline(const D3D12Pipeline& pipeline) {
+	command_list->SetGraphicsRootSignature(pipeline.GetRootSignature());
+	command_list->SetPipelineState(pipeline.GetPipelineState());
+}
+
+void D3D12CommandList::SetConstants(D3D12_GPU_VIRTUAL_ADDRESS address) {
+	command_list->SetGraphicsRootConstantBufferView(0, address);
+}
+
+void D3D12CommandList::Clear(D3D12_CPU_DESCRIPTOR_HANDLE render_target_view, const float* color) {
+	command_list->ClearRenderTargetView(render_target_view, color, 0, nullptr);
+}
+
+void D3D12CommandList::Draw(const D3D12Mesh& mesh) {
+	mesh.Draw(*&command_list);
+}
+
+void D3D12CommandList::Copy(ID3D12Resource* destination, ID3D12Resource* source) {
+	command_list->CopyResource(destination, source);
+}
+
+void D3D12CommandList::CopyBufferToTexture(ID3D12Resource* destination,
+										   const D3D12UploadBuffer& source,
+										   const TextureFootprint& footprint) {
+	CopyTexturePlanes(destination, *&source.placed.resource, footprint, true);
+}
+
+void D3D12CommandList::CopyTextureToBuffer(D3D12ReadbackBuffer& destination,
+										   ID3D12Resource* source,
+										   const TextureFootprint& footprint) {
+	CopyTexturePlanes(source, *&destination.placed.resource, footprint, false);
+}
+
+void D3D12CommandList::CopyTexturePlanes(ID3D12Resource* texture, ID3D12Resource* buffer,
+										 const TextureFootprint& footprint, bool upload) {
+	auto planar = IsPlanarFormat(footprint.format);
+	auto luma_format
+		= footprint.format == TextureFormat::NV12 ? DXGI_FORMAT_R8_UNORM : DXGI_FORMAT_R16_UNORM;
+	auto chroma_format = footprint.format == TextureFormat::NV12 ? DXGI_FORMAT_R8G8_UNORM
+																 : DXGI_FORMAT_R16G16_UNORM;
+
+	for (auto plane = 0u; plane < (planar ? 2u : 1u); ++plane) {
+		auto format
+			= planar ? (plane ? chroma_format : luma_format) : ToDxgiFormat(footprint.format);
+		D3D12_TEXTURE_COPY_LOCATION texture_location{
+			.pResource		  = texture,
+			.Type			  = D3D12_TEXTURE_COPY_TYPE_SUBRESOURCE_INDEX,
+			.SubresourceIndex = plane,
+		};
+		D3D12_TEXTURE_COPY_LOCATION buffer_location{
+			.pResource		 = buffer,
+			.Type			 = D3D12_TEXTURE_COPY_TYPE_PLACED_FOOTPRINT,
+			.PlacedFootprint = {
+				.Offset	   = footprint.offset + (plane ? footprint.chroma_offset : 0),
+				.Footprint = {
+					.Format	  = format,
+					.Width	  = plane ? (footprint.width + 1) / 2 : footprint.width,
+					.Height	  = plane ? (footprint.height + 1) / 2 : footprint.height,
+					.Depth	  = 1,
+					.RowPitch = footprint.row_pitch,
+				},
+			},
+		};
+		if (upload)
+			command_list->CopyTextureRegion(&texture_location, 0, 0, 0, &buffer_location, nullptr);
+		else
+			command_list->CopyTextureRegion(&buffer_location, 0, 0, 0, &texture_location, nullptr);
+	}
+}
+
+void D3D12CommandList::Close() {
+	Try | command_list->Close();
+}
+
+D3D12FrameResources::D3D12FrameResources(D3D12Device& device, uint32_t count,
+										 uint32_t lists_per_frame)
+	: lists_per_frame(lists_per_frame) {
 	fences.resize(count);
 	fence_events.resize(count);
+	allocators.resize((size_t)count * lists_per_frame);
 
 	ComPtr<ID3D12Device4> device4;
-	Try | device->QueryInterface(IID_PPV_ARGS(&device4));
+	Try | device.device->QueryInterface(IID_PPV_ARGS(&device4));
 
 	for (auto i = 0u; i < count; ++i) {
 		fence_events[i] = CreateEvent(nullptr, FALSE, FALSE, nullptr);
 		if (!fence_events[i])
 			throw;
 
-		ID3D12GraphicsCommandList1* command_list1 = nullptr;
-		Try | device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fences[i]))
-			| device4->CreateCommandList1(0, D3D12_COMMAND_LIST_TYPE_DIRECT,
-										  D3D12_COMMAND_LIST_FLAG_NONE,
-										  IID_PPV_ARGS(&command_list1));
-		command_lists[i] = (ID3D12GraphicsCommandList*)command_list1;
+		Try | device.device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fences[i]));
+	}
+
+	for (auto& allocator : allocators) {
+		Try
+			| device.device->CreateCommandAllocator(D3D12_COMMAND_LIST_TYPE_DIRECT,
+													IID_PPV_ARGS(&allocator));
+		command_lists.emplace_back(*&device4, *&allocator);
 	}
 }
 
 D3D12FrameResources::~D3D12FrameResources() {
-	for (auto command_list : command_lists)
-		if (command_list)
-			command_list->Release();
-
 	for (auto fence : fences)
 		if (fence)
 			fence->Release();
@@ -5,49 +5,128 @@
 
 #include <cstddef>
 #include <cstdint>
+#include <span>
+#include <utility>
 #include <vector>
 
+#include "graphics/device.h"
+#include "graphics/render_types.h"
 #include "try.h"
 
-struct RenderTextureArray {
-	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures;
+class D3D12Mesh;
+class D3D12Pipeline;
 
-	RenderTextureArray(ID3D12Device* device, uint32_t count, uint32_t width, uint32_t height,
-					   DXGI_FORMAT format) {
-		D3D12_HEAP_PROPERTIES default_heap_props{
-			.Type = D3D12_HEAP_TYPE_DEFAULT,
-		};
+struct D3D12TextureArray {
+	std::vector<D3D12HeapAllocation> allocations;
+	std::vector<Microsoft::WRL::ComPtr<ID3D12Resource>> textures;
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtv_heap;
+	std::vector<D3D12_CPU_DESCRIPTOR_HANDLE> render_target_views;
 
+	D3D12TextureArray(D3D12Device& device, uint32_t count, uint32_t width, uint32_t height,
+					  TextureFormat format) {
 		D3D12_RESOURCE_DESC texture_desc{
 			.Dimension		  = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
 			.Width			  = width,
 			.Height			  = height,
 			.DepthOrArraySize = 1,
 			.MipLevels		  = 1,
-			.Format			  = format,
+			.Format			  = ToDxgiFormat(format),
 			.SampleDesc		  = {.Count = 1},
 			.Flags			  = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
 		};
 
 		D3D12_CLEAR_VALUE clear_value{
-			.Format = format,
+			.Format = texture_desc.Format,
 			.Color	= {0.0f, 0.0f, 0.0f, 1.0f},
 		};
-		for (auto i = 0u; i < count; ++i)
-			Try
-				| device->CreateCommittedResource(&default_heap_props, D3D12_HEAP_FLAG_NONE,
-												  &texture_desc, D3D12_RESOURCE_STATE_COMMON,
-												  &clear_value,
-												  IID_PPV_ARGS(&textures.emplace_back()));
+		for (auto i = 0u; i < count; ++i) {
+			auto placed = device.CreateResource(texture_desc, D3D12_HEAP_TYPE_DEFAULT,
+												D3D12_RESOURCE_STATE_COMMON, &clear_value);
+			allocations.push_back(std::move(placed.allocation));
+			textures.push_back(placed.resource);
+		}
+
+		D3D12_DESCRIPTOR_HEAP_DESC rtv_heap_desc{
+			.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+			.NumDescriptors = count,
+		};
+		Try | device.device->CreateDescriptorHeap(&rtv_heap_desc, IID_PPV_ARGS(&rtv_heap));
+
+		auto rtv_descriptor_size
+			= device.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+		auto rtv = rtv_heap->GetCPUDescriptorHandleForHeapStart();
+		for (auto i = 0u; i < count; ++i) {
+			device.device->CreateRenderTargetView(*&textures[i], nullptr, rtv);
+			render_target_views.push_back(rtv);
+			rtv.ptr += rtv_descriptor_size;
+		}
 	}
 };
 
+struct D3D12UploadBuffer {
+	D3D12PlacedResource placed;
+	uint8_t* mapped = nullptr;
+
+	D3D12UploadBuffer(D3D12Device& device, uint32_t size);
+	~D3D12UploadBuffer();
+
+	D3D12_GPU_VIRTUAL_ADDRESS GetGpuVirtualAddress() const {
+		return placed.resource->GetGPUVirtualAddress();
+	}
+};
+
+struct D3D12ReadbackBuffer {
+	D3D12PlacedResource placed;
+	uint8_t* mapped = nullptr;
+
+	D3D12ReadbackBuffer(D3D12Device& device, uint32_t size);
+	~D3D12ReadbackBuffer();
+};
+
+class D3D12CommandList {
+  public:
+	D3D12CommandList(ID3D12Device4* device, ID3D12CommandAllocator* allocator);
+
+	void Reset();
+	void Barrier(std::span<const TextureTransition<ID3D12Resource>> transitions);
+	void AliasingBarrier(ID3D12Resource* before, ID3D12Resource* after);
+	void SetRenderTarget(D3D12_CPU_DESCRIPTOR_HANDLE render_target_view, uint32_t width,
+						 uint32_t height);
+	void SetPipeline(const D3D12Pipeline& pipeline);
+	void SetConstants(D3D12_GPU_VIRTUAL_ADDRESS address);
+	void Clear(D3D12_CPU_DESCRIPTOR_HANDLE render_target_view, const float* color);
+	void Draw(const D3D12Mesh& mesh);
+	void Copy(ID3D12Resource* destination, ID3D12Resource* source);
+	void CopyBufferToTexture(ID3D12Resource* destination, const D3D12UploadBuffer& source,
+							 const TextureFootprint& footprint);
+	void CopyTextureToBuffer(D3D12ReadbackBuffer& destination, ID3D12Resource* source,
+							 const TextureFootprint& footprint);
+	void Close();
+
+	Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList> command_list;
+
+  private:
+	static constexpr uint32_t MAX_BATCHED_BARRIERS = 16;
+
+	void CopyTexturePlanes(ID3D12Resource* texture, ID3D12Resource* buffer,
+						   const TextureFootprint& footprint, bool upload);
+
+	ID3D12CommandAllocator* allocator;
+};
+
 class D3D12FrameResources {
   public:
-	D3D12FrameResources(ID3D12Device* device, uint32_t count);
+	D3D12FrameResources(D3D12Device& device, uint32_t count, uint32_t lists_per_frame = 1);
 	~D3D12FrameResources();
 
-	std::vector<ID3D12GraphicsCommandList*> command_lists;
+	std::span<D3D12CommandList> GetCommandLists(uint32_t frame) {
+		return std::span{command_lists}.subspan((size_t)frame * lists_per_frame, lists_per_frame);
+	}
+
+	uint32_t lists_per_frame;
+
+	std::vector<Microsoft::WRL::ComPtr<ID3D12CommandAllocator>> allocators;
+	std::vector<D3D12CommandList> command_lists;
 	std::vector<ID3D12Fence*> fences;
 	std::vector<HANDLE> fence_events;
 };
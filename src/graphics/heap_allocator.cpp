@@ -0,0 +1,168 @@
+#include "graphics/heap_allocator.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "try.h"
+
+D3D12HeapAllocation::D3D12HeapAllocation(D3D12HeapAllocator& allocator, uint32_t pool,
+										 HeapPoolAllocation allocation)
+	: allocator(&allocator), pool(pool), allocation(allocation) {
+}
+
+D3D12HeapAllocation::D3D12HeapAllocation(D3D12HeapAllocation&& other)
+	: allocator(std::exchange(other.allocator, nullptr))
+	, pool(other.pool)
+	, allocation(other.allocation) {
+}
+
+D3D12HeapAllocation::~D3D12HeapAllocation() {
+	if (allocator)
+		allocator->Free(pool, allocation);
+}
+
+D3D12HeapAllocator::D3D12HeapAllocator() {
+	D3D12_HEAP_TYPE heap_types[HEAP_TYPE_COUNT]{
+		D3D12_HEAP_TYPE_DEFAULT,
+		D3D12_HEAP_TYPE_UPLOAD,
+		D3D12_HEAP_TYPE_READBACK,
+	};
+
+	for (auto heap_type : heap_types)
+		for (auto category = 0u; category < CATEGORY_COUNT; ++category)
+			for (auto alignment : ALIGNMENT_CLASSES)
+				pools.push_back(Pool{
+					.allocator	= HeapPool{heap_type == D3D12_HEAP_TYPE_DEFAULT
+											   ? DEFAULT_HEAP_BLOCK_SIZE
+											   : HOST_HEAP_BLOCK_SIZE},
+					.heap_type	= heap_type,
+					.heap_flags = GetHeapFlags((ResourceCategory)category),
+					.alignment	= alignment,
+				});
+}
+
+uint32_t D3D12HeapAllocator::GetHeapTypeIndex(D3D12_HEAP_TYPE heap_type) {
+	switch (heap_type) {
+		case D3D12_HEAP_TYPE_DEFAULT:
+			return 0;
+		case D3D12_HEAP_TYPE_UPLOAD:
+			return 1;
+		case D3D12_HEAP_TYPE_READBACK:
+			return 2;
+		default:
+			break;
+	}
+	throw;
+}
+
+D3D12HeapAllocator::ResourceCategory D3D12HeapAllocator::GetResourceCategory(
+	const D3D12_RESOURCE_DESC& desc) {
+	if (desc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER)
+		return ResourceCategory::Buffer;
+	if (desc.Flags
+		& (D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET | D3D12_RESOURCE_FLAG_ALLOW_DEPTH_STENCIL))
+		return ResourceCategory::RenderTarget;
+	return ResourceCategory::Texture;
+}
+
+D3D12_HEAP_FLAGS D3D12HeapAllocator::GetHeapFlags(ResourceCategory category) {
+	switch (category) {
+		case ResourceCategory::Buffer:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS;
+		case ResourceCategory::Texture:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES;
+		case ResourceCategory::RenderTarget:
+			return D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES;
+	}
+	throw;
+}
+
+D3D12PlacedResource D3D12HeapAllocator::CreateResource(ID3D12Device* device,
+													   const D3D12_RESOURCE_DESC& desc,
+													   D3D12_HEAP_TYPE heap_type,
+													   D3D12_RESOURCE_STATES initial_state,
+													   const D3D12_CLEAR_VALUE* clear_value) {
+	auto category	   = GetResourceCategory(desc);
+	auto resource_desc = desc;
+
+	D3D12_RESOURCE_ALLOCATION_INFO info{};
+	if (category == ResourceCategory::Texture && desc.SampleDesc.Count <= 1) {
+		resource_desc.Alignment = D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT;
+		info					= device->GetResourceAllocationInfo(0, 1, &resource_desc);
+	}
+	if (info.Alignment != D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT) {
+		resource_desc.Alignment = 0;
+		info					= device->GetResourceAllocationInfo(0, 1, &resource_desc);
+	}
+	if (info.SizeInBytes == UINT64_MAX)
+		throw;
+
+	auto range = AllocateRange(device, desc, heap_type, info.SizeInBytes, info.Alignment);
+	D3D12PlacedResource placed{.allocation = std::move(range.allocation)};
+	Try
+		| device->CreatePlacedResource(range.heap, range.offset, &resource_desc, initial_state,
+									   clear_value, IID_PPV_ARGS(&placed.resource));
+	return placed;
+}
+
+D3D12HeapRange D3D12HeapAllocator::AllocateRange(ID3D12Device* device,
+												 const D3D12_RESOURCE_DESC& desc,
+												 D3D12_HEAP_TYPE heap_type, uint64_t size,
+												 uint64_t alignment) {
+	auto category		 = GetResourceCategory(desc);
+	auto alignment_class = 0u;
+	while (alignment_class < ALIGNMENT_CLASS_COUNT
+		   && ALIGNMENT_CLASSES[alignment_class] < alignment)
+		++alignment_class;
+	if (alignment_class == ALIGNMENT_CLASS_COUNT)
+		throw;
+
+	auto pool_index = (GetHeapTypeIndex(heap_type) * CATEGORY_COUNT + (uint32_t)category)
+						  * ALIGNMENT_CLASS_COUNT
+					  + alignment_class;
+	auto& pool = pools[pool_index];
+	HeapPoolAllocation allocation;
+	ID3D12Heap* heap;
+	{
+		std::lock_guard lock{mutex};
+		allocation = pool.allocator.Allocate(size, alignment);
+		if (allocation.block == pool.heaps.size()) {
+			auto heap_alignment
+				= std::max(pool.alignment, (uint64_t)D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT);
+			auto heap_size = pool.allocator.blocks[allocation.block].capacity;
+			D3D12_HEAP_DESC heap_desc{
+				.SizeInBytes = (heap_size + heap_alignment - 1) & ~(heap_alignment - 1),
+				.Properties	 = {.Type = pool.heap_type},
+				.Alignment	 = heap_alignment,
+				.Flags		 = pool.heap_flags,
+			};
+
+			Microsoft::WRL::ComPtr<ID3D12Heap> new_heap;
+			Try | device->CreateHeap(&heap_desc, IID_PPV_ARGS(&new_heap));
+			pool.heaps.push_back(new_heap);
+		}
+		heap = pool.heaps[allocation.block].Get();
+	}
+
+	D3D12HeapRange range{
+		.allocation = D3D12HeapAllocation{*this, pool_index, allocation},
+		.heap		= heap,
+		.offset		= allocation.range.offset,
+	};
+	if (!heap)
+		throw;
+	return range;
+}
+
+void D3D12HeapAllocator::Free(uint32_t pool, const HeapPoolAllocation& allocation) {
+	std::lock_guard lock{mutex};
+	pools[pool].allocator.Free(allocation);
+}
+
+HeapPoolStats D3D12HeapAllocator::GetStats() const {
+	std::lock_guard lock{mutex};
+	HeapPoolStats stats{};
+	for (auto& pool : pools)
+		stats = CombineHeapPoolStats(stats, pool.allocator.GetStats());
+	return stats;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "graphics/tlsf_allocator.h"
+
+class D3D12HeapAllocator;
+
+class D3D12HeapAllocation {
+  public:
+	D3D12HeapAllocation(D3D12HeapAllocator& allocator, uint32_t pool,
+						HeapPoolAllocation allocation);
+	D3D12HeapAllocation(D3D12HeapAllocation&& other);
+	D3D12HeapAllocation(const D3D12HeapAllocation&) = delete;
+	~D3D12HeapAllocation();
+
+  private:
+	D3D12HeapAllocator* allocator;
+	uint32_t pool;
+	HeapPoolAllocation allocation;
+};
+
+struct D3D12PlacedResource {
+	D3D12HeapAllocation allocation;
+	Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+};
+
+struct D3D12HeapRange {
+	D3D12HeapAllocation allocation;
+	ID3D12Heap* heap;
+	uint64_t offset;
+};
+
+class D3D12HeapAllocator {
+  public:
+	D3D12HeapAllocator();
+
+	D3D12PlacedResource CreateResource(ID3D12Device* device, const D3D12_RESOURCE_DESC& desc,
+									   D3D12_HEAP_TYPE heap_type,
+									   D3D12_RESOURCE_STATES initial_state,
+									   const D3D12_CLEAR_VALUE* clear_value);
+	D3D12HeapRange AllocateRange(ID3D12Device* device, const D3D12_RESOURCE_DESC& desc,
+								 D3D12_HEAP_TYPE heap_type, uint64_t size, uint64_t alignment);
+	void Free(uint32_t pool, const HeapPoolAllocation& allocation);
+	HeapPoolStats GetStats() const;
+
+  private:
+	enum class ResourceCategory : uint32_t {
+		Buffer,
+		Texture,
+		RenderTarget,
+	};
+
+	static constexpr uint32_t HEAP_TYPE_COUNT		  = 3;
+	static constexpr uint32_t CATEGORY_COUNT		  = 3;
+	static constexpr uint32_t ALIGNMENT_CLASS_COUNT	  = 3;
+	static constexpr uint64_t DEFAULT_HEAP_BLOCK_SIZE = 64ull << 20;
+	static constexpr uint64_t HOST_HEAP_BLOCK_SIZE	  = 16ull << 20;
+
+	static constexpr uint64_t ALIGNMENT_CLASSES[ALIGNMENT_CLASS_COUNT]{
+		D3D12_SMALL_RESOURCE_PLACEMENT_ALIGNMENT,
+		D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT,
+		D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT,
+	};
+
+	struct Pool {
+		HeapPool allocator;
+		D3D12_HEAP_TYPE heap_type;
+		D3D12_HEAP_FLAGS heap_flags;
+		uint64_t alignment;
+		std::vector<Microsoft::WRL::ComPtr<ID3D12Heap>> heaps;
+	};
+
+	static uint32_t GetHeapTypeIndex(D3D12_HEAP_TYPE heap_type);
+	static ResourceCategory GetResourceCategory(const D3D12_RESOURCE_DESC& desc);
+	static D3D12_HEAP_FLAGS GetHeapFlags(ResourceCategory category);
+
+	std::vector<Pool> pools;
+	mutable std::mutex mutex;
+};
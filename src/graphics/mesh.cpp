@@ -1,55 +1,113 @@
 #include "graphics/mesh.h"
 
-#include <array>
+#include <cstddef>
 #include <cstring>
 
 #include "try.h"
 
-D3D12Mesh::D3D12Mesh(ID3D12Device* device) {
-	std::array<Vertex, 3> vertices{
-		Vertex{.position = {0.0f, 0.25f, 0.0f}, .color = {1.0f, 0.0f, 0.0f}},
-		Vertex{.position = {0.25f, -0.25f, 0.0f}, .color = {0.0f, 1.0f, 0.0f}},
-		Vertex{.position = {-0.25f, -0.25f, 0.0f}, .color = {0.0f, 0.0f, 1.0f}},
-	};
+static D3D12PlacedResource CreateUploadBuffer(D3D12Device& device, const void* data, size_t size) {
+	auto buffer = device.CreateResource(GetBufferDesc(size), D3D12_HEAP_TYPE_UPLOAD,
+										D3D12_RESOURCE_STATE_GENERIC_READ);
 
-	vertex_count	 = (uint32_t)vertices.size();
-	auto buffer_size = (UINT)(sizeof(Vertex) * vertices.size());
+	void* mapped = nullptr;
+	D3D12_RANGE range{.Begin = 0, .End = 0};
+	Try | buffer.resource->Map(0, &range, &mapped);
+	memcpy(mapped, data, size);
+	buffer.resource->Unmap(0, nullptr);
+	return buffer;
+}
 
-	D3D12_HEAP_PROPERTIES heap_properties{
-		.Type = D3D12_HEAP_TYPE_UPLOAD,
-	};
+DXGI_FORMAT ToDxgiFormat(MeshStreamFormat format) {
+	switch (format) {
+		case MeshStreamFormat::Float2:
+			return DXGI_FORMAT_R32G32_FLOAT;
+		case MeshStreamFormat::Float3:
+			return DXGI_FORMAT_R32G32B32_FLOAT;
+		case MeshStreamFormat::Unorm16x4:
+			return DXGI_FORMAT_R16G16B16A16_UNORM;
+		case MeshStreamFormat::Snorm16x2:
+			return DXGI_FORMAT_R16G16_SNORM;
+	}
+	throw;
+}
 
-	D3D12_RESOURCE_DESC resource_desc{
-		.Dimension		  = D3D12_RESOURCE_DIMENSION_BUFFER,
-		.Width			  = buffer_size,
-		.Height			  = 1,
-		.DepthOrArraySize = 1,
-		.MipLevels		  = 1,
-		.SampleDesc		  = {.Count = 1},
-		.Layout			  = D3D12_TEXTURE_LAYOUT_ROW_MAJOR,
-	};
+static MeshPositionDecode GetPositionDecode(const MeshFile& mesh_file, MeshStreamFormat format) {
+	if (format != MeshStreamFormat::Unorm16x4)
+		return POSITION_DECODE_IDENTITY;
 
-	Try
-		| device->CreateCommittedResource(&heap_properties, D3D12_HEAP_FLAG_NONE, &resource_desc,
-										  D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-										  IID_PPV_ARGS(&vertex_buffer));
+	auto& bounds = mesh_file.header.bounds;
+	auto decode	 = POSITION_DECODE_IDENTITY;
+	for (auto axis = 0u; axis < 3; ++axis) {
+		decode.offset[axis] = bounds.min[axis];
+		decode.scale[axis]	= bounds.max[axis] - bounds.min[axis];
+	}
+	return decode;
+}
 
-	void* mapped = nullptr;
-	D3D12_RANGE range{.Begin = 0, .End = 0};
-	Try | vertex_buffer->Map(0, &range, &mapped);
-	memcpy(mapped, vertices.data(), buffer_size);
-	vertex_buffer->Unmap(0, nullptr);
-
-	vertex_buffer_view = D3D12_VERTEX_BUFFER_VIEW{
-		.BufferLocation = vertex_buffer->GetGPUVirtualAddress(),
-		.SizeInBytes	= buffer_size,
-		.StrideInBytes	= sizeof(Vertex),
+static const MeshStreamDesc* FindStream(const MeshFile& mesh_file, MeshStreamType type) {
+	for (auto& stream : mesh_file.streams)
+		if (stream.type == type)
+			return &stream;
+	return nullptr;
+}
+
+D3D12Mesh::D3D12Mesh(D3D12Device& device)
+	: vertex_buffer(CreateUploadBuffer(device, TRIANGLE_VERTICES, sizeof(TRIANGLE_VERTICES)))
+	, vertex_count((uint32_t)std::size(TRIANGLE_VERTICES)) {
+	auto address = vertex_buffer.resource->GetGPUVirtualAddress();
+	for (auto offset : {offsetof(MeshVertex, position), offsetof(MeshVertex, color)})
+		vertex_buffer_views.push_back(D3D12_VERTEX_BUFFER_VIEW{
+			.BufferLocation = address + offset,
+			.SizeInBytes	= (UINT)(sizeof(TRIANGLE_VERTICES) - offset),
+			.StrideInBytes	= sizeof(MeshVertex),
+		});
+}
+
+D3D12Mesh::D3D12Mesh(D3D12Device& device, const MeshFile& mesh_file)
+	: vertex_buffer(
+		  CreateUploadBuffer(device, mesh_file.GetPayload().data(), mesh_file.GetPayload().size()))
+	, submeshes(mesh_file.submeshes.begin(), mesh_file.submeshes.end())
+	, vertex_count(mesh_file.header.vertex_count) {
+	auto payload_address = vertex_buffer.resource->GetGPUVirtualAddress();
+	auto payload_offset	 = mesh_file.header.payload_offset;
+
+	auto position_stream = FindStream(mesh_file, MeshStreamType::Position);
+	auto color_stream	 = FindStream(mesh_file, MeshStreamType::Color);
+	if (!position_stream || !color_stream || color_stream->format != MeshStreamFormat::Float3)
+		throw;
+	if (position_stream->format != MeshStreamFormat::Float3
+		&& position_stream->format != MeshStreamFormat::Unorm16x4)
+		throw;
+	position_format = position_stream->format;
+	position_decode = GetPositionDecode(mesh_file, position_format);
+
+	for (auto stream : {position_stream, color_stream})
+		vertex_buffer_views.push_back(D3D12_VERTEX_BUFFER_VIEW{
+			.BufferLocation = payload_address + stream->offset - payload_offset,
+			.SizeInBytes	= (UINT)stream->size,
+			.StrideInBytes	= stream->stride,
+		});
+
+	index_buffer_view = D3D12_INDEX_BUFFER_VIEW{
+		.BufferLocation = payload_address + mesh_file.header.index_offset - payload_offset,
+		.SizeInBytes	= (UINT)mesh_file.header.index_size,
+		.Format = mesh_file.GetIndexStride() == 4 ? DXGI_FORMAT_R32_UINT : DXGI_FORMAT_R16_UINT,
 	};
 }
 
 void D3D12Mesh::Draw(ID3D12GraphicsCommandList* command_list) const {
-	command_list->IASetVertexBuffers(0, 1, &vertex_buffer_view);
+	command_list->IASetVertexBuffers(0, (UINT)vertex_buffer_views.size(),
+									 vertex_buffer_views.data());
 	command_list->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-	command_list->DrawInstanced(vertex_count, 1, 0, 0);
-}
+	command_list->SetGraphicsRoot32BitConstants(1, sizeof(position_decode) / sizeof(float),
+												&position_decode, 0);
 
+	if (submeshes.empty()) {
+		command_list->DrawInstanced(vertex_count, 1, 0, 0);
+		return;
+	}
+
+	command_list->IASetIndexBuffer(&index_buffer_view);
+	for (auto& submesh : submeshes)
+		command_list->DrawIndexedInstanced(submesh.index_count, 1, submesh.index_offset, 0, 0);
+}
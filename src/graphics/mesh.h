@@ -4,25 +4,43 @@
 #include <wrl.h>
 
 #include <cstdint>
+#include <vector>
 
-class D3D12Mesh {
-  public:
-	struct Vertex {
-		float position[3];
-		float color[3];
-	};
+#include "graphics/device.h"
+#include "graphics/mesh_file.h"
+
+struct MeshPositionDecode {
+	float offset[4];
+	float scale[4];
+};
+
+constexpr MeshPositionDecode POSITION_DECODE_IDENTITY{
+	.offset = {0.0f, 0.0f, 0.0f, 0.0f},
+	.scale	= {1.0f, 1.0f, 1.0f, 1.0f},
+};
+
+DXGI_FORMAT ToDxgiFormat(MeshStreamFormat format);
 
-  private:
-	Microsoft::WRL::ComPtr<ID3D12Resource> vertex_buffer;
-	D3D12_VERTEX_BUFFER_VIEW vertex_buffer_view{};
-	uint32_t vertex_count = 0;
+class D3D12Mesh {
+	D3D12PlacedResource vertex_buffer;
+	std::vector<D3D12_VERTEX_BUFFER_VIEW> vertex_buffer_views;
+	D3D12_INDEX_BUFFER_VIEW index_buffer_view{};
+	std::vector<MeshSubmesh> submeshes;
+	MeshStreamFormat position_format   = MeshStreamFormat::Float3;
+	MeshPositionDecode position_decode = POSITION_DECODE_IDENTITY;
+	uint32_t vertex_count			   = 0;
 
   public:
-	D3D12Mesh(ID3D12Device* device);
+	explicit D3D12Mesh(D3D12Device& device);
+	D3D12Mesh(D3D12Device& device, const MeshFile& mesh_file);
 
 	void Draw(ID3D12GraphicsCommandList* command_list) const;
 
 	const D3D12_VERTEX_BUFFER_VIEW& GetView() const {
-		return vertex_buffer_view;
+		return vertex_buffer_views[0];
+	}
+
+	MeshStreamFormat GetPositionFormat() const {
+		return position_format;
 	}
 };
@@ -0,0 +1,356 @@
+#include "graphics/mesh_file.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+static uint64_t AlignUp(uint64_t value) {
+	return (value + MESH_FILE_ALIGNMENT - 1) & ~(MESH_FILE_ALIGNMENT - 1);
+}
+
+static bool IsAligned(uint64_t value) {
+	return (value & (MESH_FILE_ALIGNMENT - 1)) == 0;
+}
+
+static bool RangeFits(uint64_t offset, uint64_t size, uint64_t file_size) {
+	return offset <= file_size && size <= file_size - offset;
+}
+
+static uint32_t GetFormatStride(MeshStreamFormat format) {
+	switch (format) {
+		case MeshStreamFormat::Float2:
+			return 8;
+		case MeshStreamFormat::Float3:
+			return 12;
+		case MeshStreamFormat::Unorm16x4:
+			return 8;
+		case MeshStreamFormat::Snorm16x2:
+			return 4;
+	}
+	throw;
+}
+
+static float SignNotZero(float value) {
+	return value < 0.0f ? -1.0f : 1.0f;
+}
+
+static const float* GetFloat3Attribute(const MeshSourceVertex& vertex, MeshStreamType type) {
+	switch (type) {
+		case MeshStreamType::Position:
+			return vertex.position;
+		case MeshStreamType::Normal:
+			return vertex.normal;
+		case MeshStreamType::Color:
+			return vertex.color;
+		case MeshStreamType::Texcoord:
+			break;
+	}
+	throw;
+}
+
+static MeshBounds ComputeBounds(std::span<const MeshSourceVertex> vertices) {
+	MeshBounds bounds{.min = {INFINITY, INFINITY, INFINITY},
+					  .max = {-INFINITY, -INFINITY, -INFINITY}};
+	for (auto& vertex : vertices) {
+		for (auto axis = 0; axis < 3; ++axis) {
+			bounds.min[axis] = std::min(bounds.min[axis], vertex.position[axis]);
+			bounds.max[axis] = std::max(bounds.max[axis], vertex.position[axis]);
+		}
+	}
+	return bounds;
+}
+
+void QuantizePosition(const float position[3], const MeshBounds& bounds, uint16_t quantized[4]) {
+	for (auto axis = 0; axis < 3; ++axis) {
+		auto extent		= bounds.max[axis] - bounds.min[axis];
+		auto normalized	= extent > 0.0f ? (position[axis] - bounds.min[axis]) / extent : 0.0f;
+		quantized[axis]	= (uint16_t)std::lround(std::clamp(normalized, 0.0f, 1.0f) * 65535.0f);
+	}
+	quantized[3] = 0;
+}
+
+void DequantizePosition(const uint16_t quantized[4], const MeshBounds& bounds, float position[3]) {
+	for (auto axis = 0; axis < 3; ++axis) {
+		auto extent	   = bounds.max[axis] - bounds.min[axis];
+		position[axis] = bounds.min[axis] + (float)quantized[axis] / 65535.0f * extent;
+	}
+}
+
+void EncodeOctahedralNormal(const float normal[3], int16_t encoded[2]) {
+	auto length = std::abs(normal[0]) + std::abs(normal[1]) + std::abs(normal[2]);
+	auto x		= length > 0.0f ? normal[0] / length : 0.0f;
+	auto y		= length > 0.0f ? normal[1] / length : 0.0f;
+	if (normal[2] < 0.0f) {
+		auto folded_x = (1.0f - std::abs(y)) * SignNotZero(x);
+		auto folded_y = (1.0f - std::abs(x)) * SignNotZero(y);
+		x			  = folded_x;
+		y			  = folded_y;
+	}
+	encoded[0] = (int16_t)std::lround(std::clamp(x, -1.0f, 1.0f) * 32767.0f);
+	encoded[1] = (int16_t)std::lround(std::clamp(y, -1.0f, 1.0f) * 32767.0f);
+}
+
+void DecodeOctahedralNormal(const int16_t encoded[2], float normal[3]) {
+	auto x = std::max((float)encoded[0] / 32767.0f, -1.0f);
+	auto y = std::max((float)encoded[1] / 32767.0f, -1.0f);
+	auto z = 1.0f - std::abs(x) - std::abs(y);
+	if (z < 0.0f) {
+		auto unfolded_x = (1.0f - std::abs(y)) * SignNotZero(x);
+		auto unfolded_y = (1.0f - std::abs(x)) * SignNotZero(y);
+		x				= unfolded_x;
+		y				= unfolded_y;
+	}
+	auto inverse_length = 1.0f / std::sqrt(x * x + y * y + z * z);
+	normal[0]			= x * inverse_length;
+	normal[1]			= y * inverse_length;
+	normal[2]			= z * inverse_length;
+}
+
+MeshFile::MeshFile(const char* path)
+	: file(path), header(*(const MeshFileHeader*)file.data) {
+	if (file.size < sizeof(MeshFileHeader) || header.magic != MESH_FILE_MAGIC
+		|| header.version_major != MESH_FILE_VERSION_MAJOR || header.file_size != file.size)
+		throw;
+
+	if (!IsAligned(header.stream_table_offset) || !IsAligned(header.submesh_table_offset)
+		|| !IsAligned(header.payload_offset) || !IsAligned(header.index_offset)
+		|| !RangeFits(header.stream_table_offset,
+					  (uint64_t)header.stream_count * sizeof(MeshStreamDesc), file.size)
+		|| !RangeFits(header.submesh_table_offset,
+					  (uint64_t)header.submesh_count * sizeof(MeshSubmesh), file.size)
+		|| !RangeFits(header.index_offset, header.index_size, file.size)
+		|| header.index_size != (uint64_t)header.index_count * GetIndexStride())
+		throw;
+
+	streams	  = {(const MeshStreamDesc*)(file.data + header.stream_table_offset),
+				 header.stream_count};
+	submeshes = {(const MeshSubmesh*)(file.data + header.submesh_table_offset),
+				 header.submesh_count};
+
+	for (auto& stream : streams) {
+		if (!IsAligned(stream.offset) || stream.offset < header.payload_offset
+			|| stream.stride != GetFormatStride(stream.format)
+			|| stream.size != (uint64_t)stream.stride * header.vertex_count
+			|| !RangeFits(stream.offset, stream.size, file.size))
+			throw;
+	}
+
+	for (auto& submesh : submeshes) {
+		if ((uint64_t)submesh.index_offset + submesh.index_count > header.index_count
+			|| (uint64_t)submesh.vertex_offset + submesh.vertex_count > header.vertex_count)
+			throw;
+	}
+
+	if (header.version_minor >= 1 && header.meshlet_count) {
+		if (!IsAligned(header.meshlet_table_offset) || !IsAligned(header.meshlet_vertex_offset)
+			|| !IsAligned(header.meshlet_triangle_offset)
+			|| !RangeFits(header.meshlet_table_offset,
+						  (uint64_t)header.meshlet_count * sizeof(Meshlet), file.size))
+			throw;
+
+		meshlets = {(const Meshlet*)(file.data + header.meshlet_table_offset),
+					header.meshlet_count};
+
+		uint64_t vertex_end	  = 0;
+		uint64_t triangle_end = 0;
+		for (auto& meshlet : meshlets) {
+			auto last_vertex   = (uint64_t)meshlet.vertex_offset + meshlet.vertex_count;
+			auto last_triangle = (uint64_t)meshlet.triangle_offset + meshlet.triangle_count;
+			vertex_end		   = std::max(vertex_end, last_vertex);
+			triangle_end	   = std::max(triangle_end, last_triangle * 3);
+		}
+		if (!RangeFits(header.meshlet_vertex_offset, vertex_end * sizeof(uint32_t), file.size)
+			|| !RangeFits(header.meshlet_triangle_offset, triangle_end, file.size))
+			throw;
+
+		meshlet_vertices  = {(const uint32_t*)(file.data + header.meshlet_vertex_offset),
+							 (size_t)vertex_end};
+		meshlet_triangles = {file.data + header.meshlet_triangle_offset, (size_t)triangle_end};
+
+		for (auto vertex : meshlet_vertices)
+			if (vertex >= header.vertex_count)
+				throw;
+	}
+
+	file.Prefetch(header.payload_offset, file.size - header.payload_offset);
+}
+
+std::span<const uint8_t> MeshFile::GetStreamData(const MeshStreamDesc& stream) const {
+	return {file.data + stream.offset, (size_t)stream.size};
+}
+
+std::span<const uint8_t> MeshFile::GetIndexData() const {
+	return {file.data + header.index_offset, (size_t)header.index_size};
+}
+
+std::span<const uint8_t> MeshFile::GetPayload() const {
+	return {file.data + header.payload_offset, (size_t)(file.size - header.payload_offset)};
+}
+
+uint32_t MeshFile::GetIndexStride() const {
+	return header.flags & MESH_FILE_INDEX_32 ? 4 : 2;
+}
+
+MeshSourceData ReadMeshSourceData(const MeshFile& mesh_file) {
+	MeshSourceData mesh{
+		.vertices		   = std::vector<MeshSourceVertex>(mesh_file.header.vertex_count),
+		.submeshes		   = {mesh_file.submeshes.begin(), mesh_file.submeshes.end()},
+		.meshlets		   = {mesh_file.meshlets.begin(), mesh_file.meshlets.end()},
+		.meshlet_vertices  = {mesh_file.meshlet_vertices.begin(),
+							  mesh_file.meshlet_vertices.end()},
+		.meshlet_triangles = {mesh_file.meshlet_triangles.begin(),
+							  mesh_file.meshlet_triangles.end()},
+	};
+
+	for (auto& stream : mesh_file.streams) {
+		auto source = mesh_file.GetStreamData(stream).data();
+		for (auto& vertex : mesh.vertices) {
+			switch (stream.format) {
+				case MeshStreamFormat::Unorm16x4:
+					DequantizePosition((const uint16_t*)source, mesh_file.header.bounds,
+									   vertex.position);
+					break;
+				case MeshStreamFormat::Snorm16x2:
+					DecodeOctahedralNormal((const int16_t*)source, vertex.normal);
+					break;
+				case MeshStreamFormat::Float2:
+					memcpy(vertex.texcoord, source, sizeof(vertex.texcoord));
+					break;
+				case MeshStreamFormat::Float3:
+					memcpy((float*)GetFloat3Attribute(vertex, stream.type), source,
+						   sizeof(float[3]));
+					break;
+			}
+			source += stream.stride;
+		}
+	}
+
+	auto indices = mesh_file.GetIndexData().data();
+	mesh.indices.resize(mesh_file.header.index_count);
+	for (auto i = 0u; i < mesh_file.header.index_count; ++i)
+		mesh.indices[i] = mesh_file.GetIndexStride() == 4 ? ((const uint32_t*)indices)[i]
+														  : ((const uint16_t*)indices)[i];
+	return mesh;
+}
+
+void WriteMeshFile(const char* path, const MeshSourceData& mesh, uint32_t flags) {
+	auto vertex_count = (uint32_t)mesh.vertices.size();
+	if (vertex_count > 0x10000)
+		flags |= MESH_FILE_INDEX_32;
+	auto index_stride = flags & MESH_FILE_INDEX_32 ? 4u : 2u;
+
+	auto position_format = flags & MESH_FILE_QUANTIZED_POSITIONS ? MeshStreamFormat::Unorm16x4
+																 : MeshStreamFormat::Float3;
+	auto normal_format	 = flags & MESH_FILE_OCTAHEDRAL_NORMALS ? MeshStreamFormat::Snorm16x2
+																: MeshStreamFormat::Float3;
+
+	MeshStreamDesc streams[]{
+		MeshStreamDesc{.type = MeshStreamType::Position, .format = position_format},
+		MeshStreamDesc{.type = MeshStreamType::Normal, .format = normal_format},
+		MeshStreamDesc{.type = MeshStreamType::Color, .format = MeshStreamFormat::Float3},
+		MeshStreamDesc{.type = MeshStreamType::Texcoord, .format = MeshStreamFormat::Float2},
+	};
+
+	auto submeshes = mesh.submeshes;
+	if (submeshes.empty())
+		submeshes.push_back(MeshSubmesh{.index_count  = (uint32_t)mesh.indices.size(),
+										.vertex_count = vertex_count});
+
+	MeshFileHeader header{
+		.magic				  = MESH_FILE_MAGIC,
+		.version_major		  = MESH_FILE_VERSION_MAJOR,
+		.version_minor		  = MESH_FILE_VERSION_MINOR,
+		.flags				  = flags,
+		.vertex_count		  = vertex_count,
+		.index_count		  = (uint32_t)mesh.indices.size(),
+		.stream_count		  = (uint32_t)std::size(streams),
+		.submesh_count		  = (uint32_t)submeshes.size(),
+		.stream_table_offset  = sizeof(MeshFileHeader),
+		.submesh_table_offset = AlignUp(sizeof(MeshFileHeader) + sizeof(streams)),
+		.bounds				  = ComputeBounds(mesh.vertices),
+	};
+
+	header.payload_offset
+		= AlignUp(header.submesh_table_offset + submeshes.size() * sizeof(MeshSubmesh));
+
+	auto offset = header.payload_offset;
+	for (auto& stream : streams) {
+		stream.stride = GetFormatStride(stream.format);
+		stream.offset = offset;
+		stream.size	  = (uint64_t)stream.stride * vertex_count;
+		offset		  = AlignUp(offset + stream.size);
+	}
+	header.index_offset = offset;
+	header.index_size	= (uint64_t)index_stride * mesh.indices.size();
+	offset				= AlignUp(header.index_offset + header.index_size);
+
+	if (!mesh.meshlets.empty()) {
+		header.meshlet_count		   = (uint32_t)mesh.meshlets.size();
+		header.meshlet_table_offset	   = offset;
+		header.meshlet_vertex_offset   = AlignUp(offset + mesh.meshlets.size() * sizeof(Meshlet));
+		header.meshlet_triangle_offset = AlignUp(
+			header.meshlet_vertex_offset + mesh.meshlet_vertices.size() * sizeof(uint32_t));
+		offset = AlignUp(header.meshlet_triangle_offset + mesh.meshlet_triangles.size());
+	}
+	header.file_size = offset;
+
+	for (auto& submesh : submeshes) {
+		if ((uint64_t)submesh.vertex_offset + submesh.vertex_count > vertex_count
+			|| (uint64_t)submesh.index_offset + submesh.index_count > mesh.indices.size())
+			throw;
+		submesh.bounds = ComputeBounds(
+			std::span{mesh.vertices}.subspan(submesh.vertex_offset, submesh.vertex_count));
+	}
+
+	std::vector<uint8_t> image(header.file_size);
+	memcpy(image.data(), &header, sizeof(header));
+	memcpy(image.data() + header.stream_table_offset, streams, sizeof(streams));
+	memcpy(image.data() + header.submesh_table_offset, submeshes.data(),
+		   submeshes.size() * sizeof(MeshSubmesh));
+
+	for (auto& stream : streams) {
+		auto destination = image.data() + stream.offset;
+		for (auto& vertex : mesh.vertices) {
+			switch (stream.format) {
+				case MeshStreamFormat::Unorm16x4:
+					QuantizePosition(vertex.position, header.bounds, (uint16_t*)destination);
+					break;
+				case MeshStreamFormat::Snorm16x2:
+					EncodeOctahedralNormal(vertex.normal, (int16_t*)destination);
+					break;
+				case MeshStreamFormat::Float2:
+					memcpy(destination, vertex.texcoord, sizeof(vertex.texcoord));
+					break;
+				case MeshStreamFormat::Float3:
+					memcpy(destination, GetFloat3Attribute(vertex, stream.type), sizeof(float[3]));
+					break;
+			}
+			destination += stream.stride;
+		}
+	}
+
+	auto indices = image.data() + header.index_offset;
+	for (auto index : mesh.indices) {
+		if (index >= vertex_count)
+			throw;
+		if (index_stride == 4)
+			memcpy(indices, &index, sizeof(index));
+		else
+			*(uint16_t*)indices = (uint16_t)index;
+		indices += index_stride;
+	}
+
+	if (!mesh.meshlets.empty()) {
+		memcpy(image.data() + header.meshlet_table_offset, mesh.meshlets.data(),
+			   mesh.meshlets.size() * sizeof(Meshlet));
+		memcpy(image.data() + header.meshlet_vertex_offset, mesh.meshlet_vertices.data(),
+			   mesh.meshlet_vertices.size() * sizeof(uint32_t));
+		memcpy(image.data() + header.meshlet_triangle_offset, mesh.meshlet_triangles.data(),
+			   mesh.meshlet_triangles.size());
+	}
+
+	std::ofstream output{path, std::ios::binary | std::ios::trunc};
+	if (!output.write((const char*)image.data(), (std::streamsize)image.size()))
+		throw;
+}
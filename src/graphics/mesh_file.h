@@ -0,0 +1,139 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "mapped_file.h"
+
+constexpr uint32_t MESH_FILE_MAGIC		   = 0x48534D47;
+constexpr uint16_t MESH_FILE_VERSION_MAJOR = 1;
+constexpr uint16_t MESH_FILE_VERSION_MINOR = 1;
+constexpr uint64_t MESH_FILE_ALIGNMENT	   = 64;
+
+enum MeshFileFlags : uint32_t {
+	MESH_FILE_QUANTIZED_POSITIONS = 1 << 0,
+	MESH_FILE_OCTAHEDRAL_NORMALS  = 1 << 1,
+	MESH_FILE_INDEX_32			  = 1 << 2,
+};
+
+enum class MeshStreamType : uint32_t {
+	Position,
+	Normal,
+	Color,
+	Texcoord,
+};
+
+enum class MeshStreamFormat : uint32_t {
+	Float2,
+	Float3,
+	Unorm16x4,
+	Snorm16x2,
+};
+
+struct MeshBounds {
+	float min[3];
+	float max[3];
+};
+
+struct MeshFileHeader {
+	uint32_t magic;
+	uint16_t version_major;
+	uint16_t version_minor;
+	uint32_t flags;
+	uint32_t vertex_count;
+	uint32_t index_count;
+	uint32_t stream_count;
+	uint32_t submesh_count;
+	uint32_t meshlet_count;
+	uint64_t stream_table_offset;
+	uint64_t submesh_table_offset;
+	uint64_t payload_offset;
+	uint64_t index_offset;
+	uint64_t index_size;
+	uint64_t file_size;
+	MeshBounds bounds;
+	uint64_t meshlet_table_offset;
+	uint64_t meshlet_vertex_offset;
+	uint64_t meshlet_triangle_offset;
+};
+
+struct MeshStreamDesc {
+	MeshStreamType type;
+	MeshStreamFormat format;
+	uint32_t stride;
+	uint32_t reserved;
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct MeshSubmesh {
+	uint32_t index_offset;
+	uint32_t index_count;
+	uint32_t vertex_offset;
+	uint32_t vertex_count;
+	uint32_t material_index;
+	uint32_t reserved;
+	MeshBounds bounds;
+	uint8_t padding[16];
+};
+
+struct Meshlet {
+	uint32_t vertex_offset;
+	uint32_t vertex_count;
+	uint32_t triangle_offset;
+	uint32_t triangle_count;
+	float center[3];
+	float radius;
+	float cone_apex[3];
+	float cone_axis[3];
+	float cone_cutoff;
+	uint32_t reserved;
+};
+
+static_assert(sizeof(MeshFileHeader) == 2 * MESH_FILE_ALIGNMENT);
+static_assert(sizeof(MeshStreamDesc) == 32);
+static_assert(sizeof(MeshSubmesh) == MESH_FILE_ALIGNMENT);
+static_assert(sizeof(Meshlet) == MESH_FILE_ALIGNMENT);
+
+struct MeshSourceVertex {
+	float position[3];
+	float normal[3];
+	float color[3];
+	float texcoord[2];
+};
+
+struct MeshSourceData {
+	std::vector<MeshSourceVertex> vertices;
+	std::vector<uint32_t> indices;
+	std::vector<MeshSubmesh> submeshes;
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> meshlet_vertices;
+	std::vector<uint8_t> meshlet_triangles;
+};
+
+class MeshFile {
+  public:
+	explicit MeshFile(const char* path);
+
+	std::span<const uint8_t> GetStreamData(const MeshStreamDesc& stream) const;
+	std::span<const uint8_t> GetIndexData() const;
+	std::span<const uint8_t> GetPayload() const;
+	uint32_t GetIndexStride() const;
+
+	MappedFile file;
+	const MeshFileHeader& header;
+	std::span<const MeshStreamDesc> streams;
+	std::span<const MeshSubmesh> submeshes;
+	std::span<const Meshlet> meshlets;
+	std::span<const uint32_t> meshlet_vertices;
+	std::span<const uint8_t> meshlet_triangles;
+};
+
+MeshSourceData ReadMeshSourceData(const MeshFile& mesh_file);
+void WriteMeshFile(const char* path, const MeshSourceData& mesh, uint32_t flags);
+
+void QuantizePosition(const float position[3], const MeshBounds& bounds, uint16_t quantized[4]);
+void DequantizePosition(const uint16_t quantized[4], const MeshBounds& bounds, float position[3]);
+void EncodeOctahedralNormal(const float normal[3], int16_t encoded[2]);
+void DecodeOctahedralNormal(const int16_t encoded[2], float normal[3]);
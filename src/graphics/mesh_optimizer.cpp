@@ -0,0 +1,654 @@
+#include "graphics/mesh_optimizer.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <thread>
+#include <utility>
+#include <vector>
+
+constexpr uint32_t INVALID_INDEX = ~0u;
+
+struct Vector3 {
+	float x;
+	float y;
+	float z;
+};
+
+struct IndexRange {
+	uint32_t index_offset;
+	uint32_t index_count;
+};
+
+struct MeshletBatch {
+	std::vector<Meshlet> meshlets;
+	std::vector<uint32_t> vertices;
+	std::vector<uint8_t> triangles;
+};
+
+static Vector3 Subtract(Vector3 left, Vector3 right) {
+	return Vector3{.x = left.x - right.x, .y = left.y - right.y, .z = left.z - right.z};
+}
+
+static Vector3 Cross(Vector3 left, Vector3 right) {
+	return Vector3{.x = left.y * right.z - left.z * right.y,
+				   .y = left.z * right.x - left.x * right.z,
+				   .z = left.x * right.y - left.y * right.x};
+}
+
+static float Dot(Vector3 left, Vector3 right) {
+	return left.x * right.x + left.y * right.y + left.z * right.z;
+}
+
+static float Length(Vector3 value) {
+	return std::sqrt(Dot(value, value));
+}
+
+static Vector3 GetPosition(const MeshSourceVertex& vertex) {
+	return Vector3{.x = vertex.position[0], .y = vertex.position[1], .z = vertex.position[2]};
+}
+
+static void ParallelFor(uint32_t count, uint32_t thread_count, const auto& body) {
+	std::atomic<uint32_t> next_item = 0;
+
+	auto run_items = [&next_item, count, &body] {
+		for (;;) {
+			auto item = next_item.fetch_add(1, std::memory_order_relaxed);
+			if (item >= count)
+				return;
+			body(item);
+		}
+	};
+
+	std::vector<std::thread> workers;
+	for (auto i = 1u; i < std::min(thread_count, count); ++i)
+		workers.emplace_back(run_items);
+	run_items();
+	for (auto& worker : workers)
+		worker.join();
+}
+
+VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertex_count,
+									uint32_t cache_size) {
+	std::vector<uint32_t> cache_time(vertex_count, 0);
+	auto timestamp	= cache_size + 1;
+	uint64_t misses = 0;
+
+	for (auto index : indices) {
+		if (timestamp - cache_time[index] > cache_size) {
+			cache_time[index] = timestamp++;
+			++misses;
+		}
+	}
+
+	auto triangle_count = indices.size() / 3;
+	return VertexCacheStats{
+		.acmr = triangle_count ? (float)misses / (float)triangle_count : 0.0f,
+		.atvr = vertex_count ? (float)misses / (float)vertex_count : 0.0f,
+	};
+}
+
+static uint64_t HashVertex(const MeshSourceVertex& vertex) {
+	uint32_t words[sizeof(MeshSourceVertex) / sizeof(uint32_t)];
+	memcpy(words, &vertex, sizeof(words));
+	uint64_t hash = 14695981039346656037ull;
+	for (auto word : words)
+		hash = (hash ^ word) * 1099511628211ull;
+	return hash ^ hash >> 29;
+}
+
+static void DeduplicateVertices(MeshSourceData& mesh, uint32_t thread_count) {
+	auto vertex_count = (uint32_t)mesh.vertices.size();
+	std::vector<std::pair<uint64_t, uint32_t>> hashed_vertices(vertex_count);
+	ParallelFor((vertex_count + 4095) / 4096, thread_count, [&](uint32_t block) {
+		for (auto i = block * 4096; i < std::min(vertex_count, block * 4096 + 4096); ++i)
+			hashed_vertices[i] = {HashVertex(mesh.vertices[i]), i};
+	});
+	std::ranges::sort(hashed_vertices);
+
+	std::vector<uint32_t> canonical(vertex_count);
+	for (auto run_begin = 0u; run_begin < vertex_count;) {
+		auto run_end = run_begin + 1;
+		while (run_end < vertex_count
+			   && hashed_vertices[run_end].first == hashed_vertices[run_begin].first)
+			++run_end;
+
+		for (auto i = run_begin; i < run_end; ++i) {
+			auto vertex		  = hashed_vertices[i].second;
+			canonical[vertex] = vertex;
+			for (auto j = run_begin; j < i; ++j) {
+				auto candidate = hashed_vertices[j].second;
+				if (canonical[candidate] == candidate
+					&& memcmp(&mesh.vertices[candidate], &mesh.vertices[vertex],
+							  sizeof(MeshSourceVertex))
+						   == 0) {
+					canonical[vertex] = candidate;
+					break;
+				}
+			}
+		}
+		run_begin = run_end;
+	}
+
+	std::vector<uint32_t> remap(vertex_count);
+	std::vector<MeshSourceVertex> vertices;
+	for (auto i = 0u; i < vertex_count; ++i) {
+		if (canonical[i] == i) {
+			remap[i] = (uint32_t)vertices.size();
+			vertices.push_back(mesh.vertices[i]);
+		}
+		else
+			remap[i] = remap[canonical[i]];
+	}
+
+	for (auto& index : mesh.indices)
+		index = remap[index];
+	mesh.vertices = std::move(vertices);
+}
+
+static std::vector<uint32_t> TipsifyTriangleOrder(std::span<const uint32_t> indices,
+												  uint32_t vertex_count, uint32_t cache_size) {
+	auto triangle_count = (uint32_t)indices.size() / 3;
+
+	std::vector<uint32_t> live_triangles(vertex_count, 0);
+	for (auto index : indices)
+		++live_triangles[index];
+
+	std::vector<uint32_t> adjacency_offsets(vertex_count + 1, 0);
+	for (auto v = 0u; v < vertex_count; ++v)
+		adjacency_offsets[v + 1] = adjacency_offsets[v] + live_triangles[v];
+
+	std::vector<uint32_t> adjacency(indices.size());
+	std::vector<uint32_t> adjacency_fill(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+	for (auto triangle = 0u; triangle < triangle_count; ++triangle)
+		for (auto corner = 0u; corner < 3; ++corner)
+			adjacency[adjacency_fill[indices[triangle * 3 + corner]]++] = triangle;
+
+	std::vector<uint32_t> cache_time(vertex_count, 0);
+	std::vector<uint8_t> emitted(triangle_count, 0);
+	std::vector<uint32_t> dead_end;
+	std::vector<uint32_t> candidates;
+	std::vector<uint32_t> order;
+	order.reserve(triangle_count);
+
+	auto timestamp = cache_size + 1;
+	auto cursor	   = 0u;
+
+	auto skip_dead_end = [&] {
+		while (!dead_end.empty()) {
+			auto vertex = dead_end.back();
+			dead_end.pop_back();
+			if (live_triangles[vertex])
+				return vertex;
+		}
+		for (; cursor < vertex_count; ++cursor)
+			if (live_triangles[cursor])
+				return cursor;
+		return INVALID_INDEX;
+	};
+
+	auto next_fan_vertex = [&] {
+		auto best_vertex   = INVALID_INDEX;
+		auto best_priority = -1;
+		for (auto vertex : candidates) {
+			if (!live_triangles[vertex])
+				continue;
+			auto age	  = (int)(timestamp - cache_time[vertex]);
+			auto priority = age + 2 * (int)live_triangles[vertex] <= (int)cache_size ? age : 0;
+			if (priority > best_priority) {
+				best_priority = priority;
+				best_vertex	  = vertex;
+			}
+		}
+		return best_vertex != INVALID_INDEX ? best_vertex : skip_dead_end();
+	};
+
+	auto fan_vertex = skip_dead_end();
+	while (fan_vertex != INVALID_INDEX) {
+		candidates.clear();
+		for (auto a = adjacency_offsets[fan_vertex]; a < adjacency_offsets[fan_vertex + 1]; ++a) {
+			auto triangle = adjacency[a];
+			if (emitted[triangle])
+				continue;
+
+			for (auto corner = 0u; corner < 3; ++corner) {
+				auto vertex = indices[triangle * 3 + corner];
+				dead_end.push_back(vertex);
+				candidates.push_back(vertex);
+				--live_triangles[vertex];
+				if (timestamp - cache_time[vertex] > cache_size)
+					cache_time[vertex] = timestamp++;
+			}
+			emitted[triangle] = 1;
+			order.push_back(triangle);
+		}
+		fan_vertex = next_fan_vertex();
+	}
+	return order;
+}
+
+static std::vector<uint32_t> FindClusterBoundaries(std::span<const uint32_t> order,
+												   std::span<const uint32_t> indices,
+												   uint32_t vertex_count,
+												   const MeshOptimizerConfig& config) {
+	std::vector<uint32_t> cache_time(vertex_count, 0);
+	auto timestamp = config.cache_size + 1;
+
+	auto simulate_triangle = [&](uint32_t triangle) {
+		auto misses = 0u;
+		for (auto corner = 0u; corner < 3; ++corner) {
+			auto vertex = indices[triangle * 3 + corner];
+			if (timestamp - cache_time[vertex] > config.cache_size) {
+				cache_time[vertex] = timestamp++;
+				++misses;
+			}
+		}
+		return misses;
+	};
+
+	std::vector<uint32_t> misses(order.size());
+	std::vector<uint32_t> hard_boundaries;
+	for (auto i = 0u; i < (uint32_t)order.size(); ++i) {
+		misses[i] = simulate_triangle(order[i]);
+		if (i == 0 || misses[i] == 3)
+			hard_boundaries.push_back(i);
+	}
+	hard_boundaries.push_back((uint32_t)order.size());
+
+	std::vector<uint32_t> boundaries;
+	for (auto h = 0u; h + 1 < hard_boundaries.size(); ++h) {
+		auto begin			= hard_boundaries[h];
+		auto end			= hard_boundaries[h + 1];
+		auto cluster_misses = 0u;
+		for (auto i = begin; i < end; ++i)
+			cluster_misses += misses[i];
+		auto split_acmr = config.overdraw_threshold * (float)cluster_misses / (float)(end - begin);
+
+		boundaries.push_back(begin);
+		timestamp += config.cache_size + 1;
+		auto run_begin	= begin;
+		auto run_misses = 0u;
+		for (auto i = begin; i + 1 < end; ++i) {
+			run_misses += simulate_triangle(order[i]);
+			if ((float)run_misses / (float)(i + 1 - run_begin) > split_acmr)
+				continue;
+			boundaries.push_back(i + 1);
+			timestamp += config.cache_size + 1;
+			run_begin  = i + 1;
+			run_misses = 0;
+		}
+	}
+	boundaries.push_back((uint32_t)order.size());
+	return boundaries;
+}
+
+static void OptimizeChunk(std::span<uint32_t> chunk_indices,
+						  std::span<const MeshSourceVertex> vertices, Vector3 mesh_center,
+						  const MeshOptimizerConfig& config) {
+	std::vector<uint32_t> chunk_vertices(chunk_indices.begin(), chunk_indices.end());
+	std::ranges::sort(chunk_vertices);
+	chunk_vertices.erase(std::ranges::unique(chunk_vertices).begin(), chunk_vertices.end());
+
+	std::vector<uint32_t> local_indices(chunk_indices.size());
+	for (auto i = 0u; i < (uint32_t)chunk_indices.size(); ++i)
+		local_indices[i] = (uint32_t)(std::ranges::lower_bound(chunk_vertices, chunk_indices[i])
+									  - chunk_vertices.begin());
+
+	auto local_vertex_count = (uint32_t)chunk_vertices.size();
+	auto order = TipsifyTriangleOrder(local_indices, local_vertex_count, config.cache_size);
+	auto boundaries = FindClusterBoundaries(order, local_indices, local_vertex_count, config);
+
+	struct Cluster {
+		uint32_t begin;
+		uint32_t end;
+		float sort_key;
+	};
+
+	std::vector<Cluster> clusters;
+	for (auto c = 0u; c + 1 < boundaries.size(); ++c) {
+		Vector3 centroid{};
+		Vector3 normal{};
+		auto total_area = 0.0f;
+		for (auto i = boundaries[c]; i < boundaries[c + 1]; ++i) {
+			auto triangle = order[i] * 3;
+			auto p0		  = GetPosition(vertices[chunk_indices[triangle]]);
+			auto p1		  = GetPosition(vertices[chunk_indices[triangle + 1]]);
+			auto p2		  = GetPosition(vertices[chunk_indices[triangle + 2]]);
+			auto face	  = Cross(Subtract(p1, p0), Subtract(p2, p0));
+			auto area	  = Length(face);
+			centroid.x += (p0.x + p1.x + p2.x) * area;
+			centroid.y += (p0.y + p1.y + p2.y) * area;
+			centroid.z += (p0.z + p1.z + p2.z) * area;
+			normal.x += face.x;
+			normal.y += face.y;
+			normal.z += face.z;
+			total_area += area;
+		}
+
+		auto inverse_area = total_area > 0.0f ? 1.0f / (3.0f * total_area) : 0.0f;
+		centroid		  = Vector3{.x = centroid.x * inverse_area,
+									.y = centroid.y * inverse_area,
+									.z = centroid.z * inverse_area};
+		clusters.push_back(Cluster{
+			.begin	  = boundaries[c],
+			.end	  = boundaries[c + 1],
+			.sort_key = Dot(Subtract(centroid, mesh_center), normal),
+		});
+	}
+
+	std::ranges::stable_sort(clusters, [](const Cluster& left, const Cluster& right) {
+		return left.sort_key > right.sort_key;
+	});
+
+	std::vector<uint32_t> optimized;
+	optimized.reserve(chunk_indices.size());
+	for (auto& cluster : clusters)
+		for (auto i = cluster.begin; i < cluster.end; ++i)
+			for (auto corner = 0u; corner < 3; ++corner)
+				optimized.push_back(chunk_indices[order[i] * 3 + corner]);
+	std::ranges::copy(optimized, chunk_indices.begin());
+}
+
+static void OptimizeVertexFetch(MeshSourceData& mesh) {
+	std::vector<uint32_t> remap(mesh.vertices.size(), INVALID_INDEX);
+	std::vector<MeshSourceVertex> vertices;
+	vertices.reserve(mesh.vertices.size());
+
+	for (auto& index : mesh.indices) {
+		if (remap[index] == INVALID_INDEX) {
+			remap[index] = (uint32_t)vertices.size();
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+	mesh.vertices = std::move(vertices);
+
+	for (auto& submesh : mesh.submeshes) {
+		auto submesh_indices = std::span{mesh.indices}.subspan(submesh.index_offset,
+															   submesh.index_count);
+		if (submesh_indices.empty()) {
+			submesh.vertex_offset = 0;
+			submesh.vertex_count  = 0;
+			continue;
+		}
+		auto [min_index, max_index] = std::ranges::minmax(submesh_indices);
+		submesh.vertex_offset		= min_index;
+		submesh.vertex_count		= max_index - min_index + 1;
+	}
+}
+
+static void ComputeMeshletBounds(Meshlet& meshlet, std::span<const uint32_t> meshlet_vertices,
+								 std::span<const uint8_t> meshlet_triangles,
+								 std::span<const MeshSourceVertex> vertices) {
+	Vector3 minimum{.x = INFINITY, .y = INFINITY, .z = INFINITY};
+	Vector3 maximum{.x = -INFINITY, .y = -INFINITY, .z = -INFINITY};
+	for (auto vertex : meshlet_vertices) {
+		auto position = GetPosition(vertices[vertex]);
+		minimum		  = Vector3{.x = std::min(minimum.x, position.x),
+								.y = std::min(minimum.y, position.y),
+								.z = std::min(minimum.z, position.z)};
+		maximum		  = Vector3{.x = std::max(maximum.x, position.x),
+								.y = std::max(maximum.y, position.y),
+								.z = std::max(maximum.z, position.z)};
+	}
+
+	Vector3 center{.x = (minimum.x + maximum.x) * 0.5f,
+				   .y = (minimum.y + maximum.y) * 0.5f,
+				   .z = (minimum.z + maximum.z) * 0.5f};
+	auto radius = 0.0f;
+	for (auto vertex : meshlet_vertices)
+		radius = std::max(radius, Length(Subtract(GetPosition(vertices[vertex]), center)));
+
+	std::vector<Vector3> normals;
+	std::vector<Vector3> corners;
+	Vector3 axis{};
+	for (auto t = 0u; t + 2 < meshlet_triangles.size(); t += 3) {
+		auto p0	  = GetPosition(vertices[meshlet_vertices[meshlet_triangles[t]]]);
+		auto p1	  = GetPosition(vertices[meshlet_vertices[meshlet_triangles[t + 1]]]);
+		auto p2	  = GetPosition(vertices[meshlet_vertices[meshlet_triangles[t + 2]]]);
+		auto face = Cross(Subtract(p1, p0), Subtract(p2, p0));
+		auto area = Length(face);
+		if (area <= 0.0f)
+			continue;
+		auto normal = Vector3{.x = face.x / area, .y = face.y / area, .z = face.z / area};
+		normals.push_back(normal);
+		corners.push_back(p0);
+		axis = Vector3{.x = axis.x + normal.x, .y = axis.y + normal.y, .z = axis.z + normal.z};
+	}
+
+	auto axis_length = Length(axis);
+	if (axis_length > 0.0f)
+		axis = Vector3{.x = axis.x / axis_length,
+					   .y = axis.y / axis_length,
+					   .z = axis.z / axis_length};
+
+	auto min_dot = 1.0f;
+	for (auto& normal : normals)
+		min_dot = std::min(min_dot, Dot(axis, normal));
+
+	auto cone_valid	   = !normals.empty() && min_dot > 0.1f;
+	auto apex_distance = 0.0f;
+	for (auto i = 0u; cone_valid && i < normals.size(); ++i) {
+		auto distance = Dot(Subtract(center, corners[i]), normals[i]) / Dot(axis, normals[i]);
+		apex_distance = std::max(apex_distance, distance);
+	}
+
+	meshlet.center[0]	 = center.x;
+	meshlet.center[1]	 = center.y;
+	meshlet.center[2]	 = center.z;
+	meshlet.radius		 = radius;
+	meshlet.cone_apex[0] = center.x - axis.x * apex_distance;
+	meshlet.cone_apex[1] = center.y - axis.y * apex_distance;
+	meshlet.cone_apex[2] = center.z - axis.z * apex_distance;
+	meshlet.cone_axis[0] = axis.x;
+	meshlet.cone_axis[1] = axis.y;
+	meshlet.cone_axis[2] = axis.z;
+	meshlet.cone_cutoff	 = cone_valid ? std::sqrt(1.0f - min_dot * min_dot) : 1.0f;
+}
+
+static MeshletBatch BuildMeshlets(std::span<const uint32_t> chunk_indices,
+								  std::span<const MeshSourceVertex> vertices,
+								  const MeshOptimizerConfig& config) {
+	struct LocalSlot {
+		uint32_t vertex;
+		uint32_t local_vertex;
+	};
+
+	MeshletBatch batch;
+	Meshlet current{};
+	LocalSlot local_slots[512];
+	std::ranges::fill(local_slots, LocalSlot{.vertex = INVALID_INDEX});
+
+	auto flush_meshlet = [&] {
+		if (!current.triangle_count)
+			return;
+		ComputeMeshletBounds(
+			current, std::span{batch.vertices}.subspan(current.vertex_offset, current.vertex_count),
+			std::span{batch.triangles}.subspan(current.triangle_offset * 3,
+											   current.triangle_count * 3),
+			vertices);
+		batch.meshlets.push_back(current);
+		current = Meshlet{.vertex_offset   = (uint32_t)batch.vertices.size(),
+						  .triangle_offset = (uint32_t)batch.triangles.size() / 3};
+		std::ranges::fill(local_slots, LocalSlot{.vertex = INVALID_INDEX});
+	};
+
+	auto find_local_vertex = [&](uint32_t vertex) {
+		for (auto slot = vertex * 2654435761u >> 23;; slot = (slot + 1) & 511) {
+			if (local_slots[slot].vertex == vertex || local_slots[slot].vertex == INVALID_INDEX)
+				return &local_slots[slot];
+		}
+	};
+
+	for (auto t = 0u; t + 2 < chunk_indices.size(); t += 3) {
+		auto new_vertices = 0u;
+		for (auto corner = 0u; corner < 3; ++corner)
+			if (find_local_vertex(chunk_indices[t + corner])->vertex == INVALID_INDEX)
+				++new_vertices;
+
+		if (current.vertex_count + new_vertices > config.max_meshlet_vertices
+			|| current.triangle_count + 1 > config.max_meshlet_triangles)
+			flush_meshlet();
+
+		for (auto corner = 0u; corner < 3; ++corner) {
+			auto slot = find_local_vertex(chunk_indices[t + corner]);
+			if (slot->vertex == INVALID_INDEX) {
+				*slot = LocalSlot{.vertex		= chunk_indices[t + corner],
+								  .local_vertex = current.vertex_count++};
+				batch.vertices.push_back(slot->vertex);
+			}
+			batch.triangles.push_back((uint8_t)slot->local_vertex);
+		}
+		++current.triangle_count;
+	}
+	flush_meshlet();
+	return batch;
+}
+
+static uint32_t SpreadBits(uint32_t value) {
+	value = (value | value << 16) & 0x030000FF;
+	value = (value | value << 8) & 0x0300F00F;
+	value = (value | value << 4) & 0x030C30C3;
+	value = (value | value << 2) & 0x09249249;
+	return value;
+}
+
+static void SortTrianglesSpatially(std::span<uint32_t> indices,
+								   std::span<const MeshSourceVertex> vertices, Vector3 minimum,
+								   Vector3 maximum) {
+	auto extent = Subtract(maximum, minimum);
+	auto scale	= Vector3{.x = extent.x > 0.0f ? 1023.0f / extent.x : 0.0f,
+						  .y = extent.y > 0.0f ? 1023.0f / extent.y : 0.0f,
+						  .z = extent.z > 0.0f ? 1023.0f / extent.z : 0.0f};
+
+	std::vector<uint64_t> keyed_triangles(indices.size() / 3);
+	for (auto t = 0u; t < (uint32_t)keyed_triangles.size(); ++t) {
+		Vector3 centroid{};
+		for (auto corner = 0u; corner < 3; ++corner) {
+			auto position = GetPosition(vertices[indices[t * 3 + corner]]);
+			centroid	  = Vector3{.x = centroid.x + position.x / 3.0f,
+									.y = centroid.y + position.y / 3.0f,
+									.z = centroid.z + position.z / 3.0f};
+		}
+		auto morton = SpreadBits((uint32_t)((centroid.x - minimum.x) * scale.x))
+					  | SpreadBits((uint32_t)((centroid.y - minimum.y) * scale.y)) << 1
+					  | SpreadBits((uint32_t)((centroid.z - minimum.z) * scale.z)) << 2;
+		keyed_triangles[t] = (uint64_t)morton << 32 | t;
+	}
+	std::ranges::sort(keyed_triangles);
+
+	std::vector<uint32_t> sorted;
+	sorted.reserve(indices.size());
+	for (auto keyed_triangle : keyed_triangles)
+		for (auto corner = 0u; corner < 3; ++corner)
+			sorted.push_back(indices[(keyed_triangle & 0xFFFFFFFF) * 3 + corner]);
+	std::ranges::copy(sorted, indices.begin());
+}
+
+static std::vector<IndexRange> SplitIntoChunks(const MeshSourceData& mesh,
+											   uint32_t chunk_triangle_count) {
+	std::vector<IndexRange> chunks;
+	auto chunk_index_count = std::max(chunk_triangle_count, 1u) * 3;
+	for (auto& submesh : mesh.submeshes) {
+		if (submesh.index_offset % 3 || submesh.index_count % 3
+			|| (uint64_t)submesh.index_offset + submesh.index_count > mesh.indices.size())
+			throw;
+		for (auto offset = 0u; offset < submesh.index_count; offset += chunk_index_count)
+			chunks.push_back(IndexRange{
+				.index_offset = submesh.index_offset + offset,
+				.index_count  = std::min(chunk_index_count, submesh.index_count - offset),
+			});
+	}
+	return chunks;
+}
+
+MeshOptimizerStats OptimizeMesh(MeshSourceData& mesh, const MeshOptimizerConfig& config) {
+	auto start = std::chrono::steady_clock::now();
+
+	if (mesh.indices.size() % 3 || config.max_meshlet_vertices > 256)
+		throw;
+	for (auto index : mesh.indices)
+		if (index >= mesh.vertices.size())
+			throw;
+
+	MeshOptimizerStats stats{
+		.input_vertex_count = (uint32_t)mesh.vertices.size(),
+		.triangle_count		= (uint32_t)mesh.indices.size() / 3,
+		.input_cache
+		= AnalyzeVertexCache(mesh.indices, (uint32_t)mesh.vertices.size(), config.cache_size),
+	};
+
+	if (mesh.submeshes.empty())
+		mesh.submeshes.push_back(MeshSubmesh{.index_count  = (uint32_t)mesh.indices.size(),
+											 .vertex_count = (uint32_t)mesh.vertices.size()});
+
+	DeduplicateVertices(mesh, config.thread_count);
+
+	Vector3 minimum{.x = INFINITY, .y = INFINITY, .z = INFINITY};
+	Vector3 maximum{.x = -INFINITY, .y = -INFINITY, .z = -INFINITY};
+	for (auto& vertex : mesh.vertices) {
+		minimum = Vector3{.x = std::min(minimum.x, vertex.position[0]),
+						  .y = std::min(minimum.y, vertex.position[1]),
+						  .z = std::min(minimum.z, vertex.position[2])};
+		maximum = Vector3{.x = std::max(maximum.x, vertex.position[0]),
+						  .y = std::max(maximum.y, vertex.position[1]),
+						  .z = std::max(maximum.z, vertex.position[2])};
+	}
+	Vector3 mesh_center{.x = (minimum.x + maximum.x) * 0.5f,
+						.y = (minimum.y + maximum.y) * 0.5f,
+						.z = (minimum.z + maximum.z) * 0.5f};
+
+	ParallelFor((uint32_t)mesh.submeshes.size(), config.thread_count, [&](uint32_t s) {
+		auto& submesh = mesh.submeshes[s];
+		if (submesh.index_count > config.chunk_triangle_count * 3)
+			SortTrianglesSpatially(
+				std::span{mesh.indices}.subspan(submesh.index_offset, submesh.index_count),
+				mesh.vertices, minimum, maximum);
+	});
+
+	auto chunks		   = SplitIntoChunks(mesh, config.chunk_triangle_count);
+	auto chunk_indices = [&mesh, &chunks](uint32_t c) {
+		return std::span{mesh.indices}.subspan(chunks[c].index_offset, chunks[c].index_count);
+	};
+
+	ParallelFor((uint32_t)chunks.size(), config.thread_count, [&](uint32_t c) {
+		OptimizeChunk(chunk_indices(c), mesh.vertices, mesh_center, config);
+	});
+
+	OptimizeVertexFetch(mesh);
+
+	mesh.meshlets.clear();
+	mesh.meshlet_vertices.clear();
+	mesh.meshlet_triangles.clear();
+	if (config.build_meshlets) {
+		std::vector<MeshletBatch> batches(chunks.size());
+		ParallelFor((uint32_t)chunks.size(), config.thread_count, [&](uint32_t c) {
+			batches[c] = BuildMeshlets(chunk_indices(c), mesh.vertices, config);
+		});
+
+		for (auto& batch : batches) {
+			auto vertex_base   = (uint32_t)mesh.meshlet_vertices.size();
+			auto triangle_base = (uint32_t)mesh.meshlet_triangles.size() / 3;
+			for (auto meshlet : batch.meshlets) {
+				meshlet.vertex_offset += vertex_base;
+				meshlet.triangle_offset += triangle_base;
+				mesh.meshlets.push_back(meshlet);
+			}
+			mesh.meshlet_vertices.insert(mesh.meshlet_vertices.end(), batch.vertices.begin(),
+										 batch.vertices.end());
+			mesh.meshlet_triangles.insert(mesh.meshlet_triangles.end(), batch.triangles.begin(),
+										  batch.triangles.end());
+		}
+	}
+
+	stats.output_vertex_count = (uint32_t)mesh.vertices.size();
+	stats.meshlet_count		  = (uint32_t)mesh.meshlets.size();
+	stats.output_cache
+		= AnalyzeVertexCache(mesh.indices, (uint32_t)mesh.vertices.size(), config.cache_size);
+	stats.elapsed_ms
+		= std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start)
+			  .count();
+	return stats;
+}
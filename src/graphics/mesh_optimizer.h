@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#include "graphics/mesh_file.h"
+
+struct MeshOptimizerConfig {
+	uint32_t cache_size			   = 16;
+	float overdraw_threshold	   = 1.05f;
+	uint32_t chunk_triangle_count  = 1 << 16;
+	bool build_meshlets			   = true;
+	uint32_t max_meshlet_vertices  = 64;
+	uint32_t max_meshlet_triangles = 124;
+	uint32_t thread_count		   = 1;
+};
+
+struct VertexCacheStats {
+	float acmr;
+	float atvr;
+};
+
+struct MeshOptimizerStats {
+	uint32_t input_vertex_count;
+	uint32_t output_vertex_count;
+	uint32_t triangle_count;
+	uint32_t meshlet_count;
+	VertexCacheStats input_cache;
+	VertexCacheStats output_cache;
+	double elapsed_ms;
+};
+
+VertexCacheStats AnalyzeVertexCache(std::span<const uint32_t> indices, uint32_t vertex_count,
+									uint32_t cache_size);
+MeshOptimizerStats OptimizeMesh(MeshSourceData& mesh, const MeshOptimizerConfig& config);
@@ -3,12 +3,24 @@
 #include <d3dcompiler.h>
 #include <windows.h>
 
+#include <algorithm>
+#include <bit>
+#include <chrono>
 #include <cstring>
+#include <cwchar>
+#include <filesystem>
 #include <string>
 #include <vector>
 
+#include "content_hash.h"
+#include "graphics/shader_cache.h"
 #include "try.h"
 
+#ifdef GOBLIN_EMBED_SHADERS
+#include "shaders/mesh_ps.h"
+#include "shaders/mesh_vs.h"
+#endif
+
 static std::wstring GetExecutableDirectory() {
 	wchar_t path[MAX_PATH]{};
 	auto length = GetModuleFileNameW(nullptr, path, MAX_PATH);
@@ -23,18 +35,12 @@ static std::wstring GetExecutableDirectory() {
 	return full_path.substr(0, last_separator);
 }
 
+#ifndef GOBLIN_EMBED_SHADERS
 static bool FileExists(const std::wstring& path) {
 	auto attributes = GetFileAttributesW(path.c_str());
 	return attributes != INVALID_FILE_ATTRIBUTES && (attributes & FILE_ATTRIBUTE_DIRECTORY) == 0;
 }
 
-static std::wstring ReplaceExtension(const std::wstring& path, const std::wstring& extension) {
-	auto dot = path.find_last_of(L'.');
-	if (dot == std::wstring::npos)
-		return path + extension;
-	return path.substr(0, dot) + extension;
-}
-
 static std::wstring FindShaderPath(const std::wstring& file_name) {
 	auto exe_dir		   = GetExecutableDirectory();
 	std::wstring candidate = exe_dir + L"\\shaders\\" + file_name;
@@ -48,52 +54,12 @@ static std::wstring FindShaderPath(const std::wstring& file_name) {
 	return candidate;
 }
 
-static std::vector<uint8_t> ReadFileBytes(const std::wstring& path) {
-	auto handle = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
-							  FILE_ATTRIBUTE_NORMAL, nullptr);
-	if (handle == INVALID_HANDLE_VALUE)
-		throw;
-
-	LARGE_INTEGER size{};
-	if (!GetFileSizeEx(handle, &size)) {
-		CloseHandle(handle);
-		throw;
-	}
-
-	std::vector<uint8_t> data;
-	data.resize((size_t)size.QuadPart);
-	DWORD read = 0;
-	if (!ReadFile(handle, data.data(), (DWORD)data.size(), &read, nullptr)) {
-		CloseHandle(handle);
-		throw;
-	}
-
-	CloseHandle(handle);
-	return data;
-}
-
-static void WriteFileBytes(const std::wstring& path, const std::vector<uint8_t>& data) {
-	auto handle = CreateFileW(path.c_str(), GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS,
-							  FILE_ATTRIBUTE_NORMAL, nullptr);
-	if (handle == INVALID_HANDLE_VALUE)
-		throw;
-
-	DWORD written = 0;
-	if (!WriteFile(handle, data.data(), (DWORD)data.size(), &written, nullptr)) {
-		CloseHandle(handle);
-		throw;
-	}
-
-	CloseHandle(handle);
-}
-
-static std::vector<uint8_t> CompileShader(const std::wstring& path, const char* entry,
-										  const char* target) {
+static std::vector<uint8_t> CompileShader(const ShaderDesc& desc) {
 	Microsoft::WRL::ComPtr<ID3DBlob> shader_blob;
 	Microsoft::WRL::ComPtr<ID3DBlob> error_blob;
-	UINT flags	= D3DCOMPILE_ENABLE_STRICTNESS;
-	auto result = D3DCompileFromFile(path.c_str(), nullptr, D3D_COMPILE_STANDARD_FILE_INCLUDE,
-									 entry, target, flags, 0, &shader_blob, &error_blob);
+	auto result = D3DCompileFromFile(desc.source_path.c_str(), nullptr,
+									 D3D_COMPILE_STANDARD_FILE_INCLUDE, desc.entry.c_str(),
+									 desc.target.c_str(), desc.flags, 0, &shader_blob, &error_blob);
 	if (FAILED(result) || !shader_blob)
 		throw;
 
@@ -102,17 +68,7 @@ static std::vector<uint8_t> CompileShader(const std::wstring& path, const char*
 	memcpy(data.data(), shader_blob->GetBufferPointer(), shader_blob->GetBufferSize());
 	return data;
 }
-
-static std::vector<uint8_t> LoadOrCompileShader(const std::wstring& hlsl_path, const char* entry,
-												const char* target) {
-	auto cso_path = ReplaceExtension(hlsl_path, L".cso");
-	if (FileExists(cso_path))
-		return ReadFileBytes(cso_path);
-
-	auto compiled = CompileShader(hlsl_path, entry, target);
-	WriteFileBytes(cso_path, compiled);
-	return compiled;
-}
+#endif
 
 static D3D12_BLEND_DESC CreateBlendDesc() {
 	return D3D12_BLEND_DESC{
@@ -138,16 +94,236 @@ static D3D12_DEPTH_STENCIL_DESC CreateDepthStencilDesc() {
 	};
 }
 
-D3D12Pipeline::D3D12Pipeline(ID3D12Device* device, DXGI_FORMAT render_target_format) {
-	D3D12_ROOT_PARAMETER root_parameter{
-		.ParameterType	  = D3D12_ROOT_PARAMETER_TYPE_CBV,
-		.Descriptor		  = {.ShaderRegister = 0, .RegisterSpace = 0},
-		.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX,
+static uint64_t GetElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+static uint64_t HashAdapter(IDXGIAdapter4* adapter) {
+	DXGI_ADAPTER_DESC3 desc{};
+	Try | adapter->GetDesc3(&desc);
+	LARGE_INTEGER driver_version{};
+	adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driver_version);
+
+	auto hash = HashValue(CONTENT_HASH_SEED, desc.VendorId);
+	hash	  = HashValue(hash, desc.DeviceId);
+	hash	  = HashValue(hash, desc.SubSysId);
+	hash	  = HashValue(hash, desc.Revision);
+	return HashValue(hash, (uint64_t)driver_version.QuadPart);
+}
+
+static std::span<const uint8_t> ToBytes(D3D12_SHADER_BYTECODE bytecode) {
+	return {(const uint8_t*)bytecode.pShaderBytecode, bytecode.BytecodeLength};
+}
+
+static std::vector<uint32_t> GetFixedState(const D3D12_GRAPHICS_PIPELINE_STATE_DESC& state) {
+	auto& blend	 = state.BlendState;
+	auto& raster = state.RasterizerState;
+	auto& depth	 = state.DepthStencilState;
+
+	std::vector<uint32_t> words;
+	auto push = [&](auto... values) { (words.push_back((uint32_t)values), ...); };
+	push(blend.AlphaToCoverageEnable, blend.IndependentBlendEnable);
+	for (auto& target : blend.RenderTarget)
+		push(target.BlendEnable, target.LogicOpEnable, target.SrcBlend, target.DestBlend,
+			 target.BlendOp, target.SrcBlendAlpha, target.DestBlendAlpha, target.BlendOpAlpha,
+			 target.LogicOp, target.RenderTargetWriteMask);
+
+	push(raster.FillMode, raster.CullMode, raster.FrontCounterClockwise, raster.DepthBias,
+		 std::bit_cast<uint32_t>(raster.DepthBiasClamp),
+		 std::bit_cast<uint32_t>(raster.SlopeScaledDepthBias), raster.DepthClipEnable,
+		 raster.MultisampleEnable, raster.AntialiasedLineEnable, raster.ForcedSampleCount,
+		 raster.ConservativeRaster);
+
+	push(depth.DepthEnable, depth.DepthWriteMask, depth.DepthFunc, depth.StencilEnable,
+		 depth.StencilReadMask, depth.StencilWriteMask);
+	for (auto& face : {depth.FrontFace, depth.BackFace})
+		push(face.StencilFailOp, face.StencilDepthFailOp, face.StencilPassOp, face.StencilFunc);
+
+	push(state.SampleMask, state.IBStripCutValue, state.PrimitiveTopologyType, state.DSVFormat,
+		 state.SampleDesc.Count, state.SampleDesc.Quality, state.NodeMask, state.Flags,
+		 state.NumRenderTargets);
+	for (auto i = 0u; i < state.NumRenderTargets; ++i)
+		push(state.RTVFormats[i]);
+	return words;
+}
+
+D3D12PipelineCache::D3D12PipelineCache(D3D12Device& device, JobSystem& job_system,
+									   std::filesystem::path path)
+	: device(device.device.Get()),
+	  job_system(job_system),
+	  path(std::move(path)),
+	  device_hash(HashAdapter(device.adapter.Get())),
+	  contents(ReadPipelineCache(this->path, device_hash)) {
+	Microsoft::WRL::ComPtr<ID3D12Device1> device1;
+	if (FAILED(device.device.As(&device1)))
+		return;
+
+	if (FAILED(device1->CreatePipelineLibrary(contents.library.data(), contents.library.size(),
+											  IID_PPV_ARGS(&library)))) {
+		contents = {};
+		if (FAILED(device1->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&library))))
+			library.Reset();
+	}
+}
+
+D3D12PipelineCache::~D3D12PipelineCache() {
+	job_system.Wait(prewarm_counter);
+}
+
+void D3D12PipelineCache::Prewarm(std::span<const D3D12PipelineDesc> descs) {
+	job_system.Wait(prewarm_counter);
+	prewarm_descs = descs;
+
+	auto run = [](void* data, uint32_t index) {
+		auto& cache = *(D3D12PipelineCache*)data;
+		auto& desc	= cache.prewarm_descs[index];
+		auto key	= cache.HashDesc(desc);
+		if (cache.FindPipeline(key))
+			return;
+		cache.LoadOrCreate(desc, key);
+
+		std::lock_guard lock{cache.mutex};
+		++cache.stats.prewarmed_pipelines;
+	};
+	job_system.SubmitBatch(run, this, (uint32_t)descs.size(), &prewarm_counter);
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> D3D12PipelineCache::Get(
+	const D3D12PipelineDesc& desc) {
+	job_system.Wait(prewarm_counter);
+	auto key = HashDesc(desc);
+	{
+		std::lock_guard lock{mutex};
+		++stats.requested_pipelines;
+	}
+
+	auto pipeline_state = FindPipeline(key);
+	if (!pipeline_state)
+		pipeline_state = LoadOrCreate(desc, key);
+	return pipeline_state;
+}
+
+void D3D12PipelineCache::Flush() {
+	job_system.Wait(prewarm_counter);
+	std::lock_guard lock{mutex};
+	if (!library || stored_keys.empty())
+		return;
+
+	std::vector<uint8_t> serialized(library->GetSerializedSize());
+	Try | library->Serialize(serialized.data(), serialized.size());
+
+	stored_keys.insert(stored_keys.end(), contents.keys.begin(), contents.keys.end());
+	std::ranges::sort(stored_keys);
+	auto duplicates = std::ranges::unique(stored_keys);
+	stored_keys.erase(duplicates.begin(), duplicates.end());
+	contents.keys.swap(stored_keys);
+	stored_keys.clear();
+
+	WritePipelineCache(path, device_hash, contents.keys, serialized);
+	++stats.cache_writes;
+}
+
+PipelineCacheStats D3D12PipelineCache::GetStats() const {
+	std::lock_guard lock{mutex};
+	return stats;
+}
+
+uint64_t D3D12PipelineCache::HashDesc(const D3D12PipelineDesc& desc) {
+	auto hash_start = std::chrono::steady_clock::now();
+	auto& state		= desc.state;
+	if (state.StreamOutput.NumEntries || state.CachedPSO.CachedBlobSizeInBytes)
+		throw;
+
+	std::vector<PipelineInputElement> input_layout;
+	for (auto i = 0u; i < state.InputLayout.NumElements; ++i) {
+		auto& element = state.InputLayout.pInputElementDescs[i];
+		input_layout.push_back(PipelineInputElement{
+			.semantic		= element.SemanticName,
+			.semantic_index = element.SemanticIndex,
+			.format			= (uint32_t)element.Format,
+			.input_slot		= element.InputSlot,
+			.offset			= element.AlignedByteOffset,
+			.classification = (uint32_t)element.InputSlotClass,
+			.step_rate		= element.InstanceDataStepRate,
+		});
+	}
+
+	std::span<const uint8_t> shaders[]{ToBytes(state.VS), ToBytes(state.PS), ToBytes(state.DS),
+									   ToBytes(state.HS), ToBytes(state.GS)};
+	auto fixed_state = GetFixedState(state);
+	PipelineKeyDesc key_desc{
+		.root_signature = desc.root_signature,
+		.shaders		= shaders,
+		.input_layout	= input_layout,
+		.fixed_state	= fixed_state,
+	};
+	auto key = HashPipelineKeyDesc(key_desc);
+
+	std::lock_guard lock{mutex};
+	stats.hash_nanoseconds += GetElapsedNanoseconds(hash_start);
+	return key;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> D3D12PipelineCache::FindPipeline(uint64_t key) {
+	std::lock_guard lock{mutex};
+	for (auto& cached : pipelines)
+		if (cached.key == key)
+			return cached.pipeline_state;
+	return nullptr;
+}
+
+Microsoft::WRL::ComPtr<ID3D12PipelineState> D3D12PipelineCache::LoadOrCreate(
+	const D3D12PipelineDesc& desc, uint64_t key) {
+	wchar_t name[17]{};
+	swprintf_s(name, L"%016llx", (unsigned long long)key);
+
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state;
+	if (library && std::ranges::binary_search(contents.keys, key)) {
+		std::lock_guard lock{mutex};
+		if (SUCCEEDED(library->LoadGraphicsPipeline(name, &desc.state,
+													IID_PPV_ARGS(&pipeline_state))))
+			++stats.library_hits;
+	}
+
+	if (!pipeline_state) {
+		auto create_start = std::chrono::steady_clock::now();
+		Try | device->CreateGraphicsPipelineState(&desc.state, IID_PPV_ARGS(&pipeline_state));
+
+		std::lock_guard lock{mutex};
+		stats.create_nanoseconds += GetElapsedNanoseconds(create_start);
+		++stats.created_pipelines;
+		if (library && SUCCEEDED(library->StorePipeline(name, pipeline_state.Get())))
+			stored_keys.push_back(key);
+	}
+
+	std::lock_guard lock{mutex};
+	pipelines.push_back(CachedPipeline{.key = key, .pipeline_state = pipeline_state});
+	return pipeline_state;
+}
+
+D3D12Pipeline::D3D12Pipeline(D3D12Device& device, JobSystem& job_system,
+							 TextureFormat render_target_format, MeshStreamFormat position_format)
+	: pipeline_cache(device, job_system,
+					 std::filesystem::path{GetExecutableDirectory()} / L"pipelines.cache") {
+	D3D12_ROOT_PARAMETER root_parameters[]{
+		{
+			.ParameterType	  = D3D12_ROOT_PARAMETER_TYPE_CBV,
+			.Descriptor		  = {.ShaderRegister = 0, .RegisterSpace = 0},
+			.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX,
+		},
+		{
+			.ParameterType	  = D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS,
+			.Constants		  = {.ShaderRegister = 1,
+								 .RegisterSpace	 = 0,
+								 .Num32BitValues = sizeof(MeshPositionDecode) / sizeof(float)},
+			.ShaderVisibility = D3D12_SHADER_VISIBILITY_VERTEX,
+		},
 	};
 
 	D3D12_ROOT_SIGNATURE_DESC root_signature_desc{
-		.NumParameters = 1,
-		.pParameters   = &root_parameter,
+		.NumParameters = (UINT)_countof(root_parameters),
+		.pParameters   = root_parameters,
 		.Flags		   = D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT,
 	};
 
@@ -156,20 +332,40 @@ D3D12Pipeline::D3D12Pipeline(ID3D12Device* device, DXGI_FORMAT render_target_for
 	Try
 		| D3D12SerializeRootSignature(&root_signature_desc, D3D_ROOT_SIGNATURE_VERSION_1,
 									  &root_signature_blob, &error_blob)
-		| device->CreateRootSignature(0, root_signature_blob->GetBufferPointer(),
-									  root_signature_blob->GetBufferSize(),
-									  IID_PPV_ARGS(&root_signature));
-
-	auto vertex_shader_path = FindShaderPath(L"mesh_vs.hlsl");
-	auto pixel_shader_path	= FindShaderPath(L"mesh_ps.hlsl");
-	auto vertex_shader		= LoadOrCompileShader(vertex_shader_path, "main", "vs_5_0");
-	auto pixel_shader		= LoadOrCompileShader(pixel_shader_path, "main", "ps_5_0");
+		| device.device->CreateRootSignature(0, root_signature_blob->GetBufferPointer(),
+											 root_signature_blob->GetBufferSize(),
+											 IID_PPV_ARGS(&root_signature));
+
+#ifdef GOBLIN_EMBED_SHADERS
+	auto vertex_shader = MESH_VS.bytecode;
+	auto pixel_shader  = MESH_PS.bytecode;
+#else
+	ShaderCache shader_cache{std::filesystem::path{GetExecutableDirectory()} / L"shaders.pack",
+							 CompileShader, &job_system};
+	ShaderDesc shader_descs[]{
+		{
+			.source_path = FindShaderPath(L"mesh_vs.hlsl"),
+			.entry		 = "main",
+			.target		 = "vs_5_0",
+			.flags		 = D3DCOMPILE_ENABLE_STRICTNESS,
+		},
+		{
+			.source_path = FindShaderPath(L"mesh_ps.hlsl"),
+			.entry		 = "main",
+			.target		 = "ps_5_0",
+			.flags		 = D3DCOMPILE_ENABLE_STRICTNESS,
+		},
+	};
+	auto shaders	   = shader_cache.Load(shader_descs);
+	auto vertex_shader = shaders[0];
+	auto pixel_shader  = shaders[1];
+#endif
 
 	D3D12_INPUT_ELEMENT_DESC input_layout[]{
 		{
 			.SemanticName		  = "POSITION",
 			.SemanticIndex		  = 0,
-			.Format				  = DXGI_FORMAT_R32G32B32_FLOAT,
+			.Format				  = ToDxgiFormat(position_format),
 			.InputSlot			  = 0,
 			.AlignedByteOffset	  = 0,
 			.InputSlotClass		  = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
@@ -179,28 +375,34 @@ D3D12Pipeline::D3D12Pipeline(ID3D12Device* device, DXGI_FORMAT render_target_for
 			.SemanticName		  = "COLOR",
 			.SemanticIndex		  = 0,
 			.Format				  = DXGI_FORMAT_R32G32B32_FLOAT,
-			.InputSlot			  = 0,
-			.AlignedByteOffset	  = 12,
+			.InputSlot			  = 1,
+			.AlignedByteOffset	  = 0,
 			.InputSlotClass		  = D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA,
 			.InstanceDataStepRate = 0,
 		},
 	};
 
-	D3D12_GRAPHICS_PIPELINE_STATE_DESC pso_desc{
-		.pRootSignature		   = root_signature.Get(),
-		.VS					   = {vertex_shader.data(), vertex_shader.size()},
-		.PS					   = {pixel_shader.data(), pixel_shader.size()},
-		.BlendState			   = CreateBlendDesc(),
-		.SampleMask			   = UINT_MAX,
-		.RasterizerState	   = CreateRasterizerDesc(),
-		.DepthStencilState	   = CreateDepthStencilDesc(),
-		.InputLayout		   = {input_layout, (UINT)_countof(input_layout)},
-		.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
-		.NumRenderTargets	   = 1,
-		.RTVFormats			   = {render_target_format},
-		.SampleDesc			   = {.Count = 1},
+	D3D12PipelineDesc pipeline_desc{
+		.state = {
+			.pRootSignature		   = root_signature.Get(),
+			.VS					   = {vertex_shader.data(), vertex_shader.size()},
+			.PS					   = {pixel_shader.data(), pixel_shader.size()},
+			.BlendState			   = CreateBlendDesc(),
+			.SampleMask			   = UINT_MAX,
+			.RasterizerState	   = CreateRasterizerDesc(),
+			.DepthStencilState	   = CreateDepthStencilDesc(),
+			.InputLayout		   = {input_layout, (UINT)_countof(input_layout)},
+			.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE,
+			.NumRenderTargets	   = 1,
+			.RTVFormats			   = {ToDxgiFormat(render_target_format)},
+			.SampleDesc			   = {.Count = 1},
+		},
+		.root_signature = {(const uint8_t*)root_signature_blob->GetBufferPointer(),
+						   root_signature_blob->GetBufferSize()},
 	};
 
-	Try | device->CreateGraphicsPipelineState(&pso_desc, IID_PPV_ARGS(&pipeline_state));
+	pipeline_cache.Prewarm({&pipeline_desc, 1});
+	pipeline_state = pipeline_cache.Get(pipeline_desc);
+	pipeline_cache.Flush();
 }
 
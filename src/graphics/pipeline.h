@@ -4,12 +4,66 @@
 #include <dxgi1_6.h>
 #include <wrl.h>
 
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <span>
+#include <vector>
+
+#include "graphics/device.h"
+#include "graphics/mesh.h"
+#include "graphics/pipeline_cache.h"
+#include "graphics/render_types.h"
+#include "job_system.h"
+
+struct D3D12PipelineDesc {
+	D3D12_GRAPHICS_PIPELINE_STATE_DESC state;
+	std::span<const uint8_t> root_signature;
+};
+
+class D3D12PipelineCache {
+  public:
+	D3D12PipelineCache(D3D12Device& device, JobSystem& job_system, std::filesystem::path path);
+	~D3D12PipelineCache();
+
+	void Prewarm(std::span<const D3D12PipelineDesc> descs);
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> Get(const D3D12PipelineDesc& desc);
+	void Flush();
+	PipelineCacheStats GetStats() const;
+
+  private:
+	struct CachedPipeline {
+		uint64_t key;
+		Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state;
+	};
+
+	uint64_t HashDesc(const D3D12PipelineDesc& desc);
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> FindPipeline(uint64_t key);
+	Microsoft::WRL::ComPtr<ID3D12PipelineState> LoadOrCreate(const D3D12PipelineDesc& desc,
+															 uint64_t key);
+
+	ID3D12Device* device;
+	JobSystem& job_system;
+	std::filesystem::path path;
+	uint64_t device_hash;
+	PipelineCacheContents contents;
+	Microsoft::WRL::ComPtr<ID3D12PipelineLibrary> library;
+	std::vector<uint64_t> stored_keys;
+	std::vector<CachedPipeline> pipelines;
+	std::span<const D3D12PipelineDesc> prewarm_descs;
+	JobCounter prewarm_counter;
+	mutable std::mutex mutex;
+	PipelineCacheStats stats{};
+};
+
 class D3D12Pipeline {
 	Microsoft::WRL::ComPtr<ID3D12RootSignature> root_signature;
+	D3D12PipelineCache pipeline_cache;
 	Microsoft::WRL::ComPtr<ID3D12PipelineState> pipeline_state;
 
   public:
-	D3D12Pipeline(ID3D12Device* device, DXGI_FORMAT render_target_format);
+	D3D12Pipeline(D3D12Device& device, JobSystem& job_system, TextureFormat render_target_format,
+				  MeshStreamFormat position_format = MeshStreamFormat::Float3);
 
 	ID3D12RootSignature* GetRootSignature() const {
 		return root_signature.Get();
@@ -18,4 +72,8 @@ class D3D12Pipeline {
 	ID3D12PipelineState* GetPipelineState() const {
 		return pipeline_state.Get();
 	}
+
+	PipelineCacheStats GetCacheStats() const {
+		return pipeline_cache.GetStats();
+	}
 };
@@ -0,0 +1,102 @@
+#include "graphics/pipeline_cache.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+#include "content_hash.h"
+#include "mapped_file.h"
+
+uint64_t HashPipelineKeyDesc(const PipelineKeyDesc& desc) {
+	auto hash = HashValue(CONTENT_HASH_SEED, PIPELINE_CACHE_VERSION);
+	hash	  = HashValue(hash, desc.root_signature.size());
+	hash	  = HashBytes(hash, desc.root_signature);
+
+	hash = HashValue(hash, desc.shaders.size());
+	for (auto shader : desc.shaders) {
+		hash = HashValue(hash, shader.size());
+		hash = HashBytes(hash, shader);
+	}
+
+	hash = HashValue(hash, desc.input_layout.size());
+	for (auto& element : desc.input_layout) {
+		hash = HashString(hash, element.semantic);
+		hash = HashValue(hash, element.semantic_index);
+		hash = HashValue(hash, element.format);
+		hash = HashValue(hash, element.input_slot);
+		hash = HashValue(hash, element.offset);
+		hash = HashValue(hash, element.classification);
+		hash = HashValue(hash, element.step_rate);
+	}
+
+	hash = HashValue(hash, desc.fixed_state.size());
+	for (auto value : desc.fixed_state)
+		hash = HashValue(hash, value);
+	return hash;
+}
+
+PipelineCacheContents ReadPipelineCache(const std::filesystem::path& path, uint64_t device_hash) {
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(path, error)
+		|| std::filesystem::file_size(path, error) < sizeof(PipelineCacheHeader))
+		return {};
+
+	MappedFile file{path.string().c_str()};
+	auto& header   = *(const PipelineCacheHeader*)file.data;
+	auto keys_size = (uint64_t)header.key_count * sizeof(uint64_t);
+	if (header.magic != PIPELINE_CACHE_MAGIC || header.version != PIPELINE_CACHE_VERSION
+		|| header.device_hash != device_hash || header.file_size != file.size
+		|| keys_size > file.size - sizeof(PipelineCacheHeader)
+		|| header.library_offset < sizeof(PipelineCacheHeader) + keys_size
+		|| header.library_offset > file.size
+		|| header.library_size > file.size - header.library_offset)
+		return {};
+
+	std::span keys{(const uint64_t*)(file.data + sizeof(PipelineCacheHeader)), header.key_count};
+	for (auto i = 1u; i < keys.size(); ++i)
+		if (keys[i - 1] >= keys[i])
+			return {};
+
+	auto library = file.data + header.library_offset;
+	return PipelineCacheContents{
+		.keys	 = {keys.begin(), keys.end()},
+		.library = {library, library + header.library_size},
+	};
+}
+
+void WritePipelineCache(const std::filesystem::path& path, uint64_t device_hash,
+						std::span<const uint64_t> keys, std::span<const uint8_t> library) {
+	std::vector<uint64_t> sorted_keys{keys.begin(), keys.end()};
+	std::ranges::sort(sorted_keys);
+	auto duplicates = std::ranges::unique(sorted_keys);
+	sorted_keys.erase(duplicates.begin(), duplicates.end());
+
+	auto library_offset = sizeof(PipelineCacheHeader) + sorted_keys.size() * sizeof(uint64_t);
+	PipelineCacheHeader header{
+		.magic			= PIPELINE_CACHE_MAGIC,
+		.version		= PIPELINE_CACHE_VERSION,
+		.key_count		= (uint32_t)sorted_keys.size(),
+		.device_hash	= device_hash,
+		.library_offset	= library_offset,
+		.library_size	= library.size(),
+		.file_size		= library_offset + library.size(),
+	};
+
+	std::vector<uint8_t> bytes(header.file_size);
+	memcpy(bytes.data(), &header, sizeof(header));
+	if (!sorted_keys.empty())
+		memcpy(bytes.data() + sizeof(header), sorted_keys.data(),
+			   sorted_keys.size() * sizeof(uint64_t));
+	if (!library.empty())
+		memcpy(bytes.data() + library_offset, library.data(), library.size());
+
+	auto temporary_path = path;
+	temporary_path += ".tmp";
+	{
+		std::ofstream output{temporary_path, std::ios::binary | std::ios::trunc};
+		output.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+		if (!output)
+			throw;
+	}
+	std::filesystem::rename(temporary_path, path);
+}
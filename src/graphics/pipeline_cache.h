@@ -0,0 +1,58 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string_view>
+#include <vector>
+
+constexpr uint32_t PIPELINE_CACHE_MAGIC	  = 0x43505350;
+constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+struct PipelineCacheHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t key_count;
+	uint32_t reserved;
+	uint64_t device_hash;
+	uint64_t library_offset;
+	uint64_t library_size;
+	uint64_t file_size;
+};
+
+struct PipelineInputElement {
+	std::string_view semantic;
+	uint32_t semantic_index;
+	uint32_t format;
+	uint32_t input_slot;
+	uint32_t offset;
+	uint32_t classification;
+	uint32_t step_rate;
+};
+
+struct PipelineKeyDesc {
+	std::span<const uint8_t> root_signature;
+	std::span<const std::span<const uint8_t>> shaders;
+	std::span<const PipelineInputElement> input_layout;
+	std::span<const uint32_t> fixed_state;
+};
+
+struct PipelineCacheContents {
+	std::vector<uint64_t> keys;
+	std::vector<uint8_t> library;
+};
+
+struct PipelineCacheStats {
+	uint32_t requested_pipelines;
+	uint32_t library_hits;
+	uint32_t created_pipelines;
+	uint32_t prewarmed_pipelines;
+	uint32_t cache_writes;
+	uint64_t hash_nanoseconds;
+	uint64_t create_nanoseconds;
+};
+
+uint64_t HashPipelineKeyDesc(const PipelineKeyDesc& desc);
+PipelineCacheContents ReadPipelineCache(const std::filesystem::path& path, uint64_t device_hash);
+void WritePipelineCache(const std::filesystem::path& path, uint64_t device_hash,
+						std::span<const uint64_t> keys, std::span<const uint8_t> library);
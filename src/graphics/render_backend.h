@@ -0,0 +1,99 @@
+#pragma once
+
+#include <concepts>
+#include <cstdint>
+#include <span>
+
+#include "graphics/render_types.h"
+#include "platform_event.h"
+
+#ifdef GOBLIN_CPU_BACKEND
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+#include "graphics/cpu_mesh.h"
+#include "graphics/cpu_pipeline.h"
+#include "graphics/cpu_swap_chain.h"
+#else
+#include "graphics/device.h"
+#include "graphics/frame_resources.h"
+#include "graphics/mesh.h"
+#include "graphics/pipeline.h"
+#include "graphics/swap_chain.h"
+#endif
+
+template <typename Backend>
+concept RenderBackend = requires(
+	typename Backend::Device& device, typename Backend::Fence* fence,
+	typename Backend::CommandList& command_list,
+	std::span<const typename Backend::CommandList> command_lists,
+	typename Backend::Texture* texture, typename Backend::RenderTargetView render_target_view,
+	const typename Backend::Pipeline& pipeline, const typename Backend::Mesh& mesh,
+	typename Backend::SwapChain& swap_chain,
+	std::span<const TextureTransition<typename Backend::Texture>> transitions,
+	const typename Backend::UploadBuffer& upload_buffer,
+	typename Backend::ReadbackBuffer& readback_buffer, const TextureFootprint& footprint,
+	const float* clear_color, uint64_t value, EventHandle event) {
+	device.Execute(command_lists);
+	device.Signal(fence, value, event);
+	{ fence->GetCompletedValue() } -> std::convertible_to<uint64_t>;
+	command_list.Reset();
+	command_list.Barrier(transitions);
+	command_list.SetRenderTarget(render_target_view, 0u, 0u);
+	command_list.SetPipeline(pipeline);
+	command_list.SetConstants(value);
+	command_list.Clear(render_target_view, clear_color);
+	command_list.Draw(mesh);
+	command_list.Copy(texture, texture);
+	command_list.CopyBufferToTexture(texture, upload_buffer, footprint);
+	command_list.CopyTextureToBuffer(readback_buffer, texture, footprint);
+	command_list.Close();
+	{ swap_chain.Present() } -> std::same_as<PresentResult>;
+	{ swap_chain.GetCurrentBackBufferIndex() } -> std::convertible_to<uint32_t>;
+};
+
+#ifdef GOBLIN_CPU_BACKEND
+struct ActiveRenderBackend {
+	using Device		   = CpuDevice;
+	using Fence			   = CpuFence;
+	using Texture		   = CpuTexture;
+	using RenderTargetView = CpuTexture*;
+	using CommandList	   = CpuCommandList;
+	using FrameResources   = CpuFrameResources;
+	using TextureArray	   = CpuTextureArray;
+	using UploadBuffer	   = CpuUploadBuffer;
+	using ReadbackBuffer   = CpuReadbackBuffer;
+	using Pipeline		   = CpuPipeline;
+	using Mesh			   = CpuMesh;
+	using SwapChain		   = CpuSwapChain;
+};
+#else
+struct ActiveRenderBackend {
+	using Device		   = D3D12Device;
+	using Fence			   = ID3D12Fence;
+	using Texture		   = ID3D12Resource;
+	using RenderTargetView = D3D12_CPU_DESCRIPTOR_HANDLE;
+	using CommandList	   = D3D12CommandList;
+	using FrameResources   = D3D12FrameResources;
+	using TextureArray	   = D3D12TextureArray;
+	using UploadBuffer	   = D3D12UploadBuffer;
+	using ReadbackBuffer   = D3D12ReadbackBuffer;
+	using Pipeline		   = D3D12Pipeline;
+	using Mesh			   = D3D12Mesh;
+	using SwapChain		   = D3D12SwapChain;
+};
+#endif
+
+static_assert(RenderBackend<ActiveRenderBackend>);
+
+using RenderDevice		   = ActiveRenderBackend::Device;
+using RenderFence		   = ActiveRenderBackend::Fence;
+using RenderTexture		   = ActiveRenderBackend::Texture;
+using RenderTargetView	   = ActiveRenderBackend::RenderTargetView;
+using RenderCommandList	   = ActiveRenderBackend::CommandList;
+using RenderFrameResources = ActiveRenderBackend::FrameResources;
+using RenderTextureArray   = ActiveRenderBackend::TextureArray;
+using RenderUploadBuffer   = ActiveRenderBackend::UploadBuffer;
+using RenderReadbackBuffer = ActiveRenderBackend::ReadbackBuffer;
+using RenderPipeline	   = ActiveRenderBackend::Pipeline;
+using RenderMesh		   = ActiveRenderBackend::Mesh;
+using RenderSwapChain	   = ActiveRenderBackend::SwapChain;
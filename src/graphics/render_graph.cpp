@@ -0,0 +1,294 @@
+#include "graphics/render_graph.h"
+
+#include <algorithm>
+#include <bit>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+void RenderGraph::Reset() {
+	textures.clear();
+	passes.clear();
+	accesses.clear();
+	pass_order.clear();
+	transients.clear();
+	placed.clear();
+	overlapping.clear();
+	scheduled.clear();
+	transitions.clear();
+	final_transitions.clear();
+	aliasing.clear();
+	transient_heap_size		 = 0;
+	unaliased_transient_size = 0;
+}
+
+uint32_t RenderGraph::ImportTexture(ResourceState final_state) {
+	textures.push_back(TextureNode{.imported = true, .final_state = final_state});
+	return (uint32_t)textures.size() - 1;
+}
+
+uint32_t RenderGraph::CreateTexture(const RenderGraphTextureDesc& desc) {
+	if (!desc.size || !std::has_single_bit(desc.alignment))
+		throw;
+	textures.push_back(TextureNode{.desc = desc});
+	return (uint32_t)textures.size() - 1;
+}
+
+uint32_t RenderGraph::AddPass(bool has_side_effects) {
+	passes.push_back(PassNode{
+		.first_access	  = (uint32_t)accesses.size(),
+		.has_side_effects = has_side_effects,
+	});
+	return (uint32_t)passes.size() - 1;
+}
+
+void RenderGraph::Read(uint32_t pass, uint32_t texture, ResourceState state) {
+	AddAccess(pass, texture, state, false, false);
+}
+
+void RenderGraph::Write(uint32_t pass, uint32_t texture, ResourceState state, bool discard) {
+	AddAccess(pass, texture, state, true, discard);
+}
+
+void RenderGraph::AddAccess(uint32_t pass, uint32_t texture, ResourceState state, bool write,
+							bool discard) {
+	if (pass + 1 != passes.size() || texture >= textures.size())
+		throw;
+	accesses.push_back(
+		Access{.texture = texture, .state = state, .write = write, .discard = discard});
+	++passes[pass].access_count;
+}
+
+void RenderGraph::Compile() {
+	CullPasses();
+	ComputeLifetimes();
+	AliasTransients();
+	ScheduleAliasing();
+	ScheduleTransitions();
+}
+
+void RenderGraph::CullPasses() {
+	for (auto& texture : textures)
+		texture.needed = texture.imported;
+
+	for (auto p = (uint32_t)passes.size(); p-- > 0;) {
+		auto& pass		 = passes[p];
+		auto pass_access = std::span{accesses}.subspan(pass.first_access, pass.access_count);
+
+		pass.live = pass.has_side_effects;
+		for (auto& access : pass_access)
+			pass.live = pass.live || (access.write && textures[access.texture].needed);
+		if (!pass.live)
+			continue;
+
+		for (auto& access : pass_access)
+			if (access.discard)
+				textures[access.texture].needed = false;
+		for (auto& access : pass_access)
+			if (!access.write)
+				textures[access.texture].needed = true;
+	}
+
+	for (auto p = 0u; p < passes.size(); ++p)
+		if (passes[p].live)
+			pass_order.push_back(p);
+}
+
+void RenderGraph::ComputeLifetimes() {
+	for (auto& texture : textures) {
+		texture.first_use	= RENDER_GRAPH_INVALID;
+		texture.last_use	= RENDER_GRAPH_INVALID;
+		texture.offset		= ~0ull;
+		texture.last_access = RENDER_GRAPH_INVALID;
+	}
+
+	for (auto order = 0u; order < pass_order.size(); ++order) {
+		auto& pass = passes[pass_order[order]];
+		for (auto a = pass.first_access; a < pass.first_access + pass.access_count; ++a) {
+			auto& texture = textures[accesses[a].texture];
+			if (texture.first_use == RENDER_GRAPH_INVALID && !texture.imported
+				&& !accesses[a].discard)
+				throw;
+			texture.first_use = std::min(texture.first_use, order);
+			texture.last_use  = order;
+		}
+	}
+
+	for (auto t = 0u; t < textures.size(); ++t)
+		if (!textures[t].imported && textures[t].first_use != RENDER_GRAPH_INVALID)
+			transients.push_back(t);
+}
+
+void RenderGraph::AliasTransients() {
+	std::ranges::sort(transients, [this](uint32_t left, uint32_t right) {
+		auto left_size	= textures[left].desc.size;
+		auto right_size = textures[right].desc.size;
+		return left_size != right_size ? left_size > right_size : left < right;
+	});
+
+	for (auto t : transients) {
+		auto& texture = textures[t];
+
+		overlapping.clear();
+		for (auto other : placed)
+			if (textures[other].first_use <= texture.last_use
+				&& texture.first_use <= textures[other].last_use)
+				overlapping.push_back(other);
+		std::ranges::sort(overlapping, [this](uint32_t left, uint32_t right) {
+			return textures[left].offset < textures[right].offset;
+		});
+
+		auto offset = (uint64_t)0;
+		for (auto other : overlapping) {
+			if (offset + texture.desc.size <= textures[other].offset)
+				break;
+			auto other_end = textures[other].offset + textures[other].desc.size;
+			offset		   = std::max(offset, AlignUp(other_end, texture.desc.alignment));
+		}
+
+		texture.offset = offset;
+		placed.push_back(t);
+		transient_heap_size = std::max(transient_heap_size, offset + texture.desc.size);
+		unaliased_transient_size += texture.desc.size;
+	}
+}
+
+void RenderGraph::ScheduleAliasing() {
+	for (auto& pass : passes) {
+		pass.first_aliasing = 0;
+		pass.aliasing_count = 0;
+	}
+
+	std::ranges::sort(transients, [this](uint32_t left, uint32_t right) {
+		auto left_use  = textures[left].first_use;
+		auto right_use = textures[right].first_use;
+		return left_use != right_use ? left_use < right_use : left < right;
+	});
+
+	for (auto t : transients) {
+		auto& texture = textures[t];
+		auto before	  = RENDER_GRAPH_INVALID;
+		for (auto other : transients) {
+			auto& previous = textures[other];
+			if (previous.first_use >= texture.first_use)
+				break;
+			if (previous.last_use >= texture.first_use
+				|| previous.offset >= texture.offset + texture.desc.size
+				|| texture.offset >= previous.offset + previous.desc.size)
+				continue;
+			if (before == RENDER_GRAPH_INVALID || previous.last_use > textures[before].last_use)
+				before = other;
+		}
+
+		auto& pass = passes[pass_order[texture.first_use]];
+		if (!pass.aliasing_count)
+			pass.first_aliasing = (uint32_t)aliasing.size();
+		++pass.aliasing_count;
+		aliasing.push_back(RenderGraphAliasing{.before = before, .after = t});
+	}
+}
+
+void RenderGraph::ScheduleTransitions() {
+	auto schedule = [this](uint32_t order, uint32_t texture, ResourceState state,
+						   BarrierSplit split) {
+		scheduled.push_back(ScheduledTransition{
+			.order		= order,
+			.transition = {.texture = texture, .state = state, .split = split},
+		});
+	};
+
+	for (auto order = 0u; order < pass_order.size(); ++order) {
+		auto& pass = passes[pass_order[order]];
+		for (auto a = pass.first_access; a < pass.first_access + pass.access_count; ++a) {
+			auto& access  = accesses[a];
+			auto& texture = textures[access.texture];
+
+			if (texture.last_access == RENDER_GRAPH_INVALID)
+				schedule(order, access.texture, access.state, BarrierSplit::None);
+			else if (texture.last_state != access.state) {
+				if (texture.last_access == order)
+					throw;
+				if (order > texture.last_access + 1) {
+					schedule(texture.last_access + 1, access.texture, access.state,
+							 BarrierSplit::Begin);
+					schedule(order, access.texture, access.state, BarrierSplit::End);
+				}
+				else
+					schedule(order, access.texture, access.state, BarrierSplit::None);
+			}
+
+			texture.last_state	= access.state;
+			texture.last_access = order;
+		}
+	}
+
+	transitions.resize(scheduled.size());
+	for (auto order = 0u; order < pass_order.size(); ++order)
+		passes[pass_order[order]].transition_count = 0;
+	for (auto& entry : scheduled)
+		++passes[pass_order[entry.order]].transition_count;
+
+	auto next = 0u;
+	for (auto order = 0u; order < pass_order.size(); ++order) {
+		auto& pass			  = passes[pass_order[order]];
+		pass.first_transition = next;
+		next += pass.transition_count;
+		pass.transition_count = 0;
+	}
+	for (auto& entry : scheduled) {
+		auto& pass = passes[pass_order[entry.order]];
+		transitions[pass.first_transition + pass.transition_count++] = entry.transition;
+	}
+
+	for (auto t = 0u; t < textures.size(); ++t) {
+		auto& texture = textures[t];
+		if (texture.imported && texture.last_access != RENDER_GRAPH_INVALID
+			&& texture.last_state != texture.final_state)
+			final_transitions.push_back(RenderGraphTransition{
+				.texture = t,
+				.state	 = texture.final_state,
+				.split	 = BarrierSplit::None,
+			});
+	}
+}
+
+std::span<const uint32_t> RenderGraph::GetPassOrder() const {
+	return pass_order;
+}
+
+std::span<const RenderGraphTransition> RenderGraph::GetPassTransitions(uint32_t pass) const {
+	return std::span{transitions}.subspan(passes[pass].first_transition,
+										  passes[pass].transition_count);
+}
+
+std::span<const RenderGraphTransition> RenderGraph::GetFinalTransitions() const {
+	return final_transitions;
+}
+
+std::span<const RenderGraphAliasing> RenderGraph::GetPassAliasing(uint32_t pass) const {
+	return std::span{aliasing}.subspan(passes[pass].first_aliasing, passes[pass].aliasing_count);
+}
+
+std::span<const uint32_t> RenderGraph::GetTransients() const {
+	return transients;
+}
+
+const RenderGraphTextureDesc& RenderGraph::GetTextureDesc(uint32_t texture) const {
+	return textures[texture].desc;
+}
+
+uint64_t RenderGraph::GetTransientOffset(uint32_t texture) const {
+	return textures[texture].offset;
+}
+
+RenderGraphStats RenderGraph::GetStats() const {
+	return RenderGraphStats{
+		.pass_count				  = (uint32_t)passes.size(),
+		.live_pass_count		  = (uint32_t)pass_order.size(),
+		.transient_count		  = (uint32_t)transients.size(),
+		.aliasing_count			  = (uint32_t)aliasing.size(),
+		.transient_heap_size	  = transient_heap_size,
+		.unaliased_transient_size = unaliased_transient_size,
+	};
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "graphics/render_types.h"
+
+constexpr uint32_t RENDER_GRAPH_INVALID = ~0u;
+
+struct RenderGraphTextureDesc {
+	uint32_t width;
+	uint32_t height;
+	TextureFormat format;
+	uint64_t size;
+	uint64_t alignment;
+};
+
+struct RenderGraphTransition {
+	uint32_t texture;
+	ResourceState state;
+	BarrierSplit split;
+};
+
+struct RenderGraphAliasing {
+	uint32_t before;
+	uint32_t after;
+};
+
+struct RenderGraphStats {
+	uint32_t pass_count;
+	uint32_t live_pass_count;
+	uint32_t transient_count;
+	uint32_t aliasing_count;
+	uint64_t transient_heap_size;
+	uint64_t unaliased_transient_size;
+};
+
+class RenderGraph {
+  public:
+	void Reset();
+
+	uint32_t ImportTexture(ResourceState final_state);
+	uint32_t CreateTexture(const RenderGraphTextureDesc& desc);
+	uint32_t AddPass(bool has_side_effects = false);
+	void Read(uint32_t pass, uint32_t texture, ResourceState state);
+	void Write(uint32_t pass, uint32_t texture, ResourceState state, bool discard = false);
+
+	void Compile();
+
+	std::span<const uint32_t> GetPassOrder() const;
+	std::span<const RenderGraphTransition> GetPassTransitions(uint32_t pass) const;
+	std::span<const RenderGraphTransition> GetFinalTransitions() const;
+	std::span<const RenderGraphAliasing> GetPassAliasing(uint32_t pass) const;
+	std::span<const uint32_t> GetTransients() const;
+	const RenderGraphTextureDesc& GetTextureDesc(uint32_t texture) const;
+	uint64_t GetTransientOffset(uint32_t texture) const;
+	RenderGraphStats GetStats() const;
+
+  private:
+	struct TextureNode {
+		RenderGraphTextureDesc desc;
+		bool imported;
+		ResourceState final_state;
+		bool needed;
+		uint32_t first_use;
+		uint32_t last_use;
+		uint64_t offset;
+		ResourceState last_state;
+		uint32_t last_access;
+	};
+
+	struct PassNode {
+		uint32_t first_access;
+		uint32_t access_count;
+		bool has_side_effects;
+		bool live;
+		uint32_t first_transition;
+		uint32_t transition_count;
+		uint32_t first_aliasing;
+		uint32_t aliasing_count;
+	};
+
+	struct Access {
+		uint32_t texture;
+		ResourceState state;
+		bool write;
+		bool discard;
+	};
+
+	struct ScheduledTransition {
+		uint32_t order;
+		RenderGraphTransition transition;
+	};
+
+	void AddAccess(uint32_t pass, uint32_t texture, ResourceState state, bool write,
+				   bool discard);
+	void CullPasses();
+	void ComputeLifetimes();
+	void AliasTransients();
+	void ScheduleAliasing();
+	void ScheduleTransitions();
+
+	std::vector<TextureNode> textures;
+	std::vector<PassNode> passes;
+	std::vector<Access> accesses;
+	std::vector<uint32_t> pass_order;
+	std::vector<uint32_t> transients;
+	std::vector<uint32_t> placed;
+	std::vector<uint32_t> overlapping;
+	std::vector<ScheduledTransition> scheduled;
+	std::vector<RenderGraphTransition> transitions;
+	std::vector<RenderGraphTransition> final_transitions;
+	std::vector<RenderGraphAliasing> aliasing;
+	uint64_t transient_heap_size	  = 0;
+	uint64_t unaliased_transient_size = 0;
+};
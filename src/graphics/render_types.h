@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+
+enum class ResourceState : uint32_t {
+	Common,
+	RenderTarget,
+	CopySource,
+	CopyDest,
+	Present,
+};
+
+enum class TextureFormat : uint32_t {
+	B8G8R8A8Unorm,
+	R8G8B8A8Unorm,
+	R10G10B10A2Unorm,
+	NV12,
+	P010,
+};
+
+enum class PresentResult {
+	Presented,
+	StillDrawing,
+	Failed,
+};
+
+enum class BarrierSplit : uint32_t {
+	None,
+	Begin,
+	End,
+};
+
+constexpr uint32_t ALL_SUBRESOURCES = ~0u;
+
+constexpr uint32_t TEXTURE_DATA_PITCH_ALIGNMENT		= 256;
+constexpr uint32_t TEXTURE_DATA_PLACEMENT_ALIGNMENT = 512;
+
+struct TextureFootprint {
+	uint64_t offset;
+	uint32_t width;
+	uint32_t height;
+	TextureFormat format;
+	uint32_t row_pitch;
+	uint64_t chroma_offset;
+	uint64_t size;
+};
+
+constexpr uint32_t GetTextureSampleSize(TextureFormat format) {
+	switch (format) {
+		case TextureFormat::B8G8R8A8Unorm:
+		case TextureFormat::R8G8B8A8Unorm:
+		case TextureFormat::R10G10B10A2Unorm:
+			return 4;
+		case TextureFormat::NV12:
+			return 1;
+		case TextureFormat::P010:
+			return 2;
+	}
+	return 0;
+}
+
+constexpr bool IsPlanarFormat(TextureFormat format) {
+	return format == TextureFormat::NV12 || format == TextureFormat::P010;
+}
+
+constexpr TextureFootprint GetTextureFootprint(uint32_t width, uint32_t height,
+											   TextureFormat format, uint64_t offset = 0) {
+	auto align_up = [](uint64_t value, uint64_t alignment) {
+		return (value + alignment - 1) & ~(alignment - 1);
+	};
+	auto row_pitch = (uint32_t)align_up((uint64_t)width * GetTextureSampleSize(format),
+										TEXTURE_DATA_PITCH_ALIGNMENT);
+	auto luma_size = (uint64_t)row_pitch * height;
+	auto chroma_offset
+		= IsPlanarFormat(format) ? align_up(luma_size, TEXTURE_DATA_PLACEMENT_ALIGNMENT) : 0;
+	auto size = IsPlanarFormat(format) ? chroma_offset + (uint64_t)row_pitch * ((height + 1) / 2)
+									   : luma_size;
+	return TextureFootprint{
+		.offset		   = offset,
+		.width		   = width,
+		.height		   = height,
+		.format		   = format,
+		.row_pitch	   = row_pitch,
+		.chroma_offset = chroma_offset,
+		.size		   = align_up(size, TEXTURE_DATA_PLACEMENT_ALIGNMENT),
+	};
+}
+
+template <typename Texture>
+struct TextureTransition {
+	Texture* texture;
+	ResourceState before;
+	ResourceState after;
+	uint32_t subresource = ALL_SUBRESOURCES;
+	BarrierSplit split	 = BarrierSplit::None;
+};
+
+struct SwapChainConfig {
+	uint32_t buffer_count;
+	TextureFormat render_target_format;
+};
+
+struct MeshVertex {
+	float position[3];
+	float color[3];
+};
+
+constexpr MeshVertex TRIANGLE_VERTICES[]{
+	MeshVertex{.position = {0.0f, 0.25f, 0.0f}, .color = {1.0f, 0.0f, 0.0f}},
+	MeshVertex{.position = {0.25f, -0.25f, 0.0f}, .color = {0.0f, 1.0f, 0.0f}},
+	MeshVertex{.position = {-0.25f, -0.25f, 0.0f}, .color = {0.0f, 0.0f, 1.0f}},
+};
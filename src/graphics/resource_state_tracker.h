@@ -0,0 +1,201 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "graphics/render_types.h"
+
+struct ResourceStateTrackerStats {
+	uint64_t requested_transitions;
+	uint64_t emitted_barriers;
+	uint64_t elided_transitions;
+	uint64_t split_barriers;
+	uint64_t flushes;
+};
+
+template <typename Texture>
+class ResourceStateTracker {
+  public:
+	void RegisterTexture(Texture* texture, ResourceState state, uint32_t subresource_count = 1) {
+		if (FindTexture(texture) || !subresource_count)
+			throw;
+		textures.push_back(TrackedTexture{
+			.texture	  = texture,
+			.subresources = std::vector<SubresourceState>(
+				subresource_count, SubresourceState{.state = state, .desired = state}),
+		});
+	}
+
+	void UnregisterTexture(Texture* texture) {
+		auto tracked = FindTexture(texture);
+		if (!tracked)
+			throw;
+		textures.erase(textures.begin() + (tracked - textures.data()));
+	}
+
+	void Transition(Texture* texture, ResourceState after,
+					uint32_t subresource = ALL_SUBRESOURCES) {
+		ForEachSubresource(texture, subresource, [&](SubresourceState& state) {
+			state.desired	  = after;
+			state.split_begin = false;
+			if (state.split_active)
+				state.split_end = true;
+		});
+	}
+
+	void BeginSplitTransition(Texture* texture, ResourceState after,
+							  uint32_t subresource = ALL_SUBRESOURCES) {
+		ForEachSubresource(texture, subresource, [&](SubresourceState& state) {
+			if (state.split_active)
+				throw;
+			state.desired	  = after;
+			state.split_begin = after != state.state;
+		});
+	}
+
+	ResourceState GetState(Texture* texture, uint32_t subresource = 0) const {
+		auto tracked = FindTexture(texture);
+		if (!tracked || subresource >= tracked->subresources.size())
+			throw;
+		return tracked->subresources[subresource].desired;
+	}
+
+	template <typename CommandList>
+	void Flush(CommandList& command_list) {
+		barriers.clear();
+		for (auto& tracked : textures) {
+			if (!tracked.dirty)
+				continue;
+			auto first_barrier = barriers.size();
+			for (auto s = 0u; s < tracked.subresources.size(); ++s)
+				FlushSubresource(tracked.texture, s, tracked.subresources[s]);
+			CollapseSubresources(tracked, first_barrier);
+			tracked.dirty = false;
+		}
+
+		++stats.flushes;
+		stats.emitted_barriers += barriers.size();
+		for (auto& barrier : barriers)
+			stats.split_barriers += barrier.split != BarrierSplit::None ? 1 : 0;
+		if (!barriers.empty())
+			command_list.Barrier(std::span<const TextureTransition<Texture>>{barriers});
+	}
+
+	ResourceStateTrackerStats GetStats() const {
+		return stats;
+	}
+
+  private:
+	struct SubresourceState {
+		ResourceState state;
+		ResourceState desired;
+		ResourceState split_before;
+		bool requested;
+		bool split_begin;
+		bool split_active;
+		bool split_end;
+	};
+
+	struct TrackedTexture {
+		Texture* texture;
+		std::vector<SubresourceState> subresources;
+		bool dirty;
+	};
+
+	TrackedTexture* FindTexture(Texture* texture) {
+		for (auto& tracked : textures)
+			if (tracked.texture == texture)
+				return &tracked;
+		return nullptr;
+	}
+
+	const TrackedTexture* FindTexture(Texture* texture) const {
+		for (auto& tracked : textures)
+			if (tracked.texture == texture)
+				return &tracked;
+		return nullptr;
+	}
+
+	void ForEachSubresource(Texture* texture, uint32_t subresource, const auto& update) {
+		auto tracked = FindTexture(texture);
+		if (!tracked)
+			throw;
+
+		++stats.requested_transitions;
+		tracked->dirty = true;
+
+		auto request = [&](SubresourceState& state) {
+			state.requested = true;
+			update(state);
+		};
+		if (subresource == ALL_SUBRESOURCES) {
+			for (auto& state : tracked->subresources)
+				request(state);
+			return;
+		}
+		if (subresource >= tracked->subresources.size())
+			throw;
+		request(tracked->subresources[subresource]);
+	}
+
+	void FlushSubresource(Texture* texture, uint32_t subresource, SubresourceState& state) {
+		auto first_barrier = barriers.size();
+		auto requested	   = std::exchange(state.requested, false);
+		auto emit = [&](ResourceState before, ResourceState after, BarrierSplit split) {
+			barriers.push_back(TextureTransition<Texture>{
+				.texture	 = texture,
+				.before		 = before,
+				.after		 = after,
+				.subresource = subresource,
+				.split		 = split,
+			});
+		};
+
+		if (state.split_active && state.split_end) {
+			emit(state.split_before, state.state, BarrierSplit::End);
+			state.split_active = false;
+			state.split_end	   = false;
+		}
+
+		if (state.split_begin) {
+			emit(state.state, state.desired, BarrierSplit::Begin);
+			state.split_before = state.state;
+			state.state		   = state.desired;
+			state.split_active = true;
+			state.split_begin  = false;
+			return;
+		}
+
+		if (state.state == state.desired) {
+			stats.elided_transitions += requested && barriers.size() == first_barrier ? 1 : 0;
+			return;
+		}
+		emit(state.state, state.desired, BarrierSplit::None);
+		state.state = state.desired;
+	}
+
+	void CollapseSubresources(const TrackedTexture& tracked, size_t first_barrier) {
+		auto count = barriers.size() - first_barrier;
+		if (!count || count % tracked.subresources.size())
+			return;
+
+		auto per_subresource = count / tracked.subresources.size();
+		for (auto i = 0u; i < count; ++i) {
+			auto& barrier = barriers[first_barrier + i];
+			auto& first	  = barriers[first_barrier + i % per_subresource];
+			if (barrier.subresource != i / per_subresource || barrier.before != first.before
+				|| barrier.after != first.after || barrier.split != first.split)
+				return;
+		}
+
+		for (auto i = 0u; i < per_subresource; ++i)
+			barriers[first_barrier + i].subresource = ALL_SUBRESOURCES;
+		barriers.resize(first_barrier + per_subresource);
+	}
+
+	std::vector<TrackedTexture> textures;
+	std::vector<TextureTransition<Texture>> barriers;
+	ResourceStateTrackerStats stats{};
+};
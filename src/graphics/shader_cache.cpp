@@ -0,0 +1,233 @@
+#include "graphics/shader_cache.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <string_view>
+
+#include "content_hash.h"
+
+static uint64_t AlignUp(uint64_t value) {
+	return (value + SHADER_PACK_ALIGNMENT - 1) & ~(SHADER_PACK_ALIGNMENT - 1);
+}
+
+static uint64_t GetElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+static std::string_view SkipWhitespace(std::string_view text) {
+	while (!text.empty() && (text.front() == ' ' || text.front() == '\t'))
+		text.remove_prefix(1);
+	return text;
+}
+
+static std::vector<std::string_view> ParseIncludes(std::string_view text) {
+	std::vector<std::string_view> includes;
+	while (!text.empty()) {
+		auto line_end = text.find('\n');
+		auto line	  = SkipWhitespace(text.substr(0, line_end));
+		text.remove_prefix(line_end == std::string_view::npos ? text.size() : line_end + 1);
+
+		if (!line.starts_with('#'))
+			continue;
+		line = SkipWhitespace(line.substr(1));
+		if (!line.starts_with("include"))
+			continue;
+		line = SkipWhitespace(line.substr(7));
+		if (line.empty() || (line.front() != '"' && line.front() != '<'))
+			continue;
+
+		auto close = line.find(line.front() == '"' ? '"' : '>', 1);
+		if (close != std::string_view::npos)
+			includes.push_back(line.substr(1, close - 1));
+	}
+	return includes;
+}
+
+static void HashSourceFile(const std::filesystem::path& path,
+						   std::vector<std::filesystem::path>& visited, uint64_t& hash) {
+	auto normal_path = path.lexically_normal();
+	if (std::ranges::find(visited, normal_path) != visited.end())
+		return;
+	visited.push_back(normal_path);
+	hash = HashString(hash, normal_path.filename().string());
+
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(normal_path, error)
+		|| !std::filesystem::file_size(normal_path, error))
+		return;
+
+	MappedFile file{normal_path.string().c_str()};
+	hash = HashBytes(hash, {file.data, file.size});
+	for (auto include : ParseIncludes({(const char*)file.data, file.size}))
+		HashSourceFile(normal_path.parent_path() / include, visited, hash);
+}
+
+uint64_t HashShaderDesc(const ShaderDesc& desc) {
+	auto hash = HashValue(CONTENT_HASH_SEED, SHADER_PACK_VERSION);
+	hash	  = HashString(hash, desc.entry);
+	hash	  = HashString(hash, desc.target);
+	hash	  = HashValue(hash, desc.flags);
+
+	std::vector<std::filesystem::path> visited;
+	HashSourceFile(desc.source_path, visited, hash);
+	return hash;
+}
+
+ShaderCache::ShaderCache(std::filesystem::path pack_path, ShaderCompileFunction compile,
+						 JobSystem* job_system)
+	: pack_path(std::move(pack_path)), compile(compile), job_system(job_system) {
+	OpenPack();
+}
+
+std::vector<std::span<const uint8_t>> ShaderCache::Load(std::span<const ShaderDesc> descs) {
+	auto hash_start = std::chrono::steady_clock::now();
+	std::vector<uint64_t> keys;
+	for (auto& desc : descs)
+		keys.push_back(HashShaderDesc(desc));
+	stats.hash_nanoseconds += GetElapsedNanoseconds(hash_start);
+
+	std::vector<uint32_t> misses;
+	std::vector<uint64_t> miss_keys;
+	for (auto i = 0u; i < keys.size(); ++i) {
+		if (!Find(keys[i]).empty())
+			continue;
+		misses.push_back(i);
+		miss_keys.push_back(keys[i]);
+	}
+	stats.requested_shaders += (uint32_t)descs.size();
+	stats.pack_hits += (uint32_t)(descs.size() - misses.size());
+
+	if (!misses.empty()) {
+		auto compile_start = std::chrono::steady_clock::now();
+		std::vector<std::vector<uint8_t>> results(misses.size());
+		CompileJob job{.compile = compile, .descs = descs, .misses = misses, .results = results};
+		auto run = [](void* data, uint32_t index) {
+			auto& job		   = *(CompileJob*)data;
+			job.results[index] = job.compile(job.descs[job.misses[index]]);
+			if (job.results[index].empty())
+				throw;
+		};
+
+		if (job_system) {
+			JobCounter counter;
+			job_system->SubmitBatch(run, &job, (uint32_t)misses.size(), &counter);
+			job_system->Wait(counter);
+		}
+		else
+			for (auto i = 0u; i < misses.size(); ++i)
+				run(&job, i);
+
+		stats.compile_nanoseconds += GetElapsedNanoseconds(compile_start);
+		stats.compiled_shaders += (uint32_t)misses.size();
+		WritePack(miss_keys, results);
+	}
+
+	std::vector<std::span<const uint8_t>> blobs;
+	for (auto key : keys) {
+		blobs.push_back(Find(key));
+		if (blobs.back().empty())
+			throw;
+	}
+	return blobs;
+}
+
+std::span<const uint8_t> ShaderCache::Find(uint64_t key) const {
+	auto entry = std::ranges::lower_bound(entries, key, {}, &ShaderPackEntry::key);
+	if (entry == entries.end() || entry->key != key)
+		return {};
+	return {pack->data + entry->offset, (size_t)entry->size};
+}
+
+ShaderCacheStats ShaderCache::GetStats() const {
+	return stats;
+}
+
+void ShaderCache::OpenPack() {
+	entries = {};
+	pack.reset();
+
+	std::error_code error;
+	if (!std::filesystem::is_regular_file(pack_path, error)
+		|| std::filesystem::file_size(pack_path, error) < sizeof(ShaderPackHeader))
+		return;
+
+	pack.emplace(pack_path.string().c_str());
+	auto& header	= *(const ShaderPackHeader*)pack->data;
+	auto table_size = (uint64_t)header.entry_count * sizeof(ShaderPackEntry);
+	if (header.magic != SHADER_PACK_MAGIC || header.version != SHADER_PACK_VERSION
+		|| header.file_size != pack->size || table_size > pack->size - sizeof(ShaderPackHeader)) {
+		pack.reset();
+		return;
+	}
+
+	std::span table{(const ShaderPackEntry*)(pack->data + sizeof(ShaderPackHeader)),
+					header.entry_count};
+	for (auto i = 0u; i < table.size(); ++i) {
+		if (table[i].offset > pack->size || table[i].size > pack->size - table[i].offset
+			|| (i && table[i - 1].key >= table[i].key)) {
+			pack.reset();
+			return;
+		}
+	}
+	entries = table;
+}
+
+void ShaderCache::WritePack(std::span<const uint64_t> keys,
+							std::span<const std::vector<uint8_t>> blobs) {
+	struct PackSource {
+		uint64_t key;
+		std::span<const uint8_t> data;
+	};
+
+	std::vector<PackSource> sources;
+	for (auto& entry : entries)
+		sources.push_back(PackSource{.key = entry.key, .data = Find(entry.key)});
+	for (auto i = 0u; i < keys.size(); ++i)
+		sources.push_back(PackSource{.key = keys[i], .data = blobs[i]});
+
+	std::ranges::stable_sort(sources, {}, &PackSource::key);
+	auto duplicates = std::ranges::unique(sources, {}, &PackSource::key);
+	sources.erase(duplicates.begin(), duplicates.end());
+
+	auto offset = AlignUp(sizeof(ShaderPackHeader) + sources.size() * sizeof(ShaderPackEntry));
+	std::vector<ShaderPackEntry> table;
+	for (auto& source : sources) {
+		table.push_back(ShaderPackEntry{
+			.key	= source.key,
+			.offset = offset,
+			.size	= source.data.size(),
+		});
+		offset = AlignUp(offset + source.data.size());
+	}
+
+	std::vector<uint8_t> bytes(offset);
+	ShaderPackHeader header{
+		.magic		 = SHADER_PACK_MAGIC,
+		.version	 = SHADER_PACK_VERSION,
+		.entry_count = (uint32_t)table.size(),
+		.file_size	 = offset,
+	};
+	memcpy(bytes.data(), &header, sizeof(header));
+	memcpy(bytes.data() + sizeof(header), table.data(), table.size() * sizeof(ShaderPackEntry));
+	for (auto i = 0u; i < sources.size(); ++i)
+		memcpy(bytes.data() + table[i].offset, sources[i].data.data(), sources[i].data.size());
+
+	entries = {};
+	pack.reset();
+
+	auto temporary_path = pack_path;
+	temporary_path += ".tmp";
+	{
+		std::ofstream output{temporary_path, std::ios::binary | std::ios::trunc};
+		output.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+		if (!output)
+			throw;
+	}
+	std::filesystem::rename(temporary_path, pack_path);
+
+	++stats.pack_writes;
+	OpenPack();
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "job_system.h"
+#include "mapped_file.h"
+
+constexpr uint32_t SHADER_PACK_MAGIC	 = 0x4b504853;
+constexpr uint32_t SHADER_PACK_VERSION	 = 1;
+constexpr uint64_t SHADER_PACK_ALIGNMENT = 16;
+
+struct ShaderPackHeader {
+	uint32_t magic;
+	uint32_t version;
+	uint32_t entry_count;
+	uint32_t reserved;
+	uint64_t file_size;
+};
+
+struct ShaderPackEntry {
+	uint64_t key;
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct ShaderDesc {
+	std::filesystem::path source_path;
+	std::string entry;
+	std::string target;
+	uint32_t flags;
+};
+
+struct ShaderCacheStats {
+	uint32_t requested_shaders;
+	uint32_t pack_hits;
+	uint32_t compiled_shaders;
+	uint32_t pack_writes;
+	uint64_t hash_nanoseconds;
+	uint64_t compile_nanoseconds;
+};
+
+using ShaderCompileFunction = std::vector<uint8_t> (*)(const ShaderDesc& desc);
+
+uint64_t HashShaderDesc(const ShaderDesc& desc);
+
+class ShaderCache {
+  public:
+	ShaderCache(std::filesystem::path pack_path, ShaderCompileFunction compile,
+				JobSystem* job_system);
+
+	std::vector<std::span<const uint8_t>> Load(std::span<const ShaderDesc> descs);
+	std::span<const uint8_t> Find(uint64_t key) const;
+	ShaderCacheStats GetStats() const;
+
+  private:
+	struct CompileJob {
+		ShaderCompileFunction compile;
+		std::span<const ShaderDesc> descs;
+		std::span<const uint32_t> misses;
+		std::span<std::vector<uint8_t>> results;
+	};
+
+	void OpenPack();
+	void WritePack(std::span<const uint64_t> keys, std::span<const std::vector<uint8_t>> blobs);
+
+	std::filesystem::path pack_path;
+	ShaderCompileFunction compile;
+	JobSystem* job_system;
+	std::optional<MappedFile> pack;
+	std::span<const ShaderPackEntry> entries;
+	ShaderCacheStats stats{};
+};
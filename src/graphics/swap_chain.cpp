@@ -3,6 +3,7 @@
 #include <windows.h>
 #include <wrl/client.h>
 
+#include "graphics/device.h"
 #include "try.h"
 
 D3D12SwapChain::D3D12SwapChain(ID3D12Device* dev, IDXGIFactory7* fac, ID3D12CommandQueue* queue,
@@ -28,7 +29,7 @@ void D3D12SwapChain::CreateSwapChain(HWND window_handle) {
 	DXGI_SWAP_CHAIN_DESC1 sc_desc{
 		.Width		 = width,
 		.Height		 = height,
-		.Format		 = render_target_format,
+		.Format		 = ToDxgiFormat(render_target_format),
 		.SampleDesc	 = {.Count = 1, .Quality = 0},
 		.BufferUsage = DXGI_USAGE_BACK_BUFFER,
 		.BufferCount = buffer_count,
@@ -53,6 +54,17 @@ D3D12SwapChain::~D3D12SwapChain() {
 	CloseHandle(frame_latency_waitable);
 }
 
+PresentResult D3D12SwapChain::Present() {
+	auto present_result = swap_chain->Present(1, DXGI_PRESENT_DO_NOT_WAIT);
+	if (present_result == DXGI_ERROR_WAS_STILL_DRAWING)
+		return PresentResult::StillDrawing;
+	return SUCCEEDED(present_result) ? PresentResult::Presented : PresentResult::Failed;
+}
+
+uint32_t D3D12SwapChain::GetCurrentBackBufferIndex() const {
+	return swap_chain->GetCurrentBackBufferIndex();
+}
+
 void D3D12SwapChain::AcquireBackBuffers() {
 	for (uint32_t i = 0; i < buffer_count; ++i) {
 		Try | swap_chain->GetBuffer(i, IID_PPV_ARGS(&render_targets[i]));
@@ -6,12 +6,9 @@
 
 #include <vector>
 
-using Microsoft::WRL::ComPtr;
+#include "graphics/render_types.h"
 
-struct SwapChainConfig {
-	uint32_t buffer_count;
-	DXGI_FORMAT render_target_format;
-};
+using Microsoft::WRL::ComPtr;
 
 class D3D12SwapChain {
   public:
@@ -19,6 +16,9 @@ class D3D12SwapChain {
 				   HWND window_handle, const SwapChainConfig& config);
 	~D3D12SwapChain();
 
+	PresentResult Present();
+	uint32_t GetCurrentBackBufferIndex() const;
+
 	ComPtr<IDXGISwapChain4> swap_chain;
 	HANDLE frame_latency_waitable;
 	std::vector<ComPtr<ID3D12Resource>> render_targets;
@@ -31,5 +31,5 @@ class D3D12SwapChain {
 	IDXGIFactory7* factory;
 	ID3D12CommandQueue* command_queue;
 	uint32_t buffer_count;
-	DXGI_FORMAT render_target_format;
+	TextureFormat render_target_format;
 };
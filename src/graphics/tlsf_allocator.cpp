@@ -0,0 +1,298 @@
+#include "graphics/tlsf_allocator.h"
+
+#include <algorithm>
+#include <bit>
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static float ComputeFragmentation(uint64_t reserved_bytes, uint64_t used_bytes,
+								  uint64_t largest_free_range) {
+	auto free_bytes = reserved_bytes - used_bytes;
+	return free_bytes ? 1.0f - (float)largest_free_range / (float)free_bytes : 0.0f;
+}
+
+TlsfAllocator::TlsfAllocator(uint64_t capacity)
+	: capacity(AlignUp(capacity, TLSF_GRANULARITY)) {
+	if (!capacity)
+		throw;
+
+	for (auto& heads : free_heads)
+		std::ranges::fill(heads, TLSF_INVALID_NODE);
+
+	InsertFree(AcquireNode(Node{
+		.offset		   = 0,
+		.size		   = this->capacity,
+		.prev_physical = TLSF_INVALID_NODE,
+		.next_physical = TLSF_INVALID_NODE,
+	}));
+}
+
+void TlsfAllocator::MapSize(uint64_t units, uint32_t& fl, uint32_t& sl) {
+	if (units < SL_COUNT) {
+		fl = 0;
+		sl = (uint32_t)units;
+		return;
+	}
+	auto log2 = (uint32_t)std::bit_width(units) - 1;
+	fl		  = log2 - SL_LOG2 + 1;
+	sl		  = (uint32_t)(units >> (log2 - SL_LOG2)) - SL_COUNT;
+}
+
+uint32_t TlsfAllocator::FindFreeNode(uint64_t units) const {
+	if (units >= SL_COUNT)
+		units += (1ull << (std::bit_width(units) - 1 - SL_LOG2)) - 1;
+
+	uint32_t fl;
+	uint32_t sl;
+	MapSize(units, fl, sl);
+	if (fl >= FL_COUNT)
+		return TLSF_INVALID_NODE;
+
+	auto sl_map = sl_bitmaps[fl] & (~0u << sl);
+	if (!sl_map) {
+		auto fl_map = fl + 1 < FL_COUNT ? fl_bitmap & (~0ull << (fl + 1)) : 0;
+		if (!fl_map)
+			return TLSF_INVALID_NODE;
+		fl	   = (uint32_t)std::countr_zero(fl_map);
+		sl_map = sl_bitmaps[fl];
+	}
+	return free_heads[fl][std::countr_zero(sl_map)];
+}
+
+uint32_t TlsfAllocator::FindFittingNode(uint64_t size, uint64_t alignment) const {
+	uint32_t fl;
+	uint32_t sl;
+	MapSize(size / TLSF_GRANULARITY, fl, sl);
+	if (fl >= FL_COUNT)
+		return TLSF_INVALID_NODE;
+
+	for (auto node = free_heads[fl][sl]; node != TLSF_INVALID_NODE; node = nodes[node].next_free)
+		if (AlignUp(nodes[node].offset, alignment) - nodes[node].offset + size <= nodes[node].size)
+			return node;
+	return TLSF_INVALID_NODE;
+}
+
+uint32_t TlsfAllocator::AcquireNode(const Node& node) {
+	if (unused_nodes.empty()) {
+		nodes.push_back(node);
+		return (uint32_t)nodes.size() - 1;
+	}
+	auto index = unused_nodes.back();
+	unused_nodes.pop_back();
+	nodes[index] = node;
+	return index;
+}
+
+void TlsfAllocator::ReleaseNode(uint32_t node) {
+	unused_nodes.push_back(node);
+}
+
+void TlsfAllocator::InsertFree(uint32_t node) {
+	uint32_t fl;
+	uint32_t sl;
+	MapSize(nodes[node].size / TLSF_GRANULARITY, fl, sl);
+
+	auto head			  = free_heads[fl][sl];
+	nodes[node].is_free	  = true;
+	nodes[node].prev_free = TLSF_INVALID_NODE;
+	nodes[node].next_free = head;
+	if (head != TLSF_INVALID_NODE)
+		nodes[head].prev_free = node;
+
+	free_heads[fl][sl] = node;
+	sl_bitmaps[fl] |= 1u << sl;
+	fl_bitmap |= 1ull << fl;
+	++free_range_count;
+}
+
+void TlsfAllocator::RemoveFree(uint32_t node) {
+	uint32_t fl;
+	uint32_t sl;
+	MapSize(nodes[node].size / TLSF_GRANULARITY, fl, sl);
+
+	auto prev = nodes[node].prev_free;
+	auto next = nodes[node].next_free;
+	if (prev != TLSF_INVALID_NODE)
+		nodes[prev].next_free = next;
+	else
+		free_heads[fl][sl] = next;
+	if (next != TLSF_INVALID_NODE)
+		nodes[next].prev_free = prev;
+
+	if (free_heads[fl][sl] == TLSF_INVALID_NODE) {
+		sl_bitmaps[fl] &= ~(1u << sl);
+		if (!sl_bitmaps[fl])
+			fl_bitmap &= ~(1ull << fl);
+	}
+	nodes[node].is_free = false;
+	--free_range_count;
+}
+
+TlsfAllocation TlsfAllocator::Allocate(uint64_t size, uint64_t alignment) {
+	alignment = std::max(alignment, TLSF_GRANULARITY);
+	if (!std::has_single_bit(alignment) || size > capacity)
+		return TlsfAllocation{};
+
+	size	   = AlignUp(std::max(size, (uint64_t)1), TLSF_GRANULARITY);
+	auto units = size / TLSF_GRANULARITY;
+	auto node  = FindFreeNode(units);
+	if (node != TLSF_INVALID_NODE && nodes[node].offset % alignment)
+		node = FindFreeNode(units + alignment / TLSF_GRANULARITY - 1);
+	if (node == TLSF_INVALID_NODE)
+		node = FindFittingNode(size, alignment);
+	if (node == TLSF_INVALID_NODE)
+		return TlsfAllocation{};
+
+	RemoveFree(node);
+
+	auto padding = AlignUp(nodes[node].offset, alignment) - nodes[node].offset;
+	if (padding) {
+		auto front = AcquireNode(Node{
+			.offset		   = nodes[node].offset,
+			.size		   = padding,
+			.prev_physical = nodes[node].prev_physical,
+			.next_physical = node,
+		});
+		if (nodes[front].prev_physical != TLSF_INVALID_NODE)
+			nodes[nodes[front].prev_physical].next_physical = front;
+		nodes[node].prev_physical = front;
+		nodes[node].offset += padding;
+		nodes[node].size -= padding;
+		InsertFree(front);
+	}
+
+	if (nodes[node].size > size) {
+		auto back = AcquireNode(Node{
+			.offset		   = nodes[node].offset + size,
+			.size		   = nodes[node].size - size,
+			.prev_physical = node,
+			.next_physical = nodes[node].next_physical,
+		});
+		if (nodes[back].next_physical != TLSF_INVALID_NODE)
+			nodes[nodes[back].next_physical].prev_physical = back;
+		nodes[node].next_physical = back;
+		nodes[node].size		  = size;
+		InsertFree(back);
+	}
+
+	used_bytes += size;
+	++allocation_count;
+	return TlsfAllocation{.offset = nodes[node].offset, .size = size, .node = node};
+}
+
+void TlsfAllocator::Free(const TlsfAllocation& allocation) {
+	auto node = allocation.node;
+	if (node >= nodes.size() || nodes[node].is_free || nodes[node].offset != allocation.offset)
+		throw;
+
+	used_bytes -= nodes[node].size;
+	--allocation_count;
+
+	auto prev = nodes[node].prev_physical;
+	if (prev != TLSF_INVALID_NODE && nodes[prev].is_free) {
+		RemoveFree(prev);
+		nodes[prev].size += nodes[node].size;
+		nodes[prev].next_physical = nodes[node].next_physical;
+		if (nodes[prev].next_physical != TLSF_INVALID_NODE)
+			nodes[nodes[prev].next_physical].prev_physical = prev;
+		ReleaseNode(node);
+		node = prev;
+	}
+
+	auto next = nodes[node].next_physical;
+	if (next != TLSF_INVALID_NODE && nodes[next].is_free) {
+		RemoveFree(next);
+		nodes[node].size += nodes[next].size;
+		nodes[node].next_physical = nodes[next].next_physical;
+		if (nodes[node].next_physical != TLSF_INVALID_NODE)
+			nodes[nodes[node].next_physical].prev_physical = node;
+		ReleaseNode(next);
+	}
+
+	InsertFree(node);
+}
+
+TlsfStats TlsfAllocator::GetStats() const {
+	auto largest_free_range = (uint64_t)0;
+	if (fl_bitmap) {
+		auto fl = (uint32_t)std::bit_width(fl_bitmap) - 1;
+		auto sl = (uint32_t)std::bit_width(sl_bitmaps[fl]) - 1;
+		auto node = free_heads[fl][sl];
+		for (; node != TLSF_INVALID_NODE; node = nodes[node].next_free)
+			largest_free_range = std::max(largest_free_range, nodes[node].size);
+	}
+
+	return TlsfStats{
+		.capacity			= capacity,
+		.used_bytes			= used_bytes,
+		.largest_free_range = largest_free_range,
+		.allocation_count	= allocation_count,
+		.free_range_count	= free_range_count,
+	};
+}
+
+HeapPool::HeapPool(uint64_t block_size) : block_size(AlignUp(block_size, TLSF_GRANULARITY)) {
+}
+
+HeapPoolAllocation HeapPool::Allocate(uint64_t size, uint64_t alignment) {
+	auto block = 0u;
+	auto range = TlsfAllocation{};
+	for (; block < blocks.size() && range.node == TLSF_INVALID_NODE; ++block)
+		range = blocks[block].Allocate(size, alignment);
+
+	if (range.node == TLSF_INVALID_NODE) {
+		auto dedicated_size = AlignUp(size, std::max(alignment, TLSF_GRANULARITY));
+		blocks.emplace_back(std::max(block_size, dedicated_size));
+		range = blocks.back().Allocate(size, alignment);
+		block = (uint32_t)blocks.size();
+		if (range.node == TLSF_INVALID_NODE)
+			throw;
+	}
+
+	used_bytes += range.size;
+	peak_used_bytes = std::max(peak_used_bytes, used_bytes);
+	return HeapPoolAllocation{.block = block - 1, .range = range};
+}
+
+void HeapPool::Free(const HeapPoolAllocation& allocation) {
+	if (allocation.block >= blocks.size())
+		throw;
+	blocks[allocation.block].Free(allocation.range);
+	used_bytes -= allocation.range.size;
+}
+
+HeapPoolStats HeapPool::GetStats() const {
+	HeapPoolStats stats{.peak_used_bytes = peak_used_bytes};
+	for (auto& block : blocks) {
+		auto block_stats = block.GetStats();
+		stats.block_count++;
+		stats.empty_block_count += block_stats.allocation_count ? 0 : 1;
+		stats.reserved_bytes += block_stats.capacity;
+		stats.used_bytes += block_stats.used_bytes;
+		stats.largest_free_range
+			= std::max(stats.largest_free_range, block_stats.largest_free_range);
+		stats.allocation_count += block_stats.allocation_count;
+		stats.free_range_count += block_stats.free_range_count;
+	}
+	stats.fragmentation
+		= ComputeFragmentation(stats.reserved_bytes, stats.used_bytes, stats.largest_free_range);
+	return stats;
+}
+
+HeapPoolStats CombineHeapPoolStats(const HeapPoolStats& left, const HeapPoolStats& right) {
+	HeapPoolStats stats{
+		.block_count		= left.block_count + right.block_count,
+		.empty_block_count	= left.empty_block_count + right.empty_block_count,
+		.reserved_bytes		= left.reserved_bytes + right.reserved_bytes,
+		.used_bytes			= left.used_bytes + right.used_bytes,
+		.peak_used_bytes	= left.peak_used_bytes + right.peak_used_bytes,
+		.largest_free_range = std::max(left.largest_free_range, right.largest_free_range),
+		.allocation_count	= left.allocation_count + right.allocation_count,
+		.free_range_count	= left.free_range_count + right.free_range_count,
+	};
+	stats.fragmentation
+		= ComputeFragmentation(stats.reserved_bytes, stats.used_bytes, stats.largest_free_range);
+	return stats;
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+constexpr uint64_t TLSF_GRANULARITY	 = 256;
+constexpr uint32_t TLSF_INVALID_NODE = ~0u;
+
+struct TlsfAllocation {
+	uint64_t offset;
+	uint64_t size;
+	uint32_t node = TLSF_INVALID_NODE;
+};
+
+struct TlsfStats {
+	uint64_t capacity;
+	uint64_t used_bytes;
+	uint64_t largest_free_range;
+	uint32_t allocation_count;
+	uint32_t free_range_count;
+};
+
+class TlsfAllocator {
+  public:
+	explicit TlsfAllocator(uint64_t capacity);
+
+	TlsfAllocation Allocate(uint64_t size, uint64_t alignment);
+	void Free(const TlsfAllocation& allocation);
+	TlsfStats GetStats() const;
+
+	uint64_t capacity;
+
+  private:
+	static constexpr uint32_t SL_LOG2  = 4;
+	static constexpr uint32_t SL_COUNT = 1 << SL_LOG2;
+	static constexpr uint32_t FL_COUNT = 64;
+
+	struct Node {
+		uint64_t offset;
+		uint64_t size;
+		uint32_t prev_physical;
+		uint32_t next_physical;
+		uint32_t prev_free;
+		uint32_t next_free;
+		bool is_free;
+	};
+
+	static void MapSize(uint64_t units, uint32_t& fl, uint32_t& sl);
+	uint32_t FindFreeNode(uint64_t units) const;
+	uint32_t FindFittingNode(uint64_t size, uint64_t alignment) const;
+	uint32_t AcquireNode(const Node& node);
+	void ReleaseNode(uint32_t node);
+	void InsertFree(uint32_t node);
+	void RemoveFree(uint32_t node);
+
+	std::vector<Node> nodes;
+	std::vector<uint32_t> unused_nodes;
+	uint64_t fl_bitmap = 0;
+	uint32_t sl_bitmaps[FL_COUNT]{};
+	uint32_t free_heads[FL_COUNT][SL_COUNT];
+	uint64_t used_bytes		  = 0;
+	uint32_t allocation_count = 0;
+	uint32_t free_range_count = 0;
+};
+
+struct HeapPoolAllocation {
+	uint32_t block;
+	TlsfAllocation range;
+};
+
+struct HeapPoolStats {
+	uint32_t block_count;
+	uint32_t empty_block_count;
+	uint64_t reserved_bytes;
+	uint64_t used_bytes;
+	uint64_t peak_used_bytes;
+	uint64_t largest_free_range;
+	uint32_t allocation_count;
+	uint32_t free_range_count;
+	float fragmentation;
+};
+
+class HeapPool {
+  public:
+	explicit HeapPool(uint64_t block_size);
+
+	HeapPoolAllocation Allocate(uint64_t size, uint64_t alignment);
+	void Free(const HeapPoolAllocation& allocation);
+	HeapPoolStats GetStats() const;
+
+	std::vector<TlsfAllocator> blocks;
+
+  private:
+	uint64_t block_size;
+	uint64_t used_bytes		 = 0;
+	uint64_t peak_used_bytes = 0;
+};
+
+HeapPoolStats CombineHeapPoolStats(const HeapPoolStats& left, const HeapPoolStats& right);
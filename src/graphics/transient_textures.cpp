@@ -0,0 +1,153 @@
+#include "graphics/transient_textures.h"
+
+#include <algorithm>
+
+#include "graphics/frame_resources.h"
+#include "try.h"
+
+static D3D12_RESOURCE_DESC GetTextureResourceDesc(uint32_t width, uint32_t height,
+												  TextureFormat format) {
+	return D3D12_RESOURCE_DESC{
+		.Dimension		  = D3D12_RESOURCE_DIMENSION_TEXTURE2D,
+		.Width			  = width,
+		.Height			  = height,
+		.DepthOrArraySize = 1,
+		.MipLevels		  = 1,
+		.Format			  = ToDxgiFormat(format),
+		.SampleDesc		  = {.Count = 1},
+		.Flags			  = D3D12_RESOURCE_FLAG_ALLOW_RENDER_TARGET,
+	};
+}
+
+D3D12TransientTextures::D3D12TransientTextures(D3D12Device& device)
+	: device(device)
+	, rtv_descriptor_size(
+		  device.device->GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE_RTV)) {
+	idle_event = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+	if (!idle_event)
+		throw;
+	Try | device.device->CreateFence(0, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&idle_fence));
+}
+
+D3D12TransientTextures::~D3D12TransientTextures() {
+	WaitForGpu();
+	CloseHandle(idle_event);
+}
+
+RenderGraphTextureDesc D3D12TransientTextures::GetTextureDesc(uint32_t width, uint32_t height,
+															  TextureFormat format) const {
+	auto resource_desc = GetTextureResourceDesc(width, height, format);
+	auto info		   = device.device->GetResourceAllocationInfo(0, 1, &resource_desc);
+	if (info.SizeInBytes == UINT64_MAX)
+		throw;
+	return RenderGraphTextureDesc{
+		.width	   = width,
+		.height	   = height,
+		.format	   = format,
+		.size	   = info.SizeInBytes,
+		.alignment = info.Alignment,
+	};
+}
+
+bool D3D12TransientTextures::IsPlaced(const RenderGraph& graph, uint32_t texture) const {
+	if (texture >= textures.size() || !textures[texture].resource)
+		return false;
+	auto& placed = textures[texture];
+	auto& desc	 = graph.GetTextureDesc(texture);
+	return placed.offset == graph.GetTransientOffset(texture) && placed.desc.width == desc.width
+		&& placed.desc.height == desc.height && placed.desc.format == desc.format;
+}
+
+void D3D12TransientTextures::Place(const RenderGraph& graph,
+								   ResourceStateTracker<ID3D12Resource>& state_tracker) {
+	auto required_size = graph.GetStats().transient_heap_size;
+	auto transients	   = graph.GetTransients();
+	auto all_placed
+		= std::ranges::all_of(transients, [&](uint32_t t) { return IsPlaced(graph, t); });
+	if (required_size <= heap_size && all_placed)
+		return;
+
+	WaitForGpu();
+	if (required_size > heap_size) {
+		for (auto t = 0u; t < textures.size(); ++t)
+			Release(t, state_tracker);
+		heap.reset();
+		auto category_desc = GetTextureResourceDesc(1, 1, TextureFormat::B8G8R8A8Unorm);
+		heap.emplace(device.heap_allocator.AllocateRange(
+			device.device.Get(), category_desc, D3D12_HEAP_TYPE_DEFAULT, required_size,
+			D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT));
+		heap_size = required_size;
+	}
+
+	auto texture_count = (uint32_t)textures.size();
+	for (auto t : transients)
+		texture_count = std::max(texture_count, t + 1);
+	if (texture_count > textures.size()) {
+		for (auto t = 0u; t < textures.size(); ++t)
+			Release(t, state_tracker);
+		textures.resize(texture_count);
+
+		D3D12_DESCRIPTOR_HEAP_DESC rtv_heap_desc{
+			.Type			= D3D12_DESCRIPTOR_HEAP_TYPE_RTV,
+			.NumDescriptors = texture_count,
+		};
+		rtv_heap.Reset();
+		Try | device.device->CreateDescriptorHeap(&rtv_heap_desc, IID_PPV_ARGS(&rtv_heap));
+	}
+
+	for (auto t : transients) {
+		if (IsPlaced(graph, t))
+			continue;
+		Release(t, state_tracker);
+
+		auto& desc		   = graph.GetTextureDesc(t);
+		auto resource_desc = GetTextureResourceDesc(desc.width, desc.height, desc.format);
+		auto offset		   = graph.GetTransientOffset(t);
+		D3D12_CLEAR_VALUE clear_value{
+			.Format = resource_desc.Format,
+			.Color	= {0.0f, 0.0f, 0.0f, 1.0f},
+		};
+		auto& texture = textures[t];
+		Try
+			| device.device->CreatePlacedResource(heap->heap, heap->offset + offset, &resource_desc,
+												  D3D12_RESOURCE_STATE_COMMON, &clear_value,
+												  IID_PPV_ARGS(&texture.resource));
+		texture.desc   = desc;
+		texture.offset = offset;
+		auto rtv	   = GetRenderTargetView(t);
+		device.device->CreateRenderTargetView(texture.resource.Get(), nullptr, rtv);
+		state_tracker.RegisterTexture(texture.resource.Get(), ResourceState::Common);
+	}
+}
+
+void D3D12TransientTextures::RecordAliasing(D3D12CommandList& command_list,
+											std::span<const RenderGraphAliasing> aliasing) const {
+	for (auto& entry : aliasing)
+		command_list.AliasingBarrier(
+			entry.before == RENDER_GRAPH_INVALID ? nullptr : GetTexture(entry.before),
+			GetTexture(entry.after));
+}
+
+ID3D12Resource* D3D12TransientTextures::GetTexture(uint32_t texture) const {
+	return textures[texture].resource.Get();
+}
+
+D3D12_CPU_DESCRIPTOR_HANDLE D3D12TransientTextures::GetRenderTargetView(uint32_t texture) const {
+	auto rtv = rtv_heap->GetCPUDescriptorHandleForHeapStart();
+	rtv.ptr += (size_t)texture * rtv_descriptor_size;
+	return rtv;
+}
+
+void D3D12TransientTextures::Release(uint32_t texture,
+									 ResourceStateTracker<ID3D12Resource>& state_tracker) {
+	auto& resource = textures[texture].resource;
+	if (!resource)
+		return;
+	state_tracker.UnregisterTexture(resource.Get());
+	resource.Reset();
+}
+
+void D3D12TransientTextures::WaitForGpu() {
+	device.Signal(idle_fence.Get(), ++idle_value, idle_event);
+	WaitForSingleObject(idle_event, INFINITE);
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl/client.h>
+
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <vector>
+
+#include "graphics/device.h"
+#include "graphics/render_graph.h"
+#include "graphics/resource_state_tracker.h"
+
+class D3D12CommandList;
+
+class D3D12TransientTextures {
+  public:
+	explicit D3D12TransientTextures(D3D12Device& device);
+	~D3D12TransientTextures();
+
+	D3D12TransientTextures(const D3D12TransientTextures&)			 = delete;
+	D3D12TransientTextures& operator=(const D3D12TransientTextures&) = delete;
+
+	RenderGraphTextureDesc GetTextureDesc(uint32_t width, uint32_t height,
+										  TextureFormat format) const;
+	void Place(const RenderGraph& graph, ResourceStateTracker<ID3D12Resource>& state_tracker);
+	void RecordAliasing(D3D12CommandList& command_list,
+						std::span<const RenderGraphAliasing> aliasing) const;
+	ID3D12Resource* GetTexture(uint32_t texture) const;
+	D3D12_CPU_DESCRIPTOR_HANDLE GetRenderTargetView(uint32_t texture) const;
+
+  private:
+	struct PlacedTexture {
+		RenderGraphTextureDesc desc;
+		uint64_t offset;
+		Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+	};
+
+	bool IsPlaced(const RenderGraph& graph, uint32_t texture) const;
+	void Release(uint32_t texture, ResourceStateTracker<ID3D12Resource>& state_tracker);
+	void WaitForGpu();
+
+	D3D12Device& device;
+	std::optional<D3D12HeapRange> heap;
+	uint64_t heap_size = 0;
+	std::vector<PlacedTexture> textures;
+	Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> rtv_heap;
+	uint32_t rtv_descriptor_size;
+	Microsoft::WRL::ComPtr<ID3D12Fence> idle_fence;
+	HANDLE idle_event;
+	uint64_t idle_value = 0;
+};
@@ -0,0 +1,61 @@
+#include "graphics/upload_ring.h"
+
+#include <algorithm>
+#include <bit>
+
+UploadRing::UploadRing(uint64_t capacity, uint32_t max_pending_frames)
+	: capacity(capacity), pending_frames(max_pending_frames) {
+	if (!capacity || !max_pending_frames)
+		throw;
+}
+
+UploadRingAllocation UploadRing::Allocate(uint64_t size, uint64_t alignment) {
+	if (!std::has_single_bit(alignment) || capacity % alignment || size > capacity)
+		throw;
+
+	auto offset = (head + alignment - 1) & ~(alignment - 1);
+	if (offset % capacity + size > capacity) {
+		offset = (offset / capacity + 1) * capacity;
+		++wrap_count;
+	}
+	if (offset + size - tail > capacity)
+		throw;
+
+	head			= offset + size;
+	peak_used_bytes = std::max(peak_used_bytes, head - tail);
+	++allocation_count;
+	return UploadRingAllocation{.offset = offset % capacity, .size = size};
+}
+
+void UploadRing::EndFrame(uint32_t fence_index, uint64_t fence_value) {
+	if (pending_count == pending_frames.size())
+		throw;
+
+	auto slot			 = (pending_head + pending_count) % (uint32_t)pending_frames.size();
+	pending_frames[slot] = PendingFrame{
+		.end		 = head,
+		.fence_index = fence_index,
+		.fence_value = fence_value,
+	};
+	++pending_count;
+}
+
+void UploadRing::RetireFrame() {
+	if (!pending_count)
+		throw;
+
+	tail		 = pending_frames[pending_head].end;
+	pending_head = (pending_head + 1) % (uint32_t)pending_frames.size();
+	--pending_count;
+}
+
+UploadRingStats UploadRing::GetStats() const {
+	return UploadRingStats{
+		.capacity			 = capacity,
+		.used_bytes			 = head - tail,
+		.peak_used_bytes	 = peak_used_bytes,
+		.allocation_count	 = allocation_count,
+		.wrap_count			 = wrap_count,
+		.pending_frame_count = pending_count,
+	};
+}
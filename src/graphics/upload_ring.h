@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+struct UploadRingAllocation {
+	uint64_t offset;
+	uint64_t size;
+};
+
+struct UploadRingStats {
+	uint64_t capacity;
+	uint64_t used_bytes;
+	uint64_t peak_used_bytes;
+	uint64_t allocation_count;
+	uint64_t wrap_count;
+	uint32_t pending_frame_count;
+};
+
+class UploadRing {
+  public:
+	UploadRing(uint64_t capacity, uint32_t max_pending_frames);
+
+	UploadRingAllocation Allocate(uint64_t size, uint64_t alignment);
+	void EndFrame(uint32_t fence_index, uint64_t fence_value);
+	void RetireFrame();
+	UploadRingStats GetStats() const;
+
+	template <typename Fence>
+	void RetireCompletedFrames(std::span<Fence* const> fences) {
+		while (pending_count) {
+			auto& frame = pending_frames[pending_head];
+			if (fences[frame.fence_index]->GetCompletedValue() < frame.fence_value)
+				break;
+			RetireFrame();
+		}
+	}
+
+	uint64_t capacity;
+
+  private:
+	struct PendingFrame {
+		uint64_t end;
+		uint32_t fence_index;
+		uint64_t fence_value;
+	};
+
+	std::vector<PendingFrame> pending_frames;
+	uint32_t pending_head	  = 0;
+	uint32_t pending_count	  = 0;
+	uint64_t head			  = 0;
+	uint64_t tail			  = 0;
+	uint64_t peak_used_bytes  = 0;
+	uint64_t allocation_count = 0;
+	uint64_t wrap_count		  = 0;
+};
@@ -0,0 +1,143 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <string>
+
+#include "encoder/frame_pacing.h"
+#include "encoder/y4m_file.h"
+#include "thread_placement.h"
+
+import App;
+
+constexpr char UDP_URL_SCHEME[]			= "udp://";
+constexpr uint32_t HEADLESS_FRAME_COUNT = 500;
+constexpr uint32_t DEFAULT_FRAME_SIZE	= 512;
+
+struct CommandLine {
+	uint32_t frame_count = HEADLESS_FRAME_COUNT;
+	std::string dump_path;
+	std::string mesh_path;
+	std::string replay_path;
+	std::string export_name;
+	std::string rtp_host;
+	uint16_t rtp_port = 0;
+	std::string ts_path;
+	std::string ts_host;
+	uint16_t ts_port					   = 0;
+	BackpressurePolicy backpressure_policy = BackpressurePolicy::Block;
+	bool capture_clock					   = false;
+	PipelinePlacement placement;
+};
+
+bool ParseDestination(const std::string& destination, std::string& host, uint16_t& port) {
+	auto separator = destination.rfind(':');
+	if (separator == std::string::npos)
+		return false;
+	host = destination.substr(0, separator);
+	port = (uint16_t)strtoul(destination.c_str() + separator + 1, nullptr, 10);
+	return true;
+}
+
+BackpressurePolicy ParseBackpressurePolicy(const char* name) {
+	if (strcmp(name, "drop") == 0)
+		return BackpressurePolicy::DropNewest;
+	if (strcmp(name, "drop-non-reference") == 0)
+		return BackpressurePolicy::DropNonReference;
+	if (strcmp(name, "lower-bitrate") == 0)
+		return BackpressurePolicy::LowerBitrate;
+	return BackpressurePolicy::Block;
+}
+
+std::optional<CommandLine> ParseCommandLine(int argc, char** argv) {
+	CommandLine command_line;
+	for (auto i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc)
+			command_line.frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--dump") == 0 && i + 1 < argc)
+			command_line.dump_path = argv[++i];
+		else if (strcmp(argv[i], "--mesh") == 0 && i + 1 < argc)
+			command_line.mesh_path = argv[++i];
+		else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc)
+			command_line.replay_path = argv[++i];
+		else if (strcmp(argv[i], "--export") == 0 && i + 1 < argc)
+			command_line.export_name = argv[++i];
+		else if (strcmp(argv[i], "--rtp") == 0 && i + 1 < argc)
+			ParseDestination(argv[++i], command_line.rtp_host, command_line.rtp_port);
+		else if (strcmp(argv[i], "--ts") == 0 && i + 1 < argc) {
+			std::string destination = argv[++i];
+			if (destination.starts_with(UDP_URL_SCHEME))
+				ParseDestination(destination.substr(sizeof(UDP_URL_SCHEME) - 1),
+								 command_line.ts_host, command_line.ts_port);
+			else
+				command_line.ts_path = destination;
+		}
+		else if (strcmp(argv[i], "--backpressure") == 0 && i + 1 < argc)
+			command_line.backpressure_policy = ParseBackpressurePolicy(argv[++i]);
+		else if (strcmp(argv[i], "--capture-clock") == 0)
+			command_line.capture_clock = true;
+		else if (strcmp(argv[i], "--placement") == 0 && i + 1 < argc)
+			ParsePipelinePlacement(argv[++i], command_line.placement);
+		else
+			return std::nullopt;
+	}
+	if (!command_line.frame_count)
+		return std::nullopt;
+	return command_line;
+}
+
+int main(int argc, char** argv) {
+	try {
+		auto parsed = ParseCommandLine(argc, argv);
+		if (!parsed) {
+			fprintf(stderr,
+					"usage: %s [--frames <n>] [--dump <path>] [--mesh <path.gmesh>] "
+					"[--replay <clip.y4m>] [--export <name>] [--rtp <host:port>] "
+					"[--ts <path|udp://host:port>] [--backpressure <policy>] [--capture-clock] "
+					"[--placement <spec>]\n",
+					argv[0]);
+			return 1;
+		}
+
+		auto& command_line = *parsed;
+		std::optional<Y4mReplaySource> replay_source;
+		if (!command_line.replay_path.empty())
+			replay_source.emplace(command_line.replay_path.c_str());
+
+		auto width	= replay_source ? replay_source->header.width : DEFAULT_FRAME_SIZE;
+		auto height = replay_source ? replay_source->header.height : DEFAULT_FRAME_SIZE;
+
+		auto dump_path = command_line.dump_path.empty() ? nullptr : command_line.dump_path.c_str();
+		auto mesh_path = command_line.mesh_path.empty() ? nullptr : command_line.mesh_path.c_str();
+		auto export_name
+			= command_line.export_name.empty() ? nullptr : command_line.export_name.c_str();
+		auto ts_path = command_line.ts_path.empty() ? nullptr : command_line.ts_path.c_str();
+		AppOptions options{
+			.headless			 = true,
+			.frame_count		 = command_line.frame_count,
+			.dump_path			 = dump_path,
+			.mesh_path			 = mesh_path,
+			.export_name		 = export_name,
+			.rtp_host			 = command_line.rtp_port ? command_line.rtp_host.c_str() : nullptr,
+			.rtp_port			 = command_line.rtp_port,
+			.ts_path			 = ts_path,
+			.ts_host			 = command_line.ts_port ? command_line.ts_host.c_str() : nullptr,
+			.ts_port			 = command_line.ts_port,
+			.replay_source		 = replay_source ? &*replay_source : nullptr,
+			.backpressure_policy = command_line.backpressure_policy,
+			.capture_clock		 = command_line.capture_clock,
+			.placement			 = command_line.placement,
+		};
+
+		auto start	= std::chrono::steady_clock::now();
+		auto result = App{nullptr, options, width, height}.Run();
+		auto seconds
+			= std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		printf("frames=%u size=%ux%u seconds=%.3f fps=%.1f\n", command_line.frame_count, width,
+			   height, seconds, command_line.frame_count / seconds);
+		return result;
+	} catch (...) {
+		return 1;
+	}
+}
@@ -0,0 +1,338 @@
+#include "job_system.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "platform_thread.h"
+
+constexpr uint32_t EXTERNAL_THREAD = ~0u;
+
+static thread_local const JobSystem* current_system = nullptr;
+static thread_local uint32_t current_worker			= EXTERNAL_THREAD;
+
+JobSystem::WorkStealingDeque::WorkStealingDeque(uint32_t capacity)
+	: buffer(capacity), mask((int64_t)capacity - 1) {
+}
+
+bool JobSystem::WorkStealingDeque::Push(PooledJob* job) {
+	auto b = bottom.load(std::memory_order_relaxed);
+	auto t = top.load(std::memory_order_acquire);
+	if (b - t > mask)
+		return false;
+	buffer[b & mask].store(job, std::memory_order_relaxed);
+	bottom.store(b + 1, std::memory_order_release);
+	return true;
+}
+
+JobSystem::PooledJob* JobSystem::WorkStealingDeque::Pop() {
+	auto b = bottom.load(std::memory_order_relaxed) - 1;
+	bottom.store(b, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto t = top.load(std::memory_order_relaxed);
+	if (t > b) {
+		bottom.store(b + 1, std::memory_order_relaxed);
+		return nullptr;
+	}
+
+	auto job = buffer[b & mask].load(std::memory_order_relaxed);
+	if (t == b) {
+		if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+										 std::memory_order_relaxed))
+			job = nullptr;
+		bottom.store(b + 1, std::memory_order_relaxed);
+	}
+	return job;
+}
+
+JobSystem::PooledJob* JobSystem::WorkStealingDeque::Steal() {
+	auto t = top.load(std::memory_order_acquire);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	auto b = bottom.load(std::memory_order_acquire);
+	if (t >= b)
+		return nullptr;
+
+	auto job = buffer[t & mask].load(std::memory_order_relaxed);
+	if (!top.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+									 std::memory_order_relaxed))
+		return nullptr;
+	return job;
+}
+
+JobSystem::JobSystem(const JobSystemConfig& config)
+	: thread_count(std::max(config.thread_count, 1u))
+	, workers(thread_count)
+	, placement(config.placement) {
+	current_system = this;
+	current_worker = 0;
+	for (auto i = 1u; i < thread_count; ++i)
+		threads.emplace_back(&JobSystem::RunWorker, this, i, config.pin_threads);
+}
+
+JobSystem::~JobSystem() {
+	{
+		std::lock_guard lock{sleep_mutex};
+		stopping = true;
+	}
+	work_available.notify_all();
+	for (auto& thread : threads)
+		thread.join();
+
+	if (current_system == this) {
+		current_system = nullptr;
+		current_worker = EXTERNAL_THREAD;
+	}
+}
+
+void JobSystem::Submit(JobFunction function, void* data, uint32_t index, JobCounter* counter) {
+	if (counter)
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+	Enqueue(Job{.function = function, .data = data, .index = index, .counter = counter});
+	WakeWorkers(1);
+}
+
+void JobSystem::SubmitBatch(JobFunction function, void* data, uint32_t count,
+							JobCounter* counter) {
+	if (counter)
+		counter->value.fetch_add(count, std::memory_order_relaxed);
+	for (auto i = 0u; i < count; ++i)
+		Enqueue(Job{.function = function, .data = data, .index = i, .counter = counter});
+	WakeWorkers(count);
+}
+
+void JobSystem::SubmitAfter(JobCounter& dependency, JobFunction function, void* data,
+							uint32_t index, JobCounter* counter) {
+	if (counter)
+		counter->value.fetch_add(1, std::memory_order_relaxed);
+
+	Job job{.function = function, .data = data, .index = index, .counter = counter};
+	{
+		std::lock_guard lock{dependency.mutex};
+		if (!dependency.IsDone()) {
+			dependency.continuations.push_back(job);
+			return;
+		}
+	}
+	Enqueue(job);
+	WakeWorkers(1);
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+	if (current_system == this) {
+		auto& worker = workers[current_worker];
+		auto spins	 = 0u;
+		while (!counter.IsDone()) {
+			auto seen_epoch = work_epoch.load(std::memory_order_seq_cst);
+			if (TryRunJob(current_worker)) {
+				spins = 0;
+				continue;
+			}
+			if (spins < SPIN_COUNT) {
+				++spins;
+				std::this_thread::yield();
+				continue;
+			}
+
+			waiting_threads.fetch_add(1, std::memory_order_seq_cst);
+			if (!counter.IsDone() && work_epoch.load(std::memory_order_seq_cst) == seen_epoch) {
+				worker.blocked_waits.fetch_add(1, std::memory_order_relaxed);
+				work_epoch.wait(seen_epoch, std::memory_order_seq_cst);
+			}
+			waiting_threads.fetch_sub(1, std::memory_order_seq_cst);
+		}
+	}
+	else {
+		auto value = counter.value.load(std::memory_order_acquire);
+		while (value) {
+			counter.value.wait(value, std::memory_order_acquire);
+			value = counter.value.load(std::memory_order_acquire);
+		}
+	}
+
+	std::lock_guard lock{counter.mutex};
+}
+
+void JobSystem::Enqueue(const Job& job) {
+	if (current_system != this) {
+		std::lock_guard lock{injection_mutex};
+		injected_jobs.push_back(job);
+		injected_count.fetch_add(1, std::memory_order_release);
+		injected_total.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	auto& worker = workers[current_worker];
+	worker.submitted_jobs.fetch_add(1, std::memory_order_relaxed);
+
+	auto& slot = worker.jobs[worker.next_job];
+	if (slot.busy.load(std::memory_order_acquire)) {
+		worker.inline_jobs.fetch_add(1, std::memory_order_relaxed);
+		Execute(job);
+		return;
+	}
+
+	slot.job = job;
+	slot.busy.store(true, std::memory_order_relaxed);
+	if (!worker.deque.Push(&slot)) {
+		slot.busy.store(false, std::memory_order_relaxed);
+		worker.inline_jobs.fetch_add(1, std::memory_order_relaxed);
+		Execute(job);
+		return;
+	}
+	worker.next_job = (worker.next_job + 1) % JOB_POOL_SIZE;
+}
+
+bool JobSystem::TryRunJob(uint32_t worker_index) {
+	auto& worker = workers[worker_index];
+	auto pooled	 = worker.deque.Pop();
+
+	if (!pooled && injected_count.load(std::memory_order_acquire)) {
+		std::unique_lock lock{injection_mutex};
+		if (!injected_jobs.empty()) {
+			auto job = injected_jobs.front();
+			injected_jobs.pop_front();
+			injected_count.fetch_sub(1, std::memory_order_relaxed);
+			lock.unlock();
+			Execute(job);
+			worker.executed_jobs.fetch_add(1, std::memory_order_relaxed);
+			return true;
+		}
+	}
+
+	if (!pooled && thread_count > 1) {
+		worker.random_state ^= worker.random_state << 13;
+		worker.random_state ^= worker.random_state >> 17;
+		worker.random_state ^= worker.random_state << 5;
+		auto first_victim = worker.random_state % thread_count;
+		for (auto i = 0u; i < thread_count && !pooled; ++i) {
+			auto victim = (first_victim + i) % thread_count;
+			if (victim == worker_index)
+				continue;
+			worker.steal_attempts.fetch_add(1, std::memory_order_relaxed);
+			pooled = workers[victim].deque.Steal();
+			if (pooled)
+				worker.steals.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+
+	if (!pooled)
+		return false;
+
+	auto job = pooled->job;
+	pooled->busy.store(false, std::memory_order_release);
+	Execute(job);
+	worker.executed_jobs.fetch_add(1, std::memory_order_relaxed);
+	return true;
+}
+
+void JobSystem::Execute(const Job& job) {
+	job.function(job.data, job.index);
+	CompleteJob(job.counter);
+}
+
+void JobSystem::CompleteJob(JobCounter* counter) {
+	if (!counter)
+		return;
+
+	auto value = counter->value.load(std::memory_order_relaxed);
+	while (value > 1)
+		if (counter->value.compare_exchange_weak(value, value - 1, std::memory_order_acq_rel,
+												 std::memory_order_relaxed))
+			return;
+
+	std::vector<Job> ready;
+	{
+		std::lock_guard lock{counter->mutex};
+		if (counter->value.fetch_sub(1, std::memory_order_acq_rel) != 1)
+			return;
+		ready.swap(counter->continuations);
+		counter->value.notify_all();
+	}
+	WakeWaiters();
+
+	for (auto& job : ready)
+		Enqueue(job);
+	if (!ready.empty())
+		WakeWorkers((uint32_t)ready.size());
+}
+
+void JobSystem::WakeWaiters() {
+	work_epoch.fetch_add(1, std::memory_order_seq_cst);
+	if (waiting_threads.load(std::memory_order_seq_cst))
+		work_epoch.notify_all();
+}
+
+void JobSystem::WakeWorkers(uint32_t count) {
+	WakeWaiters();
+	if (!sleeping_workers.load(std::memory_order_seq_cst))
+		return;
+
+	{
+		std::lock_guard lock{sleep_mutex};
+	}
+	if (count == 1)
+		work_available.notify_one();
+	else
+		work_available.notify_all();
+}
+
+void JobSystem::RunWorker(uint32_t worker_index, bool pin_thread) {
+	current_system = this;
+	current_worker = worker_index;
+	if (pin_thread)
+		PinCurrentThread(worker_index % GetLogicalCoreCount());
+	else
+		ApplyWorkerPlacement(placement, worker_index - 1);
+
+	auto& worker		= workers[worker_index];
+	worker.random_state = worker_index * 0x9e3779b9u + 1;
+
+	for (;;) {
+		auto seen_epoch = work_epoch.load(std::memory_order_seq_cst);
+		if (TryRunJob(worker_index))
+			continue;
+
+		auto idle_start = std::chrono::steady_clock::now();
+		for (auto spin = 0u; spin < SPIN_COUNT; ++spin) {
+			if (work_epoch.load(std::memory_order_relaxed) != seen_epoch)
+				break;
+			std::this_thread::yield();
+		}
+
+		{
+			std::unique_lock lock{sleep_mutex};
+			sleeping_workers.fetch_add(1, std::memory_order_seq_cst);
+			if (!stopping && work_epoch.load(std::memory_order_seq_cst) == seen_epoch) {
+				worker.sleeps.fetch_add(1, std::memory_order_relaxed);
+				work_available.wait(lock, [this, seen_epoch] {
+					return stopping || work_epoch.load(std::memory_order_seq_cst) != seen_epoch;
+				});
+			}
+			sleeping_workers.fetch_sub(1, std::memory_order_seq_cst);
+			if (stopping)
+				return;
+		}
+
+		auto elapsed = std::chrono::steady_clock::now() - idle_start;
+		worker.idle_nanoseconds.fetch_add(
+			(uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count(),
+			std::memory_order_relaxed);
+	}
+}
+
+JobSystemStats JobSystem::GetStats() const {
+	JobSystemStats stats{
+		.thread_count	= thread_count,
+		.submitted_jobs = injected_total.load(std::memory_order_relaxed),
+	};
+	for (auto& worker : workers) {
+		stats.submitted_jobs += worker.submitted_jobs.load(std::memory_order_relaxed);
+		stats.executed_jobs += worker.executed_jobs.load(std::memory_order_relaxed);
+		stats.inline_jobs += worker.inline_jobs.load(std::memory_order_relaxed);
+		stats.steal_attempts += worker.steal_attempts.load(std::memory_order_relaxed);
+		stats.steals += worker.steals.load(std::memory_order_relaxed);
+		stats.sleeps += worker.sleeps.load(std::memory_order_relaxed);
+		stats.blocked_waits += worker.blocked_waits.load(std::memory_order_relaxed);
+		stats.idle_nanoseconds += worker.idle_nanoseconds.load(std::memory_order_relaxed);
+	}
+	return stats;
+}
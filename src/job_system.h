@@ -0,0 +1,131 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "thread_placement.h"
+
+using JobFunction = void (*)(void* data, uint32_t index);
+
+class JobCounter;
+
+struct Job {
+	JobFunction function;
+	void* data;
+	uint32_t index;
+	JobCounter* counter;
+};
+
+class JobCounter {
+  public:
+	bool IsDone() const {
+		return value.load(std::memory_order_acquire) == 0;
+	}
+
+  private:
+	friend class JobSystem;
+
+	std::atomic<uint32_t> value = 0;
+	std::mutex mutex;
+	std::vector<Job> continuations;
+};
+
+struct JobSystemConfig {
+	uint32_t thread_count;
+	bool pin_threads;
+	ThreadPlacement placement;
+};
+
+struct JobSystemStats {
+	uint32_t thread_count;
+	uint64_t submitted_jobs;
+	uint64_t executed_jobs;
+	uint64_t inline_jobs;
+	uint64_t steal_attempts;
+	uint64_t steals;
+	uint64_t sleeps;
+	uint64_t blocked_waits;
+	uint64_t idle_nanoseconds;
+};
+
+class JobSystem {
+  public:
+	explicit JobSystem(const JobSystemConfig& config);
+	~JobSystem();
+
+	void Submit(JobFunction function, void* data, uint32_t index, JobCounter* counter);
+	void SubmitBatch(JobFunction function, void* data, uint32_t count, JobCounter* counter);
+	void SubmitAfter(JobCounter& dependency, JobFunction function, void* data, uint32_t index,
+					 JobCounter* counter);
+	void Wait(JobCounter& counter);
+	JobSystemStats GetStats() const;
+
+	uint32_t thread_count;
+
+  private:
+	static constexpr uint32_t JOB_POOL_SIZE = 4096;
+	static constexpr uint32_t SPIN_COUNT	= 64;
+
+	struct PooledJob {
+		Job job;
+		std::atomic<bool> busy = false;
+	};
+
+	class WorkStealingDeque {
+	  public:
+		explicit WorkStealingDeque(uint32_t capacity);
+
+		bool Push(PooledJob* job);
+		PooledJob* Pop();
+		PooledJob* Steal();
+
+	  private:
+		std::vector<std::atomic<PooledJob*>> buffer;
+		int64_t mask;
+		alignas(64) std::atomic<int64_t> top	= 0;
+		alignas(64) std::atomic<int64_t> bottom = 0;
+	};
+
+	struct alignas(64) Worker {
+		WorkStealingDeque deque{JOB_POOL_SIZE};
+		std::vector<PooledJob> jobs			   = std::vector<PooledJob>(JOB_POOL_SIZE);
+		uint32_t next_job					   = 0;
+		uint32_t random_state				   = 1;
+		std::atomic<uint64_t> submitted_jobs   = 0;
+		std::atomic<uint64_t> executed_jobs	   = 0;
+		std::atomic<uint64_t> inline_jobs	   = 0;
+		std::atomic<uint64_t> steal_attempts   = 0;
+		std::atomic<uint64_t> steals		   = 0;
+		std::atomic<uint64_t> sleeps		   = 0;
+		std::atomic<uint64_t> blocked_waits	   = 0;
+		std::atomic<uint64_t> idle_nanoseconds = 0;
+	};
+
+	void Enqueue(const Job& job);
+	bool TryRunJob(uint32_t worker_index);
+	void Execute(const Job& job);
+	void CompleteJob(JobCounter* counter);
+	void WakeWaiters();
+	void WakeWorkers(uint32_t count);
+	void RunWorker(uint32_t worker_index, bool pin_thread);
+
+	std::vector<Worker> workers;
+	std::mutex injection_mutex;
+	std::deque<Job> injected_jobs;
+	std::atomic<uint32_t> injected_count = 0;
+	std::atomic<uint64_t> injected_total = 0;
+
+	std::mutex sleep_mutex;
+	std::condition_variable work_available;
+	std::atomic<uint64_t> work_epoch	   = 0;
+	std::atomic<uint32_t> sleeping_workers = 0;
+	std::atomic<uint32_t> waiting_threads  = 0;
+	bool stopping						   = false;
+	ThreadPlacement placement;
+	std::vector<std::thread> threads;
+};
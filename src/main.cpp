@@ -3,10 +3,20 @@
 #include <shellapi.h>
 // clang-format on
 
+#include <cstdlib>
+#include <optional>
+#include <string>
+
+#include "encoder/frame_pacing.h"
+#include "encoder/y4m_file.h"
+#include "thread_placement.h"
+
 import App;
 
-constexpr wchar_t WINDOW_CLASS_NAME[] = L"GoblinStreamWindow";
-constexpr wchar_t WINDOW_TITLE[]	  = L"Goblin Stream";
+constexpr wchar_t WINDOW_CLASS_NAME[]	= L"GoblinStreamWindow";
+constexpr wchar_t WINDOW_TITLE[]		= L"Goblin Stream";
+constexpr char UDP_URL_SCHEME[]			= "udp://";
+constexpr uint32_t HEADLESS_FRAME_COUNT = 500;
 
 LRESULT CALLBACK WindowProc(HWND hwnd, UINT message, WPARAM wparam, LPARAM lparam) {
 	switch (message) {
@@ -55,36 +65,130 @@ HWND CreateAppWindow(HINSTANCE instance, int show_command, unsigned int width,
 	return hwnd;
 }
 
-bool IsHeadlessMode() {
+struct CommandLine {
+	bool headless		 = false;
+	uint32_t frame_count = HEADLESS_FRAME_COUNT;
+	std::string dump_path;
+	std::string mesh_path;
+	std::string replay_path;
+	std::string export_name;
+	std::string rtp_host;
+	uint16_t rtp_port = 0;
+	std::string ts_path;
+	std::string ts_host;
+	uint16_t ts_port					   = 0;
+	BackpressurePolicy backpressure_policy = BackpressurePolicy::Block;
+	bool capture_clock					   = false;
+	PipelinePlacement placement;
+};
+
+std::string ToNarrowString(const wchar_t* text) {
+	auto size = WideCharToMultiByte(CP_ACP, 0, text, -1, nullptr, 0, nullptr, nullptr);
+	if (size <= 1)
+		return {};
+	std::string narrow((size_t)size - 1, '\0');
+	WideCharToMultiByte(CP_ACP, 0, text, -1, narrow.data(), size, nullptr, nullptr);
+	return narrow;
+}
+
+bool ParseDestination(const std::string& destination, std::string& host, uint16_t& port) {
+	auto separator = destination.rfind(':');
+	if (separator == std::string::npos)
+		return false;
+	host = destination.substr(0, separator);
+	port = (uint16_t)strtoul(destination.c_str() + separator + 1, nullptr, 10);
+	return true;
+}
+
+BackpressurePolicy ParseBackpressurePolicy(const wchar_t* name) {
+	if (wcscmp(name, L"drop") == 0)
+		return BackpressurePolicy::DropNewest;
+	if (wcscmp(name, L"drop-non-reference") == 0)
+		return BackpressurePolicy::DropNonReference;
+	if (wcscmp(name, L"lower-bitrate") == 0)
+		return BackpressurePolicy::LowerBitrate;
+	return BackpressurePolicy::Block;
+}
+
+CommandLine ParseCommandLine() {
+	CommandLine command_line;
 	int argc  = 0;
 	auto argv = CommandLineToArgvW(GetCommandLineW(), &argc);
 	if (!argv)
-		return false;
-
-	bool is_headless = false;
+		return command_line;
 
 	for (auto i = 1; i < argc; ++i) {
-		if (wcscmp(argv[i], L"--headless") == 0) {
-			is_headless = true;
-			break;
+		if (wcscmp(argv[i], L"--headless") == 0)
+			command_line.headless = true;
+		else if (wcscmp(argv[i], L"--frames") == 0 && i + 1 < argc)
+			command_line.frame_count = (uint32_t)wcstoul(argv[++i], nullptr, 10);
+		else if (wcscmp(argv[i], L"--dump") == 0 && i + 1 < argc)
+			command_line.dump_path = ToNarrowString(argv[++i]);
+		else if (wcscmp(argv[i], L"--mesh") == 0 && i + 1 < argc)
+			command_line.mesh_path = ToNarrowString(argv[++i]);
+		else if (wcscmp(argv[i], L"--replay") == 0 && i + 1 < argc)
+			command_line.replay_path = ToNarrowString(argv[++i]);
+		else if (wcscmp(argv[i], L"--export") == 0 && i + 1 < argc)
+			command_line.export_name = ToNarrowString(argv[++i]);
+		else if (wcscmp(argv[i], L"--rtp") == 0 && i + 1 < argc)
+			ParseDestination(ToNarrowString(argv[++i]), command_line.rtp_host,
+							 command_line.rtp_port);
+		else if (wcscmp(argv[i], L"--ts") == 0 && i + 1 < argc) {
+			auto destination = ToNarrowString(argv[++i]);
+			if (destination.starts_with(UDP_URL_SCHEME))
+				ParseDestination(destination.substr(sizeof(UDP_URL_SCHEME) - 1),
+								 command_line.ts_host, command_line.ts_port);
+			else
+				command_line.ts_path = destination;
 		}
+		else if (wcscmp(argv[i], L"--backpressure") == 0 && i + 1 < argc)
+			command_line.backpressure_policy = ParseBackpressurePolicy(argv[++i]);
+		else if (wcscmp(argv[i], L"--capture-clock") == 0)
+			command_line.capture_clock = true;
+		else if (wcscmp(argv[i], L"--placement") == 0 && i + 1 < argc)
+			ParsePipelinePlacement(ToNarrowString(argv[++i]), command_line.placement);
 	}
 
 	LocalFree(argv);
-	return is_headless;
+	return command_line;
 }
 
 int WINAPI WinMain(HINSTANCE instance, HINSTANCE, PSTR, int show_command) {
 	try {
-		auto headless	   = IsHeadlessMode();
-		auto window_width  = 512u;
-		auto window_height = 512u;
-		auto hwnd = CreateAppWindow(instance, headless ? SW_HIDE : show_command, window_width,
-									window_height);
+		auto command_line = ParseCommandLine();
+		std::optional<Y4mReplaySource> replay_source;
+		if (!command_line.replay_path.empty())
+			replay_source.emplace(command_line.replay_path.c_str());
+
+		auto window_width  = replay_source ? replay_source->header.width : 512u;
+		auto window_height = replay_source ? replay_source->header.height : 512u;
+		auto window_show   = command_line.headless ? SW_HIDE : show_command;
+		auto hwnd		   = CreateAppWindow(instance, window_show, window_width, window_height);
 		if (!hwnd)
 			return 1;
 
-		return App{hwnd, headless, window_width, window_height}.Run();
+		auto dump_path = command_line.dump_path.empty() ? nullptr : command_line.dump_path.c_str();
+		auto mesh_path = command_line.mesh_path.empty() ? nullptr : command_line.mesh_path.c_str();
+		auto export_name
+			= command_line.export_name.empty() ? nullptr : command_line.export_name.c_str();
+		auto ts_path = command_line.ts_path.empty() ? nullptr : command_line.ts_path.c_str();
+		AppOptions options{
+			.headless			 = command_line.headless,
+			.frame_count		 = command_line.frame_count,
+			.dump_path			 = dump_path,
+			.mesh_path			 = mesh_path,
+			.export_name		 = export_name,
+			.rtp_host			 = command_line.rtp_port ? command_line.rtp_host.c_str() : nullptr,
+			.rtp_port			 = command_line.rtp_port,
+			.ts_path			 = ts_path,
+			.ts_host			 = command_line.ts_port ? command_line.ts_host.c_str() : nullptr,
+			.ts_port			 = command_line.ts_port,
+			.replay_source		 = replay_source ? &*replay_source : nullptr,
+			.backpressure_policy = command_line.backpressure_policy,
+			.capture_clock		 = command_line.capture_clock,
+			.placement			 = command_line.placement,
+		};
+		return App{hwnd, options, window_width, window_height}.Run();
 	} catch (...) {
 		return 1;
 	}
@@ -0,0 +1,82 @@
+#include "mapped_file.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(const char* path)
+	: file_handle(CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+							  FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr)) {
+	if (file_handle == INVALID_HANDLE_VALUE)
+		throw;
+
+	LARGE_INTEGER file_size{};
+	if (!GetFileSizeEx(file_handle, &file_size) || file_size.QuadPart == 0) {
+		CloseHandle(file_handle);
+		throw;
+	}
+	size = (size_t)file_size.QuadPart;
+
+	mapping_handle = CreateFileMappingA(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping_handle)
+		data = (const uint8_t*)MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+	if (!data) {
+		if (mapping_handle)
+			CloseHandle(mapping_handle);
+		CloseHandle(file_handle);
+		throw;
+	}
+}
+
+MappedFile::~MappedFile() {
+	UnmapViewOfFile(data);
+	CloseHandle(mapping_handle);
+	CloseHandle(file_handle);
+}
+
+void MappedFile::Prefetch(size_t offset, size_t length) const {
+	WIN32_MEMORY_RANGE_ENTRY range{.VirtualAddress = (void*)(data + offset),
+								   .NumberOfBytes  = length};
+	PrefetchVirtualMemory(GetCurrentProcess(), 1, &range, 0);
+}
+
+#else
+
+MappedFile::MappedFile(const char* path) : descriptor(open(path, O_RDONLY | O_CLOEXEC)) {
+	if (descriptor < 0)
+		throw;
+
+	struct stat file_status{};
+	if (fstat(descriptor, &file_status) != 0 || file_status.st_size == 0) {
+		close(descriptor);
+		throw;
+	}
+	size = (size_t)file_status.st_size;
+
+	auto mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+	if (mapping == MAP_FAILED) {
+		close(descriptor);
+		throw;
+	}
+	data = (const uint8_t*)mapping;
+}
+
+MappedFile::~MappedFile() {
+	munmap((void*)data, size);
+	close(descriptor);
+}
+
+void MappedFile::Prefetch(size_t offset, size_t length) const {
+	auto page_size = (size_t)sysconf(_SC_PAGESIZE);
+	auto begin	   = offset & ~(page_size - 1);
+	madvise((void*)(data + begin), offset + length - begin, MADV_WILLNEED);
+}
+
+#endif
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+class MappedFile {
+  public:
+	explicit MappedFile(const char* path);
+	~MappedFile();
+
+	void Prefetch(size_t offset, size_t length) const;
+
+	const uint8_t* data = nullptr;
+	size_t size			= 0;
+
+  private:
+#ifdef _WIN32
+	void* file_handle	 = nullptr;
+	void* mapping_handle = nullptr;
+#else
+	int descriptor = -1;
+#endif
+};
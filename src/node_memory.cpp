@@ -0,0 +1,109 @@
+#include "node_memory.h"
+
+#include <cstring>
+
+#include "platform_thread.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdio>
+#endif
+
+#ifdef _WIN32
+
+NodeBuffer::NodeBuffer(size_t size, uint32_t node) : size(size), node(node) {
+	data = (uint8_t*)VirtualAllocExNuma(GetCurrentProcess(), nullptr, size,
+										MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE, node);
+	bound = data != nullptr;
+	if (!data)
+		data = (uint8_t*)VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (!data)
+		throw;
+	memset(data, 0, size);
+}
+
+NodeBuffer::~NodeBuffer() {
+	VirtualFree(data, 0, MEM_RELEASE);
+}
+
+bool BindNumaNode(void*, size_t, uint32_t) {
+	return false;
+}
+
+uint32_t GetAddressNumaNode(const void* address) {
+	PSAPI_WORKING_SET_EX_INFORMATION info{.VirtualAddress = (void*)address};
+	if (!QueryWorkingSetEx(GetCurrentProcess(), &info, sizeof(info))
+		|| !info.VirtualAttributes.Valid)
+		return 0;
+	return (uint32_t)info.VirtualAttributes.Node;
+}
+
+NumaTrafficStats ReadNumaTrafficStats() {
+	return NumaTrafficStats{};
+}
+
+#else
+
+constexpr uint32_t NODE_MASK_BITS = 64;
+
+NodeBuffer::NodeBuffer(size_t size, uint32_t node) : size(size), node(node) {
+	auto mapping = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (mapping == MAP_FAILED)
+		throw;
+	data  = (uint8_t*)mapping;
+	bound = BindNumaNode(data, size, node);
+	memset(data, 0, size);
+}
+
+NodeBuffer::~NodeBuffer() {
+	munmap(data, size);
+}
+
+bool BindNumaNode(void* data, size_t size, uint32_t node) {
+	if (node >= NODE_MASK_BITS)
+		return false;
+
+	uint64_t node_mask = 1ull << node;
+	auto result		   = syscall(SYS_mbind, data, size, MPOL_BIND, &node_mask, NODE_MASK_BITS + 1,
+								 MPOL_MF_STRICT);
+	return result == 0;
+}
+
+uint32_t GetAddressNumaNode(const void* address) {
+	int node = 0;
+	if (syscall(SYS_get_mempolicy, &node, nullptr, 0, address, MPOL_F_NODE | MPOL_F_ADDR) != 0)
+		return GetCoreNumaNode(GetCurrentCore());
+	return (uint32_t)node;
+}
+
+NumaTrafficStats ReadNumaTrafficStats() {
+	NumaTrafficStats stats{};
+	for (auto node = 0u; node < GetNumaNodeCount(); ++node) {
+		char path[96];
+		snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/numastat", node);
+		auto file = fopen(path, "r");
+		if (!file)
+			continue;
+
+		char name[32];
+		unsigned long long value = 0;
+		while (fscanf(file, "%31s %llu", name, &value) == 2)
+			if (strcmp(name, "local_node") == 0)
+				stats.local_pages += value;
+			else if (strcmp(name, "other_node") == 0)
+				stats.remote_pages += value;
+			else if (strcmp(name, "numa_miss") == 0)
+				stats.missed_pages += value;
+		fclose(file);
+	}
+	return stats;
+}
+
+#endif
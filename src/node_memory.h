@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+struct NumaTrafficStats {
+	uint64_t local_pages;
+	uint64_t remote_pages;
+	uint64_t missed_pages;
+};
+
+class NodeBuffer {
+  public:
+	NodeBuffer(size_t size, uint32_t node);
+	~NodeBuffer();
+
+	NodeBuffer(const NodeBuffer&)			 = delete;
+	NodeBuffer& operator=(const NodeBuffer&) = delete;
+
+	uint8_t* data = nullptr;
+	size_t size	  = 0;
+	uint32_t node = 0;
+	bool bound	  = false;
+};
+
+bool BindNumaNode(void* data, size_t size, uint32_t node);
+uint32_t GetAddressNumaNode(const void* address);
+NumaTrafficStats ReadNumaTrafficStats();
@@ -0,0 +1,91 @@
+#include "platform_event.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <vector>
+#endif
+
+#ifdef _WIN32
+
+EventHandle CreateAutoResetEvent(bool signaled) {
+	auto event = CreateEvent(nullptr, FALSE, signaled, nullptr);
+	if (!event)
+		throw;
+	return event;
+}
+
+EventHandle CreateCountingSemaphore(uint32_t initial_count, uint32_t maximum_count) {
+	auto semaphore = CreateSemaphore(nullptr, (LONG)initial_count, (LONG)maximum_count, nullptr);
+	if (!semaphore)
+		throw;
+	return semaphore;
+}
+
+void SignalAutoResetEvent(EventHandle event) {
+	SetEvent(event);
+}
+
+void ReleaseCountingSemaphore(EventHandle semaphore) {
+	ReleaseSemaphore(semaphore, 1, nullptr);
+}
+
+void CloseEventHandle(EventHandle event) {
+	CloseHandle(event);
+}
+
+uint32_t WaitForAnyEvent(std::span<const EventHandle> events, uint32_t timeout_milliseconds) {
+	auto result = WaitForMultipleObjects((DWORD)events.size(), events.data(), FALSE,
+										 timeout_milliseconds);
+	if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + events.size())
+		return result - WAIT_OBJECT_0;
+	return (uint32_t)events.size();
+}
+
+#else
+
+EventHandle CreateAutoResetEvent(bool signaled) {
+	auto event = eventfd(signaled ? 1 : 0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (event < 0)
+		throw;
+	return event;
+}
+
+EventHandle CreateCountingSemaphore(uint32_t initial_count, uint32_t) {
+	auto semaphore = eventfd(initial_count, EFD_CLOEXEC | EFD_NONBLOCK | EFD_SEMAPHORE);
+	if (semaphore < 0)
+		throw;
+	return semaphore;
+}
+
+void SignalAutoResetEvent(EventHandle event) {
+	uint64_t increment = 1;
+	if (write(event, &increment, sizeof(increment)) != sizeof(increment))
+		throw;
+}
+
+void ReleaseCountingSemaphore(EventHandle semaphore) {
+	SignalAutoResetEvent(semaphore);
+}
+
+void CloseEventHandle(EventHandle event) {
+	close(event);
+}
+
+uint32_t WaitForAnyEvent(std::span<const EventHandle> events, uint32_t timeout_milliseconds) {
+	std::vector<pollfd> descriptors;
+	descriptors.reserve(events.size());
+	for (auto event : events)
+		descriptors.push_back(pollfd{.fd = event, .events = POLLIN});
+	if (poll(descriptors.data(), descriptors.size(), (int)timeout_milliseconds) > 0)
+		for (auto i = 0u; i < descriptors.size(); ++i)
+			if (descriptors[i].revents & POLLIN)
+				return i;
+	return (uint32_t)events.size();
+}
+
+#endif
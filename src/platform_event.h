@@ -0,0 +1,19 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+#ifdef _WIN32
+using EventHandle = void*;
+#else
+using EventHandle = int;
+#endif
+
+constexpr uint32_t INFINITE_TIMEOUT = 0xFFFFFFFF;
+
+EventHandle CreateAutoResetEvent(bool signaled);
+EventHandle CreateCountingSemaphore(uint32_t initial_count, uint32_t maximum_count);
+void SignalAutoResetEvent(EventHandle event);
+void ReleaseCountingSemaphore(EventHandle semaphore);
+void CloseEventHandle(EventHandle event);
+uint32_t WaitForAnyEvent(std::span<const EventHandle> events, uint32_t timeout_milliseconds);
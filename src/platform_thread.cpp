@@ -0,0 +1,151 @@
+#include "platform_thread.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <cstdlib>
+#endif
+
+#include <thread>
+
+uint32_t GetLogicalCoreCount() {
+	auto count = std::thread::hardware_concurrency();
+	return count ? count : 1;
+}
+
+uint32_t GetCoreNumaNode(uint32_t core) {
+	for (auto node = 0u; node < GetNumaNodeCount(); ++node)
+		for (auto node_core : GetNumaNodeCores(node))
+			if (node_core == core)
+				return node;
+	return 0;
+}
+
+void PinCurrentThread(uint32_t core) {
+	PinCurrentThreadToCores({&core, 1});
+}
+
+#ifdef _WIN32
+
+uint32_t GetNumaNodeCount() {
+	ULONG highest_node = 0;
+	if (!GetNumaHighestNodeNumber(&highest_node))
+		return 1;
+	return (uint32_t)highest_node + 1;
+}
+
+std::vector<uint32_t> GetNumaNodeCores(uint32_t node) {
+	std::vector<uint32_t> cores;
+	GROUP_AFFINITY affinity{};
+	if (!GetNumaNodeProcessorMaskEx((USHORT)node, &affinity))
+		return cores;
+	for (auto bit = 0u; bit < 64; ++bit)
+		if (affinity.Mask & (1ull << bit))
+			cores.push_back(affinity.Group * 64u + bit);
+	return cores;
+}
+
+uint32_t GetCurrentCore() {
+	PROCESSOR_NUMBER processor{};
+	GetCurrentProcessorNumberEx(&processor);
+	return processor.Group * 64u + processor.Number;
+}
+
+void PinCurrentThreadToCores(std::span<const uint32_t> cores) {
+	DWORD_PTR mask = 0;
+	for (auto core : cores) {
+		if (core >= 64)
+			throw;
+		mask |= 1ull << core;
+	}
+	if (!mask || !SetThreadAffinityMask(GetCurrentThread(), mask))
+		throw;
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+	auto level = priority == ThreadPriority::Low	? THREAD_PRIORITY_BELOW_NORMAL
+			   : priority == ThreadPriority::High ? THREAD_PRIORITY_HIGHEST
+												  : THREAD_PRIORITY_NORMAL;
+	return SetThreadPriority(GetCurrentThread(), level);
+}
+
+#else
+
+constexpr int LOW_PRIORITY_NICE	 = 10;
+constexpr int HIGH_PRIORITY_NICE = -10;
+
+static bool ReadNodeCoreList(uint32_t node, char* list, size_t size) {
+	char path[96];
+	snprintf(path, sizeof(path), "/sys/devices/system/node/node%u/cpulist", node);
+	auto file = fopen(path, "r");
+	if (!file)
+		return false;
+	auto read = fgets(list, (int)size, file) != nullptr;
+	fclose(file);
+	return read;
+}
+
+uint32_t GetNumaNodeCount() {
+	char list[256];
+	auto count = 0u;
+	while (ReadNodeCoreList(count, list, sizeof(list)))
+		++count;
+	return count ? count : 1;
+}
+
+std::vector<uint32_t> GetNumaNodeCores(uint32_t node) {
+	std::vector<uint32_t> cores;
+	char list[4096];
+	if (!ReadNodeCoreList(node, list, sizeof(list))) {
+		if (node == 0)
+			for (auto core = 0u; core < GetLogicalCoreCount(); ++core)
+				cores.push_back(core);
+		return cores;
+	}
+
+	for (auto cursor = list; *cursor && *cursor != '\n';) {
+		char* end  = nullptr;
+		auto first = (uint32_t)strtoul(cursor, &end, 10);
+		auto last  = first;
+		if (end == cursor)
+			break;
+		if (*end == '-')
+			last = (uint32_t)strtoul(end + 1, &end, 10);
+		for (auto core = first; core <= last; ++core)
+			cores.push_back(core);
+		cursor = *end == ',' ? end + 1 : end;
+	}
+	return cores;
+}
+
+uint32_t GetCurrentCore() {
+	auto core = sched_getcpu();
+	return core < 0 ? 0 : (uint32_t)core;
+}
+
+void PinCurrentThreadToCores(std::span<const uint32_t> cores) {
+	cpu_set_t set;
+	CPU_ZERO(&set);
+	for (auto core : cores) {
+		if (core >= CPU_SETSIZE)
+			throw;
+		CPU_SET(core, &set);
+	}
+	if (cores.empty() || pthread_setaffinity_np(pthread_self(), sizeof(set), &set))
+		throw;
+}
+
+bool SetCurrentThreadPriority(ThreadPriority priority) {
+	auto nice = priority == ThreadPriority::Low	   ? LOW_PRIORITY_NICE
+			  : priority == ThreadPriority::High ? HIGH_PRIORITY_NICE
+												 : 0;
+	return setpriority(PRIO_PROCESS, (id_t)gettid(), nice) == 0;
+}
+
+#endif
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+enum class ThreadPriority { Low, Normal, High };
+
+uint32_t GetLogicalCoreCount();
+uint32_t GetNumaNodeCount();
+std::vector<uint32_t> GetNumaNodeCores(uint32_t node);
+uint32_t GetCurrentCore();
+uint32_t GetCoreNumaNode(uint32_t core);
+void PinCurrentThread(uint32_t core);
+void PinCurrentThreadToCores(std::span<const uint32_t> cores);
+bool SetCurrentThreadPriority(ThreadPriority priority);
@@ -3,6 +3,12 @@ cbuffer MVP : register(b0)
 	float4x4 mvp;
 }
 
+cbuffer PositionDecode : register(b1)
+{
+	float4 position_offset;
+	float4 position_scale;
+}
+
 struct VSInput
 {
 	float3 position : POSITION;
@@ -18,7 +24,8 @@ struct VSOutput
 VSOutput main(VSInput input)
 {
 	VSOutput output;
-	output.position = mul(mvp, float4(input.position, 1.0f));
+	float3 position = position_offset.xyz + input.position * position_scale.xyz;
+	output.position = mul(mvp, float4(position, 1.0f));
 	output.color = input.color;
 	return output;
 }
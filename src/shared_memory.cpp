@@ -0,0 +1,127 @@
+#include "shared_memory.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif
+
+#ifdef _WIN32
+
+SharedMemory::SharedMemory(const char* name, size_t size)
+	: size(size)
+	, owner(true)
+	, mapping_handle(CreateFileMappingA(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE,
+										(DWORD)((uint64_t)size >> 32), (DWORD)size, name)) {
+	if (!mapping_handle)
+		throw;
+	if (GetLastError() == ERROR_ALREADY_EXISTS) {
+		CloseHandle(mapping_handle);
+		throw;
+	}
+
+	data = (uint8_t*)MapViewOfFile(mapping_handle, FILE_MAP_WRITE, 0, 0, size);
+	if (!data) {
+		CloseHandle(mapping_handle);
+		throw;
+	}
+}
+
+SharedMemory::SharedMemory(const char* name)
+	: mapping_handle(OpenFileMappingA(FILE_MAP_READ | FILE_MAP_WRITE, FALSE, name)) {
+	if (!mapping_handle)
+		throw;
+
+	data = (uint8_t*)MapViewOfFile(mapping_handle, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, 0);
+	MEMORY_BASIC_INFORMATION region{};
+	if (!data || !VirtualQuery(data, &region, sizeof(region))) {
+		if (data)
+			UnmapViewOfFile(data);
+		CloseHandle(mapping_handle);
+		throw;
+	}
+	size = region.RegionSize;
+}
+
+SharedMemory::~SharedMemory() {
+	UnmapViewOfFile(data);
+	CloseHandle(mapping_handle);
+}
+
+#else
+
+static std::string GetObjectName(const char* name) {
+	std::string object_name;
+	if (name[0] != '/')
+		object_name += '/';
+	object_name += name;
+	return object_name;
+}
+
+static bool IsAbandoned(const std::string& name) {
+	auto descriptor = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+	if (descriptor < 0)
+		return false;
+	auto abandoned = flock(descriptor, LOCK_EX | LOCK_NB) == 0;
+	close(descriptor);
+	return abandoned;
+}
+
+static int CreateObject(const std::string& name) {
+	return shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+}
+
+SharedMemory::SharedMemory(const char* object_name, size_t size)
+	: size(size), owner(true), name(GetObjectName(object_name)) {
+	descriptor = CreateObject(name);
+	if (descriptor < 0 && errno == EEXIST && IsAbandoned(name)) {
+		shm_unlink(name.c_str());
+		descriptor = CreateObject(name);
+	}
+	if (descriptor < 0)
+		throw;
+
+	auto locked	 = flock(descriptor, LOCK_EX | LOCK_NB) == 0;
+	auto mapping = locked && ftruncate(descriptor, (off_t)size) == 0
+					   ? mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0)
+					   : MAP_FAILED;
+	if (mapping == MAP_FAILED) {
+		close(descriptor);
+		shm_unlink(name.c_str());
+		throw;
+	}
+	data = (uint8_t*)mapping;
+}
+
+SharedMemory::SharedMemory(const char* object_name) : name(GetObjectName(object_name)) {
+	auto descriptor = shm_open(name.c_str(), O_RDWR | O_CLOEXEC, 0);
+	if (descriptor < 0)
+		throw;
+
+	struct stat object_status{};
+	auto mapping = fstat(descriptor, &object_status) == 0 && object_status.st_size > 0
+					   ? mmap(nullptr, (size_t)object_status.st_size, PROT_READ | PROT_WRITE,
+							  MAP_SHARED, descriptor, 0)
+					   : MAP_FAILED;
+	close(descriptor);
+	if (mapping == MAP_FAILED)
+		throw;
+	data = (uint8_t*)mapping;
+	size = (size_t)object_status.st_size;
+}
+
+SharedMemory::~SharedMemory() {
+	munmap(data, size);
+	if (!owner)
+		return;
+	shm_unlink(name.c_str());
+	close(descriptor);
+}
+
+#endif
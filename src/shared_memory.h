@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+class SharedMemory {
+  public:
+	SharedMemory(const char* name, size_t size);
+	explicit SharedMemory(const char* name);
+	~SharedMemory();
+
+	SharedMemory(const SharedMemory&)			 = delete;
+	SharedMemory& operator=(const SharedMemory&) = delete;
+
+	uint8_t* data = nullptr;
+	size_t size	  = 0;
+	bool owner	  = false;
+
+  private:
+#ifdef _WIN32
+	void* mapping_handle = nullptr;
+#else
+	std::string name;
+	int descriptor = -1;
+#endif
+};
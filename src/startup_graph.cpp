@@ -0,0 +1,121 @@
+#include "startup_graph.h"
+
+#include <algorithm>
+
+static uint64_t GetElapsedNanoseconds(std::chrono::steady_clock::time_point start) {
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+}
+
+uint32_t StartupGraph::Add(const char* name, bool main_thread, void* context,
+						   TaskFunction function, std::initializer_list<uint32_t> dependencies) {
+	auto index = (uint32_t)tasks.size();
+	for (auto dependency : dependencies)
+		if (dependency >= index || (main_thread && !timings[dependency].main_thread))
+			throw;
+
+	tasks.push_back(Task{.function = function, .context = context});
+	timings.push_back(StartupTaskTiming{.name = name, .main_thread = main_thread});
+	dependency_counts.push_back((uint32_t)dependencies.size());
+	for (auto dependency : dependencies)
+		edges.emplace_back(dependency, index);
+	return index;
+}
+
+void StartupGraph::Run(JobSystem& job_system) {
+	this->job_system = &job_system;
+	run_start		 = std::chrono::steady_clock::now();
+
+	for (auto& task : tasks)
+		task.dependent_count = 0;
+	for (auto [dependency, task] : edges)
+		++tasks[dependency].dependent_count;
+	auto offset = 0u;
+	for (auto& task : tasks) {
+		task.first_dependent = offset;
+		offset += task.dependent_count;
+		task.dependent_count = 0;
+	}
+	dependents.resize(edges.size());
+	for (auto [dependency, task] : edges) {
+		auto& source = tasks[dependency];
+		dependents[source.first_dependent + source.dependent_count++] = task;
+	}
+
+	remaining = std::vector<std::atomic<uint32_t>>(tasks.size());
+	for (auto i = 0u; i < tasks.size(); ++i)
+		remaining[i].store(dependency_counts[i], std::memory_order_relaxed);
+
+	for (auto i = 0u; i < tasks.size(); ++i)
+		if (!timings[i].main_thread && !dependency_counts[i])
+			job_system.Submit(RunTask, this, i, &counter);
+
+	for (auto i = 0u; i < tasks.size(); ++i) {
+		if (!timings[i].main_thread)
+			continue;
+		Execute(i);
+		Release(i);
+	}
+
+	job_system.Wait(counter);
+	wall_nanoseconds = GetElapsedNanoseconds(run_start);
+	if (error)
+		std::rethrow_exception(error);
+}
+
+std::span<const StartupTaskTiming> StartupGraph::GetTimings() const {
+	return timings;
+}
+
+StartupGraphStats StartupGraph::GetStats() const {
+	StartupGraphStats stats{
+		.task_count		  = (uint32_t)tasks.size(),
+		.wall_nanoseconds = wall_nanoseconds,
+	};
+
+	std::vector<uint64_t> finish(tasks.size());
+	auto edge = edges.begin();
+	for (auto i = 0u; i < tasks.size(); ++i) {
+		auto duration  = timings[i].end_nanoseconds - timings[i].start_nanoseconds;
+		uint64_t ready = 0;
+		for (; edge != edges.end() && edge->second == i; ++edge)
+			ready = std::max(ready, finish[edge->first]);
+		finish[i] = ready + duration;
+
+		stats.serial_nanoseconds += duration;
+		stats.critical_path_nanoseconds = std::max(stats.critical_path_nanoseconds, finish[i]);
+	}
+	return stats;
+}
+
+void StartupGraph::Execute(uint32_t task) {
+	auto& timing			 = timings[task];
+	timing.start_nanoseconds = GetElapsedNanoseconds(run_start);
+	if (!failed.load(std::memory_order_acquire)) {
+		try {
+			tasks[task].function(tasks[task].context);
+		} catch (...) {
+			std::lock_guard lock{error_mutex};
+			if (!error)
+				error = std::current_exception();
+			failed.store(true, std::memory_order_release);
+		}
+	}
+	timing.end_nanoseconds = GetElapsedNanoseconds(run_start);
+}
+
+void StartupGraph::RunTask(void* data, uint32_t index) {
+	auto& graph = *(StartupGraph*)data;
+	graph.Execute(index);
+	graph.Release(index);
+}
+
+void StartupGraph::Release(uint32_t task) {
+	auto& source = tasks[task];
+	for (auto i = 0u; i < source.dependent_count; ++i) {
+		auto dependent = dependents[source.first_dependent + i];
+		if (remaining[dependent].fetch_sub(1, std::memory_order_acq_rel) == 1
+			&& !timings[dependent].main_thread)
+			job_system->Submit(RunTask, this, dependent, &counter);
+	}
+}
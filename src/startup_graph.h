@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <initializer_list>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "job_system.h"
+
+struct StartupTaskTiming {
+	const char* name;
+	bool main_thread;
+	uint64_t start_nanoseconds;
+	uint64_t end_nanoseconds;
+};
+
+struct StartupGraphStats {
+	uint32_t task_count;
+	uint64_t wall_nanoseconds;
+	uint64_t serial_nanoseconds;
+	uint64_t critical_path_nanoseconds;
+};
+
+class StartupGraph {
+  public:
+	template <typename Function>
+	uint32_t AddTask(const char* name, Function& function,
+					 std::initializer_list<uint32_t> dependencies = {}) {
+		return Add(name, false, &function, Invoke<Function>, dependencies);
+	}
+
+	template <typename Function>
+	uint32_t AddMainThreadTask(const char* name, Function& function,
+							   std::initializer_list<uint32_t> dependencies = {}) {
+		return Add(name, true, &function, Invoke<Function>, dependencies);
+	}
+
+	void Run(JobSystem& job_system);
+	std::span<const StartupTaskTiming> GetTimings() const;
+	StartupGraphStats GetStats() const;
+
+  private:
+	using TaskFunction = void (*)(void* context);
+
+	struct Task {
+		TaskFunction function;
+		void* context;
+		uint32_t first_dependent;
+		uint32_t dependent_count;
+	};
+
+	template <typename Function>
+	static void Invoke(void* context) {
+		(*(Function*)context)();
+	}
+
+	uint32_t Add(const char* name, bool main_thread, void* context, TaskFunction function,
+				 std::initializer_list<uint32_t> dependencies);
+	static void RunTask(void* data, uint32_t index);
+	void Execute(uint32_t task);
+	void Release(uint32_t task);
+
+	JobSystem* job_system = nullptr;
+	std::vector<Task> tasks;
+	std::vector<StartupTaskTiming> timings;
+	std::vector<uint32_t> dependency_counts;
+	std::vector<std::pair<uint32_t, uint32_t>> edges;
+	std::vector<uint32_t> dependents;
+	std::vector<std::atomic<uint32_t>> remaining;
+	JobCounter counter;
+	std::mutex error_mutex;
+	std::exception_ptr error;
+	std::atomic<bool> failed = false;
+	std::chrono::steady_clock::time_point run_start;
+	uint64_t wall_nanoseconds = 0;
+};
@@ -0,0 +1,217 @@
+#include "stream_host.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <span>
+
+#include "platform_thread.h"
+
+constexpr uint32_t DRAIN_TIMEOUT_MS = 1000;
+constexpr uint32_t OUTPUT_PATH_SIZE = 512;
+#ifdef _WIN32
+constexpr auto DISCARD_OUTPUT_PATH = "NUL";
+#else
+constexpr auto DISCARD_OUTPUT_PATH = "/dev/null";
+#endif
+
+#ifndef GOBLIN_CPU_BACKEND
+static uint32_t GetOutputBufferSize(const EncoderConfig& config) {
+	return config.width * config.height * 4 * 2;
+}
+#endif
+
+StreamHost::Stream::Stream(StreamHost& host, uint32_t index, const char* output_path)
+	: host(host)
+	, index(index)
+	, renderer(host.device, host.job_system, host.config.mesh_path)
+	, render_targets(host.device, BUFFER_COUNT, host.config.encoder_config.width,
+					 host.config.encoder_config.height, RENDER_TARGET_FORMAT)
+#ifdef GOBLIN_CPU_BACKEND
+	, pipeline(host.config.encoder_config, {.output_path = output_path},
+			   host.config.encoder_config, BUFFER_COUNT) {
+#else
+	, session(*&host.device.device, host.config.encoder_config)
+	, pipeline(host.config.encoder_config, {.output_path = output_path}, session, host.device,
+			   BUFFER_COUNT, GetOutputBufferSize(host.config.encoder_config),
+			   host.config.encoder_config.min_idr_interval) {
+#endif
+	auto& encoder_config = host.config.encoder_config;
+	for (auto i = 0u; i < BUFFER_COUNT; ++i)
+		pipeline.encoder.RegisterTexture(*&render_targets.textures[i], encoder_config.width,
+										 encoder_config.height,
+										 TextureFormatToNvencFormat(RENDER_TARGET_FORMAT),
+										 renderer.frames.fences[i]);
+	pipeline.encoder.AddOutput(StreamHost::CountFrame, this);
+	pipeline.SetCompletionHandler(StreamHost::CompleteFrame, this);
+	if (host.config.paced)
+		clock.emplace(encoder_config.frame_rate_num, encoder_config.frame_rate_den);
+}
+
+StreamHost::StreamHost(const StreamHostConfig& config)
+	: config(config)
+	, job_system({.thread_count = config.worker_count ? config.worker_count
+													  : GetLogicalCoreCount()})
+	, scheduler(config.scheduler, config.stream_count) {
+	if (config.scheduler.max_stream_inflight >= BUFFER_COUNT)
+		throw;
+
+	char output_path[OUTPUT_PATH_SIZE];
+	for (auto i = 0u; i < config.stream_count; ++i) {
+		if (config.output_pattern)
+			snprintf(output_path, sizeof(output_path), config.output_pattern, i);
+		streams.emplace_back(*this, i, config.output_pattern ? output_path : DISCARD_OUTPUT_PATH);
+	}
+}
+
+void StreamHost::Run(std::chrono::nanoseconds duration) {
+	auto end = std::chrono::steady_clock::now() + duration;
+	stopping = false;
+	for (auto i = 0u; i < streams.size(); ++i)
+		if (config.paced)
+			loop.Spawn(RunClock(i));
+		else
+			MarkReady(i);
+	Dispatch();
+
+	auto now = std::chrono::steady_clock::now();
+	while (now < end) {
+		auto remaining = std::chrono::ceil<std::chrono::milliseconds>(end - now);
+		loop.RunOnce((uint32_t)remaining.count());
+		now = std::chrono::steady_clock::now();
+	}
+
+	stopping = true;
+	while (scheduler.GetInflightCount())
+		if (!loop.RunOnce(DRAIN_TIMEOUT_MS))
+			throw;
+	for (auto& stream : streams)
+		stream.pipeline.Drain();
+#ifdef GOBLIN_CPU_BACKEND
+	CpuFence idle_fence;
+	device.command_queue.Signal(&idle_fence, 1);
+	idle_fence.Wait(1);
+#else
+	for (auto& stream : streams)
+		WaitForMultipleObjects((DWORD)stream.renderer.frames.fences.size(),
+							   stream.renderer.frames.fence_events.data(), TRUE, INFINITE);
+#endif
+}
+
+void StreamHost::MarkReady(uint32_t index) {
+	auto& stream = streams[index];
+	if (!scheduler.MarkReady(index)) {
+		++stream.stats.coalesced_ticks;
+		return;
+	}
+	stream.ready_time = std::chrono::steady_clock::now();
+}
+
+void StreamHost::Dispatch() {
+	uint32_t index = 0;
+	while (!stopping && scheduler.TakeNext(index))
+		SubmitFrame(index);
+}
+
+void StreamHost::SubmitFrame(uint32_t index) {
+	auto& stream		 = streams[index];
+	auto& renderer		 = stream.renderer;
+	auto& encoder_config = config.encoder_config;
+	auto frame			 = stream.next_frame++;
+	auto slot			 = frame % BUFFER_COUNT;
+	auto fence_value	 = frame + 1ull;
+	auto render_target	 = *&stream.render_targets.textures[slot];
+	auto rtv			 = stream.render_targets.render_target_views[slot];
+	auto command_lists	 = renderer.frames.GetCommandLists(slot);
+	float color[]{(float)index / streams.size(), (float)(frame % 256) / 255.0f, 0.0f, 1.0f};
+	TextureTransition<RenderTexture> begin_transitions[]{{
+		.texture = render_target,
+		.before	 = ResourceState::Common,
+		.after	 = ResourceState::RenderTarget,
+	}};
+	TextureTransition<RenderTexture> end_transitions[]{{
+		.texture = render_target,
+		.before	 = ResourceState::RenderTarget,
+		.after	 = ResourceState::Common,
+	}};
+
+	renderer.BeginFrame();
+	command_lists.front().Reset();
+	command_lists.front().Barrier(begin_transitions);
+	command_lists.front().Clear(rtv, color);
+	command_lists.front().Close();
+	renderer.RecordDraws(command_lists.subspan(1, DRAW_COMMAND_LIST_COUNT), rtv,
+						 encoder_config.width, encoder_config.height, config.draw_count);
+	command_lists.back().Reset();
+	command_lists.back().Barrier(end_transitions);
+	command_lists.back().Close();
+	device.Execute(command_lists);
+	renderer.EndFrame(slot, fence_value);
+	device.Signal(renderer.frames.fences[slot], fence_value, renderer.frames.fence_events[slot]);
+
+	auto submitted_frames = stream.pipeline.encoder.GetStats().submitted_frames;
+	stream.ready_times[submitted_frames % BUFFER_COUNT] = stream.ready_time;
+	if (!stream.pipeline.EncodeFrame(loop, slot, fence_value, frame,
+									 config.paced ? stream.timestamp : frame)) {
+		++stream.stats.dropped_frames;
+		FinishFrame(index);
+	}
+}
+
+void StreamHost::FinishFrame(uint32_t index) {
+	scheduler.Complete(index);
+	if (!config.paced && !stopping)
+		MarkReady(index);
+}
+
+EventTask StreamHost::RunClock(uint32_t index) {
+	auto& stream = streams[index];
+	while (true) {
+		co_await loop.Wait(stream.clock->GetEvent());
+		auto ticks			= stream.clock->GetStats().ticks;
+		uint64_t timestamp	= 0;
+		stream.clock->OnTick(timestamp);
+		if (stopping || stream.clock->GetStats().ticks == ticks)
+			continue;
+
+		++stream.stats.ticks;
+		stream.timestamp = timestamp;
+		MarkReady(index);
+		Dispatch();
+	}
+}
+
+void StreamHost::CountFrame(void* stream, const EncodedFrame& frame) {
+	((Stream*)stream)->stats.bytes += frame.size;
+}
+
+void StreamHost::CompleteFrame(void* context, uint64_t submitted_frames) {
+	auto& stream	= *(Stream*)context;
+	auto ready_time = stream.ready_times[(submitted_frames - 1) % BUFFER_COUNT];
+	auto elapsed	= std::chrono::steady_clock::now() - ready_time;
+	auto latency	= (uint64_t)std::chrono::nanoseconds(elapsed).count();
+	++stream.stats.frames;
+	stream.stats.latency_nanoseconds += latency;
+	stream.stats.max_latency_nanoseconds = std::max(stream.stats.max_latency_nanoseconds, latency);
+	stream.host.FinishFrame(stream.index);
+	stream.host.Dispatch();
+}
+
+uint32_t StreamHost::GetStreamCount() const {
+	return (uint32_t)streams.size();
+}
+
+StreamStats StreamHost::GetStreamStats(uint32_t index) const {
+	return streams[index].stats;
+}
+
+StreamSchedulerStats StreamHost::GetSchedulerStats() const {
+	return scheduler.GetStats();
+}
+
+EventLoopStats StreamHost::GetEventLoopStats() const {
+	return loop.GetStats();
+}
+
+JobSystemStats StreamHost::GetJobSystemStats() const {
+	return job_system.GetStats();
+}
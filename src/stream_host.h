@@ -0,0 +1,87 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+#include <vector>
+
+#include "capture_clock.h"
+#include "encoder/encoder_config.h"
+#include "event_loop.h"
+#include "job_system.h"
+#include "stream_pipeline.h"
+#include "stream_scheduler.h"
+
+struct StreamHostConfig {
+	uint32_t stream_count = 1;
+	EncoderConfig encoder_config{.width = 320, .height = 180};
+	StreamSchedulerConfig scheduler;
+	bool paced				   = true;
+	const char* output_pattern = nullptr;
+	const char* mesh_path	   = nullptr;
+	uint32_t draw_count		   = 1;
+	uint32_t worker_count	   = 0;
+};
+
+struct StreamStats {
+	uint64_t frames;
+	uint64_t bytes;
+	uint64_t ticks;
+	uint64_t coalesced_ticks;
+	uint64_t dropped_frames;
+	uint64_t latency_nanoseconds;
+	uint64_t max_latency_nanoseconds;
+};
+
+class StreamHost {
+  public:
+	explicit StreamHost(const StreamHostConfig& config);
+
+	StreamHost(const StreamHost&)			 = delete;
+	StreamHost& operator=(const StreamHost&) = delete;
+
+	void Run(std::chrono::nanoseconds duration);
+	uint32_t GetStreamCount() const;
+	StreamStats GetStreamStats(uint32_t stream) const;
+	StreamSchedulerStats GetSchedulerStats() const;
+	EventLoopStats GetEventLoopStats() const;
+	JobSystemStats GetJobSystemStats() const;
+
+  private:
+	struct Stream {
+		StreamHost& host;
+		uint32_t index;
+		Renderer renderer;
+		RenderTextureArray render_targets;
+#ifndef GOBLIN_CPU_BACKEND
+		NvencSession session;
+#endif
+		StreamPipeline pipeline;
+		std::vector<std::chrono::steady_clock::time_point> ready_times{BUFFER_COUNT};
+		std::optional<CaptureClock> clock;
+		std::chrono::steady_clock::time_point ready_time;
+		uint64_t timestamp	= 0;
+		uint32_t next_frame = 0;
+		StreamStats stats{};
+
+		Stream(StreamHost& host, uint32_t index, const char* output_path);
+	};
+
+	static void CountFrame(void* stream, const EncodedFrame& frame);
+	static void CompleteFrame(void* stream, uint64_t submitted_frames);
+
+	void MarkReady(uint32_t stream);
+	void Dispatch();
+	void SubmitFrame(uint32_t stream);
+	void FinishFrame(uint32_t stream);
+	EventTask RunClock(uint32_t stream);
+
+	StreamHostConfig config;
+	JobSystem job_system;
+	RenderDevice device;
+	StreamScheduler scheduler;
+	std::deque<Stream> streams;
+	EventLoop loop;
+	bool stopping = false;
+};
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <utility>
+
+#include "debug_log.h"
+#include "encoder/bitstream_file_writer.h"
+#include "encoder/encoder_config.h"
+#include "encoder/frame_pacing.h"
+#include "event_loop.h"
+#include "graphics/command_recorder.h"
+#include "graphics/mesh_file.h"
+#include "graphics/render_backend.h"
+#include "graphics/upload_ring.h"
+#include "job_system.h"
+
+#ifdef GOBLIN_CPU_BACKEND
+#include "encoder/mock_frame_encoder.h"
+#else
+#include "encoder/frame_encoder.h"
+#include "encoder/nvenc_session.h"
+#endif
+
+constexpr auto BUFFER_COUNT				 = 3u;
+constexpr auto RENDER_TARGET_FORMAT		 = TextureFormat::B8G8R8A8Unorm;
+constexpr auto CONSTANT_BUFFER_ALIGNMENT = 256u;
+constexpr auto UPLOAD_RING_FRAME_SIZE	 = 64u * 1024u;
+constexpr auto DRAW_COMMAND_LIST_COUNT	 = 4u;
+constexpr auto COMMAND_LISTS_PER_FRAME	 = DRAW_COMMAND_LIST_COUNT + 2;
+
+#ifdef GOBLIN_CPU_BACKEND
+using StreamEncoder = MockFrameEncoder;
+#else
+using StreamEncoder = FrameEncoder;
+#endif
+
+using FrameCompletionHandler = void (*)(void* context, uint64_t submitted_frames);
+
+struct MvpConstants {
+	float mvp[16];
+};
+
+constexpr MvpConstants MVP_IDENTITY{
+	.mvp = {
+		1.0f, 0.0f, 0.0f, 0.0f,
+		0.0f, 1.0f, 0.0f, 0.0f,
+		0.0f, 0.0f, 1.0f, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f,
+	},
+};
+
+struct UploadAddress {
+	uint8_t* cpu_address;
+	uint64_t gpu_address;
+};
+
+struct FrameUploadRing {
+	RenderUploadBuffer buffer;
+	UploadRing ring;
+
+	FrameUploadRing(RenderDevice& device, uint32_t frame_count)
+		: buffer(device, UPLOAD_RING_FRAME_SIZE * frame_count)
+		, ring(UPLOAD_RING_FRAME_SIZE * frame_count, frame_count) {
+	}
+
+	UploadAddress Allocate(uint64_t size, uint64_t alignment) {
+		auto allocation = ring.Allocate(size, alignment);
+		return UploadAddress{
+			.cpu_address = buffer.mapped + allocation.offset,
+			.gpu_address = buffer.GetGpuVirtualAddress() + allocation.offset,
+		};
+	}
+
+	template <typename T>
+	uint64_t Write(const T& data, uint64_t alignment = CONSTANT_BUFFER_ALIGNMENT) {
+		auto address = Allocate(sizeof(T), alignment);
+		memcpy(address.cpu_address, &data, sizeof(T));
+		return address.gpu_address;
+	}
+};
+
+inline RenderMesh LoadMesh(RenderDevice& device, const char* mesh_path) {
+	if (mesh_path)
+		return RenderMesh{device, MeshFile{mesh_path}};
+	return RenderMesh{device};
+}
+
+struct Renderer {
+	RenderDevice& d;
+
+	RenderFrameResources frames{d, BUFFER_COUNT, COMMAND_LISTS_PER_FRAME};
+	FrameUploadRing upload_ring{d, BUFFER_COUNT};
+	RenderMesh mesh;
+	RenderPipeline pipeline;
+	ParallelCommandRecorder recorder;
+
+	Renderer(RenderDevice& d, JobSystem& job_system, const char* mesh_path)
+		: d(d)
+		, mesh(LoadMesh(d, mesh_path))
+		, pipeline(d, job_system, RENDER_TARGET_FORMAT, mesh.GetPositionFormat())
+		, recorder(job_system) {
+	}
+
+	void BeginFrame() {
+		upload_ring.ring.RetireCompletedFrames(std::span<RenderFence* const>{frames.fences});
+	}
+
+	void EndFrame(uint32_t frame_index, uint64_t fence_value) {
+		upload_ring.ring.EndFrame(frame_index, fence_value);
+	}
+
+	void ClearRenderTarget(RenderCommandList& command_list, RenderTargetView rtv) {
+		float clear_color[]{0.0f, 0.0f, 0.0f, 1.0f};
+		command_list.Clear(rtv, clear_color);
+	}
+
+	void RecordDraws(std::span<RenderCommandList> command_lists, RenderTargetView rtv,
+					 uint32_t width, uint32_t height, uint32_t draw_count) {
+		auto constants = upload_ring.Write(MVP_IDENTITY);
+		recorder.Record(command_lists, draw_count,
+						[&](RenderCommandList& command_list, uint32_t begin, uint32_t end) {
+							if (begin == end)
+								return;
+							command_list.SetRenderTarget(rtv, width, height);
+							command_list.SetPipeline(pipeline);
+							command_list.SetConstants(constants);
+							for (auto i = begin; i < end; ++i)
+								command_list.Draw(mesh);
+						});
+	}
+};
+
+struct StreamPipelineConfig {
+	const char* output_path;
+	uint32_t node = ANY_NUMA_NODE;
+	FramePacingConfig pacing;
+};
+
+class StreamPipeline {
+  public:
+	template <typename... EncoderArgs>
+	StreamPipeline(const EncoderConfig& encoder_config, const StreamPipelineConfig& config,
+				   EncoderArgs&&... encoder_args)
+		: encoder(std::forward<EncoderArgs>(encoder_args)...)
+		, writer(config.output_path, HUGE_PAGE_SIZE, config.node)
+		, pacer(config.pacing, encoder_config.codec)
+		, bitrate(encoder_config.bitrate)
+		, max_bitrate(encoder_config.max_bitrate) {
+		encoder.SetWriteFilter(FramePacer::FilterWrite, &pacer);
+	}
+
+	StreamPipeline(const StreamPipeline&)			 = delete;
+	StreamPipeline& operator=(const StreamPipeline&) = delete;
+
+	bool EncodeFrame(EventLoop& loop, uint32_t texture_index, uint64_t fence_value, uint32_t frame,
+					 uint64_t timestamp) {
+		writer.DrainCompleted();
+		auto action = pacer.BeforeEncode((uint32_t)encoder.GetStats().pending_frames,
+										 writer.GetPendingCount());
+		uint32_t bitrate_percent = 0;
+		if (pacer.TakeBitrateChange(bitrate_percent))
+			encoder.SetBitrate(bitrate / 100 * bitrate_percent,
+							   max_bitrate / 100 * bitrate_percent);
+
+		FRAME_LOG("frame=%u pacing action=%d bitrate_percent=%u", frame, (int)action,
+				  pacer.GetStats().bitrate_percent);
+		if (action == FrameAction::Wait)
+			encoder.ProcessCompletedFrames(writer, true);
+		if (action == FrameAction::Drop)
+			return false;
+
+		encoder.EncodeFrame(texture_index, fence_value, frame, timestamp);
+		loop.Spawn(CompleteFrame(loop, encoder.GetStats().submitted_frames));
+		return true;
+	}
+
+	void Drain() {
+		encoder.ProcessCompletedFrames(writer, true);
+	}
+
+	void SetCompletionHandler(FrameCompletionHandler handler, void* context) {
+		completion_handler = handler;
+		completion_context = context;
+	}
+
+	StreamEncoder encoder;
+	BitstreamFileWriter writer;
+	FramePacer pacer;
+
+  private:
+	EventTask CompleteFrame(EventLoop& loop, uint64_t submitted_frames) {
+		while (encoder.GetStats().completed_frames < submitted_frames) {
+			co_await loop.Wait(encoder.NextOutputEvent());
+			encoder.ProcessCompletedFrames(writer);
+		}
+		while (writer.HasPendingWrites()) {
+			co_await loop.Wait(writer.NextWriteEvent());
+			writer.DrainCompleted();
+		}
+		if (completion_handler)
+			completion_handler(completion_context, submitted_frames);
+	}
+
+	uint32_t bitrate;
+	uint32_t max_bitrate;
+	FrameCompletionHandler completion_handler = nullptr;
+	void* completion_context				  = nullptr;
+};
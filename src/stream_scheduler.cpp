@@ -0,0 +1,72 @@
+#include "stream_scheduler.h"
+
+#include <algorithm>
+
+StreamScheduler::StreamScheduler(const StreamSchedulerConfig& config, uint32_t stream_count)
+	: config(config), streams(stream_count) {
+	if (!stream_count || !config.max_inflight_frames || !config.max_stream_inflight)
+		throw;
+}
+
+bool StreamScheduler::MarkReady(uint32_t stream) {
+	auto& state = streams[stream];
+	if (state.ready) {
+		++stats.coalesced_frames;
+		return false;
+	}
+
+	state.ready = true;
+	++ready_count;
+	++stats.ready_frames;
+	stats.max_ready = std::max(stats.max_ready, ready_count);
+	return true;
+}
+
+bool StreamScheduler::TakeNext(uint32_t& stream) {
+	if (!ready_count)
+		return false;
+	if (inflight == config.max_inflight_frames) {
+		++stats.budget_waits;
+		return false;
+	}
+
+	auto stream_count = (uint32_t)streams.size();
+	for (auto i = 0u; i < stream_count; ++i) {
+		auto index	= (cursor + i) % stream_count;
+		auto& state = streams[index];
+		if (!state.ready || state.inflight == config.max_stream_inflight)
+			continue;
+
+		state.ready = false;
+		++state.inflight;
+		--ready_count;
+		++inflight;
+		cursor = (index + 1) % stream_count;
+		stream = index;
+		++stats.scheduled_frames;
+		stats.max_inflight = std::max(stats.max_inflight, inflight);
+		return true;
+	}
+	return false;
+}
+
+void StreamScheduler::Complete(uint32_t stream) {
+	auto& state = streams[stream];
+	if (!state.inflight)
+		throw;
+	--state.inflight;
+	--inflight;
+	++stats.completed_frames;
+}
+
+bool StreamScheduler::IsReady(uint32_t stream) const {
+	return streams[stream].ready;
+}
+
+uint32_t StreamScheduler::GetInflightCount() const {
+	return inflight;
+}
+
+StreamSchedulerStats StreamScheduler::GetStats() const {
+	return stats;
+}
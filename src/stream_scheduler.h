@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+struct StreamSchedulerConfig {
+	uint32_t max_inflight_frames = 8;
+	uint32_t max_stream_inflight = 2;
+};
+
+struct StreamSchedulerStats {
+	uint64_t ready_frames;
+	uint64_t coalesced_frames;
+	uint64_t scheduled_frames;
+	uint64_t completed_frames;
+	uint64_t budget_waits;
+	uint32_t max_inflight;
+	uint32_t max_ready;
+};
+
+class StreamScheduler {
+  public:
+	StreamScheduler(const StreamSchedulerConfig& config, uint32_t stream_count);
+
+	bool MarkReady(uint32_t stream);
+	bool TakeNext(uint32_t& stream);
+	void Complete(uint32_t stream);
+	bool IsReady(uint32_t stream) const;
+	uint32_t GetInflightCount() const;
+	StreamSchedulerStats GetStats() const;
+
+  private:
+	struct StreamState {
+		bool ready;
+		uint32_t inflight;
+	};
+
+	StreamSchedulerConfig config;
+	std::vector<StreamState> streams;
+	uint32_t cursor		 = 0;
+	uint32_t inflight	 = 0;
+	uint32_t ready_count = 0;
+	StreamSchedulerStats stats{};
+};
@@ -0,0 +1,128 @@
+#include "thread_placement.h"
+
+#include <charconv>
+
+static bool ParseNumber(std::string_view text, uint32_t& value) {
+	auto end	= text.data() + text.size();
+	auto result = std::from_chars(text.data(), end, value);
+	return result.ec == std::errc{} && result.ptr == end;
+}
+
+static bool ParseCoreList(std::string_view text, std::vector<uint32_t>& cores) {
+	cores.clear();
+	while (!text.empty()) {
+		auto separator = text.find('+');
+		auto range	   = text.substr(0, separator);
+		auto dash	   = range.find('-');
+		uint32_t first = 0;
+		uint32_t last  = 0;
+		if (!ParseNumber(range.substr(0, dash), first))
+			return false;
+		if (dash == std::string_view::npos)
+			last = first;
+		else if (!ParseNumber(range.substr(dash + 1), last) || last < first)
+			return false;
+		for (auto core = first; core <= last; ++core)
+			cores.push_back(core);
+		text = separator == std::string_view::npos ? std::string_view{}
+												   : text.substr(separator + 1);
+	}
+	return !cores.empty();
+}
+
+static bool ParsePriority(std::string_view text, ThreadPriority& priority) {
+	if (text == "low")
+		priority = ThreadPriority::Low;
+	else if (text == "normal")
+		priority = ThreadPriority::Normal;
+	else if (text == "high")
+		priority = ThreadPriority::High;
+	else
+		return false;
+	return true;
+}
+
+static ThreadPlacement* FindRole(std::string_view role, PipelinePlacement& placement) {
+	if (role == "render")
+		return &placement.render;
+	if (role == "writer")
+		return &placement.writer;
+	if (role == "workers")
+		return &placement.workers;
+	return nullptr;
+}
+
+bool ParsePipelinePlacement(std::string_view spec, PipelinePlacement& placement) {
+	while (!spec.empty()) {
+		auto separator = spec.find(',');
+		auto entry	   = spec.substr(0, separator);
+		auto dot	   = entry.find('.');
+		auto equals	   = entry.find('=');
+		if (dot == std::string_view::npos || equals == std::string_view::npos || equals < dot)
+			return false;
+
+		auto role	= FindRole(entry.substr(0, dot), placement);
+		auto field	= entry.substr(dot + 1, equals - dot - 1);
+		auto value	= entry.substr(equals + 1);
+		auto parsed = false;
+		if (!role)
+			return false;
+		if (field == "node")
+			parsed = ParseNumber(value, role->node);
+		else if (field == "cores")
+			parsed = ParseCoreList(value, role->cores);
+		else if (field == "priority")
+			parsed = ParsePriority(value, role->priority);
+		if (!parsed)
+			return false;
+		spec = separator == std::string_view::npos ? std::string_view{}
+												   : spec.substr(separator + 1);
+	}
+	return true;
+}
+
+std::vector<uint32_t> GetPlacementCores(const ThreadPlacement& placement) {
+	if (!placement.cores.empty())
+		return placement.cores;
+	if (placement.node == ANY_NUMA_NODE)
+		return {};
+
+	auto cores = GetNumaNodeCores(placement.node);
+	if (cores.empty())
+		throw;
+	return cores;
+}
+
+uint32_t GetPlacementNode(const ThreadPlacement& placement) {
+	if (placement.node != ANY_NUMA_NODE)
+		return placement.node;
+	if (!placement.cores.empty())
+		return GetCoreNumaNode(placement.cores.front());
+	return GetCoreNumaNode(GetCurrentCore());
+}
+
+AppliedPlacement ApplyThreadPlacement(const ThreadPlacement& placement) {
+	auto cores = GetPlacementCores(placement);
+	if (!cores.empty())
+		PinCurrentThreadToCores(cores);
+	return AppliedPlacement{
+		.node		  = GetPlacementNode(placement),
+		.core_count	  = (uint32_t)cores.size(),
+		.pinned		  = !cores.empty(),
+		.priority_set = placement.priority == ThreadPriority::Normal
+					 || SetCurrentThreadPriority(placement.priority),
+	};
+}
+
+AppliedPlacement ApplyWorkerPlacement(const ThreadPlacement& placement, uint32_t worker_index) {
+	auto cores = GetPlacementCores(placement);
+	if (!cores.empty())
+		PinCurrentThread(cores[worker_index % cores.size()]);
+	return AppliedPlacement{
+		.node		  = GetPlacementNode(placement),
+		.core_count	  = cores.empty() ? 0u : 1u,
+		.pinned		  = !cores.empty(),
+		.priority_set = placement.priority == ThreadPriority::Normal
+					 || SetCurrentThreadPriority(placement.priority),
+	};
+}
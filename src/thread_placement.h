@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "platform_thread.h"
+
+constexpr uint32_t ANY_NUMA_NODE = UINT32_MAX;
+
+struct ThreadPlacement {
+	uint32_t node = ANY_NUMA_NODE;
+	std::vector<uint32_t> cores;
+	ThreadPriority priority = ThreadPriority::Normal;
+};
+
+struct PipelinePlacement {
+	ThreadPlacement render;
+	ThreadPlacement writer;
+	ThreadPlacement workers;
+};
+
+struct AppliedPlacement {
+	uint32_t node;
+	uint32_t core_count;
+	bool pinned;
+	bool priority_set;
+};
+
+bool ParsePipelinePlacement(std::string_view spec, PipelinePlacement& placement);
+std::vector<uint32_t> GetPlacementCores(const ThreadPlacement& placement);
+uint32_t GetPlacementNode(const ThreadPlacement& placement);
+AppliedPlacement ApplyThreadPlacement(const ThreadPlacement& placement);
+AppliedPlacement ApplyWorkerPlacement(const ThreadPlacement& placement, uint32_t worker_index);
@@ -0,0 +1,359 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <vector>
+
+#include "buffer_pool.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <linux/perf_event.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+constexpr uint32_t WRITE_SLOT_COUNT = 4;
+constexpr size_t CACHE_LINE_SIZE	= 64;
+
+constexpr const char* PAGE_BACKING_NAMES[]{"small", "transparent", "huge"};
+
+static std::atomic<uint64_t> allocation_count = 0;
+
+void* operator new(size_t size) {
+	allocation_count.fetch_add(1, std::memory_order_relaxed);
+	if (auto memory = malloc(size ? size : 1))
+		return memory;
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* memory) noexcept {
+	free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept {
+	free(memory);
+}
+
+enum class StagingMode { Vector, SmallPagePool, HugePagePool };
+
+struct WorkloadConfig {
+	uint32_t frame_count   = 5000;
+	uint32_t gop_length	   = 60;
+	uint32_t keyframe_size = 1024 * 1024;
+	uint32_t frame_size	   = 128 * 1024;
+	size_t buffer_capacity = HUGE_PAGE_SIZE;
+	uint32_t node		   = ANY_NUMA_NODE;
+};
+
+struct CounterValues {
+	uint64_t tlb_misses;
+	uint64_t page_faults;
+};
+
+struct RunResult {
+	double seconds;
+	uint64_t bytes;
+	uint64_t checksum;
+	uint64_t allocations;
+	CounterValues counters;
+	bool has_pool;
+	BufferPoolStats pool;
+	uint64_t huge_page_kb;
+};
+
+#ifdef _WIN32
+
+class MemoryCounters {
+  public:
+	bool HasTlbCounter() const {
+		return false;
+	}
+
+	CounterValues Read() const {
+		PROCESS_MEMORY_COUNTERS counters{.cb = sizeof(counters)};
+		GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters));
+		return CounterValues{.page_faults = counters.PageFaultCount};
+	}
+};
+
+static uint64_t ReadAnonHugePageKb() {
+	return 0;
+}
+
+#else
+
+constexpr uint64_t DTLB_READ_MISSES = PERF_COUNT_HW_CACHE_DTLB
+									| PERF_COUNT_HW_CACHE_OP_READ << 8
+									| PERF_COUNT_HW_CACHE_RESULT_MISS << 16;
+
+class MemoryCounters {
+  public:
+	MemoryCounters() {
+		perf_event_attr attributes{
+			.type			= PERF_TYPE_HW_CACHE,
+			.size			= sizeof(perf_event_attr),
+			.config			= DTLB_READ_MISSES,
+			.exclude_kernel = 1,
+			.exclude_hv		= 1,
+		};
+		tlb_descriptor = (int)syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+	}
+
+	~MemoryCounters() {
+		if (tlb_descriptor >= 0)
+			close(tlb_descriptor);
+	}
+
+	MemoryCounters(const MemoryCounters&)			 = delete;
+	MemoryCounters& operator=(const MemoryCounters&) = delete;
+
+	bool HasTlbCounter() const {
+		return tlb_descriptor >= 0;
+	}
+
+	CounterValues Read() const {
+		CounterValues values{};
+		if (tlb_descriptor >= 0
+			&& read(tlb_descriptor, &values.tlb_misses, sizeof(values.tlb_misses))
+				   != sizeof(values.tlb_misses))
+			values.tlb_misses = 0;
+
+		rusage usage{};
+		getrusage(RUSAGE_SELF, &usage);
+		values.page_faults = (uint64_t)usage.ru_minflt;
+		return values;
+	}
+
+  private:
+	int tlb_descriptor = -1;
+};
+
+static uint64_t ReadAnonHugePageKb() {
+	auto file = fopen("/proc/self/smaps_rollup", "r");
+	if (!file)
+		return 0;
+
+	char line[128];
+	unsigned long long kb = 0;
+	while (fgets(line, sizeof(line), file))
+		if (sscanf(line, "AnonHugePages: %llu kB", &kb) == 1)
+			break;
+	fclose(file);
+	return kb;
+}
+
+#endif
+
+static uint64_t SampleChecksum(const uint8_t* data, size_t size) {
+	uint64_t checksum = 0;
+	for (size_t offset = 0; offset < size; offset += CACHE_LINE_SIZE)
+		checksum += data[offset];
+	return checksum;
+}
+
+struct VectorSlots {
+	std::vector<uint8_t> slots[WRITE_SLOT_COUNT];
+	uint32_t head	  = 0;
+	uint32_t pending  = 0;
+	uint64_t checksum = 0;
+
+	void Write(const uint8_t* data, uint32_t size) {
+		if (pending == WRITE_SLOT_COUNT)
+			RetireHead();
+		slots[(head + pending) % WRITE_SLOT_COUNT].assign(data, data + size);
+		++pending;
+	}
+
+	void RetireHead() {
+		checksum += SampleChecksum(slots[head].data(), slots[head].size());
+		head = (head + 1) % WRITE_SLOT_COUNT;
+		--pending;
+	}
+};
+
+struct PooledSlots {
+	BufferPool pool;
+	uint8_t* buffers[WRITE_SLOT_COUNT]{};
+	uint32_t sizes[WRITE_SLOT_COUNT]{};
+	uint32_t head	  = 0;
+	uint32_t pending  = 0;
+	uint64_t checksum = 0;
+
+	void Write(const uint8_t* data, uint32_t size) {
+		for (uint32_t offset = 0; offset < size;) {
+			auto chunk_size = (uint32_t)std::min<size_t>(size - offset, pool.GetCapacity());
+			if (pending == WRITE_SLOT_COUNT)
+				RetireHead();
+
+			auto slot	  = (head + pending) % WRITE_SLOT_COUNT;
+			buffers[slot] = pool.Acquire(chunk_size);
+			sizes[slot]	  = chunk_size;
+			memcpy(buffers[slot], data + offset, chunk_size);
+			offset += chunk_size;
+			++pending;
+		}
+	}
+
+	void RetireHead() {
+		checksum += SampleChecksum(buffers[head], sizes[head]);
+		pool.Release(buffers[head]);
+		head = (head + 1) % WRITE_SLOT_COUNT;
+		--pending;
+	}
+};
+
+static uint32_t GetFrameSize(const WorkloadConfig& workload, uint32_t frame) {
+	if (frame % workload.gop_length == 0)
+		return workload.keyframe_size;
+	return workload.frame_size / 2 + frame * 7919 % (workload.frame_size + 1);
+}
+
+template <typename Slots>
+static void RunWorkload(Slots& slots, const WorkloadConfig& workload,
+						const std::vector<uint8_t>& source, RunResult& result,
+						const MemoryCounters& counters) {
+	auto counters_before	= counters.Read();
+	auto allocations_before = allocation_count.load(std::memory_order_relaxed);
+	auto start				= std::chrono::steady_clock::now();
+	for (auto frame = 0u; frame < workload.frame_count; ++frame) {
+		auto size = GetFrameSize(workload, frame);
+		slots.Write(source.data() + frame % CACHE_LINE_SIZE, size);
+		result.bytes += size;
+	}
+	while (slots.pending)
+		slots.RetireHead();
+	auto elapsed   = std::chrono::steady_clock::now() - start;
+	result.seconds = std::chrono::duration<double>(elapsed).count();
+
+	result.allocations = allocation_count.load(std::memory_order_relaxed) - allocations_before;
+	result.checksum	   = slots.checksum;
+
+	auto counters_after			= counters.Read();
+	result.counters.tlb_misses	= counters_after.tlb_misses - counters_before.tlb_misses;
+	result.counters.page_faults = counters_after.page_faults - counters_before.page_faults;
+}
+
+static RunResult Run(StagingMode mode, const WorkloadConfig& workload,
+					 const std::vector<uint8_t>& source, const MemoryCounters& counters) {
+	RunResult result{};
+	auto huge_page_kb_before = ReadAnonHugePageKb();
+	if (mode == StagingMode::Vector) {
+		VectorSlots slots;
+		RunWorkload(slots, workload, source, result, counters);
+		return result;
+	}
+
+	BufferPoolConfig config{
+		.buffer_capacity = workload.buffer_capacity,
+		.buffer_count	 = WRITE_SLOT_COUNT,
+		.huge_pages		 = mode == StagingMode::HugePagePool,
+		.node			 = workload.node,
+	};
+	PooledSlots slots{.pool = BufferPool{config}};
+	result.huge_page_kb = ReadAnonHugePageKb() - huge_page_kb_before;
+	RunWorkload(slots, workload, source, result, counters);
+	result.has_pool = true;
+	result.pool		= slots.pool.GetStats();
+	return result;
+}
+
+static const char* GetModeName(StagingMode mode) {
+	switch (mode) {
+		case StagingMode::Vector:
+			return "vector";
+		case StagingMode::SmallPagePool:
+			return "pool-4k";
+		case StagingMode::HugePagePool:
+			return "pool-huge";
+	}
+	return "unknown";
+}
+
+int main(int argc, char** argv) {
+	WorkloadConfig workload{};
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--frames") == 0 && has_value)
+			workload.frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--gop") == 0 && has_value)
+			workload.gop_length = std::max(1u, (uint32_t)strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--keyframe-bytes") == 0 && has_value)
+			workload.keyframe_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--frame-bytes") == 0 && has_value)
+			workload.frame_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--capacity") == 0 && has_value)
+			workload.buffer_capacity = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--node") == 0 && has_value)
+			workload.node = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr,
+					"usage: %s [--frames <n>] [--gop <n>] [--keyframe-bytes <n>] "
+					"[--frame-bytes <n>]\n"
+					"          [--capacity <bytes>] [--node <n>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!workload.frame_count || !workload.buffer_capacity)
+		return 1;
+
+	try {
+		MemoryCounters counters;
+		auto max_frame_size = std::max(workload.keyframe_size, workload.frame_size * 3 / 2);
+		std::vector<uint8_t> source(max_frame_size + CACHE_LINE_SIZE);
+		for (size_t i = 0; i < source.size(); ++i)
+			source[i] = (uint8_t)(i * 2654435761u >> 13);
+
+		printf("%u frames, keyframe %u bytes every %u, frame ~%u bytes, %u write slots, "
+			   "%zu-byte buffers, dTLB counter %s\n",
+			   workload.frame_count, workload.keyframe_size, workload.gop_length,
+			   workload.frame_size, WRITE_SLOT_COUNT, workload.buffer_capacity,
+			   counters.HasTlbCounter() ? "available" : "unavailable");
+
+		RunResult results[3]{};
+		StagingMode modes[]{StagingMode::Vector, StagingMode::SmallPagePool,
+							StagingMode::HugePagePool};
+		auto passed = true;
+		for (auto i = 0u; i < std::size(modes); ++i) {
+			results[i]	 = Run(modes[i], workload, source, counters);
+			auto& result = results[i];
+			printf("%-9s %.2f GB/s, %llu allocations, %llu page faults, ", GetModeName(modes[i]),
+				   result.bytes / result.seconds / 1e9, (unsigned long long)result.allocations,
+				   (unsigned long long)result.counters.page_faults);
+			if (counters.HasTlbCounter())
+				printf("%.1f dTLB misses/frame", (double)result.counters.tlb_misses
+													 / workload.frame_count);
+			else
+				printf("dTLB misses n/a");
+			if (result.has_pool)
+				printf(", %s pages (%llu kB huge), slab %llu kB, max %u buffers, %llu bytes, "
+					   "largest %llu, exhausted %llu",
+					   PAGE_BACKING_NAMES[(int)result.pool.backing],
+					   (unsigned long long)result.huge_page_kb,
+					   (unsigned long long)result.pool.slab_size / 1024,
+					   result.pool.max_buffers_in_use,
+					   (unsigned long long)result.pool.max_bytes_in_use,
+					   (unsigned long long)result.pool.max_acquire_size,
+					   (unsigned long long)result.pool.exhausted_acquires);
+			printf("\n");
+
+			passed = passed && result.checksum == results[0].checksum;
+			if (result.has_pool)
+				passed = passed && !result.allocations && !result.pool.exhausted_acquires
+					  && result.pool.max_buffers_in_use <= WRITE_SLOT_COUNT
+					  && !result.pool.buffers_in_use;
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "buffer pool benchmark failed\n");
+		return 1;
+	}
+}
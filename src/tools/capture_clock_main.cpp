@@ -0,0 +1,165 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "capture_clock.h"
+#include "encoder/encoder_config.h"
+#include "encoder/mock_frame_encoder.h"
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+#include "platform_event.h"
+
+constexpr uint32_t BUFFER_COUNT		   = 3;
+constexpr uint32_t WAIT_TIMEOUT_MS	   = 100;
+constexpr uint32_t DISPLAY_RATE_DEN	   = 1000;
+constexpr uint32_t CAPTURE_EVENT_INDEX = 0;
+
+struct NullWriter {
+	void WriteFrame(const void*, uint32_t) {}
+};
+
+struct TimestampTracker {
+	uint64_t frames			  = 0;
+	uint64_t out_of_order	  = 0;
+	uint64_t last_timestamp	  = 0;
+	uint64_t timestamp_gaps	  = 0;
+	uint32_t last_frame_index = 0;
+
+	static void OnFrame(void* context, const EncodedFrame& frame) {
+		auto tracker = (TimestampTracker*)context;
+		if (tracker->frames && frame.timestamp <= tracker->last_timestamp)
+			++tracker->out_of_order;
+		if (tracker->frames && frame.timestamp > tracker->last_timestamp + 1)
+			tracker->timestamp_gaps += frame.timestamp - tracker->last_timestamp - 1;
+		tracker->last_timestamp	  = frame.timestamp;
+		tracker->last_frame_index = frame.frame_index;
+		++tracker->frames;
+	}
+};
+
+int main(int argc, char** argv) {
+	EncoderConfig config{.codec = EncoderCodec::H264, .width = 64, .height = 64};
+	auto seconds		= 5.0;
+	auto display_rate	= 144.0;
+	uint32_t stall_ms	= 0;
+	uint32_t stall_each = 0;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--fps") == 0 && i + 2 < argc) {
+			config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			config.frame_rate_den = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--display-fps") == 0 && has_value)
+			display_rate = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--seconds") == 0 && has_value)
+			seconds = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--stall") == 0 && i + 2 < argc) {
+			stall_ms   = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			stall_each = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			fprintf(stderr,
+					"usage: %s [--fps <num> <den>] [--display-fps <rate>] [--seconds <n>]\n"
+					"          [--stall <ms> <every-n-display-frames>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!config.frame_rate_num || !config.frame_rate_den || display_rate <= 0.0)
+		return 1;
+
+	try {
+		std::vector<CpuTexture> textures;
+		std::vector<CpuFence> fences(BUFFER_COUNT);
+		textures.reserve(BUFFER_COUNT);
+		MockFrameEncoder encoder{config, BUFFER_COUNT};
+		for (auto i = 0u; i < BUFFER_COUNT; ++i) {
+			auto& texture = textures.emplace_back(config.width, config.height,
+												  TextureFormat::B8G8R8A8Unorm);
+			encoder.RegisterTexture(&texture, config.width, config.height,
+									TextureFormatToNvencFormat(texture.format), &fences[i]);
+		}
+		TimestampTracker tracker;
+		NullWriter writer;
+		encoder.AddOutput(TimestampTracker::OnFrame, &tracker);
+
+		CaptureClock capture{config.frame_rate_num, config.frame_rate_den};
+		CaptureClock display{(uint32_t)(display_rate * DISPLAY_RATE_DEN), DISPLAY_RATE_DEN};
+		EventHandle events[]{capture.GetEvent(), display.GetEvent()};
+		auto start		 = std::chrono::steady_clock::now();
+		auto end		 = start + std::chrono::duration<double>(seconds);
+		auto wake_total	 = std::chrono::nanoseconds::zero();
+		auto wake_max	 = std::chrono::nanoseconds::zero();
+		uint32_t frame	 = 0;
+		uint64_t encodes = 0;
+
+		auto capture_frame = [&] {
+			uint64_t timestamp = 0;
+			if (capture.OnTick(timestamp) == CaptureAction::None)
+				return;
+
+			auto wake = std::chrono::steady_clock::now() - capture.GetTickTime(timestamp);
+			wake_max  = std::max(wake_max, wake);
+			wake_total += wake;
+			encoder.ProcessCompletedFrames(writer);
+			encoder.EncodeFrame((frame - 1) % BUFFER_COUNT, frame, frame - 1, timestamp);
+			++encodes;
+		};
+		while (std::chrono::steady_clock::now() < end) {
+			auto index = WaitForAnyEvent(events, WAIT_TIMEOUT_MS);
+			if (index == CAPTURE_EVENT_INDEX)
+				capture_frame();
+			else if (index < std::size(events)) {
+				uint64_t display_tick = 0;
+				auto display_ticks	  = display.GetStats().ticks;
+				display.OnTick(display_tick);
+				if (display.GetStats().ticks == display_ticks)
+					continue;
+
+				fences[frame % BUFFER_COUNT].Complete(frame + 1);
+				++frame;
+				capture.OnFramePresented();
+				if (stall_each && frame % stall_each == 0)
+					std::this_thread::sleep_for(std::chrono::milliseconds(stall_ms));
+			}
+		}
+		capture_frame();
+		encoder.ProcessCompletedFrames(writer, true);
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		auto stats			= capture.GetStats();
+		auto expected_ticks = elapsed.count() * config.frame_rate_num / config.frame_rate_den;
+		auto wake_mean_us	= encodes ? wake_total.count() / 1000.0 / encodes : 0.0;
+		printf("capture %u/%u fps, display %.3f fps, %.2f s\n", config.frame_rate_num,
+			   config.frame_rate_den, display_rate, elapsed.count());
+		printf("ticks %llu (expected %.1f, %.3f fps), missed %llu, captured %llu, duplicated %llu, "
+			   "skipped %llu\n",
+			   (unsigned long long)stats.ticks, expected_ticks, stats.ticks / elapsed.count(),
+			   (unsigned long long)stats.missed_ticks, (unsigned long long)stats.captured_frames,
+			   (unsigned long long)stats.duplicated_frames,
+			   (unsigned long long)stats.skipped_frames);
+		printf("rendered %u, encoded %llu, timestamps out of order %llu, gaps %llu, last %llu, "
+			   "wake latency mean %.1f us, max %.1f us\n",
+			   frame, (unsigned long long)tracker.frames,
+			   (unsigned long long)tracker.out_of_order,
+			   (unsigned long long)tracker.timestamp_gaps,
+			   (unsigned long long)tracker.last_timestamp, wake_mean_us,
+			   wake_max.count() / 1000.0);
+
+		auto accounted = stats.captured_frames + stats.duplicated_frames;
+		auto passed	   = tracker.frames == encodes && accounted == encodes
+					  && !tracker.out_of_order && tracker.timestamp_gaps == stats.missed_ticks
+					  && stats.captured_frames + stats.skipped_frames <= frame
+					  && std::abs(stats.ticks - expected_ticks) <= 2.0;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "capture clock test failed\n");
+		return 1;
+	}
+}
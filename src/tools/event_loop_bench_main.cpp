@@ -0,0 +1,179 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "event_loop.h"
+#include "platform_event.h"
+
+#ifndef _WIN32
+#include <unistd.h>
+#endif
+
+constexpr uint32_t WAIT_TIMEOUT_MS = 1000;
+
+struct BenchResult {
+	double seconds;
+	uint64_t awaits;
+	EventLoopStats stats;
+};
+
+static double GetElapsedSeconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void AcquireEvent(EventHandle event) {
+	WaitForAnyEvent({&event, 1}, WAIT_TIMEOUT_MS);
+#ifndef _WIN32
+	uint64_t value = 0;
+	if (read(event, &value, sizeof(value)) != sizeof(value))
+		throw;
+#endif
+}
+
+static EventTask Ping(EventLoop& loop, EventHandle ping, EventHandle pong, uint32_t rounds) {
+	for (auto i = 0u; i < rounds; ++i) {
+		SignalAutoResetEvent(ping);
+		co_await loop.Wait(pong);
+	}
+}
+
+static EventTask Pong(EventLoop& loop, EventHandle ping, EventHandle pong, uint32_t rounds) {
+	for (auto i = 0u; i < rounds; ++i) {
+		co_await loop.Wait(ping);
+		SignalAutoResetEvent(pong);
+	}
+}
+
+static EventTask Await(EventLoop& loop, EventHandle event, uint32_t rounds, uint64_t& resumes) {
+	for (auto i = 0u; i < rounds; ++i) {
+		co_await loop.Wait(event);
+		++resumes;
+	}
+}
+
+static double RunRawPingPong(uint32_t rounds) {
+	auto ping  = CreateAutoResetEvent(false);
+	auto pong  = CreateAutoResetEvent(false);
+	auto start = std::chrono::steady_clock::now();
+	for (auto i = 0u; i < rounds; ++i) {
+		SignalAutoResetEvent(ping);
+		AcquireEvent(ping);
+		SignalAutoResetEvent(pong);
+		AcquireEvent(pong);
+	}
+	auto seconds = GetElapsedSeconds(start);
+	CloseEventHandle(ping);
+	CloseEventHandle(pong);
+	return seconds;
+}
+
+static BenchResult RunPingPong(uint32_t rounds) {
+	auto ping = CreateAutoResetEvent(false);
+	auto pong = CreateAutoResetEvent(false);
+	BenchResult result{};
+	{
+		EventLoop loop;
+		auto start = std::chrono::steady_clock::now();
+		loop.Spawn(Pong(loop, ping, pong, rounds));
+		loop.Spawn(Ping(loop, ping, pong, rounds));
+		while (loop.HasTasks())
+			if (!loop.RunOnce(WAIT_TIMEOUT_MS))
+				throw;
+		result.seconds = GetElapsedSeconds(start);
+		result.awaits  = 2ull * rounds;
+		result.stats   = loop.GetStats();
+	}
+	CloseEventHandle(ping);
+	CloseEventHandle(pong);
+	return result;
+}
+
+static BenchResult RunFanOut(uint32_t task_count, uint32_t rounds, bool shared) {
+	std::vector<EventHandle> events(shared ? 1 : task_count);
+	for (auto& event : events)
+		event = CreateAutoResetEvent(false);
+
+	BenchResult result{};
+	{
+		EventLoop loop;
+		uint64_t resumes = 0;
+		auto start		 = std::chrono::steady_clock::now();
+		for (auto i = 0u; i < task_count; ++i)
+			loop.Spawn(Await(loop, events[i % events.size()], rounds, resumes));
+		for (auto round = 0u; round < rounds; ++round) {
+			for (auto event : events)
+				SignalAutoResetEvent(event);
+			auto expected = (uint64_t)task_count * (round + 1);
+			while (resumes < expected)
+				if (!loop.RunOnce(WAIT_TIMEOUT_MS))
+					throw;
+		}
+		result.seconds = GetElapsedSeconds(start);
+		result.awaits  = resumes;
+		result.stats   = loop.GetStats();
+		if (loop.HasTasks())
+			throw;
+	}
+	for (auto event : events)
+		CloseEventHandle(event);
+	return result;
+}
+
+static void PrintResult(const char* name, const BenchResult& result) {
+	printf("%-16s %8llu awaits in %7.1f ms, %7.1f ns/await, %6.2f resumes/poll, "
+		   "%llu registrations\n",
+		   name, (unsigned long long)result.awaits, result.seconds * 1000.0,
+		   result.seconds * 1e9 / result.awaits,
+		   (double)result.stats.resumes / result.stats.polls,
+		   (unsigned long long)result.stats.registrations);
+}
+
+int main(int argc, char** argv) {
+	auto rounds		= 200000u;
+	auto task_count = 64u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--rounds") == 0 && has_value)
+			rounds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--tasks") == 0 && has_value)
+			task_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--rounds <n>] [--tasks <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!rounds || !task_count)
+		return 1;
+
+	try {
+		auto raw_seconds = RunRawPingPong(rounds);
+		auto ping_pong	 = RunPingPong(rounds);
+		auto fan_rounds	 = std::max(1u, rounds / task_count);
+		auto fan_out	 = RunFanOut(task_count, fan_rounds, false);
+		auto broadcast	 = RunFanOut(task_count, fan_rounds, true);
+
+		auto raw_ns		  = raw_seconds * 1e9 / (2.0 * rounds);
+		auto ping_pong_ns = ping_pong.seconds * 1e9 / ping_pong.awaits;
+		printf("raw wait/signal  %8u waits in %7.1f ms, %7.1f ns/wait\n", 2 * rounds,
+			   raw_seconds * 1000.0, raw_ns);
+		PrintResult("ping-pong", ping_pong);
+		PrintResult("fan-out", fan_out);
+		PrintResult("broadcast", broadcast);
+		printf("scheduler overhead %.1f ns/await over raw wait/signal\n", ping_pong_ns - raw_ns);
+
+		auto passed = ping_pong.stats.completed_tasks == 2
+				   && ping_pong.stats.resumes == ping_pong.awaits
+				   && fan_out.stats.completed_tasks == task_count
+				   && fan_out.awaits == (uint64_t)task_count * fan_rounds
+				   && broadcast.stats.completed_tasks == task_count
+				   && broadcast.stats.registrations == 1;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "event loop benchmark failed\n");
+		return 1;
+	}
+}
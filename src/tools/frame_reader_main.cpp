@@ -0,0 +1,150 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "encoder/shared_frame_ring.h"
+
+constexpr uint64_t PRODUCER_CAPACITY	= 16ull * 1024 * 1024;
+constexpr uint32_t PRODUCER_SLOT_COUNT	= 256;
+constexpr auto READER_IDLE_TIMEOUT		= std::chrono::seconds(1);
+constexpr auto READER_POLL_INTERVAL		= std::chrono::microseconds(100);
+constexpr auto PRODUCER_ATTACH_INTERVAL = std::chrono::seconds(1);
+
+static double GetElapsedSeconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static void RequestKeyframe(void* pending) {
+	*(bool*)pending = true;
+}
+
+static int Produce(const char* name, uint32_t frame_count, uint32_t frame_size,
+				   uint32_t gop_length) {
+	SharedFrameRing ring{name, EncoderConfig{.width = 0, .height = 0}, PRODUCER_CAPACITY,
+						 PRODUCER_SLOT_COUNT};
+	std::vector<uint8_t> access_unit(frame_size);
+	auto keyframe_pending = false;
+	ring.SetKeyframeRequestHandler(RequestKeyframe, &keyframe_pending);
+	std::this_thread::sleep_for(PRODUCER_ATTACH_INTERVAL);
+
+	auto start = std::chrono::steady_clock::now();
+	for (auto frame = 0u; frame < frame_count; ++frame) {
+		auto keyframe	 = keyframe_pending || frame % gop_length == 0;
+		keyframe_pending = false;
+		memset(access_unit.data(), (uint8_t)frame, access_unit.size());
+		ring.Publish(EncodedFrame{
+			.data		 = access_unit.data(),
+			.size		 = frame_size,
+			.frame_index = frame,
+			.timestamp	 = frame,
+			.keyframe	 = keyframe,
+		});
+	}
+	auto seconds = GetElapsedSeconds(start);
+	std::this_thread::sleep_for(PRODUCER_ATTACH_INTERVAL);
+
+	auto stats = ring.GetStats();
+	printf("produced %llu frames, %llu bytes in %.1f ms, %.0f frames/s, %.1f MB/s\n",
+		   (unsigned long long)stats.published_frames, (unsigned long long)stats.published_bytes,
+		   seconds * 1000.0, stats.published_frames / seconds,
+		   stats.published_bytes / seconds / 1e6);
+	printf("keyframe requests %llu\n", (unsigned long long)stats.keyframe_requests);
+	return 0;
+}
+
+static int Consume(const char* name, double duration, const char* output_path, bool verify) {
+	SharedFrameRingReader reader{name};
+	auto file = output_path ? fopen(output_path, "wb") : nullptr;
+	if (output_path && !file)
+		throw;
+
+	std::vector<uint8_t> buffer;
+	SharedFrameInfo info{};
+	uint64_t corrupt_frames = 0;
+	auto start				= std::chrono::steady_clock::now();
+	auto first_frame		= start;
+	auto last_frame			= start;
+	while (GetElapsedSeconds(start) < duration) {
+		auto result = reader.Read(buffer, info);
+		if (result == SharedFrameReadResult::Empty) {
+			if (reader.GetStats().read_frames
+				&& std::chrono::steady_clock::now() - last_frame > READER_IDLE_TIMEOUT)
+				break;
+			std::this_thread::sleep_for(READER_POLL_INTERVAL);
+			continue;
+		}
+		if (result == SharedFrameReadResult::Overrun)
+			continue;
+
+		last_frame = std::chrono::steady_clock::now();
+		if (reader.GetStats().read_frames == 1)
+			first_frame = last_frame;
+		if (verify)
+			for (auto byte : buffer)
+				if (byte != (uint8_t)info.frame_index) {
+					++corrupt_frames;
+					break;
+				}
+		if (file)
+			fwrite(buffer.data(), 1, buffer.size(), file);
+	}
+	if (file)
+		fclose(file);
+
+	auto stats	 = reader.GetStats();
+	auto seconds = std::chrono::duration<double>(last_frame - first_frame).count();
+	printf("%ux%u %u/%u, %u slots, %llu KB ring\n", reader.header->width, reader.header->height,
+		   reader.header->frame_rate_num, reader.header->frame_rate_den, reader.header->slot_count,
+		   (unsigned long long)reader.header->data_capacity / 1024);
+	printf("read %llu frames, %llu bytes in %.1f ms, %.0f frames/s, %.1f MB/s\n",
+		   (unsigned long long)stats.read_frames, (unsigned long long)stats.read_bytes,
+		   seconds * 1000.0, seconds > 0.0 ? stats.read_frames / seconds : 0.0,
+		   seconds > 0.0 ? stats.read_bytes / seconds / 1e6 : 0.0);
+	printf("overruns %llu, skipped %llu, keyframe requests %llu, corrupt %llu\n",
+		   (unsigned long long)stats.overruns, (unsigned long long)stats.skipped_frames,
+		   (unsigned long long)stats.keyframe_requests, (unsigned long long)corrupt_frames);
+	return corrupt_frames ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr,
+				"usage: %s <ring-name> [--seconds <n>] [--output <file.h264>] [--verify]\n"
+				"       %s <ring-name> --produce <frame-count> <frame-bytes> [--gop <n>]\n",
+				argv[0], argv[0]);
+		return 1;
+	}
+
+	auto duration			= 10.0;
+	auto verify				= false;
+	const char* output_path = nullptr;
+	uint32_t frame_count	= 0;
+	uint32_t frame_size		= 0;
+	uint32_t gop_length		= 120;
+	for (auto i = 2; i < argc; ++i) {
+		if (strcmp(argv[i], "--seconds") == 0 && i + 1 < argc)
+			duration = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output_path = argv[++i];
+		else if (strcmp(argv[i], "--verify") == 0)
+			verify = true;
+		else if (strcmp(argv[i], "--produce") == 0 && i + 2 < argc) {
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			frame_size	= (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--gop") == 0 && i + 1 < argc)
+			gop_length = (uint32_t)strtoul(argv[++i], nullptr, 10);
+	}
+
+	try {
+		if (frame_count)
+			return Produce(argv[1], frame_count, frame_size, gop_length ? gop_length : 1);
+		return Consume(argv[1], duration, output_path, verify);
+	} catch (...) {
+		fprintf(stderr, "failed to open frame ring %s\n", argv[1]);
+		return 1;
+	}
+}
@@ -0,0 +1,276 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <random>
+#include <vector>
+
+#include "graphics/tlsf_allocator.h"
+
+constexpr uint64_t HEAP_BLOCK_SIZE	   = 64ull << 20;
+constexpr uint64_t COMMITTED_ALIGNMENT = 64ull << 10;
+constexpr uint32_t ALLOCATE_PERCENT	   = 55;
+constexpr uint32_t MAX_ALIGNMENT_LOG2  = 23;
+
+constexpr uint64_t PLACEMENT_ALIGNMENTS[]{4ull << 10, 64ull << 10, 4ull << 20};
+
+struct Workload {
+	const char* name;
+	uint64_t min_size;
+	uint64_t max_size;
+	uint32_t alignment_class_count;
+	uint32_t live_allocations;
+};
+
+constexpr Workload WORKLOADS[]{
+	{"buffers", 256, 64ull << 10, 1, 4096},
+	{"textures", 64ull << 10, 16ull << 20, 2, 128},
+	{"mixed", 256, 16ull << 20, 3, 512},
+};
+
+struct ShadowHeap {
+	std::map<uint64_t, uint64_t> ranges;
+	uint64_t used_bytes = 0;
+
+	bool Insert(uint64_t offset, uint64_t size) {
+		auto next = ranges.lower_bound(offset);
+		if (next != ranges.end() && next->first < offset + size)
+			return false;
+		if (next != ranges.begin() && std::prev(next)->first + std::prev(next)->second > offset)
+			return false;
+		ranges[offset] = size;
+		used_bytes += size;
+		return true;
+	}
+
+	void Erase(uint64_t offset) {
+		used_bytes -= ranges[offset];
+		ranges.erase(offset);
+	}
+};
+
+struct ChurnResult {
+	double ns_per_operation;
+	uint64_t committed_bytes;
+	HeapPoolStats stats;
+	bool consistent;
+};
+
+static uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+	return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static uint64_t GetRandomSize(std::mt19937_64& random, uint64_t min_size, uint64_t max_size) {
+	return min_size + random() % (max_size - min_size + 1);
+}
+
+static bool FuzzTlsf(std::mt19937_64& random, uint32_t rounds, uint32_t operations) {
+	for (auto round = 0u; round < rounds; ++round) {
+		TlsfAllocator allocator{(1 + random() % 64) << 20};
+		std::vector<TlsfAllocation> live;
+		ShadowHeap shadow;
+		for (auto operation = 0u; operation < operations; ++operation) {
+			if (live.empty() || random() % 100 < ALLOCATE_PERCENT) {
+				auto size = random() % 4 ? GetRandomSize(random, 1, 64ull << 10)
+										 : GetRandomSize(random, 1, 4ull << 20);
+				auto alignment	= (uint64_t)1 << (random() % MAX_ALIGNMENT_LOG2);
+				auto allocation = allocator.Allocate(size, alignment);
+				if (allocation.node == TLSF_INVALID_NODE)
+					continue;
+				if (allocation.offset % std::max(alignment, TLSF_GRANULARITY)
+					|| allocation.size < size
+					|| allocation.offset + allocation.size > allocator.capacity
+					|| !shadow.Insert(allocation.offset, allocation.size)) {
+					printf("tlsf round %u operation %u: bad range %llu+%llu\n", round, operation,
+						   (unsigned long long)allocation.offset,
+						   (unsigned long long)allocation.size);
+					return false;
+				}
+				live.push_back(allocation);
+			}
+			else {
+				auto index = random() % live.size();
+				allocator.Free(live[index]);
+				shadow.Erase(live[index].offset);
+				live[index] = live.back();
+				live.pop_back();
+			}
+
+			auto stats = allocator.GetStats();
+			if (stats.used_bytes != shadow.used_bytes || stats.allocation_count != live.size()) {
+				printf("tlsf round %u operation %u: stats mismatch\n", round, operation);
+				return false;
+			}
+		}
+
+		for (auto& allocation : live)
+			allocator.Free(allocation);
+		auto stats = allocator.GetStats();
+		if (stats.used_bytes || stats.free_range_count != 1
+			|| stats.largest_free_range != allocator.capacity) {
+			printf("tlsf round %u: %u free ranges left after freeing everything\n", round,
+				   stats.free_range_count);
+			return false;
+		}
+	}
+	return true;
+}
+
+static bool FuzzHeapPool(std::mt19937_64& random, uint32_t rounds, uint32_t operations) {
+	for (auto round = 0u; round < rounds; ++round) {
+		HeapPool pool{HEAP_BLOCK_SIZE};
+		std::vector<HeapPoolAllocation> live;
+		std::vector<ShadowHeap> shadows;
+		uint64_t used_bytes = 0;
+		uint64_t peak_bytes = 0;
+		for (auto operation = 0u; operation < operations; ++operation) {
+			if (live.empty() || random() % 100 < ALLOCATE_PERCENT) {
+				auto size = random() % 64 ? GetRandomSize(random, 1, 16ull << 20)
+										  : GetRandomSize(random, 1, 2 * HEAP_BLOCK_SIZE);
+				auto alignment	= PLACEMENT_ALIGNMENTS[random() % std::size(PLACEMENT_ALIGNMENTS)];
+				auto allocation = pool.Allocate(size, alignment);
+				shadows.resize(pool.blocks.size());
+				auto& range = allocation.range;
+				if (allocation.block >= pool.blocks.size() || range.offset % alignment
+					|| range.size < size
+					|| range.offset + range.size > pool.blocks[allocation.block].capacity
+					|| !shadows[allocation.block].Insert(range.offset, range.size)) {
+					printf("pool round %u operation %u: bad range %u:%llu+%llu\n", round, operation,
+						   allocation.block, (unsigned long long)range.offset,
+						   (unsigned long long)range.size);
+					return false;
+				}
+				used_bytes += range.size;
+				peak_bytes = std::max(peak_bytes, used_bytes);
+				live.push_back(allocation);
+			}
+			else {
+				auto index = random() % live.size();
+				pool.Free(live[index]);
+				shadows[live[index].block].Erase(live[index].range.offset);
+				used_bytes -= live[index].range.size;
+				live[index] = live.back();
+				live.pop_back();
+			}
+
+			auto stats = pool.GetStats();
+			if (stats.used_bytes != used_bytes || stats.peak_used_bytes != peak_bytes
+				|| stats.allocation_count != live.size()
+				|| stats.block_count != pool.blocks.size()) {
+				printf("pool round %u operation %u: stats mismatch\n", round, operation);
+				return false;
+			}
+		}
+
+		for (auto& allocation : live)
+			pool.Free(allocation);
+		auto stats = pool.GetStats();
+		if (stats.used_bytes || stats.empty_block_count != stats.block_count
+			|| stats.free_range_count != stats.block_count) {
+			printf("pool round %u: %u of %u blocks empty after freeing everything\n", round,
+				   stats.empty_block_count, stats.block_count);
+			return false;
+		}
+	}
+	return true;
+}
+
+static ChurnResult RunChurn(std::mt19937_64& random, const Workload& workload,
+							uint32_t operations) {
+	std::vector<uint64_t> sizes(operations);
+	std::vector<uint64_t> alignments(operations);
+	std::vector<uint32_t> choices(operations);
+	for (auto i = 0u; i < operations; ++i) {
+		sizes[i]	  = GetRandomSize(random, workload.min_size, workload.max_size);
+		alignments[i] = PLACEMENT_ALIGNMENTS[random() % workload.alignment_class_count];
+		choices[i]	  = (uint32_t)random();
+	}
+
+	HeapPool pool{HEAP_BLOCK_SIZE};
+	std::vector<HeapPoolAllocation> live;
+	live.reserve(workload.live_allocations);
+	auto start = std::chrono::steady_clock::now();
+	for (auto i = 0u; i < operations; ++i) {
+		if (live.size() < workload.live_allocations
+			&& (live.size() < workload.live_allocations / 2 || choices[i] % 100 < ALLOCATE_PERCENT))
+			live.push_back(pool.Allocate(sizes[i], alignments[i]));
+		else {
+			auto index = choices[i] % live.size();
+			pool.Free(live[index]);
+			live[index] = live.back();
+			live.pop_back();
+		}
+	}
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	ChurnResult result{
+		.ns_per_operation = std::chrono::duration<double, std::nano>(elapsed).count() / operations,
+		.stats			  = pool.GetStats(),
+	};
+	uint64_t used_bytes = 0;
+	for (auto& allocation : live) {
+		result.committed_bytes += AlignUp(allocation.range.size, COMMITTED_ALIGNMENT);
+		used_bytes += allocation.range.size;
+	}
+	result.consistent = result.stats.used_bytes == used_bytes
+					 && result.stats.allocation_count == live.size()
+					 && result.stats.reserved_bytes >= result.stats.used_bytes;
+	return result;
+}
+
+int main(int argc, char** argv) {
+	uint64_t seed		  = 1;
+	auto rounds			  = 20u;
+	auto operations		  = 20000u;
+	auto bench_operations = 1000000u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--seed") == 0 && has_value)
+			seed = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--rounds") == 0 && has_value)
+			rounds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--operations") == 0 && has_value)
+			operations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--bench-operations") == 0 && has_value)
+			bench_operations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr,
+					"usage: %s [--seed <n>] [--rounds <n>] [--operations <n>] "
+					"[--bench-operations <n>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!bench_operations)
+		return 1;
+
+	try {
+		std::mt19937_64 random{seed};
+		auto tlsf_passed = FuzzTlsf(random, rounds, operations);
+		printf("tlsf fuzz: %u rounds x %u operations %s\n", rounds, operations,
+			   tlsf_passed ? "ok" : "FAILED");
+		auto pool_passed = FuzzHeapPool(random, rounds, operations);
+		printf("heap pool fuzz: %u rounds x %u operations %s\n", rounds, operations,
+			   pool_passed ? "ok" : "FAILED");
+
+		auto passed = tlsf_passed && pool_passed;
+		for (auto& workload : WORKLOADS) {
+			auto result = RunChurn(random, workload, bench_operations);
+			auto& stats = result.stats;
+			printf("%-8s %6.1f ns/op, %3u blocks, reserved %7.1f MB, used %7.1f MB, "
+				   "committed %7.1f MB, peak %7.1f MB, %5u free ranges, fragmentation %.3f%s\n",
+				   workload.name, result.ns_per_operation, stats.block_count,
+				   stats.reserved_bytes / 1e6, stats.used_bytes / 1e6, result.committed_bytes / 1e6,
+				   stats.peak_used_bytes / 1e6, stats.free_range_count, stats.fragmentation,
+				   result.consistent ? "" : " stats mismatch");
+			passed = passed && result.consistent;
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "heap allocator benchmark failed\n");
+		return 1;
+	}
+}
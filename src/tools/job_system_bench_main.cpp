@@ -0,0 +1,153 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+
+#include "job_system.h"
+
+constexpr uint32_t NESTED_PARENTS		= 64;
+constexpr uint32_t NESTED_CHILDREN		= 8;
+constexpr uint32_t EXTERNAL_SUBMISSIONS = 500;
+
+struct JobGrain {
+	const char* name;
+	uint32_t job_nanoseconds;
+	uint32_t job_count;
+};
+
+constexpr JobGrain GRAINS[]{
+	{"fine", 1000, 100000},
+	{"coarse", 100000, 2000},
+};
+
+struct BenchContext {
+	JobSystem* job_system;
+	JobCounter* children;
+	uint32_t job_nanoseconds;
+	std::atomic<uint64_t> sum				  = 0;
+	std::atomic<uint32_t> early_continuations = 0;
+};
+
+struct GrainResult {
+	double milliseconds;
+	bool consistent;
+};
+
+static void SpendJobTime(uint32_t nanoseconds) {
+	auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(nanoseconds);
+	while (std::chrono::steady_clock::now() < end)
+		;
+}
+
+static void RunWork(void* data, uint32_t index) {
+	auto context = (BenchContext*)data;
+	SpendJobTime(context->job_nanoseconds);
+	context->sum.fetch_add(index, std::memory_order_relaxed);
+}
+
+static void RunParent(void* data, uint32_t) {
+	auto context = (BenchContext*)data;
+	for (auto i = 0u; i < NESTED_CHILDREN; ++i)
+		context->job_system->Submit(RunWork, data, 1, context->children);
+}
+
+static void RunContinuation(void* data, uint32_t) {
+	auto context = (BenchContext*)data;
+	if (!context->children->IsDone())
+		context->early_continuations.fetch_add(1, std::memory_order_relaxed);
+}
+
+static GrainResult RunGrain(JobSystem& job_system, const JobGrain& grain) {
+	BenchContext context{.job_system = &job_system, .job_nanoseconds = grain.job_nanoseconds};
+	JobCounter counter;
+	auto start = std::chrono::steady_clock::now();
+	job_system.SubmitBatch(RunWork, &context, grain.job_count, &counter);
+	job_system.Wait(counter);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+	return GrainResult{
+		.milliseconds = std::chrono::duration<double, std::milli>(elapsed).count(),
+		.consistent	  = context.sum == (uint64_t)grain.job_count * (grain.job_count - 1) / 2,
+	};
+}
+
+static bool RunDependencies(JobSystem& job_system) {
+	JobCounter children;
+	JobCounter parents;
+	JobCounter continuation;
+	BenchContext context{.job_system = &job_system, .children = &children, .job_nanoseconds = 100};
+	job_system.SubmitBatch(RunParent, &context, NESTED_PARENTS, &parents);
+	job_system.Wait(parents);
+	job_system.SubmitAfter(children, RunContinuation, &context, 0, &continuation);
+	job_system.Wait(children);
+	job_system.Wait(continuation);
+	return context.sum == NESTED_PARENTS * NESTED_CHILDREN && !context.early_continuations;
+}
+
+static bool RunExternalSubmission(JobSystem& job_system) {
+	JobCounter counter;
+	BenchContext context{.job_system = &job_system, .job_nanoseconds = 500};
+	std::thread external{[&] {
+		for (auto i = 0u; i < EXTERNAL_SUBMISSIONS; ++i)
+			job_system.Submit(RunWork, &context, 2, &counter);
+		job_system.Wait(counter);
+	}};
+	external.join();
+	return context.sum == 2 * EXTERNAL_SUBMISSIONS;
+}
+
+int main(int argc, char** argv) {
+	auto max_threads = std::max(std::thread::hardware_concurrency(), 2u);
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--threads") == 0 && has_value)
+			max_threads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--threads <max>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!max_threads)
+		return 1;
+
+	try {
+		auto passed = true;
+		double single_thread_ms[std::size(GRAINS)]{};
+		printf("%u hardware threads\n", std::thread::hardware_concurrency());
+		for (auto thread_count = 1u; thread_count <= max_threads; thread_count *= 2) {
+			JobSystem job_system{
+				JobSystemConfig{.thread_count = thread_count, .pin_threads = false}};
+			for (auto g = 0u; g < std::size(GRAINS); ++g) {
+				auto& grain	= GRAINS[g];
+				auto result = RunGrain(job_system, grain);
+				if (thread_count == 1)
+					single_thread_ms[g] = result.milliseconds;
+				auto ideal_ms = grain.job_count * (grain.job_nanoseconds / 1e6) / thread_count;
+				printf("%2u threads %-6s %6u x %6.1f us: %9.2f ms, ideal %9.2f ms, speedup %5.2fx"
+					   "%s\n",
+					   thread_count, grain.name, grain.job_count, grain.job_nanoseconds / 1e3,
+					   result.milliseconds, ideal_ms, single_thread_ms[g] / result.milliseconds,
+					   result.consistent ? "" : " sum mismatch");
+				passed = passed && result.consistent;
+			}
+
+			auto dependencies_passed = RunDependencies(job_system);
+			auto external_passed	 = thread_count == 1 || RunExternalSubmission(job_system);
+			auto stats				 = job_system.GetStats();
+			printf("   dependencies %s, external submission %s, %llu jobs, %llu inline, "
+				   "%llu steals, %llu sleeps, %llu blocked waits\n",
+				   dependencies_passed ? "ok" : "FAILED", external_passed ? "ok" : "FAILED",
+				   (unsigned long long)stats.submitted_jobs, (unsigned long long)stats.inline_jobs,
+				   (unsigned long long)stats.steals, (unsigned long long)stats.sleeps,
+				   (unsigned long long)stats.blocked_waits);
+			passed = passed && dependencies_passed && external_passed;
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "job system benchmark failed\n");
+		return 1;
+	}
+}
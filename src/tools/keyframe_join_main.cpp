@@ -0,0 +1,253 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "encoder/keyframe_cache.h"
+#include "encoder/mock_frame_encoder.h"
+#include "encoder/nal_parser.h"
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+
+constexpr uint32_t BUFFER_COUNT	= 3;
+constexpr uint32_t JOIN_SEED	= 0x4B455946;
+constexpr uint32_t H264_NAL_SPS	= 7;
+constexpr uint32_t H264_NAL_PPS	= 8;
+constexpr uint32_t H264_NAL_IDR	= 5;
+constexpr uint32_t H264_NAL_SEI	= 6;
+constexpr uint32_t HEVC_NAL_IDR	= 19;
+constexpr uint32_t HEVC_NAL_VPS	= 32;
+constexpr uint32_t HEVC_NAL_SPS	= 33;
+constexpr uint32_t HEVC_NAL_PPS	= 34;
+constexpr uint32_t HEVC_NAL_SEI	= 39;
+
+struct NullWriter {
+	void WriteFrame(const void*, uint32_t) {}
+};
+
+struct JoinTracker {
+	std::vector<uint32_t> waiting;
+	std::vector<uint32_t> latencies;
+	uint64_t keyframes = 0;
+
+	static void OnFrame(void* context, const EncodedFrame& frame) {
+		auto tracker = (JoinTracker*)context;
+		if (!frame.keyframe)
+			return;
+		++tracker->keyframes;
+		for (auto join_frame : tracker->waiting)
+			tracker->latencies.push_back(frame.frame_index - join_frame);
+		tracker->waiting.clear();
+	}
+};
+
+struct JoinResult {
+	JoinTracker tracker;
+	KeyframeRequestStats request_stats;
+	KeyframeCacheStats cache_stats;
+	uint64_t cache_joins;
+	uint64_t cache_failures;
+	uint64_t max_cache_age;
+};
+
+static bool IsDecodable(EncoderCodec codec, std::span<const uint8_t> access_unit) {
+	auto is_hevc = codec == EncoderCodec::HEVC;
+	auto has_vps = !is_hevc;
+	auto has_sps = false;
+	auto has_idr = false;
+	std::span<const uint8_t> nal_unit;
+	while (NextNalUnit(access_unit, nal_unit)) {
+		auto type = GetNalUnitType(codec, nal_unit);
+		has_vps	  = has_vps || type == HEVC_NAL_VPS;
+		has_sps	  = has_sps || type == (is_hevc ? HEVC_NAL_SPS : H264_NAL_SPS);
+		has_idr	  = has_idr || type == (is_hevc ? HEVC_NAL_IDR : H264_NAL_IDR);
+	}
+	return has_vps && has_sps && has_idr;
+}
+
+static void AppendNalUnit(EncoderCodec codec, std::vector<uint8_t>& access_unit, uint32_t type,
+						  uint8_t payload) {
+	access_unit.insert(access_unit.end(), {0, 0, 0, 1});
+	if (codec == EncoderCodec::HEVC)
+		access_unit.insert(access_unit.end(), {(uint8_t)(type << 1), 1});
+	else
+		access_unit.push_back((uint8_t)(0x60 | type));
+	access_unit.insert(access_unit.end(), {payload, 0x80});
+}
+
+static bool CheckSeiKeyframes(EncoderCodec codec) {
+	auto is_hevc  = codec == EncoderCodec::HEVC;
+	auto aud_type = is_hevc ? HEVC_NAL_ACCESS_UNIT_DELIMITER : H264_NAL_ACCESS_UNIT_DELIMITER;
+	auto sei_type = is_hevc ? HEVC_NAL_SEI : H264_NAL_SEI;
+	auto idr_type = is_hevc ? HEVC_NAL_IDR : H264_NAL_IDR;
+
+	std::vector<uint8_t> keyframe;
+	AppendNalUnit(codec, keyframe, aud_type, 0x10);
+	AppendNalUnit(codec, keyframe, sei_type, 0x05);
+	if (is_hevc)
+		AppendNalUnit(codec, keyframe, HEVC_NAL_VPS, 0x21);
+	AppendNalUnit(codec, keyframe, is_hevc ? HEVC_NAL_SPS : H264_NAL_SPS, 0x22);
+	AppendNalUnit(codec, keyframe, is_hevc ? HEVC_NAL_PPS : H264_NAL_PPS, 0x23);
+	AppendNalUnit(codec, keyframe, sei_type, 0x06);
+	AppendNalUnit(codec, keyframe, idr_type, 0x30);
+
+	std::vector<uint8_t> bare_keyframe;
+	AppendNalUnit(codec, bare_keyframe, sei_type, 0x05);
+	AppendNalUnit(codec, bare_keyframe, idr_type, 0x31);
+
+	KeyframeCache cache{codec};
+	cache.Update(EncodedFrame{.data = keyframe.data(), .size = (uint32_t)keyframe.size(),
+							  .keyframe = true});
+	std::vector<uint8_t> copy;
+	EncodedFrame copy_info{};
+	auto cached_as_is = cache.CopyKeyframe(copy, copy_info) && copy == keyframe;
+
+	cache.Update(EncodedFrame{.data = bare_keyframe.data(), .size = (uint32_t)bare_keyframe.size(),
+							  .keyframe = true});
+	auto prefixed = cache.CopyKeyframe(copy, copy_info) && IsDecodable(codec, copy)
+				 && copy.size() > bare_keyframe.size();
+
+	auto passed = cached_as_is && prefixed
+			   && cache.GetStats().parameter_set_updates == (is_hevc ? 3u : 2u);
+	printf("sei-led keyframes: parameter sets %s, bare keyframe %s\n",
+		   cached_as_is ? "cached" : "MISSED", prefixed ? "prefixed" : "NOT PREFIXED");
+	return passed;
+}
+
+static JoinResult RunJoins(const EncoderConfig& config, uint32_t frame_count,
+						   const std::vector<uint32_t>& join_frames, bool request_keyframes) {
+	std::vector<CpuTexture> textures;
+	std::vector<CpuFence> fences(BUFFER_COUNT);
+	textures.reserve(BUFFER_COUNT);
+	MockFrameEncoder encoder{config, BUFFER_COUNT};
+	for (auto i = 0u; i < BUFFER_COUNT; ++i) {
+		auto& texture = textures.emplace_back(config.width, config.height,
+											  TextureFormat::B8G8R8A8Unorm);
+		encoder.RegisterTexture(&texture, config.width, config.height,
+								TextureFormatToNvencFormat(texture.format), &fences[i]);
+	}
+
+	JoinResult result{};
+	KeyframeCache cache{config.codec};
+	encoder.AddOutput(KeyframeCache::UpdateFrame, &cache);
+	encoder.AddOutput(JoinTracker::OnFrame, &result.tracker);
+
+	NullWriter writer;
+	std::vector<uint8_t> keyframe;
+	EncodedFrame keyframe_info{};
+	auto next_join = join_frames.begin();
+	for (auto frame = 0u; frame < frame_count; ++frame) {
+		encoder.ProcessCompletedFrames(writer);
+		for (; next_join != join_frames.end() && *next_join == frame; ++next_join) {
+			result.tracker.waiting.push_back(frame);
+			if (request_keyframes)
+				encoder.RequestKeyframe();
+			if (!cache.CopyKeyframe(keyframe, keyframe_info)) {
+				++result.cache_failures;
+				continue;
+			}
+			++result.cache_joins;
+			result.max_cache_age
+				= std::max(result.max_cache_age, (uint64_t)(frame - keyframe_info.frame_index));
+			if (!IsDecodable(config.codec, keyframe))
+				++result.cache_failures;
+		}
+
+		auto slot = frame % BUFFER_COUNT;
+		fences[slot].Complete(frame + 1);
+		encoder.EncodeFrame(slot, frame + 1, frame, frame);
+	}
+	encoder.ProcessCompletedFrames(writer, true);
+
+	result.request_stats = encoder.GetKeyframeRequestStats();
+	result.cache_stats	 = cache.GetStats();
+	return result;
+}
+
+static void PrintLatency(const char* mode, const JoinResult& result, const EncoderConfig& config) {
+	auto& latencies = result.tracker.latencies;
+	uint64_t total	= 0;
+	for (auto latency : latencies)
+		total += latency;
+	auto mean	  = latencies.empty() ? 0.0 : (double)total / latencies.size();
+	auto max	  = latencies.empty() ? 0u : *std::ranges::max_element(latencies);
+	auto frame_ms = 1000.0 * config.frame_rate_den / config.frame_rate_num;
+	printf("%-8s joins %zu, latency mean %.1f frames (%.1f ms), max %u frames (%.1f ms), "
+		   "%llu keyframes\n",
+		   mode, latencies.size(), mean, mean * frame_ms, max, max * frame_ms,
+		   (unsigned long long)result.tracker.keyframes);
+}
+
+int main(int argc, char** argv) {
+	EncoderConfig config{.codec = EncoderCodec::H264, .width = 64, .height = 64};
+	auto frame_count  = 3600u;
+	auto joiner_count = 64u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--hevc") == 0)
+			config.codec = EncoderCodec::HEVC;
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value)
+			config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--gop") == 0 && has_value)
+			config.gop_length = std::max(1u, (uint32_t)strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--min-interval") == 0 && has_value)
+			config.min_idr_interval = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--joiners") == 0 && has_value)
+			joiner_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr,
+					"usage: %s [--hevc] [--frames <n>] [--fps <n>] [--gop <n>] "
+					"[--min-interval <n>] [--joiners <n>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (frame_count <= config.gop_length || !config.frame_rate_num)
+		return 1;
+
+	std::mt19937 random{JOIN_SEED};
+	std::uniform_int_distribution<uint32_t> distribution{1, frame_count - config.gop_length};
+	std::vector<uint32_t> join_frames(joiner_count);
+	for (auto& join_frame : join_frames)
+		join_frame = distribution(random);
+	std::sort(join_frames.begin(), join_frames.end());
+
+	try {
+		auto waiting   = RunJoins(config, frame_count, join_frames, false);
+		auto requested = RunJoins(config, frame_count, join_frames, true);
+
+		printf("%s, %u frames at %u/%u fps, gop %u, min idr interval %u, %u joiners\n",
+			   config.codec == EncoderCodec::HEVC ? "hevc" : "h264", frame_count,
+			   config.frame_rate_num, config.frame_rate_den, config.gop_length,
+			   config.min_idr_interval, joiner_count);
+		PrintLatency("wait", waiting, config);
+		PrintLatency("request", requested, config);
+		printf("%-8s joins %llu, latency 0 frames, oldest cached keyframe %llu frames, "
+			   "%llu failed, %llu parameter set updates\n",
+			   "cache", (unsigned long long)waiting.cache_joins,
+			   (unsigned long long)waiting.max_cache_age,
+			   (unsigned long long)waiting.cache_failures,
+			   (unsigned long long)waiting.cache_stats.parameter_set_updates);
+		printf("requests %llu, forced %llu, coalesced %llu\n",
+			   (unsigned long long)requested.request_stats.requests,
+			   (unsigned long long)requested.request_stats.forced_keyframes,
+			   (unsigned long long)requested.request_stats.coalesced_requests);
+
+		auto& latencies	 = requested.tracker.latencies;
+		auto max_request = latencies.empty() ? 0u : *std::ranges::max_element(latencies);
+		auto passed		 = !waiting.cache_failures && waiting.cache_joins == joiner_count
+						   && max_request <= config.min_idr_interval;
+		passed			 = CheckSeiKeyframes(config.codec) && passed;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "keyframe join test failed\n");
+		return 1;
+	}
+}
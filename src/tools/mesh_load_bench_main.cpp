@@ -0,0 +1,186 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#include "graphics/mesh_file.h"
+
+constexpr float GRID_EXTENT = 0.9f;
+
+struct LoadResult {
+	double cold_mb_per_sec;
+	double warm_mb_per_sec;
+	uint64_t payload_size;
+	bool consistent;
+};
+
+static MeshSourceData BuildGrid(uint32_t grid) {
+	MeshSourceData mesh;
+	mesh.vertices.reserve((size_t)(grid + 1) * (grid + 1));
+	for (auto row = 0u; row <= grid; ++row) {
+		for (auto column = 0u; column <= grid; ++column) {
+			auto u = (float)column / grid;
+			auto v = (float)row / grid;
+			mesh.vertices.push_back(MeshSourceVertex{
+				.position = {(u * 2.0f - 1.0f) * GRID_EXTENT, (v * 2.0f - 1.0f) * GRID_EXTENT,
+							 0.0f},
+				.normal	  = {0.0f, 0.0f, -1.0f},
+				.color	  = {u, v, 1.0f - u},
+				.texcoord = {u, 1.0f - v},
+			});
+		}
+	}
+
+	mesh.indices.reserve((size_t)grid * grid * 6);
+	for (auto row = 0u; row < grid; ++row) {
+		for (auto column = 0u; column < grid; ++column) {
+			auto bottom_left  = row * (grid + 1) + column;
+			auto bottom_right = bottom_left + 1;
+			auto top_left	  = bottom_left + grid + 1;
+			auto top_right	  = top_left + 1;
+			mesh.indices.insert(mesh.indices.end(), {top_left, top_right, bottom_right});
+			mesh.indices.insert(mesh.indices.end(), {top_left, bottom_right, bottom_left});
+		}
+	}
+	return mesh;
+}
+
+static bool EvictFromPageCache(const char* path) {
+#ifdef _WIN32
+	(void)path;
+	return false;
+#else
+	auto descriptor = open(path, O_RDONLY | O_CLOEXEC);
+	if (descriptor < 0)
+		return false;
+	auto evicted = fdatasync(descriptor) == 0
+				&& posix_fadvise(descriptor, 0, 0, POSIX_FADV_DONTNEED) == 0;
+	close(descriptor);
+	return evicted;
+#endif
+}
+
+static uint64_t LoadMesh(const char* path, std::vector<uint8_t>& upload, uint64_t& file_size) {
+	MeshFile mesh_file{path};
+	auto payload = mesh_file.GetPayload();
+	upload.resize(payload.size());
+	memcpy(upload.data(), payload.data(), payload.size());
+	file_size = mesh_file.file.size;
+
+	uint64_t checksum = mesh_file.header.vertex_count;
+	for (size_t offset = 0; offset < upload.size(); offset += sizeof(uint64_t)) {
+		uint64_t value = 0;
+		memcpy(&value, upload.data() + offset, std::min(sizeof(value), upload.size() - offset));
+		checksum = checksum * 31 + value;
+	}
+	return checksum;
+}
+
+static double MeasureLoad(const char* path, bool cold, uint32_t runs, uint64_t& checksum,
+						  bool& consistent) {
+	std::vector<uint8_t> upload;
+	uint64_t file_size = 0;
+	double seconds	   = 0.0;
+	for (auto run = 0u; run < runs; ++run) {
+		if (cold && !EvictFromPageCache(path))
+			return 0.0;
+		auto start	= std::chrono::steady_clock::now();
+		auto loaded = LoadMesh(path, upload, file_size);
+		seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (checksum && loaded != checksum)
+			consistent = false;
+		checksum = loaded;
+	}
+	return (double)file_size * runs / seconds / 1e6;
+}
+
+static float GetMaxPositionError(const char* path, const MeshSourceData& source) {
+	auto loaded = ReadMeshSourceData(MeshFile{path});
+	if (loaded.vertices.size() != source.vertices.size())
+		return INFINITY;
+
+	auto error = 0.0f;
+	for (size_t i = 0; i < source.vertices.size(); ++i)
+		for (auto axis = 0; axis < 3; ++axis)
+			error = std::max(error, std::abs(loaded.vertices[i].position[axis]
+											 - source.vertices[i].position[axis]));
+	return error;
+}
+
+static LoadResult RunFile(const char* path, uint32_t runs) {
+	LoadResult result{.consistent = true};
+	uint64_t checksum	   = 0;
+	result.cold_mb_per_sec = MeasureLoad(path, true, runs, checksum, result.consistent);
+	result.warm_mb_per_sec = MeasureLoad(path, false, runs, checksum, result.consistent);
+	result.payload_size	   = MeshFile{path}.GetPayload().size();
+	return result;
+}
+
+static void PrintResult(const char* name, const LoadResult& result, float position_error) {
+	char cold[32] = "n/a";
+	if (result.cold_mb_per_sec > 0.0)
+		snprintf(cold, sizeof(cold), "%.1f", result.cold_mb_per_sec);
+	printf("%-9s payload %8.2f MB, cold %9s MB/s, warm %9.1f MB/s, position error %g\n", name,
+		   result.payload_size / 1e6, cold, result.warm_mb_per_sec, position_error);
+}
+
+int main(int argc, char** argv) {
+	auto grid		   = 512u;
+	auto runs		   = 5u;
+	std::string prefix = "mesh_load_bench";
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--grid") == 0 && has_value)
+			grid = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--runs") == 0 && has_value)
+			runs = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--output") == 0 && has_value)
+			prefix = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--grid <n>] [--runs <n>] [--output <prefix>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!grid || !runs)
+		return 1;
+
+	try {
+		auto mesh			= BuildGrid(grid);
+		auto float_path		= prefix + ".gmesh";
+		auto quantized_path = prefix + "_quantized.gmesh";
+		WriteMeshFile(float_path.c_str(), mesh, 0);
+		WriteMeshFile(quantized_path.c_str(), mesh,
+					  MESH_FILE_QUANTIZED_POSITIONS | MESH_FILE_OCTAHEDRAL_NORMALS);
+
+		printf("%zu vertices, %zu indices, %u runs\n", mesh.vertices.size(), mesh.indices.size(),
+			   runs);
+		auto float_result	  = RunFile(float_path.c_str(), runs);
+		auto quantized_result = RunFile(quantized_path.c_str(), runs);
+		auto float_error	  = GetMaxPositionError(float_path.c_str(), mesh);
+		auto quantized_error  = GetMaxPositionError(quantized_path.c_str(), mesh);
+
+		PrintResult("float", float_result, float_error);
+		PrintResult("quantized", quantized_result, quantized_error);
+		auto payload_ratio = (double)quantized_result.payload_size / float_result.payload_size;
+		printf("quantized payload is %.0f%% of float\n", payload_ratio * 100.0);
+
+		auto quantization_step = 2.0f * GRID_EXTENT / 65535.0f;
+		auto consistent		   = float_result.consistent && quantized_result.consistent;
+		auto accurate		   = float_error == 0.0f && quantized_error <= quantization_step;
+		auto passed			   = consistent && accurate && payload_ratio < 1.0;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "mesh load benchmark failed\n");
+		return 1;
+	}
+}
@@ -0,0 +1,41 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <thread>
+
+#include "graphics/mesh_optimizer.h"
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <input.gmesh> <output.gmesh> [--no-meshlets]\n", argv[0]);
+		return 1;
+	}
+
+	MeshOptimizerConfig config{.thread_count = std::max(1u, std::thread::hardware_concurrency())};
+	for (auto i = 3; i < argc; ++i)
+		if (strcmp(argv[i], "--no-meshlets") == 0)
+			config.build_meshlets = false;
+
+	try {
+		MeshSourceData mesh;
+		uint32_t flags;
+		{
+			MeshFile input{argv[1]};
+			mesh  = ReadMeshSourceData(input);
+			flags = input.header.flags & ~MESH_FILE_INDEX_32;
+		}
+
+		auto stats = OptimizeMesh(mesh, config);
+		WriteMeshFile(argv[2], mesh, flags);
+
+		printf("vertices %u -> %u, triangles %u, meshlets %u\n", stats.input_vertex_count,
+			   stats.output_vertex_count, stats.triangle_count, stats.meshlet_count);
+		printf("acmr %.3f -> %.3f, atvr %.3f -> %.3f, %.1f ms on %u threads\n",
+			   stats.input_cache.acmr, stats.output_cache.acmr, stats.input_cache.atvr,
+			   stats.output_cache.atvr, stats.elapsed_ms, config.thread_count);
+		return 0;
+	} catch (...) {
+		fprintf(stderr, "failed to optimize %s\n", argv[1]);
+		return 1;
+	}
+}
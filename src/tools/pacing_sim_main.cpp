@@ -0,0 +1,254 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "encoder/frame_pacing.h"
+#include "encoder/mock_frame_encoder.h"
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+
+constexpr uint32_t BUFFER_COUNT		= 3;
+constexpr uint32_t WRITE_SLOT_COUNT = 4;
+
+constexpr BackpressurePolicy POLICIES[]{
+	BackpressurePolicy::Block,
+	BackpressurePolicy::DropNewest,
+	BackpressurePolicy::DropNonReference,
+	BackpressurePolicy::LowerBitrate,
+};
+
+struct SimulationConfig {
+	uint32_t frame_count  = 1200;
+	uint32_t slow_begin	  = 300;
+	uint32_t slow_end	  = 900;
+	double encode_ms	  = 8.0;
+	double write_ms		  = 10.0;
+	double slow_encode_ms = 8.0;
+	double slow_write_ms  = 30.0;
+};
+
+struct SimulationResult {
+	FramePacingStats pacing;
+	EncoderStats encoder;
+	uint64_t written_frames;
+	uint64_t late_frames;
+	double stall_ms;
+	double max_late_ms;
+	double write_stall_ms;
+	uint32_t min_bitrate_percent;
+};
+
+struct ThrottledWriter {
+	double& now;
+	double write_ms;
+	uint32_t bitrate_percent = 100;
+	double disk_free_at		 = 0.0;
+	double stall_ms			 = 0.0;
+	uint64_t written_frames	 = 0;
+	std::deque<double> completions;
+
+	void Retire() {
+		while (!completions.empty() && completions.front() <= now)
+			completions.pop_front();
+	}
+
+	uint32_t GetPendingCount() {
+		Retire();
+		return (uint32_t)completions.size();
+	}
+
+	void WriteFrame(const void*, uint32_t) {
+		Retire();
+		if (completions.size() == WRITE_SLOT_COUNT) {
+			stall_ms += completions.front() - now;
+			now		  = completions.front();
+			Retire();
+		}
+		disk_free_at = std::max(now, disk_free_at) + write_ms * bitrate_percent / 100.0;
+		completions.push_back(disk_free_at);
+		++written_frames;
+	}
+};
+
+struct PendingEncode {
+	double done;
+	CpuFence* fence;
+	uint64_t fence_value;
+};
+
+static void CompleteEncodes(std::deque<PendingEncode>& encodes, double now) {
+	while (!encodes.empty() && encodes.front().done <= now) {
+		encodes.front().fence->Complete(encodes.front().fence_value);
+		encodes.pop_front();
+	}
+}
+
+static SimulationResult Simulate(const EncoderConfig& config, const SimulationConfig& simulation,
+								 BackpressurePolicy policy) {
+	std::vector<CpuTexture> textures;
+	std::vector<CpuFence> fences(BUFFER_COUNT);
+	textures.reserve(BUFFER_COUNT);
+	MockFrameEncoder encoder{config, BUFFER_COUNT};
+	for (auto i = 0u; i < BUFFER_COUNT; ++i) {
+		auto& texture = textures.emplace_back(config.width, config.height,
+											  TextureFormat::B8G8R8A8Unorm);
+		encoder.RegisterTexture(&texture, config.width, config.height,
+								TextureFormatToNvencFormat(texture.format), &fences[i]);
+	}
+
+	FramePacer pacer{{.policy = policy}, config.codec};
+	encoder.SetWriteFilter(FramePacer::FilterWrite, &pacer);
+
+	SimulationResult result{.min_bitrate_percent = 100};
+	auto now = 0.0;
+	ThrottledWriter writer{.now = now, .write_ms = simulation.write_ms};
+	std::deque<PendingEncode> encodes;
+	auto encoder_free_at = 0.0;
+	auto frame_ms		 = 1000.0 * config.frame_rate_den / config.frame_rate_num;
+	for (auto frame = 0u; frame < simulation.frame_count; ++frame) {
+		auto slow		= frame >= simulation.slow_begin && frame < simulation.slow_end;
+		auto due		= frame * frame_ms;
+		auto start		= std::max(now, due);
+		now				= start;
+		writer.write_ms	= slow ? simulation.slow_write_ms : simulation.write_ms;
+		CompleteEncodes(encodes, now);
+		encoder.ProcessCompletedFrames(writer);
+
+		auto action = pacer.BeforeEncode((uint32_t)encoder.GetStats().pending_frames,
+										 writer.GetPendingCount());
+		uint32_t bitrate_percent = 0;
+		if (pacer.TakeBitrateChange(bitrate_percent)) {
+			encoder.SetBitrate(config.bitrate / 100 * bitrate_percent,
+							   config.max_bitrate / 100 * bitrate_percent);
+			writer.bitrate_percent	   = bitrate_percent;
+			result.min_bitrate_percent = std::min(result.min_bitrate_percent, bitrate_percent);
+		}
+
+		if (action == FrameAction::Wait) {
+			now = std::max(now, encoder_free_at);
+			CompleteEncodes(encodes, now);
+			encoder.ProcessCompletedFrames(writer, true);
+		}
+		if (action != FrameAction::Drop) {
+			auto slot		= frame % BUFFER_COUNT;
+			encoder_free_at = std::max(now, encoder_free_at)
+							+ (slow ? simulation.slow_encode_ms : simulation.encode_ms);
+			encodes.push_back(PendingEncode{
+				.done		 = encoder_free_at,
+				.fence		 = &fences[slot],
+				.fence_value = frame + 1ull,
+			});
+			encoder.EncodeFrame(slot, frame + 1ull, frame, frame);
+		}
+
+		auto late		   = now - due;
+		result.max_late_ms = std::max(result.max_late_ms, late);
+		result.stall_ms += now - start;
+		if (late >= frame_ms)
+			++result.late_frames;
+	}
+
+	now = std::max(now, encoder_free_at);
+	CompleteEncodes(encodes, now);
+	encoder.ProcessCompletedFrames(writer, true);
+
+	result.pacing		  = pacer.GetStats();
+	result.encoder		  = encoder.GetStats();
+	result.written_frames = writer.written_frames;
+	result.write_stall_ms = writer.stall_ms;
+	return result;
+}
+
+static const char* GetPolicyName(BackpressurePolicy policy) {
+	switch (policy) {
+		case BackpressurePolicy::Block:
+			return "block";
+		case BackpressurePolicy::DropNewest:
+			return "drop";
+		case BackpressurePolicy::DropNonReference:
+			return "drop-non-ref";
+		case BackpressurePolicy::LowerBitrate:
+			return "lower-bitrate";
+	}
+	return "unknown";
+}
+
+int main(int argc, char** argv) {
+	EncoderConfig config{.codec = EncoderCodec::H264, .width = 64, .height = 64, .b_frames = 2};
+	SimulationConfig simulation{};
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--hevc") == 0)
+			config.codec = EncoderCodec::HEVC;
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			simulation.frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value)
+			config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--b-frames") == 0 && has_value)
+			config.b_frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--encode-ms") == 0 && has_value)
+			simulation.encode_ms = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--write-ms") == 0 && has_value)
+			simulation.write_ms = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--slow-encode-ms") == 0 && has_value)
+			simulation.slow_encode_ms = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--slow-write-ms") == 0 && has_value)
+			simulation.slow_write_ms = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--slow-frames") == 0 && i + 2 < argc) {
+			simulation.slow_begin = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			simulation.slow_end	  = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else {
+			fprintf(stderr,
+					"usage: %s [--hevc] [--frames <n>] [--fps <n>] [--b-frames <n>]\n"
+					"          [--encode-ms <ms>] [--write-ms <ms>] [--slow-encode-ms <ms>]\n"
+					"          [--slow-write-ms <ms>] [--slow-frames <begin> <end>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!config.frame_rate_num)
+		return 1;
+
+	try {
+		printf("%s, %u frames at %u/%u fps, b-frames %u, encode %.1f/%.1f ms, write %.1f/%.1f ms, "
+			   "slow frames %u-%u\n",
+			   config.codec == EncoderCodec::HEVC ? "hevc" : "h264", simulation.frame_count,
+			   config.frame_rate_num, config.frame_rate_den, config.b_frames,
+			   simulation.encode_ms, simulation.slow_encode_ms, simulation.write_ms,
+			   simulation.slow_write_ms, simulation.slow_begin, simulation.slow_end);
+		auto passed = true;
+		for (auto policy : POLICIES) {
+			auto result = Simulate(config, simulation, policy);
+			auto& stats = result.pacing;
+			printf("%-13s encoded %llu, written %llu, blocked %llu, drops encoder %llu writer %llu "
+				   "non-ref %llu, bitrate -%llu +%llu (min %u%%), stall %.1f ms (max %.1f ms, "
+				   "%llu late frames, %.1f ms in writes)\n",
+				   GetPolicyName(policy), (unsigned long long)stats.encoded_frames,
+				   (unsigned long long)result.written_frames,
+				   (unsigned long long)stats.blocked_frames,
+				   (unsigned long long)stats.encoder_queue_drops,
+				   (unsigned long long)stats.writer_queue_drops,
+				   (unsigned long long)stats.non_reference_drops,
+				   (unsigned long long)stats.bitrate_reductions,
+				   (unsigned long long)stats.bitrate_restores, result.min_bitrate_percent,
+				   result.stall_ms, result.max_late_ms, (unsigned long long)result.late_frames,
+				   result.write_stall_ms);
+
+			auto submitted = stats.encoded_frames + stats.blocked_frames;
+			auto accounted = submitted + stats.encoder_queue_drops + stats.writer_queue_drops;
+			passed = passed && accounted == simulation.frame_count
+				  && result.encoder.completed_frames == submitted
+				  && result.written_frames + stats.non_reference_drops == submitted;
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "pacing simulation failed\n");
+		return 1;
+	}
+}
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "graphics/pipeline_cache.h"
+
+constexpr uint64_t DEVICE_HASH		= 0x1234abcd5678ef00ull;
+constexpr uint32_t COLLISION_ROUNDS = 100000;
+constexpr uint32_t STATE_WORDS		= 8;
+constexpr uint32_t STATE_WORD_BITS	= 3;
+constexpr uint32_t STATE_WORD_MASK	= 7;
+constexpr uint64_t LIBRARY_SIZE		= 1000;
+constexpr uint64_t UNIQUE_KEY_COUNT = 4;
+
+struct KeyVariant {
+	std::vector<uint8_t> root_signature{1, 2, 3, 4};
+	std::vector<std::vector<uint8_t>> shader_bytes{{10, 11, 12}, {20, 21}};
+	std::vector<PipelineInputElement> input_layout{
+		{"POSITION", 0, 6, 0, 0, 0, 0},
+		{"COLOR", 0, 6, 1, 0, 0, 0},
+	};
+	std::vector<uint32_t> fixed_state{1, 0, 3, 87};
+
+	uint64_t Hash() const {
+		std::vector<std::span<const uint8_t>> shaders{shader_bytes.begin(), shader_bytes.end()};
+		return HashPipelineKeyDesc(PipelineKeyDesc{
+			.root_signature = root_signature,
+			.shaders		= shaders,
+			.input_layout	= input_layout,
+			.fixed_state	= fixed_state,
+		});
+	}
+};
+
+struct CacheCorruption {
+	const char* name;
+	void (*apply)(std::vector<uint8_t>& bytes);
+};
+
+struct KeyMutation {
+	const char* name;
+	void (*apply)(KeyVariant& variant);
+};
+
+constexpr KeyMutation KEY_MUTATIONS[]{
+	{"root signature byte", [](KeyVariant& v) { v.root_signature[2] ^= 1; }},
+	{"root signature size", [](KeyVariant& v) { v.root_signature.push_back(0); }},
+	{"shader byte", [](KeyVariant& v) { v.shader_bytes[1][0] ^= 1; }},
+	{"shader boundary", [](KeyVariant& v) { v.shader_bytes = {{10, 11}, {12, 20, 21}}; }},
+	{"shader count", [](KeyVariant& v) { v.shader_bytes.push_back({}); }},
+	{"shader order", [](KeyVariant& v) { std::swap(v.shader_bytes[0], v.shader_bytes[1]); }},
+	{"semantic", [](KeyVariant& v) { v.input_layout[1].semantic = "COLOR0"; }},
+	{"semantic index", [](KeyVariant& v) { v.input_layout[1].semantic_index = 1; }},
+	{"format", [](KeyVariant& v) { v.input_layout[0].format = 2; }},
+	{"input slot", [](KeyVariant& v) { v.input_layout[1].input_slot = 0; }},
+	{"offset", [](KeyVariant& v) { v.input_layout[1].offset = 12; }},
+	{"classification", [](KeyVariant& v) { v.input_layout[0].classification = 1; }},
+	{"step rate", [](KeyVariant& v) { v.input_layout[0].step_rate = 1; }},
+	{"element order", [](KeyVariant& v) { std::swap(v.input_layout[0], v.input_layout[1]); }},
+	{"fixed state", [](KeyVariant& v) { v.fixed_state[3] = 28; }},
+	{"fixed state size", [](KeyVariant& v) { v.fixed_state.push_back(0); }},
+};
+
+static bool TestKeys() {
+	KeyVariant base;
+	auto base_key = base.Hash();
+	auto passed	  = base_key == KeyVariant{}.Hash();
+	if (!passed)
+		printf("key is not deterministic\n");
+
+	std::vector<uint64_t> keys{base_key};
+	for (auto& mutation : KEY_MUTATIONS) {
+		KeyVariant variant;
+		mutation.apply(variant);
+		keys.push_back(variant.Hash());
+		if (keys.back() == base_key) {
+			printf("changing the %s does not change the key\n", mutation.name);
+			passed = false;
+		}
+	}
+
+	KeyVariant variant;
+	variant.fixed_state.resize(STATE_WORDS);
+	for (auto i = 0u; i < COLLISION_ROUNDS; ++i) {
+		for (auto word = 0u; word < STATE_WORDS; ++word)
+			variant.fixed_state[word] = (i >> (word * STATE_WORD_BITS)) & STATE_WORD_MASK;
+		keys.push_back(variant.Hash());
+	}
+
+	auto key_count = keys.size();
+	std::ranges::sort(keys);
+	auto duplicates = std::ranges::unique(keys);
+	keys.erase(duplicates.begin(), duplicates.end());
+	printf("keys: %zu field mutations, %u fixed states, %zu collisions\n", std::size(KEY_MUTATIONS),
+		   COLLISION_ROUNDS, key_count - keys.size());
+	return passed && keys.size() == key_count;
+}
+
+static PipelineCacheHeader& GetHeader(std::vector<uint8_t>& bytes) {
+	return *(PipelineCacheHeader*)bytes.data();
+}
+
+static uint64_t* GetKeys(std::vector<uint8_t>& bytes) {
+	return (uint64_t*)(bytes.data() + sizeof(PipelineCacheHeader));
+}
+
+constexpr CacheCorruption CACHE_CORRUPTIONS[]{
+	{"bad magic", [](std::vector<uint8_t>& b) { GetHeader(b).magic ^= 1; }},
+	{"old version", [](std::vector<uint8_t>& b) { --GetHeader(b).version; }},
+	{"appended byte", [](std::vector<uint8_t>& b) { b.push_back(0); }},
+	{"truncated", [](std::vector<uint8_t>& b) { b.pop_back(); }},
+	{"key count", [](std::vector<uint8_t>& b) { GetHeader(b).key_count = ~0u; }},
+	{"unsorted keys", [](std::vector<uint8_t>& b) { std::swap(GetKeys(b)[0], GetKeys(b)[1]); }},
+	{"library offset", [](std::vector<uint8_t>& b) { GetHeader(b).library_offset -= 8; }},
+	{"library size", [](std::vector<uint8_t>& b) { ++GetHeader(b).library_size; }},
+};
+
+static std::vector<uint8_t> ReadBytes(const std::filesystem::path& path) {
+	std::ifstream input{path, std::ios::binary};
+	return {std::istreambuf_iterator<char>{input}, std::istreambuf_iterator<char>{}};
+}
+
+static void WriteBytes(const std::filesystem::path& path, std::span<const uint8_t> bytes) {
+	std::ofstream output{path, std::ios::binary | std::ios::trunc};
+	output.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+	if (!output)
+		throw;
+}
+
+static bool Check(bool condition, const char* what) {
+	if (!condition)
+		printf("%s\n", what);
+	return condition;
+}
+
+static bool IsEmpty(const PipelineCacheContents& contents) {
+	return contents.keys.empty() && contents.library.empty();
+}
+
+static bool TestPersistence(const std::filesystem::path& directory) {
+	auto path = directory / "pipelines.cache";
+	std::filesystem::remove(path);
+	auto passed = Check(IsEmpty(ReadPipelineCache(path, DEVICE_HASH)), "missing file not empty");
+
+	std::vector<uint64_t> keys{5, 3, 9, 3, 1, 9};
+	std::vector<uint8_t> library(LIBRARY_SIZE);
+	for (auto i = 0u; i < library.size(); ++i)
+		library[i] = (uint8_t)(i * 7);
+	WritePipelineCache(path, DEVICE_HASH, keys, library);
+
+	auto contents = ReadPipelineCache(path, DEVICE_HASH);
+	auto expected_size
+		= sizeof(PipelineCacheHeader) + UNIQUE_KEY_COUNT * sizeof(uint64_t) + LIBRARY_SIZE;
+	passed = Check(contents.keys == std::vector<uint64_t>{1, 3, 5, 9}, "keys not sorted and unique")
+		  && Check(contents.library == library, "library does not round trip")
+		  && Check(std::filesystem::file_size(path) == expected_size, "unexpected file size")
+		  && Check(!std::filesystem::exists(path.string() + ".tmp"), "temporary file left behind")
+		  && passed;
+	passed = Check(IsEmpty(ReadPipelineCache(path, ~DEVICE_HASH)), "other device accepted cache")
+		  && passed;
+
+	auto good_bytes = ReadBytes(path);
+	auto rejected	= 0u;
+	for (auto& corruption : CACHE_CORRUPTIONS) {
+		auto bytes = good_bytes;
+		corruption.apply(bytes);
+		WriteBytes(path, bytes);
+		if (IsEmpty(ReadPipelineCache(path, DEVICE_HASH)))
+			++rejected;
+		else {
+			printf("%s cache was accepted\n", corruption.name);
+			passed = false;
+		}
+	}
+
+	WritePipelineCache(path, DEVICE_HASH, {}, {});
+	auto empty_round_trip = IsEmpty(ReadPipelineCache(path, DEVICE_HASH))
+						 && std::filesystem::file_size(path) == sizeof(PipelineCacheHeader);
+	passed = Check(empty_round_trip, "empty cache does not round trip") && passed;
+
+	printf("persistence: %zu unique keys, %llu byte library, %u of %zu corruptions rejected\n",
+		   contents.keys.size(), (unsigned long long)LIBRARY_SIZE, rejected,
+		   std::size(CACHE_CORRUPTIONS));
+	return passed;
+}
+
+int main(int argc, char** argv) {
+	std::filesystem::path directory = ".";
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--directory") == 0 && has_value)
+			directory = argv[++i];
+		else {
+			fprintf(stderr, "usage: %s [--directory <dir>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	try {
+		std::filesystem::create_directories(directory);
+		auto keys_passed		= TestKeys();
+		auto persistence_passed = TestPersistence(directory);
+		auto passed				= keys_passed && persistence_passed;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "pipeline cache test failed\n");
+		return 1;
+	}
+}
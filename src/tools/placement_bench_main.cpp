@@ -0,0 +1,238 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "node_memory.h"
+#include "platform_thread.h"
+#include "thread_placement.h"
+
+constexpr size_t CACHE_LINE_SIZE	= 64;
+constexpr uint32_t READ_PASSES		= 4;
+constexpr uint32_t CHASE_LOADS		= 4'000'000;
+constexpr uint32_t FRAME_SLOTS		= 4;
+constexpr uint32_t PERMUTATION_SEED = 0x4E554D41;
+
+struct MatrixResult {
+	double read_gb_per_second;
+	double load_latency_ns;
+	uint32_t resident_node;
+	bool bound;
+	uint64_t checksum;
+	NumaTrafficStats traffic;
+};
+
+struct PipelineResult {
+	double gb_per_second;
+	double latency_p50_us;
+	double latency_p99_us;
+	uint32_t render_node;
+	uint32_t writer_node;
+	uint32_t buffer_node;
+	uint64_t checksum_errors;
+	NumaTrafficStats traffic;
+};
+
+struct FrameSlot {
+	std::chrono::steady_clock::time_point produced_time;
+	uint64_t frame;
+};
+
+static double GetElapsedSeconds(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+static NumaTrafficStats GetTrafficDelta(const NumaTrafficStats& before) {
+	auto after = ReadNumaTrafficStats();
+	return NumaTrafficStats{
+		.local_pages  = after.local_pages - before.local_pages,
+		.remote_pages = after.remote_pages - before.remote_pages,
+		.missed_pages = after.missed_pages - before.missed_pages,
+	};
+}
+
+static MatrixResult MeasureNodePair(uint32_t thread_node, uint32_t memory_node, size_t size) {
+	MatrixResult result{};
+	std::thread thread{[&] {
+		ApplyThreadPlacement(ThreadPlacement{.node = thread_node});
+		auto traffic_before = ReadNumaTrafficStats();
+		NodeBuffer buffer{size, memory_node};
+		result.bound		 = buffer.bound;
+		result.resident_node = GetAddressNumaNode(buffer.data);
+
+		auto words	 = (const uint64_t*)buffer.data;
+		auto count	 = size / sizeof(uint64_t);
+		uint64_t sum = 0;
+		auto start	 = std::chrono::steady_clock::now();
+		for (auto pass = 0u; pass < READ_PASSES; ++pass)
+			for (size_t i = 0; i < count; ++i)
+				sum += words[i];
+		result.read_gb_per_second = size * READ_PASSES / GetElapsedSeconds(start) / 1e9;
+
+		auto line_count = size / CACHE_LINE_SIZE;
+		std::vector<uint32_t> order(line_count);
+		std::iota(order.begin(), order.end(), 0u);
+		std::shuffle(order.begin() + 1, order.end(), std::mt19937{PERMUTATION_SEED});
+		for (size_t i = 0; i < line_count; ++i)
+			*(uint64_t*)(buffer.data + order[i] * CACHE_LINE_SIZE)
+				= order[(i + 1) % line_count] * CACHE_LINE_SIZE;
+
+		uint64_t offset = 0;
+		start			= std::chrono::steady_clock::now();
+		for (auto i = 0u; i < CHASE_LOADS; ++i)
+			offset = *(const uint64_t*)(buffer.data + offset);
+		result.load_latency_ns = GetElapsedSeconds(start) * 1e9 / CHASE_LOADS;
+		result.checksum		   = sum ^ offset;
+		result.traffic		   = GetTrafficDelta(traffic_before);
+	}};
+	thread.join();
+	return result;
+}
+
+static PipelineResult RunPipeline(const PipelinePlacement& placement, uint32_t buffer_node,
+								  size_t frame_size, uint32_t frame_count) {
+	PipelineResult result{.buffer_node = buffer_node};
+	auto traffic_before = ReadNumaTrafficStats();
+	NodeBuffer frames{frame_size * FRAME_SLOTS, buffer_node};
+	FrameSlot slots[FRAME_SLOTS]{};
+	std::atomic<uint64_t> produced = 0;
+	std::atomic<uint64_t> consumed = 0;
+	std::vector<double> latencies;
+	latencies.reserve(frame_count);
+
+	auto start = std::chrono::steady_clock::now();
+	std::thread render{[&] {
+		ApplyThreadPlacement(placement.render);
+		result.render_node = GetCoreNumaNode(GetCurrentCore());
+		for (uint64_t frame = 0; frame < frame_count; ++frame) {
+			while (frame - consumed.load(std::memory_order_acquire) >= FRAME_SLOTS)
+				std::this_thread::yield();
+			auto slot = frame % FRAME_SLOTS;
+			memset(frames.data + slot * frame_size, (uint8_t)frame, frame_size);
+			slots[slot] = FrameSlot{.produced_time = std::chrono::steady_clock::now(),
+									.frame		   = frame};
+			produced.store(frame + 1, std::memory_order_release);
+		}
+	}};
+	std::thread writer{[&] {
+		ApplyThreadPlacement(placement.writer);
+		result.writer_node = GetCoreNumaNode(GetCurrentCore());
+		for (uint64_t frame = 0; frame < frame_count; ++frame) {
+			while (produced.load(std::memory_order_acquire) <= frame)
+				std::this_thread::yield();
+			auto slot  = frame % FRAME_SLOTS;
+			auto words = (const uint64_t*)(frames.data + slot * frame_size);
+			auto fill  = 0x0101010101010101ull * (uint8_t)frame;
+			uint64_t mismatches = 0;
+			for (size_t i = 0; i < frame_size / sizeof(uint64_t); ++i)
+				mismatches += words[i] != fill;
+			if (mismatches || slots[slot].frame != frame)
+				++result.checksum_errors;
+			auto latency = std::chrono::steady_clock::now() - slots[slot].produced_time;
+			latencies.push_back(std::chrono::duration<double, std::micro>(latency).count());
+			consumed.store(frame + 1, std::memory_order_release);
+		}
+	}};
+	render.join();
+	writer.join();
+
+	auto seconds = GetElapsedSeconds(start);
+	std::sort(latencies.begin(), latencies.end());
+	result.gb_per_second  = (double)frame_size * frame_count / seconds / 1e9;
+	result.latency_p50_us = latencies[latencies.size() / 2];
+	result.latency_p99_us = latencies[latencies.size() * 99 / 100];
+	result.traffic		  = GetTrafficDelta(traffic_before);
+	return result;
+}
+
+int main(int argc, char** argv) {
+	size_t matrix_size	 = 64ull * 1024 * 1024;
+	size_t frame_size	 = 1920ull * 1080 * 4;
+	uint32_t frame_count = 600;
+	auto buffer_node	 = ANY_NUMA_NODE;
+	PipelinePlacement placement;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--placement") == 0 && has_value) {
+			if (!ParsePipelinePlacement(argv[++i], placement)) {
+				fprintf(stderr, "invalid placement %s\n", argv[i]);
+				return 1;
+			}
+		}
+		else if (strcmp(argv[i], "--matrix-mb") == 0 && has_value)
+			matrix_size = strtoull(argv[++i], nullptr, 10) * 1024 * 1024;
+		else if (strcmp(argv[i], "--frame-bytes") == 0 && has_value)
+			frame_size = strtoull(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--buffer-node") == 0 && has_value)
+			buffer_node = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr,
+					"usage: %s [--placement <role.field=value,...>] [--matrix-mb <n>]\n"
+					"          [--frame-bytes <n>] [--frames <n>] [--buffer-node <n>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!frame_count || frame_size < sizeof(uint64_t) || matrix_size < CACHE_LINE_SIZE)
+		return 1;
+
+	try {
+		auto node_count = GetNumaNodeCount();
+		printf("%u numa nodes, %u logical cores\n", node_count, GetLogicalCoreCount());
+		for (auto node = 0u; node < node_count; ++node)
+			printf("node %u: %zu cores\n", node, GetNumaNodeCores(node).size());
+
+		auto passed = true;
+		for (auto thread_node = 0u; thread_node < node_count; ++thread_node) {
+			if (GetNumaNodeCores(thread_node).empty())
+				continue;
+			for (auto memory_node = 0u; memory_node < node_count; ++memory_node) {
+				auto result = MeasureNodePair(thread_node, memory_node, matrix_size);
+				printf("thread node %u, memory node %u (resident %u, %s): read %.2f GB/s, "
+					   "load latency %.1f ns, pages local %llu remote %llu missed %llu, "
+					   "checksum %016llx\n",
+					   thread_node, memory_node, result.resident_node,
+					   result.bound ? "bound" : "first-touch", result.read_gb_per_second,
+					   result.load_latency_ns, (unsigned long long)result.traffic.local_pages,
+					   (unsigned long long)result.traffic.remote_pages,
+					   (unsigned long long)result.traffic.missed_pages,
+					   (unsigned long long)result.checksum);
+				passed = passed && (!result.bound || result.resident_node == memory_node);
+			}
+		}
+
+		auto render_node = GetPlacementNode(placement.render);
+		auto writer_node = GetPlacementNode(placement.writer);
+		std::vector<uint32_t> buffer_nodes{buffer_node};
+		if (buffer_node == ANY_NUMA_NODE) {
+			buffer_nodes = {writer_node};
+			if (render_node != writer_node)
+				buffer_nodes.push_back(render_node);
+		}
+		for (auto node : buffer_nodes) {
+			auto result = RunPipeline(placement, node, frame_size, frame_count);
+			printf("pipeline render node %u -> writer node %u, buffers on node %u: %.2f GB/s, "
+				   "handoff p50 %.1f us p99 %.1f us, pages local %llu remote %llu, "
+				   "checksum errors %llu\n",
+				   result.render_node, result.writer_node, result.buffer_node,
+				   result.gb_per_second, result.latency_p50_us, result.latency_p99_us,
+				   (unsigned long long)result.traffic.local_pages,
+				   (unsigned long long)result.traffic.remote_pages,
+				   (unsigned long long)result.checksum_errors);
+			passed = passed && !result.checksum_errors;
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "placement benchmark failed\n");
+		return 1;
+	}
+}
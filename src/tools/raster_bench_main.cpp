@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "graphics/cpu_frame_resources.h"
+#include "graphics/cpu_rasterizer.h"
+
+struct FrameSize {
+	uint32_t width;
+	uint32_t height;
+};
+
+constexpr FrameSize FRAME_SIZES[]{
+	{512, 512}, {1280, 720}, {1920, 1080}, {2560, 1440}, {3840, 2160},
+};
+
+constexpr float MVP_IDENTITY[16]{
+	1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
+	0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+};
+
+static std::vector<MeshVertex> BuildGrid(uint32_t grid) {
+	std::vector<MeshVertex> vertices;
+	vertices.reserve((size_t)grid * grid * 6);
+	auto step = 2.0f / (float)grid;
+	for (auto row = 0u; row < grid; ++row) {
+		for (auto column = 0u; column < grid; ++column) {
+			auto x0 = -1.0f + column * step;
+			auto x1 = column + 1 == grid ? 1.0f : x0 + step;
+			auto y0 = -1.0f + row * step;
+			auto y1 = row + 1 == grid ? 1.0f : y0 + step;
+			auto r	= (float)column / grid;
+			auto g	= (float)row / grid;
+			MeshVertex top_left{.position = {x0, y1, 0.0f}, .color = {r, g, 0.0f}};
+			MeshVertex top_right{.position = {x1, y1, 0.0f}, .color = {r, g, 0.5f}};
+			MeshVertex bottom_right{.position = {x1, y0, 0.0f}, .color = {r, g, 1.0f}};
+			MeshVertex bottom_left{.position = {x0, y0, 0.0f}, .color = {1.0f, g, r}};
+			vertices.insert(vertices.end(), {top_left, top_right, bottom_right});
+			vertices.insert(vertices.end(), {top_left, bottom_right, bottom_left});
+		}
+	}
+	return vertices;
+}
+
+static std::vector<uint32_t> GetThreadCounts(uint32_t max_threads) {
+	std::vector<uint32_t> counts;
+	for (auto count = 1u; count < max_threads; count *= 2)
+		counts.push_back(count);
+	counts.push_back(max_threads);
+	return counts;
+}
+
+int main(int argc, char** argv) {
+	auto max_threads = std::max(std::thread::hardware_concurrency(), 1u);
+	auto frames		 = 20u;
+	auto grid		 = 16u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--threads") == 0 && has_value)
+			max_threads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--grid") == 0 && has_value)
+			grid = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--threads <max>] [--frames <n>] [--grid <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (!max_threads || !frames || !grid)
+		return 1;
+
+	try {
+		auto vertices = BuildGrid(grid);
+		auto passed	  = true;
+		printf("%u triangles per frame, %u frames per run\n", grid * grid * 2, frames);
+		for (auto size : FRAME_SIZES) {
+			std::vector<uint32_t> reference;
+			double single_thread_rate = 0.0;
+			for (auto thread_count : GetThreadCounts(max_threads)) {
+				CpuRasterizer rasterizer{thread_count};
+				CpuTexture target{size.width, size.height, TextureFormat::B8G8R8A8Unorm};
+				rasterizer.Draw(target, vertices, MVP_IDENTITY);
+
+				auto start = std::chrono::steady_clock::now();
+				for (auto frame = 0u; frame < frames; ++frame)
+					rasterizer.Draw(target, vertices, MVP_IDENTITY);
+				auto elapsed = std::chrono::steady_clock::now() - start;
+				auto seconds = std::chrono::duration<double>(elapsed).count();
+
+				auto stats			 = rasterizer.GetStats();
+				auto frame_pixels	 = (uint64_t)size.width * size.height;
+				auto mpixels_per_sec = frame_pixels * frames / seconds / 1e6;
+				if (thread_count == 1)
+					single_thread_rate = mpixels_per_sec;
+				auto covered   = stats.shaded_pixels == frame_pixels * (frames + 1);
+				auto identical = reference.empty() || target.pixels == reference;
+				if (reference.empty())
+					reference = target.pixels;
+				passed = passed && covered && identical;
+
+				printf("%4ux%-4u %3u threads %9.1f Mpixels/s %7.2f ms/frame %5.2fx%s%s\n",
+					   size.width, size.height, thread_count, mpixels_per_sec,
+					   seconds * 1000.0 / frames, mpixels_per_sec / single_thread_rate,
+					   covered ? "" : " coverage mismatch", identical ? "" : " image mismatch");
+			}
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "rasterizer benchmark failed\n");
+		return 1;
+	}
+}
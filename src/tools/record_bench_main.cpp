@@ -0,0 +1,131 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "graphics/command_recorder.h"
+#include "graphics/cpu_frame_resources.h"
+#include "graphics/cpu_mesh.h"
+#include "graphics/cpu_pipeline.h"
+
+constexpr uint32_t FRAMES_IN_FLIGHT = 3;
+constexpr uint32_t TARGET_SIZE		= 64;
+constexpr uint32_t DRAW_COUNTS[]{1000, 10000, 50000};
+
+constexpr float CULLED_MVP[16]{};
+
+struct ScalingResult {
+	double best_ms;
+	double median_ms;
+	uint64_t executed_draws;
+	CommandRecorderStats stats;
+	bool consistent;
+};
+
+static void SpendDrawCost(uint32_t draw_cost_ns) {
+	auto end = std::chrono::steady_clock::now() + std::chrono::nanoseconds(draw_cost_ns);
+	while (std::chrono::steady_clock::now() < end)
+		;
+}
+
+static ScalingResult RunScaling(CpuDevice& device, uint32_t thread_count, uint32_t draw_count,
+								uint32_t frame_count, uint32_t draw_cost_ns) {
+	JobSystem job_system{JobSystemConfig{.thread_count = thread_count, .pin_threads = false}};
+	CpuFrameResources frames{device, FRAMES_IN_FLIGHT, thread_count};
+	CpuPipeline pipeline{device, job_system, TextureFormat::B8G8R8A8Unorm};
+	CpuMesh mesh{device};
+	CpuTexture target{TARGET_SIZE, TARGET_SIZE, TextureFormat::B8G8R8A8Unorm};
+	ParallelCommandRecorder recorder{job_system};
+
+	ScalingResult result;
+	uint64_t slot_values[FRAMES_IN_FLIGHT]{};
+	std::vector<double> samples;
+	auto first_draw = device.rasterizer.GetStats().draw_count;
+	for (uint64_t frame = 1; frame <= frame_count; ++frame) {
+		auto slot = (uint32_t)((frame - 1) % FRAMES_IN_FLIGHT);
+		frames.fences[slot]->Wait(slot_values[slot]);
+
+		auto start = std::chrono::steady_clock::now();
+		recorder.Record(frames.GetCommandLists(slot), draw_count,
+						[&](CpuCommandList& command_list, uint32_t begin, uint32_t end) {
+							command_list.SetRenderTarget(&target, TARGET_SIZE, TARGET_SIZE);
+							command_list.SetPipeline(pipeline);
+							command_list.SetConstants((uint64_t)CULLED_MVP);
+							for (auto i = begin; i < end; ++i) {
+								SpendDrawCost(draw_cost_ns);
+								command_list.Draw(mesh);
+							}
+						});
+		auto elapsed = std::chrono::steady_clock::now() - start;
+		samples.push_back(std::chrono::duration<double, std::milli>(elapsed).count());
+
+		device.Execute(frames.GetCommandLists(slot));
+		device.Signal(frames.fences[slot], frame, frames.fence_events[slot]);
+		slot_values[slot] = frame;
+	}
+	for (auto slot = 0u; slot < FRAMES_IN_FLIGHT; ++slot)
+		frames.fences[slot]->Wait(slot_values[slot]);
+
+	std::ranges::sort(samples);
+	result.best_ms		  = samples.front();
+	result.median_ms	  = samples[samples.size() / 2];
+	result.executed_draws = device.rasterizer.GetStats().draw_count - first_draw;
+	result.stats		  = recorder.GetStats();
+	result.consistent	  = result.executed_draws == (uint64_t)draw_count * frame_count
+						&& result.stats.dispatch_count == frame_count
+						&& result.stats.job_count == (uint64_t)thread_count * frame_count
+						&& result.stats.recorded_items == result.executed_draws;
+	return result;
+}
+
+int main(int argc, char** argv) {
+	auto max_threads  = std::max(std::thread::hardware_concurrency(), 2u);
+	auto frame_count  = 12u;
+	auto draw_cost_ns = 500u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--threads") == 0 && has_value)
+			max_threads = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--draw-cost") == 0 && has_value)
+			draw_cost_ns = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--threads <max>] [--frames <n>] [--draw-cost <ns>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!max_threads || !frame_count)
+		return 1;
+
+	try {
+		CpuDevice device;
+		auto passed = true;
+		printf("%u frames in flight, %u frames per run, %u ns per draw, %u hardware threads\n",
+			   FRAMES_IN_FLIGHT, frame_count, draw_cost_ns, std::thread::hardware_concurrency());
+		for (auto draw_count : DRAW_COUNTS) {
+			auto single_thread_ms = 0.0;
+			for (auto thread_count = 1u; thread_count <= max_threads; thread_count *= 2) {
+				auto result
+					= RunScaling(device, thread_count, draw_count, frame_count, draw_cost_ns);
+				if (thread_count == 1)
+					single_thread_ms = result.median_ms;
+				printf("%6u draws %3u threads: record best %8.3f ms, median %8.3f ms, "
+					   "%7.2f Mdraws/s, speedup %5.2fx%s\n",
+					   draw_count, thread_count, result.best_ms, result.median_ms,
+					   draw_count / result.median_ms / 1e3, single_thread_ms / result.median_ms,
+					   result.consistent ? "" : " stats mismatch");
+				passed = passed && result.consistent;
+			}
+		}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "record benchmark failed\n");
+		return 1;
+	}
+}
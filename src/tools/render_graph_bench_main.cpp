@@ -0,0 +1,296 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "graphics/render_graph.h"
+
+constexpr uint32_t FRAME_WIDTH		   = 1920;
+constexpr uint32_t FRAME_HEIGHT		   = 1080;
+constexpr uint64_t TEXTURE_ALIGNMENT   = 64 * 1024;
+constexpr uint32_t LADDER_LEVELS	   = 4;
+constexpr uint32_t OVERLAY_INTERVAL	   = 10;
+constexpr uint32_t SCENE_READ_INTERVAL = 3;
+constexpr double COMPILE_TARGET_US	   = 50.0;
+
+using Microseconds = std::chrono::duration<double, std::micro>;
+
+struct GraphAccess {
+	uint32_t pass;
+	uint32_t texture;
+	ResourceState state;
+};
+
+struct GraphScript {
+	std::vector<GraphAccess> accesses;
+	std::vector<uint64_t> texture_sizes;
+};
+
+struct GraphRecorder {
+	RenderGraph& graph;
+	GraphScript& script;
+
+	uint32_t ImportTexture(ResourceState final_state) {
+		script.texture_sizes.push_back(0);
+		return graph.ImportTexture(final_state);
+	}
+
+	uint32_t CreateTexture(const RenderGraphTextureDesc& desc) {
+		script.texture_sizes.push_back(desc.size);
+		return graph.CreateTexture(desc);
+	}
+
+	void Read(uint32_t pass, uint32_t texture, ResourceState state) {
+		graph.Read(pass, texture, state);
+		script.accesses.push_back(GraphAccess{.pass = pass, .texture = texture, .state = state});
+	}
+
+	void Write(uint32_t pass, uint32_t texture, ResourceState state, bool discard = false) {
+		graph.Write(pass, texture, state, discard);
+		script.accesses.push_back(GraphAccess{.pass = pass, .texture = texture, .state = state});
+	}
+};
+
+struct Timings {
+	double best;
+	double median;
+	double p99;
+};
+
+static RenderGraphTextureDesc GetTextureDesc(uint32_t level) {
+	auto width	= FRAME_WIDTH >> level;
+	auto height = FRAME_HEIGHT >> level;
+	auto size	= (uint64_t)width * height * 4;
+	return RenderGraphTextureDesc{
+		.width	   = width,
+		.height	   = height,
+		.format	   = TextureFormat::B8G8R8A8Unorm,
+		.size	   = (size + TEXTURE_ALIGNMENT - 1) & ~(TEXTURE_ALIGNMENT - 1),
+		.alignment = TEXTURE_ALIGNMENT,
+	};
+}
+
+static bool IsOverlayPass(uint32_t pass) {
+	return pass % OVERLAY_INTERVAL == OVERLAY_INTERVAL / 2;
+}
+
+static void BuildGraph(RenderGraph& graph, uint32_t pass_count, GraphScript& script) {
+	GraphRecorder recorder{graph, script};
+	graph.Reset();
+	script.accesses.clear();
+	script.texture_sizes.clear();
+
+	auto back_buffer = recorder.ImportTexture(ResourceState::Present);
+	auto scene		 = recorder.CreateTexture(GetTextureDesc(0));
+	auto depth		 = recorder.CreateTexture(GetTextureDesc(0));
+	auto scene_pass	 = graph.AddPass();
+	recorder.Write(scene_pass, scene, ResourceState::RenderTarget, true);
+	recorder.Write(scene_pass, depth, ResourceState::RenderTarget, true);
+
+	auto previous = scene;
+	for (auto p = 1u; p + 1 < pass_count; ++p) {
+		auto output = recorder.CreateTexture(GetTextureDesc(p % LADDER_LEVELS));
+		auto pass	= graph.AddPass();
+		recorder.Read(pass, previous, ResourceState::CopySource);
+		if (p % SCENE_READ_INTERVAL == 0 && previous != scene)
+			recorder.Read(pass, scene, ResourceState::CopySource);
+		if (p == pass_count / 2)
+			recorder.Read(pass, depth, ResourceState::CopySource);
+		recorder.Write(pass, output, ResourceState::RenderTarget, true);
+		if (!IsOverlayPass(p))
+			previous = output;
+	}
+
+	auto present_pass = graph.AddPass();
+	recorder.Read(present_pass, previous, ResourceState::CopySource);
+	recorder.Write(present_pass, back_buffer, ResourceState::CopyDest);
+}
+
+static bool CheckGraph(const RenderGraph& graph, uint32_t pass_count, const GraphScript& script) {
+	auto stats		= graph.GetStats();
+	auto pass_order = graph.GetPassOrder();
+	auto culled		= 0u;
+	for (auto p = 1u; p + 1 < pass_count; ++p)
+		culled += IsOverlayPass(p) ? 1 : 0;
+	if (stats.live_pass_count != pass_count - culled) {
+		printf("%u live passes, expected %u\n", stats.live_pass_count, pass_count - culled);
+		return false;
+	}
+
+	std::vector<uint32_t> orders(pass_count, RENDER_GRAPH_INVALID);
+	for (auto order = 0u; order < pass_order.size(); ++order)
+		orders[pass_order[order]] = order;
+
+	auto& sizes = script.texture_sizes;
+	std::vector<uint32_t> first_use(sizes.size(), RENDER_GRAPH_INVALID);
+	std::vector<uint32_t> last_use(sizes.size(), 0);
+	for (auto& access : script.accesses) {
+		auto order = orders[access.pass];
+		if (order == RENDER_GRAPH_INVALID || !sizes[access.texture])
+			continue;
+		first_use[access.texture] = std::min(first_use[access.texture], order);
+		last_use[access.texture]  = std::max(last_use[access.texture], order);
+	}
+
+	for (auto left = 0u; left < sizes.size(); ++left) {
+		if (first_use[left] == RENDER_GRAPH_INVALID)
+			continue;
+		auto left_offset = graph.GetTransientOffset(left);
+		if (left_offset % TEXTURE_ALIGNMENT
+			|| left_offset + sizes[left] > stats.transient_heap_size) {
+			printf("texture %u placed outside the heap\n", left);
+			return false;
+		}
+
+		for (auto right = left + 1; right < sizes.size(); ++right) {
+			if (first_use[right] == RENDER_GRAPH_INVALID || first_use[left] > last_use[right]
+				|| first_use[right] > last_use[left])
+				continue;
+			auto right_offset = graph.GetTransientOffset(right);
+			if (left_offset < right_offset + sizes[right]
+				&& right_offset < left_offset + sizes[left]) {
+				printf("textures %u and %u are live together but share memory\n", left, right);
+				return false;
+			}
+		}
+	}
+
+	std::vector<ResourceState> states(sizes.size());
+	std::vector<bool> in_transition(sizes.size());
+	for (auto pass : pass_order) {
+		for (auto& transition : graph.GetPassTransitions(pass)) {
+			in_transition[transition.texture] = transition.split == BarrierSplit::Begin;
+			if (transition.split != BarrierSplit::Begin)
+				states[transition.texture] = transition.state;
+		}
+		for (auto& access : script.accesses)
+			if (access.pass == pass
+				&& (in_transition[access.texture] || states[access.texture] != access.state)) {
+				printf("pass %u uses texture %u in the wrong state\n", pass, access.texture);
+				return false;
+			}
+	}
+
+	auto aliasing_count = 0u;
+	for (auto pass : pass_order)
+		for (auto& aliasing : graph.GetPassAliasing(pass)) {
+			auto after	= aliasing.after;
+			auto before = aliasing.before;
+			++aliasing_count;
+			if (orders[pass] != first_use[after]) {
+				printf("aliasing barrier for texture %u is not at its first use\n", after);
+				return false;
+			}
+			if (before == RENDER_GRAPH_INVALID)
+				continue;
+			auto before_offset = graph.GetTransientOffset(before);
+			auto after_offset  = graph.GetTransientOffset(after);
+			if (last_use[before] >= first_use[after]
+				|| before_offset >= after_offset + sizes[after]
+				|| after_offset >= before_offset + sizes[before]) {
+				printf("texture %u aliases texture %u without sharing its memory after it\n",
+					   after, before);
+				return false;
+			}
+		}
+	if (aliasing_count != stats.transient_count) {
+		printf("%u aliasing barriers for %u transients\n", aliasing_count, stats.transient_count);
+		return false;
+	}
+
+	if (stats.transient_heap_size >= stats.unaliased_transient_size) {
+		printf("aliasing saved nothing\n");
+		return false;
+	}
+	return true;
+}
+
+static bool CheckLayeredWrites(RenderGraph& graph, bool cleared, uint32_t expected_live) {
+	graph.Reset();
+	auto back_buffer  = graph.ImportTexture(ResourceState::Present);
+	auto scene_pass	  = graph.AddPass();
+	graph.Write(scene_pass, back_buffer, ResourceState::RenderTarget, true);
+	auto overlay_pass = graph.AddPass();
+	graph.Write(overlay_pass, back_buffer, ResourceState::RenderTarget);
+	if (cleared) {
+		auto clear_pass = graph.AddPass();
+		graph.Write(clear_pass, back_buffer, ResourceState::RenderTarget, true);
+	}
+	graph.Compile();
+
+	auto live = (uint32_t)graph.GetPassOrder().size();
+	if (live != expected_live)
+		printf("%s layered writes: %u live passes, expected %u\n", cleared ? "cleared" : "kept",
+			   live, expected_live);
+	return live == expected_live;
+}
+
+static Timings GetTimings(std::vector<double>& samples) {
+	std::ranges::sort(samples);
+	return Timings{
+		.best	= samples.front(),
+		.median = samples[samples.size() / 2],
+		.p99	= samples[samples.size() * 99 / 100],
+	};
+}
+
+int main(int argc, char** argv) {
+	auto pass_count = 50u;
+	auto iterations = 10000u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--passes") == 0 && has_value)
+			pass_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--iterations") == 0 && has_value)
+			iterations = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--passes <n>] [--iterations <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+	if (pass_count < 2 || !iterations)
+		return 1;
+
+	try {
+		RenderGraph graph;
+		auto passed = CheckLayeredWrites(graph, false, 2);
+		passed		= CheckLayeredWrites(graph, true, 1) && passed;
+
+		GraphScript script;
+		BuildGraph(graph, pass_count, script);
+		graph.Compile();
+		passed = CheckGraph(graph, pass_count, script) && passed;
+
+		std::vector<double> build_samples(iterations);
+		std::vector<double> compile_samples(iterations);
+		for (auto i = 0u; i < iterations; ++i) {
+			auto start = std::chrono::steady_clock::now();
+			BuildGraph(graph, pass_count, script);
+			auto built = std::chrono::steady_clock::now();
+			graph.Compile();
+			auto compiled	   = std::chrono::steady_clock::now();
+			build_samples[i]   = Microseconds(built - start).count();
+			compile_samples[i] = Microseconds(compiled - built).count();
+		}
+
+		auto stats	 = graph.GetStats();
+		auto build	 = GetTimings(build_samples);
+		auto compile = GetTimings(compile_samples);
+		printf("%u passes (%u live), %u transients, %u aliasing barriers, heap %.1f MB aliased vs "
+			   "%.1f MB unaliased\n",
+			   stats.pass_count, stats.live_pass_count, stats.transient_count, stats.aliasing_count,
+			   stats.transient_heap_size / 1e6, stats.unaliased_transient_size / 1e6);
+		printf("build   best %6.2f us, median %6.2f us, p99 %6.2f us\n", build.best, build.median,
+			   build.p99);
+		printf("compile best %6.2f us, median %6.2f us, p99 %6.2f us (target %.0f us %s)\n",
+			   compile.best, compile.median, compile.p99, COMPILE_TARGET_US,
+			   compile.median < COMPILE_TARGET_US ? "met" : "missed");
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "render graph benchmark failed\n");
+		return 1;
+	}
+}
@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "encoder/rtp_packetizer.h"
+#include "encoder/rtp_sender.h"
+#include "udp_socket.h"
+
+constexpr uint32_t RECEIVE_BUFFER_SIZE	 = 65536;
+constexpr uint32_t RECEIVE_TIMEOUT_MS	 = 200;
+constexpr uint32_t KEYFRAME_SLICE_COUNT	 = 4;
+constexpr uint32_t PARAMETER_SET_PAYLOAD = 24;
+
+constexpr uint8_t H264_NAL_HEADERS[]{0x67, 0x68, 0x65, 0x41};
+constexpr uint8_t HEVC_NAL_HEADERS[][2]{{0x40, 1}, {0x42, 1}, {0x44, 1}, {0x26, 1}, {0x02, 1}};
+
+struct StreamShape {
+	EncoderCodec codec;
+	uint32_t gop_length;
+	uint32_t keyframe_size;
+	uint32_t frame_size;
+};
+
+struct ReceiverStats {
+	uint64_t verified_frames;
+	uint64_t mismatched_frames;
+};
+
+static void AppendNalUnit(std::vector<uint8_t>& access_unit, const StreamShape& shape,
+						  uint32_t header_index, uint32_t size, uint32_t seed) {
+	access_unit.insert(access_unit.end(), {0, 0, 0, 1});
+	if (shape.codec == EncoderCodec::HEVC)
+		access_unit.insert(access_unit.end(), std::begin(HEVC_NAL_HEADERS[header_index]),
+						   std::end(HEVC_NAL_HEADERS[header_index]));
+	else
+		access_unit.push_back(H264_NAL_HEADERS[header_index == 4 ? 3 : header_index]);
+
+	auto state = seed * 2654435761u + 1;
+	for (auto i = 0u; i < size; ++i) {
+		state ^= state << 13;
+		state ^= state >> 17;
+		state ^= state << 5;
+		access_unit.push_back((uint8_t)(state | 1));
+	}
+}
+
+static void BuildAccessUnit(std::vector<uint8_t>& access_unit, const StreamShape& shape,
+							uint32_t frame_index) {
+	access_unit.clear();
+	auto seed = frame_index * 16;
+	if (frame_index % shape.gop_length != 0) {
+		auto size = shape.frame_size / 2 + frame_index * 7919 % (shape.frame_size + 1);
+		AppendNalUnit(access_unit, shape, 4, size, seed);
+		return;
+	}
+
+	auto is_hevc = shape.codec == EncoderCodec::HEVC;
+	if (is_hevc)
+		AppendNalUnit(access_unit, shape, 0, PARAMETER_SET_PAYLOAD, seed++);
+	AppendNalUnit(access_unit, shape, is_hevc ? 1 : 0, PARAMETER_SET_PAYLOAD, seed++);
+	AppendNalUnit(access_unit, shape, is_hevc ? 2 : 1, PARAMETER_SET_PAYLOAD, seed++);
+	for (auto slice = 0u; slice < KEYFRAME_SLICE_COUNT; ++slice)
+		AppendNalUnit(access_unit, shape, is_hevc ? 3 : 2,
+					  shape.keyframe_size / KEYFRAME_SLICE_COUNT, seed++);
+}
+
+static void Receive(UdpSocket& socket, const StreamShape& shape, const EncoderConfig& config,
+					const std::atomic<bool>& sending, RtpDepacketizer& depacketizer,
+					ReceiverStats& stats) {
+	std::vector<uint8_t> packet(RECEIVE_BUFFER_SIZE);
+	std::vector<uint8_t> expected;
+	auto ticks_per_frame = (uint64_t)RTP_CLOCK_RATE * config.frame_rate_den;
+	while (true) {
+		auto size = socket.Receive(packet, RECEIVE_TIMEOUT_MS);
+		if (!size) {
+			if (!sending.load(std::memory_order_acquire))
+				return;
+			continue;
+		}
+
+		if (!depacketizer.Push(std::span{packet}.first(size)))
+			continue;
+
+		auto frame_index = (uint32_t)(((uint64_t)depacketizer.timestamp * config.frame_rate_num
+									   + ticks_per_frame / 2)
+									  / ticks_per_frame);
+		BuildAccessUnit(expected, shape, frame_index);
+		if (depacketizer.access_unit == expected)
+			++stats.verified_frames;
+		else
+			++stats.mismatched_frames;
+	}
+}
+
+int main(int argc, char** argv) {
+	auto frame_count = 600u;
+	StreamShape shape{.codec		 = EncoderCodec::H264,
+					  .gop_length	 = 60,
+					  .keyframe_size = 256 * 1024,
+					  .frame_size	 = 16 * 1024};
+	EncoderConfig config{.codec = EncoderCodec::H264, .width = 1920, .height = 1080};
+	RtpConfig rtp_config{};
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--hevc") == 0)
+			shape.codec = EncoderCodec::HEVC;
+		else if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value)
+			config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--mtu") == 0 && has_value)
+			rtp_config.max_packet_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--gop") == 0 && has_value)
+			shape.gop_length = std::max(1u, (uint32_t)strtoul(argv[++i], nullptr, 10));
+		else if (strcmp(argv[i], "--keyframe-bytes") == 0 && has_value)
+			shape.keyframe_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--frame-bytes") == 0 && has_value)
+			shape.frame_size = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr,
+					"usage: %s [--hevc] [--frames <n>] [--fps <n>] [--mtu <bytes>] [--gop <n>]\n"
+					"          [--keyframe-bytes <n>] [--frame-bytes <n>]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	config.codec = shape.codec;
+
+	try {
+		UdpSocket receiver{0};
+		RtpDepacketizer depacketizer{shape.codec};
+		ReceiverStats receiver_stats{};
+		std::atomic<bool> sending = true;
+		std::thread receive_thread{[&] {
+			Receive(receiver, shape, config, sending, depacketizer, receiver_stats);
+		}};
+
+		RtpSender sender{"127.0.0.1", receiver.GetLocalPort(), config, rtp_config};
+		std::vector<uint8_t> access_unit;
+		auto frame_interval = std::chrono::nanoseconds(1'000'000'000ull * config.frame_rate_den
+													   / config.frame_rate_num);
+		auto start			= std::chrono::steady_clock::now();
+		for (auto frame = 0u; frame < frame_count; ++frame) {
+			std::this_thread::sleep_until(start + frame_interval * frame);
+			BuildAccessUnit(access_unit, shape, frame);
+			sender.Send(EncodedFrame{
+				.data		 = access_unit.data(),
+				.size		 = (uint32_t)access_unit.size(),
+				.frame_index = frame,
+				.timestamp	 = frame,
+				.keyframe	 = frame % shape.gop_length == 0,
+			});
+		}
+		sender.Flush();
+		auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+		sending.store(false, std::memory_order_release);
+		receive_thread.join();
+
+		auto sender_stats		= sender.GetStats();
+		auto packetizer_stats	= sender.GetPacketizerStats();
+		auto depacketizer_stats = depacketizer.GetStats();
+		printf("%s, %u frames at %u/%u fps, mtu %u, %.1f s\n",
+			   shape.codec == EncoderCodec::HEVC ? "hevc" : "h264", frame_count,
+			   config.frame_rate_num, config.frame_rate_den, rtp_config.max_packet_size,
+			   seconds.count());
+		printf("sent %llu packets (%llu single, %llu fragments), %.1f Mbit/s, %.1f packets/call, "
+			   "%llu paced bursts, max queue %llu, failed %llu\n",
+			   (unsigned long long)sender_stats.datagrams,
+			   (unsigned long long)packetizer_stats.single_packets,
+			   (unsigned long long)packetizer_stats.fragment_packets,
+			   sender_stats.bytes * 8 / seconds.count() / 1e6,
+			   sender_stats.send_calls ? (double)sender_stats.datagrams / sender_stats.send_calls
+									   : 0.0,
+			   (unsigned long long)sender_stats.paced_bursts,
+			   (unsigned long long)sender_stats.max_queued_frames,
+			   (unsigned long long)sender_stats.failed_datagrams);
+		printf("received %llu packets, %llu frames verified, %llu mismatched, %llu discarded, "
+			   "%llu lost packets\n",
+			   (unsigned long long)depacketizer_stats.packets,
+			   (unsigned long long)receiver_stats.verified_frames,
+			   (unsigned long long)receiver_stats.mismatched_frames,
+			   (unsigned long long)depacketizer_stats.discarded_frames,
+			   (unsigned long long)depacketizer_stats.lost_packets);
+		return receiver_stats.verified_frames == frame_count ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "rtp loopback failed\n");
+		return 1;
+	}
+}
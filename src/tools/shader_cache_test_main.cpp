@@ -0,0 +1,167 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "graphics/shader_cache.h"
+
+constexpr uint32_t SHADER_COUNT		 = 6;
+constexpr uint32_t COMPILE_THREADS	 = 4;
+constexpr const char* COMMON_INCLUDE = "inc/common.hlsli";
+
+static std::atomic<uint32_t> compile_count = 0;
+static uint32_t compile_milliseconds	   = 5;
+
+struct StepResult {
+	double milliseconds;
+	bool passed;
+};
+
+static std::string ReadText(const std::filesystem::path& path) {
+	std::ifstream input{path, std::ios::binary};
+	std::stringstream text;
+	text << input.rdbuf();
+	return text.str();
+}
+
+static void WriteText(const std::filesystem::path& path, const char* text) {
+	std::ofstream output{path, std::ios::binary | std::ios::trunc};
+	output << text;
+	if (!output)
+		throw;
+}
+
+static std::string GetExpectedBlob(const ShaderDesc& desc) {
+	auto source = ReadText(desc.source_path);
+	auto blob	= desc.entry + ":" + desc.target + ":" + std::to_string(desc.flags) + ":" + source;
+	if (source.find(COMMON_INCLUDE) != std::string::npos)
+		blob += ReadText(desc.source_path.parent_path() / COMMON_INCLUDE);
+	return blob;
+}
+
+static std::vector<uint8_t> CompileStub(const ShaderDesc& desc) {
+	compile_count.fetch_add(1, std::memory_order_relaxed);
+	std::this_thread::sleep_for(std::chrono::milliseconds(compile_milliseconds));
+	auto blob = GetExpectedBlob(desc);
+	return {blob.begin(), blob.end()};
+}
+
+static StepResult RunStep(const char* name, const std::filesystem::path& pack_path,
+						  std::span<const ShaderDesc> descs, JobSystem* job_system,
+						  uint32_t expected_compiles) {
+	compile_count = 0;
+	auto start	  = std::chrono::steady_clock::now();
+	ShaderCache cache{pack_path, CompileStub, job_system};
+	auto blobs	 = cache.Load(descs);
+	auto elapsed = std::chrono::steady_clock::now() - start;
+
+	auto fresh = true;
+	for (auto i = 0u; i < descs.size(); ++i) {
+		auto expected = GetExpectedBlob(descs[i]);
+		if (blobs[i].size() != expected.size()
+			|| memcmp(blobs[i].data(), expected.data(), expected.size()) != 0)
+			fresh = false;
+	}
+
+	auto stats	= cache.GetStats();
+	auto passed = fresh && compile_count == expected_compiles
+			   && stats.compiled_shaders == expected_compiles
+			   && stats.pack_hits == descs.size() - expected_compiles
+			   && stats.pack_writes == (expected_compiles ? 1u : 0u);
+	StepResult result{
+		.milliseconds = std::chrono::duration<double, std::milli>(elapsed).count(),
+		.passed		  = passed,
+	};
+	printf("%-16s %u compiled (expected %u), %u hits, %u writes, %7.1f ms%s %s\n", name,
+		   compile_count.load(), expected_compiles, stats.pack_hits, stats.pack_writes,
+		   result.milliseconds, fresh ? "" : ", stale blob", passed ? "ok" : "FAILED");
+	return result;
+}
+
+static void CorruptPack(const std::filesystem::path& pack_path, uint64_t offset, uint64_t size) {
+	std::fstream pack{pack_path, std::ios::in | std::ios::out | std::ios::binary};
+	pack.seekp((std::streamoff)offset);
+	pack.write(std::string(size, 'x').data(), (std::streamsize)size);
+	if (!pack)
+		throw;
+}
+
+int main(int argc, char** argv) {
+	std::filesystem::path directory = "shader_cache_test";
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--directory") == 0 && has_value)
+			directory = argv[++i];
+		else if (strcmp(argv[i], "--compile-ms") == 0 && has_value)
+			compile_milliseconds = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--directory <dir>] [--compile-ms <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	try {
+		std::filesystem::remove_all(directory);
+		std::filesystem::create_directories(directory / "inc");
+		WriteText(directory / COMMON_INCLUDE, "float4 Shade();\n");
+		WriteText(directory / "quoted.hlsl", "  #  include \"inc/common.hlsli\"\nvoid main() {}\n");
+		WriteText(directory / "angled.hlsl", "#include <inc/common.hlsli>\nvoid main() {}\n");
+		WriteText(directory / "plain.hlsl", "void main() {}\n");
+
+		const char* sources[]{"quoted.hlsl", "angled.hlsl", "plain.hlsl"};
+		std::vector<ShaderDesc> descs;
+		for (auto i = 0u; i < SHADER_COUNT; ++i)
+			descs.push_back(ShaderDesc{
+				.source_path = directory / sources[i % std::size(sources)],
+				.entry		 = "main" + std::to_string(i),
+				.target		 = i % 2 ? "ps_5_0" : "vs_5_0",
+			});
+
+		JobSystem job_system{JobSystemConfig{.thread_count = COMPILE_THREADS}};
+		auto pack_path = directory / "shaders.pack";
+		auto run = [&](const char* name, uint32_t expected_compiles) {
+			return RunStep(name, pack_path, descs, &job_system, expected_compiles);
+		};
+
+		auto serial = RunStep("cold serial", pack_path, descs, nullptr, SHADER_COUNT);
+		auto passed = serial.passed;
+		passed		= run("warm", 0).passed && passed;
+
+		std::filesystem::remove(pack_path);
+		auto parallel = run("cold parallel", SHADER_COUNT);
+		passed		  = parallel.passed && passed;
+
+		WriteText(directory / COMMON_INCLUDE, "float4 Shade(float2 uv);\n");
+		passed = run("include changed", 4).passed && passed;
+		passed = run("warm again", 0).passed && passed;
+
+		WriteText(directory / "plain.hlsl", "void main() { return; }\n");
+		passed = run("source changed", 2).passed && passed;
+
+		descs[1].flags = 1;
+		passed		   = run("flags changed", 1).passed && passed;
+
+		CorruptPack(pack_path, 0, sizeof(uint32_t));
+		passed = run("bad magic", SHADER_COUNT).passed && passed;
+
+		std::filesystem::resize_file(pack_path, std::filesystem::file_size(pack_path) - 1);
+		passed = run("truncated", SHADER_COUNT).passed && passed;
+		passed = run("warm final", 0).passed && passed;
+
+		printf("parallel cold load %.1fx faster than serial with %u threads, pack %llu bytes\n",
+			   serial.milliseconds / parallel.milliseconds, COMPILE_THREADS,
+			   (unsigned long long)std::filesystem::file_size(pack_path));
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "shader cache test failed\n");
+		return 1;
+	}
+}
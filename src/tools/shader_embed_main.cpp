@@ -0,0 +1,60 @@
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+
+#include "content_hash.h"
+#include "graphics/shader_cache.h"
+#include "mapped_file.h"
+
+int main(int argc, char** argv) {
+	if (argc != 8) {
+		fprintf(stderr,
+				"usage: %s <output.h> <SYMBOL> <bytecode.cso> <source.hlsl> <entry> <target> "
+				"<flags>\n",
+				argv[0]);
+		return 1;
+	}
+
+	try {
+		std::string symbol = argv[2];
+		MappedFile bytecode{argv[3]};
+		ShaderDesc desc{
+			.source_path = argv[4],
+			.entry		 = argv[5],
+			.target		 = argv[6],
+			.flags		 = (uint32_t)strtoul(argv[7], nullptr, 0),
+		};
+		auto source_hash   = HashShaderDesc(desc);
+		auto bytecode_hash = HashBytes(CONTENT_HASH_SEED, {bytecode.data, bytecode.size});
+
+		std::string text = "#pragma once\n\n#include \"graphics/embedded_shader.h\"\n\n";
+		text += "alignas(16) constexpr uint8_t " + symbol + "_BYTECODE[]{";
+		for (auto i = 0u; i < bytecode.size; ++i) {
+			char byte[8];
+			snprintf(byte, sizeof(byte), "0x%02x,", bytecode.data[i]);
+			text += i % 16 ? " " : "\n\t";
+			text += byte;
+		}
+
+		text += "\n};\n\nconstexpr EmbeddedShader " + symbol + "{\n\t.bytecode      = " + symbol
+			  + "_BYTECODE,\n";
+		char hashes[96];
+		snprintf(hashes, sizeof(hashes),
+				 "\t.source_hash   = 0x%016llxull,\n\t.bytecode_hash = 0x%016llxull,\n};\n",
+				 (unsigned long long)source_hash, (unsigned long long)bytecode_hash);
+		text += hashes;
+
+		std::ofstream output{argv[1], std::ios::binary | std::ios::trunc};
+		output.write(text.data(), (std::streamsize)text.size());
+		if (!output)
+			throw;
+
+		printf("%s: %zu bytes, source %016llx, bytecode %016llx\n", symbol.c_str(), bytecode.size,
+			   (unsigned long long)source_hash, (unsigned long long)bytecode_hash);
+		return 0;
+	} catch (...) {
+		fprintf(stderr, "failed to embed %s\n", argv[3]);
+		return 1;
+	}
+}
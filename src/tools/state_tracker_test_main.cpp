@@ -0,0 +1,200 @@
+#include <cstdio>
+#include <string>
+#include <vector>
+
+#include "graphics/resource_state_tracker.h"
+
+constexpr uint32_t SCENE_TARGET		  = 0;
+constexpr uint32_t BACK_BUFFER		  = 1;
+constexpr uint32_t MIP_CHAIN		  = 2;
+constexpr uint32_t MIP_CHAIN_LEVELS	  = 4;
+constexpr uint32_t FRAME_SCRIPT_COUNT = 2;
+
+constexpr const char* STATE_NAMES[]{"Common", "RenderTarget", "CopySource", "CopyDest", "Present"};
+
+struct TestTexture {
+	const char* name;
+};
+
+enum class StepType { Transition, BeginSplit, Flush };
+
+struct ScriptStep {
+	StepType type;
+	uint32_t texture;
+	ResourceState state;
+	uint32_t subresource;
+};
+
+struct Script {
+	const char* name;
+	std::vector<ScriptStep> steps;
+	const char* expected;
+	uint64_t expected_elided;
+};
+
+struct RecordingCommandList {
+	std::string batches;
+
+	void Barrier(std::span<const TextureTransition<TestTexture>> transitions) {
+		batches += batches.empty() ? "[" : " [";
+		for (auto& transition : transitions) {
+			if (&transition != transitions.data())
+				batches += ", ";
+			batches += transition.texture->name;
+			if (transition.subresource != ALL_SUBRESOURCES)
+				batches += "/" + std::to_string(transition.subresource);
+			batches += " ";
+			batches += STATE_NAMES[(uint32_t)transition.before];
+			batches += "->";
+			batches += STATE_NAMES[(uint32_t)transition.after];
+			if (transition.split == BarrierSplit::Begin)
+				batches += " begin";
+			else if (transition.split == BarrierSplit::End)
+				batches += " end";
+		}
+		batches += "]";
+	}
+};
+
+static ScriptStep Transition(uint32_t texture, ResourceState state,
+							 uint32_t subresource = ALL_SUBRESOURCES) {
+	return ScriptStep{StepType::Transition, texture, state, subresource};
+}
+
+static ScriptStep BeginSplit(uint32_t texture, ResourceState state,
+							 uint32_t subresource = ALL_SUBRESOURCES) {
+	return ScriptStep{StepType::BeginSplit, texture, state, subresource};
+}
+
+static ScriptStep Flush() {
+	return ScriptStep{StepType::Flush};
+}
+
+static std::vector<Script> BuildScripts() {
+	std::vector<Script> scripts;
+	std::vector<ScriptStep> frame;
+	for (auto i = 0u; i < FRAME_SCRIPT_COUNT; ++i)
+		frame.insert(frame.end(), {
+									  Transition(SCENE_TARGET, ResourceState::RenderTarget),
+									  Flush(),
+									  Transition(SCENE_TARGET, ResourceState::CopySource),
+									  Transition(BACK_BUFFER, ResourceState::CopyDest),
+									  Flush(),
+									  Transition(SCENE_TARGET, ResourceState::Common),
+									  Transition(BACK_BUFFER, ResourceState::Present),
+									  Flush(),
+								  });
+	scripts.push_back(Script{
+		.name	  = "frame",
+		.steps	  = frame,
+		.expected = "[scene Common->RenderTarget] "
+					"[scene RenderTarget->CopySource, back Present->CopyDest] "
+					"[scene CopySource->Common, back CopyDest->Present] "
+					"[scene Common->RenderTarget] "
+					"[scene RenderTarget->CopySource, back Present->CopyDest] "
+					"[scene CopySource->Common, back CopyDest->Present]",
+	});
+
+	scripts.push_back(Script{
+		.name	  = "merge",
+		.steps	  = {Transition(SCENE_TARGET, ResourceState::RenderTarget),
+					 Transition(BACK_BUFFER, ResourceState::CopyDest), Flush(),
+					 Transition(SCENE_TARGET, ResourceState::CopySource),
+					 Transition(SCENE_TARGET, ResourceState::CopyDest), Flush()},
+		.expected = "[scene Common->RenderTarget, back Present->CopyDest] "
+					"[scene RenderTarget->CopyDest]",
+	});
+
+	scripts.push_back(Script{
+		.name			 = "redundant",
+		.steps			 = {Transition(SCENE_TARGET, ResourceState::RenderTarget), Flush(),
+							Transition(SCENE_TARGET, ResourceState::RenderTarget), Flush(),
+							Transition(SCENE_TARGET, ResourceState::Common),
+							Transition(SCENE_TARGET, ResourceState::RenderTarget), Flush(),
+							Transition(BACK_BUFFER, ResourceState::Present), Flush()},
+		.expected		 = "[scene Common->RenderTarget] [] [] []",
+		.expected_elided = 3,
+	});
+
+	scripts.push_back(Script{
+		.name	  = "subresources",
+		.steps	  = {Transition(MIP_CHAIN, ResourceState::CopyDest, 1), Flush(),
+					 Transition(MIP_CHAIN, ResourceState::CopySource), Flush(),
+					 Transition(MIP_CHAIN, ResourceState::Common), Flush(),
+					 Transition(MIP_CHAIN, ResourceState::CopyDest, 2),
+					 Transition(MIP_CHAIN, ResourceState::CopyDest, 3), Flush(),
+					 Transition(MIP_CHAIN, ResourceState::CopyDest, 2), Flush()},
+		.expected = "[mips/1 Common->CopyDest] "
+					"[mips/0 Common->CopySource, mips/1 CopyDest->CopySource, "
+					"mips/2 Common->CopySource, mips/3 Common->CopySource] "
+					"[mips CopySource->Common] "
+					"[mips/2 Common->CopyDest, mips/3 Common->CopyDest] []",
+		.expected_elided = 1,
+	});
+
+	scripts.push_back(Script{
+		.name	  = "split",
+		.steps	  = {BeginSplit(BACK_BUFFER, ResourceState::CopyDest), Flush(), Flush(),
+					 Transition(BACK_BUFFER, ResourceState::CopyDest), Flush(),
+					 BeginSplit(BACK_BUFFER, ResourceState::Present), Flush(),
+					 Transition(BACK_BUFFER, ResourceState::CopySource), Flush(),
+					 BeginSplit(MIP_CHAIN, ResourceState::RenderTarget), Flush(),
+					 Transition(MIP_CHAIN, ResourceState::CopyDest), Flush()},
+		.expected = "[back Present->CopyDest begin] [] "
+					"[back Present->CopyDest end] "
+					"[back CopyDest->Present begin] "
+					"[back CopyDest->Present end, back Present->CopySource] "
+					"[mips Common->RenderTarget begin] "
+					"[mips Common->RenderTarget end, mips RenderTarget->CopyDest]",
+	});
+	return scripts;
+}
+
+static bool RunScript(const Script& script) {
+	TestTexture textures[]{{"scene"}, {"back"}, {"mips"}};
+	ResourceStateTracker<TestTexture> tracker;
+	tracker.RegisterTexture(&textures[SCENE_TARGET], ResourceState::Common);
+	tracker.RegisterTexture(&textures[BACK_BUFFER], ResourceState::Present);
+	tracker.RegisterTexture(&textures[MIP_CHAIN], ResourceState::Common, MIP_CHAIN_LEVELS);
+
+	RecordingCommandList command_list;
+	for (auto& step : script.steps) {
+		auto texture = &textures[step.texture];
+		if (step.type == StepType::Transition)
+			tracker.Transition(texture, step.state, step.subresource);
+		else if (step.type == StepType::BeginSplit)
+			tracker.BeginSplitTransition(texture, step.state, step.subresource);
+		else {
+			auto batch_length = command_list.batches.size();
+			tracker.Flush(command_list);
+			if (command_list.batches.size() == batch_length)
+				command_list.batches += batch_length ? " []" : "[]";
+		}
+	}
+
+	auto stats	= tracker.GetStats();
+	auto passed = command_list.batches == script.expected
+			   && stats.elided_transitions == script.expected_elided;
+	printf("%-12s %llu requested, %llu barriers, %llu elided, %llu split, %llu flushes %s\n",
+		   script.name, (unsigned long long)stats.requested_transitions,
+		   (unsigned long long)stats.emitted_barriers,
+		   (unsigned long long)stats.elided_transitions, (unsigned long long)stats.split_barriers,
+		   (unsigned long long)stats.flushes, passed ? "ok" : "FAILED");
+	if (!passed)
+		printf("  expected %s (%llu elided)\n  got      %s\n", script.expected,
+			   (unsigned long long)script.expected_elided, command_list.batches.c_str());
+	return passed;
+}
+
+int main() {
+	try {
+		auto passed = true;
+		for (auto& script : BuildScripts())
+			passed = RunScript(script) && passed;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "state tracker test failed\n");
+		return 1;
+	}
+}
@@ -0,0 +1,119 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "stream_host.h"
+
+constexpr uint32_t SWEEP_STREAM_COUNTS[]{1, 2, 4, 8, 16, 32, 64};
+constexpr double MIN_FAIRNESS = 0.95;
+
+static bool RunHost(const StreamHostConfig& config, double seconds) {
+	StreamHost host{config};
+	auto start = std::chrono::steady_clock::now();
+	host.Run(std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::duration<double>(seconds)));
+	auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	uint64_t frames			 = 0;
+	uint64_t bytes			 = 0;
+	uint64_t coalesced_ticks = 0;
+	uint64_t latency		 = 0;
+	uint64_t max_latency	 = 0;
+	uint64_t min_frames		 = UINT64_MAX;
+	uint64_t max_frames		 = 0;
+	auto sum_squares		 = 0.0;
+	for (auto i = 0u; i < host.GetStreamCount(); ++i) {
+		auto stats	= host.GetStreamStats(i);
+		max_latency = std::max(max_latency, stats.max_latency_nanoseconds);
+		min_frames	= std::min(min_frames, stats.frames);
+		max_frames	= std::max(max_frames, stats.frames);
+		frames += stats.frames;
+		bytes += stats.bytes;
+		latency += stats.latency_nanoseconds;
+		coalesced_ticks += stats.coalesced_ticks;
+		sum_squares += (double)stats.frames * stats.frames;
+	}
+
+	auto scheduler = host.GetSchedulerStats();
+	auto loop	   = host.GetEventLoopStats();
+	auto jobs	   = host.GetJobSystemStats();
+	auto fairness  = sum_squares ? (double)frames * frames / (config.stream_count * sum_squares)
+								  : 0.0;
+	printf("%3u streams %8.0f frames/s (%7.1f per stream, min %llu max %llu), fairness %.3f, "
+		   "latency mean %.2f ms max %.2f ms, coalesced %llu, budget waits %llu, "
+		   "%.1f resumes/poll, %.1f MB/s, %llu jobs on %u workers\n",
+		   config.stream_count, frames / elapsed, frames / elapsed / config.stream_count,
+		   (unsigned long long)min_frames, (unsigned long long)max_frames, fairness,
+		   frames ? latency / 1e6 / frames : 0.0, max_latency / 1e6,
+		   (unsigned long long)coalesced_ticks, (unsigned long long)scheduler.budget_waits,
+		   loop.polls ? (double)loop.resumes / loop.polls : 0.0, bytes / elapsed / 1e6,
+		   (unsigned long long)jobs.executed_jobs, jobs.thread_count);
+	return min_frames && fairness >= MIN_FAIRNESS && scheduler.completed_frames == frames
+		&& scheduler.max_inflight <= config.scheduler.max_inflight_frames;
+}
+
+int main(int argc, char** argv) {
+	StreamHostConfig config{.stream_count = 4};
+	auto seconds = 2.0;
+	auto sweep	 = false;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--streams") == 0 && has_value)
+			config.stream_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--seconds") == 0 && has_value)
+			seconds = strtod(argv[++i], nullptr);
+		else if (strcmp(argv[i], "--fps") == 0 && has_value)
+			config.encoder_config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--size") == 0 && i + 2 < argc) {
+			config.encoder_config.width	 = (uint32_t)strtoul(argv[++i], nullptr, 10);
+			config.encoder_config.height = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		}
+		else if (strcmp(argv[i], "--inflight") == 0 && has_value)
+			config.scheduler.max_inflight_frames = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--output") == 0 && has_value)
+			config.output_pattern = argv[++i];
+		else if (strcmp(argv[i], "--mesh") == 0 && has_value)
+			config.mesh_path = argv[++i];
+		else if (strcmp(argv[i], "--draws") == 0 && has_value)
+			config.draw_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--workers") == 0 && has_value)
+			config.worker_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--unpaced") == 0)
+			config.paced = false;
+		else if (strcmp(argv[i], "--sweep") == 0)
+			sweep = true;
+		else {
+			fprintf(stderr,
+					"usage: %s [--streams <n>] [--seconds <n>] [--fps <n>] [--size <w> <h>]\n"
+					"          [--inflight <n>] [--output <pattern-with-%%u>] [--mesh <file>]\n"
+					"          [--draws <n>] [--workers <n>] [--unpaced] [--sweep]\n",
+					argv[0]);
+			return 1;
+		}
+	}
+	if (!config.stream_count || !config.encoder_config.frame_rate_num)
+		return 1;
+
+	try {
+		printf("%ux%u, %s, inflight budget %u frames (%u per stream)\n",
+			   config.encoder_config.width, config.encoder_config.height,
+			   config.paced ? "paced" : "unpaced", config.scheduler.max_inflight_frames,
+			   config.scheduler.max_stream_inflight);
+		auto passed = true;
+		if (!sweep)
+			passed = RunHost(config, seconds);
+		else
+			for (auto stream_count : SWEEP_STREAM_COUNTS) {
+				config.stream_count = stream_count;
+				passed				= RunHost(config, seconds) && passed;
+			}
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "stream host failed\n");
+		return 1;
+	}
+}
@@ -0,0 +1,149 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <optional>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "encoder/encoder_config.h"
+#include "encoder/nal_parser.h"
+#include "encoder/ts_muxer.h"
+#include "encoder/ts_sender.h"
+#include "mapped_file.h"
+
+constexpr uint32_t H264_NAL_IDR			= 5;
+constexpr uint32_t HEVC_NAL_IRAP_BEGIN	= 16;
+constexpr uint32_t HEVC_NAL_IRAP_END	= 23;
+constexpr uint32_t DEFAULT_REPEAT_COUNT	= 10;
+
+static bool IsKeyframe(EncoderCodec codec, std::span<const uint8_t> access_unit) {
+	std::span<const uint8_t> nal_unit;
+	while (NextNalUnit(access_unit, nal_unit)) {
+		auto type = GetNalUnitType(codec, nal_unit);
+		if (codec == EncoderCodec::HEVC ? type >= HEVC_NAL_IRAP_BEGIN && type <= HEVC_NAL_IRAP_END
+										: type == H264_NAL_IDR)
+			return true;
+	}
+	return false;
+}
+
+int main(int argc, char** argv) {
+	if (argc < 2) {
+		fprintf(stderr,
+				"usage: %s <input.h264|input.h265> [--hevc] [--fps <n>] [--repeat <n>]\n"
+				"          [--output <file.ts>] [--udp <host:port>]\n",
+				argv[0]);
+		return 1;
+	}
+
+	EncoderConfig config{.codec = EncoderCodec::H264, .width = 0, .height = 0};
+	auto repeat_count		= DEFAULT_REPEAT_COUNT;
+	const char* output_path = nullptr;
+	std::string udp_host;
+	uint16_t udp_port = 0;
+	for (auto i = 2; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--hevc") == 0)
+			config.codec = EncoderCodec::HEVC;
+		else if (strcmp(argv[i], "--fps") == 0 && has_value)
+			config.frame_rate_num = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--repeat") == 0 && has_value)
+			repeat_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--output") == 0 && has_value)
+			output_path = argv[++i];
+		else if (strcmp(argv[i], "--udp") == 0 && has_value) {
+			std::string destination = argv[++i];
+			auto separator			= destination.rfind(':');
+			if (separator == std::string::npos)
+				return 1;
+			udp_host = destination.substr(0, separator);
+			udp_port = (uint16_t)strtoul(destination.c_str() + separator + 1, nullptr, 10);
+		}
+	}
+
+	try {
+		MappedFile input{argv[1]};
+		std::vector<std::span<const uint8_t>> access_units;
+		std::vector<bool> keyframes;
+		std::span<const uint8_t> stream{input.data, input.size};
+		std::span<const uint8_t> access_unit;
+		while (NextAccessUnit(config.codec, stream, access_unit)) {
+			access_units.push_back(access_unit);
+			keyframes.push_back(IsKeyframe(config.codec, access_unit));
+		}
+		if (access_units.empty())
+			throw;
+
+		auto file = output_path ? fopen(output_path, "wb") : nullptr;
+		if (output_path && !file)
+			throw;
+
+		TsMuxer muxer{config};
+		std::vector<uint8_t> output;
+		uint64_t input_bytes = 0;
+		auto frame			 = 0u;
+		auto start			 = std::chrono::steady_clock::now();
+		for (auto repeat = 0u; repeat < repeat_count; ++repeat)
+			for (size_t i = 0; i < access_units.size(); ++i, ++frame) {
+				output.clear();
+				muxer.Mux(EncodedFrame{.data		= access_units[i].data(),
+									   .size		= (uint32_t)access_units[i].size(),
+									   .frame_index = frame,
+									   .timestamp	= frame,
+									   .keyframe	= keyframes[i]},
+						  output);
+				input_bytes += access_units[i].size();
+				if (file)
+					fwrite(output.data(), 1, output.size(), file);
+			}
+		auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+		if (file)
+			fclose(file);
+
+		auto stats = muxer.GetStats();
+		printf("%s, %zu access units x %u, %llu frames in %.1f ms\n",
+			   config.codec == EncoderCodec::HEVC ? "hevc" : "h264", access_units.size(),
+			   repeat_count, (unsigned long long)stats.frames, seconds.count() * 1000.0);
+		printf("muxed %llu bytes into %llu packets (%llu psi, %llu pcr, %llu null), "
+			   "%.2f%% overhead, %.0f frames/s, %.1f MB/s\n",
+			   (unsigned long long)input_bytes, (unsigned long long)stats.packets,
+			   (unsigned long long)stats.psi_packets, (unsigned long long)stats.pcr_packets,
+			   (unsigned long long)stats.null_packets,
+			   input_bytes ? 100.0 * (stats.bytes - input_bytes) / input_bytes : 0.0,
+			   stats.frames / seconds.count(), input_bytes / seconds.count() / 1e6);
+
+		if (!udp_port)
+			return 0;
+
+		TsSender sender{udp_host.c_str(), udp_port, config};
+		auto frame_interval = std::chrono::nanoseconds(1'000'000'000ull * config.frame_rate_den
+													   / config.frame_rate_num);
+		start				= std::chrono::steady_clock::now();
+		for (size_t i = 0; i < access_units.size(); ++i) {
+			std::this_thread::sleep_until(start + frame_interval * i);
+			sender.Send(EncodedFrame{.data		  = access_units[i].data(),
+									 .size		  = (uint32_t)access_units[i].size(),
+									 .frame_index = (uint32_t)i,
+									 .timestamp	  = i,
+									 .keyframe	  = keyframes[i]});
+		}
+		sender.Flush();
+		seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		auto sender_stats = sender.GetStats();
+		printf("sent %llu datagrams to %s:%u in %.1f s, %.1f Mbit/s, %.1f datagrams/call, "
+			   "failed %llu\n",
+			   (unsigned long long)sender_stats.datagrams, udp_host.c_str(), udp_port,
+			   seconds.count(), sender_stats.bytes * 8 / seconds.count() / 1e6,
+			   sender_stats.send_calls ? (double)sender_stats.datagrams / sender_stats.send_calls
+									   : 0.0,
+			   (unsigned long long)sender_stats.failed_datagrams);
+		return sender_stats.failed_datagrams ? 1 : 0;
+	} catch (...) {
+		fprintf(stderr, "failed to mux %s\n", argv[1]);
+		return 1;
+	}
+}
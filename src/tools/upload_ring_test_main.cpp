@@ -0,0 +1,219 @@
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <random>
+#include <span>
+#include <vector>
+
+#include "graphics/upload_ring.h"
+
+constexpr uint32_t FRAMES_IN_FLIGHT	  = 3;
+constexpr uint64_t FRAME_SIZE		  = 64 * 1024;
+constexpr uint64_t FRAME_BUDGET		  = 48 * 1024;
+constexpr uint64_t MAX_UPLOAD_SIZE	  = 4096;
+constexpr uint32_t MAX_ALIGNMENT_LOG2 = 9;
+constexpr uint32_t MAX_STALL_FRAMES	  = 8;
+
+struct TestFence {
+	uint64_t completed_value = 0;
+
+	uint64_t GetCompletedValue() const {
+		return completed_value;
+	}
+};
+
+struct Submission {
+	uint32_t fence_index;
+	uint64_t fence_value;
+};
+
+struct LiveRange {
+	uint64_t offset;
+	uint64_t size;
+	uint64_t frame;
+};
+
+struct SequenceResult {
+	uint64_t allocation_count;
+	uint64_t wrap_count;
+	uint64_t peak_used_bytes;
+	uint64_t cpu_wait_count;
+	bool passed;
+};
+
+static bool Overlaps(const std::vector<LiveRange>& live, uint64_t offset, uint64_t size) {
+	for (auto& range : live)
+		if (offset < range.offset + range.size && range.offset < offset + size)
+			return true;
+	return false;
+}
+
+static bool Check(bool condition, const char* name, const char* what) {
+	if (!condition)
+		printf("%s: %s\n", name, what);
+	return condition;
+}
+
+static bool RunWrapCase() {
+	UploadRing ring{FRAMES_IN_FLIGHT * 4096, FRAMES_IN_FLIGHT};
+	TestFence fences[FRAMES_IN_FLIGHT];
+	TestFence* fence_pointers[FRAMES_IN_FLIGHT]{&fences[0], &fences[1], &fences[2]};
+
+	for (auto frame = 1u; frame <= FRAMES_IN_FLIGHT; ++frame) {
+		ring.Allocate(4000, 256);
+		ring.EndFrame(frame - 1, frame);
+	}
+	fences[0].completed_value = 1;
+	ring.RetireCompletedFrames(std::span<TestFence* const>{fence_pointers});
+
+	auto allocation = ring.Allocate(2500, 64);
+	auto stats		= ring.GetStats();
+	return Check(allocation.offset == 0, "wrap", "allocation did not wrap to 0")
+		&& Check(allocation.offset + allocation.size <= 4096, "wrap", "overwrote frame 2")
+		&& Check(stats.wrap_count == 1, "wrap", "wrap not counted")
+		&& Check(stats.pending_frame_count == 2, "wrap", "frame 1 not retired");
+}
+
+static bool RunStallCase() {
+	UploadRing ring{FRAMES_IN_FLIGHT * FRAME_SIZE, FRAMES_IN_FLIGHT};
+	TestFence fences[FRAMES_IN_FLIGHT];
+	TestFence* fence_pointers[FRAMES_IN_FLIGHT]{&fences[0], &fences[1], &fences[2]};
+	std::span<TestFence* const> fence_span{fence_pointers};
+
+	for (auto frame = 1u; frame <= FRAMES_IN_FLIGHT; ++frame) {
+		ring.Allocate(FRAME_SIZE, 256);
+		ring.EndFrame(frame - 1, frame);
+	}
+	ring.RetireCompletedFrames(fence_span);
+	if (!Check(ring.GetStats().pending_frame_count == 3, "stall", "retired an incomplete frame"))
+		return false;
+
+	fences[2].completed_value = 3;
+	ring.RetireCompletedFrames(fence_span);
+	if (!Check(ring.GetStats().pending_frame_count == 3, "stall", "retired frames out of order"))
+		return false;
+
+	fences[0].completed_value = 1;
+	ring.RetireCompletedFrames(fence_span);
+	auto stats		= ring.GetStats();
+	auto allocation = ring.Allocate(FRAME_SIZE, 256);
+
+	fences[1].completed_value = 2;
+	ring.RetireCompletedFrames(fence_span);
+	return Check(stats.pending_frame_count == 2, "stall", "frame 1 not retired")
+		&& Check(stats.used_bytes == 2 * FRAME_SIZE, "stall", "used bytes wrong")
+		&& Check(allocation.offset == 0, "stall", "frame 4 did not reuse frame 1")
+		&& Check(ring.GetStats().pending_frame_count == 0, "stall", "burst did not retire");
+}
+
+static SequenceResult RunSequence(uint32_t frame_count, uint32_t seed) {
+	std::mt19937 random{seed};
+	UploadRing ring{FRAMES_IN_FLIGHT * FRAME_SIZE, FRAMES_IN_FLIGHT};
+	TestFence fences[FRAMES_IN_FLIGHT];
+	TestFence* fence_pointers[FRAMES_IN_FLIGHT]{&fences[0], &fences[1], &fences[2]};
+	std::span<TestFence* const> fence_span{fence_pointers};
+	uint64_t slot_values[FRAMES_IN_FLIGHT]{};
+	std::deque<Submission> gpu_queue;
+	std::vector<LiveRange> live;
+	SequenceResult result{.passed = true};
+
+	auto complete_oldest = [&] {
+		auto submission = gpu_queue.front();
+		gpu_queue.pop_front();
+		fences[submission.fence_index].completed_value = submission.fence_value;
+	};
+
+	auto stall_frames = 0u;
+	for (uint64_t frame = 1; frame <= frame_count && result.passed; ++frame) {
+		auto slot = (uint32_t)((frame - 1) % FRAMES_IN_FLIGHT);
+		if (fences[slot].completed_value < slot_values[slot])
+			++result.cpu_wait_count;
+		while (fences[slot].completed_value < slot_values[slot])
+			complete_oldest();
+
+		ring.RetireCompletedFrames(fence_span);
+		auto pending	  = ring.GetStats().pending_frame_count;
+		auto oldest_frame = frame - pending;
+		result.passed	  = Check(pending == gpu_queue.size(), "sequence",
+								  "retired frames do not match completed fences");
+		std::erase_if(live, [&](const LiveRange& range) { return range.frame < oldest_frame; });
+
+		uint64_t frame_bytes = 0;
+		while (result.passed) {
+			auto size	   = 1 + random() % MAX_UPLOAD_SIZE;
+			auto alignment = (uint64_t)1 << (random() % MAX_ALIGNMENT_LOG2);
+			if (frame_bytes + size + alignment > FRAME_BUDGET)
+				break;
+			frame_bytes += size + alignment;
+
+			auto allocation = ring.Allocate(size, alignment);
+			if (allocation.offset % alignment || allocation.offset + size > ring.capacity
+				|| Overlaps(live, allocation.offset, size)) {
+				printf("sequence frame %llu: bad allocation %llu+%llu\n", (unsigned long long)frame,
+					   (unsigned long long)allocation.offset, (unsigned long long)size);
+				result.passed = false;
+			}
+			live.push_back(LiveRange{.offset = allocation.offset, .size = size, .frame = frame});
+		}
+
+		ring.EndFrame(slot, frame);
+		slot_values[slot] = frame;
+		gpu_queue.push_back(Submission{.fence_index = slot, .fence_value = frame});
+
+		if (stall_frames)
+			--stall_frames;
+		else if (random() % 64 == 0)
+			stall_frames = 1 + random() % MAX_STALL_FRAMES;
+		else
+			for (auto completions = random() % 3; completions && !gpu_queue.empty(); --completions)
+				complete_oldest();
+	}
+
+	auto stats				= ring.GetStats();
+	result.allocation_count = stats.allocation_count;
+	result.wrap_count		= stats.wrap_count;
+	result.peak_used_bytes	= stats.peak_used_bytes;
+	result.passed			= result.passed && stats.peak_used_bytes <= ring.capacity;
+	return result;
+}
+
+int main(int argc, char** argv) {
+	auto frame_count = 100000u;
+	auto seed		 = 1u;
+	for (auto i = 1; i < argc; ++i) {
+		auto has_value = i + 1 < argc;
+		if (strcmp(argv[i], "--frames") == 0 && has_value)
+			frame_count = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else if (strcmp(argv[i], "--seed") == 0 && has_value)
+			seed = (uint32_t)strtoul(argv[++i], nullptr, 10);
+		else {
+			fprintf(stderr, "usage: %s [--frames <n>] [--seed <n>]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	try {
+		auto wrap_passed  = RunWrapCase();
+		auto stall_passed = RunStallCase();
+		printf("wrap case %s, stall case %s\n", wrap_passed ? "ok" : "FAILED",
+			   stall_passed ? "ok" : "FAILED");
+
+		auto result = RunSequence(frame_count, seed);
+		printf("%u frames, %llu allocations, %llu wraps, peak %llu of %llu bytes, %llu CPU waits "
+			   "on frame fences\n",
+			   frame_count, (unsigned long long)result.allocation_count,
+			   (unsigned long long)result.wrap_count, (unsigned long long)result.peak_used_bytes,
+			   (unsigned long long)(FRAMES_IN_FLIGHT * FRAME_SIZE),
+			   (unsigned long long)result.cpu_wait_count);
+
+		auto passed = wrap_passed && stall_passed && result.passed && result.wrap_count > 0
+				   && result.cpu_wait_count > 0;
+		printf("%s\n", passed ? "passed" : "FAILED");
+		return passed ? 0 : 1;
+	} catch (...) {
+		fprintf(stderr, "upload ring test failed\n");
+		return 1;
+	}
+}
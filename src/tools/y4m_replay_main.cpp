@@ -0,0 +1,111 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include "encoder/encoder_config.h"
+#include "encoder/mock_frame_encoder.h"
+#include "encoder/y4m_file.h"
+#include "graphics/cpu_device.h"
+#include "graphics/cpu_frame_resources.h"
+
+constexpr uint32_t BUFFER_COUNT = 3;
+
+struct BitstreamSink {
+	FILE* file;
+	uint64_t access_units = 0;
+	uint64_t bytes		  = 0;
+
+	void WriteFrame(const void* data, uint32_t size) {
+		++access_units;
+		bytes += size;
+		if (file)
+			fwrite(data, 1, size, file);
+	}
+};
+
+int main(int argc, char** argv) {
+	if (argc < 3) {
+		fprintf(stderr, "usage: %s <input.y4m> <frame-count> [--nv12] [--output <file.h264>]\n",
+				argv[0]);
+		return 1;
+	}
+
+	auto frame_count		= (uint32_t)strtoul(argv[2], nullptr, 10);
+	auto format				= TextureFormat::B8G8R8A8Unorm;
+	const char* output_path = nullptr;
+	for (auto i = 3; i < argc; ++i) {
+		if (strcmp(argv[i], "--nv12") == 0)
+			format = TextureFormat::NV12;
+		else if (strcmp(argv[i], "--output") == 0 && i + 1 < argc)
+			output_path = argv[++i];
+	}
+
+	try {
+		Y4mReplaySource source{argv[1]};
+		auto width	   = source.header.width;
+		auto height	   = source.header.height;
+		auto footprint = GetTextureFootprint(width, height, format);
+
+		CpuDevice device;
+		CpuFrameResources frames{device, BUFFER_COUNT};
+		CpuTextureArray textures{device, BUFFER_COUNT, width, height, format};
+		CpuUploadBuffer upload_buffer{device, (uint32_t)(footprint.size * BUFFER_COUNT)};
+		MockFrameEncoder encoder{EncoderConfig{.width		   = width,
+											   .height		   = height,
+											   .frame_rate_num = source.header.frame_rate_num,
+											   .frame_rate_den = source.header.frame_rate_den},
+								 BUFFER_COUNT};
+		for (auto i = 0u; i < BUFFER_COUNT; ++i)
+			encoder.RegisterTexture(textures.textures[i], width, height,
+									TextureFormatToNvencFormat(format), frames.fences[i]);
+
+		BitstreamSink sink{.file = output_path ? fopen(output_path, "wb") : nullptr};
+		if (output_path && !sink.file)
+			throw;
+
+		auto start = std::chrono::steady_clock::now();
+		for (auto frame = 0u; frame < frame_count; ++frame) {
+			auto slot  = frame % BUFFER_COUNT;
+			auto fence = frames.fences[slot];
+			if (frame >= BUFFER_COUNT)
+				fence->Wait(frame + 1 - BUFFER_COUNT);
+			encoder.ProcessCompletedFrames(sink);
+
+			auto slot_footprint = GetTextureFootprint(width, height, format, slot * footprint.size);
+			source.ReadFrame(upload_buffer.mapped, slot_footprint);
+
+			auto command_lists = frames.GetCommandLists(slot);
+			command_lists.front().Reset();
+			command_lists.front().CopyBufferToTexture(textures.textures[slot], upload_buffer,
+													  slot_footprint);
+			command_lists.front().Close();
+			device.Execute(command_lists);
+			device.Signal(fence, frame + 1, frames.fence_events[slot]);
+			encoder.EncodeFrame(slot, frame + 1, frame, frame);
+		}
+		encoder.ProcessCompletedFrames(sink, true);
+		auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+		if (sink.file)
+			fclose(sink.file);
+
+		auto replay_stats  = source.GetStats();
+		auto encoder_stats = encoder.GetStats();
+		auto seconds	   = elapsed.count();
+		printf("%ux%u %s, %u source frames, %llu replayed (%llu loops)\n", width, height,
+			   format == TextureFormat::NV12 ? "nv12" : "bgra", source.frame_count,
+			   (unsigned long long)replay_stats.read_frames,
+			   (unsigned long long)replay_stats.loop_count);
+		printf("%.1f ms, %.1f fps, %.1f MB/s read, convert %.1f ms, encode waits %llu\n",
+			   seconds * 1000.0, frame_count / seconds, replay_stats.read_bytes / seconds / 1e6,
+			   replay_stats.convert_nanoseconds / 1e6,
+			   (unsigned long long)encoder_stats.wait_count);
+		printf("%llu access units, %llu bytes\n", (unsigned long long)sink.access_units,
+			   (unsigned long long)sink.bytes);
+		return 0;
+	} catch (...) {
+		fprintf(stderr, "failed to replay %s\n", argv[1]);
+		return 1;
+	}
+}
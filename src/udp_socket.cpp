@@ -0,0 +1,193 @@
+#include "udp_socket.h"
+
+#include <algorithm>
+#include <string>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <cerrno>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+constexpr int UDP_SEND_BUFFER_SIZE	  = 4 * 1024 * 1024;
+constexpr int UDP_RECEIVE_BUFFER_SIZE = 8 * 1024 * 1024;
+
+#ifdef _WIN32
+
+struct WinsockLibrary {
+	WinsockLibrary() {
+		WSADATA data{};
+		if (WSAStartup(MAKEWORD(2, 2), &data) != 0)
+			throw;
+	}
+
+	~WinsockLibrary() {
+		WSACleanup();
+	}
+};
+
+static void StartWinsock() {
+	static WinsockLibrary library;
+}
+
+UdpSocket::UdpSocket(const char* host, uint16_t port) {
+	StartWinsock();
+	addrinfo hints{.ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM, .ai_protocol = IPPROTO_UDP};
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(host, std::to_string(port).c_str(), &hints, &addresses) != 0)
+		throw;
+
+	socket_handle  = socket(addresses->ai_family, SOCK_DGRAM, IPPROTO_UDP);
+	auto connected = socket_handle != INVALID_SOCKET
+				  && connect(socket_handle, addresses->ai_addr, (int)addresses->ai_addrlen) == 0;
+	freeaddrinfo(addresses);
+	if (!connected) {
+		if (socket_handle != INVALID_SOCKET)
+			closesocket(socket_handle);
+		throw;
+	}
+	setsockopt(socket_handle, SOL_SOCKET, SO_SNDBUF, (const char*)&UDP_SEND_BUFFER_SIZE,
+			   sizeof(UDP_SEND_BUFFER_SIZE));
+}
+
+UdpSocket::UdpSocket(uint16_t port) {
+	StartWinsock();
+	socket_handle = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+	if (socket_handle == INVALID_SOCKET)
+		throw;
+
+	sockaddr_in address{};
+	address.sin_family		= AF_INET;
+	address.sin_port		= htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(socket_handle, (const sockaddr*)&address, sizeof(address)) != 0) {
+		closesocket(socket_handle);
+		throw;
+	}
+	setsockopt(socket_handle, SOL_SOCKET, SO_RCVBUF, (const char*)&UDP_RECEIVE_BUFFER_SIZE,
+			   sizeof(UDP_RECEIVE_BUFFER_SIZE));
+}
+
+UdpSocket::~UdpSocket() {
+	closesocket(socket_handle);
+}
+
+uint32_t UdpSocket::Send(std::span<const std::span<const uint8_t>> datagrams) {
+	auto sent = 0u;
+	for (auto datagram : datagrams) {
+		++send_calls;
+		if (send(socket_handle, (const char*)datagram.data(), (int)datagram.size(), 0)
+			!= SOCKET_ERROR)
+			++sent;
+	}
+	return sent;
+}
+
+uint32_t UdpSocket::Receive(std::span<uint8_t> buffer, uint32_t timeout_milliseconds) {
+	WSAPOLLFD poll_descriptor{.fd = socket_handle, .events = POLLRDNORM};
+	if (WSAPoll(&poll_descriptor, 1, (INT)timeout_milliseconds) <= 0)
+		return 0;
+	auto size = recv(socket_handle, (char*)buffer.data(), (int)buffer.size(), 0);
+	return size > 0 ? (uint32_t)size : 0;
+}
+
+uint16_t UdpSocket::GetLocalPort() const {
+	sockaddr_storage address{};
+	int address_size = sizeof(address);
+	if (getsockname(socket_handle, (sockaddr*)&address, &address_size) != 0)
+		return 0;
+	return ntohs(((const sockaddr_in*)&address)->sin_port);
+}
+
+#else
+
+constexpr uint32_t UDP_SEND_BATCH = 64;
+
+UdpSocket::UdpSocket(const char* host, uint16_t port) {
+	addrinfo hints{.ai_family = AF_UNSPEC, .ai_socktype = SOCK_DGRAM, .ai_protocol = IPPROTO_UDP};
+	addrinfo* addresses = nullptr;
+	if (getaddrinfo(host, std::to_string(port).c_str(), &hints, &addresses) != 0)
+		throw;
+
+	descriptor	   = socket(addresses->ai_family, SOCK_DGRAM | SOCK_CLOEXEC, IPPROTO_UDP);
+	auto connected = descriptor >= 0
+				  && connect(descriptor, addresses->ai_addr, addresses->ai_addrlen) == 0;
+	freeaddrinfo(addresses);
+	if (!connected) {
+		if (descriptor >= 0)
+			close(descriptor);
+		throw;
+	}
+	setsockopt(descriptor, SOL_SOCKET, SO_SNDBUF, &UDP_SEND_BUFFER_SIZE,
+			   sizeof(UDP_SEND_BUFFER_SIZE));
+}
+
+UdpSocket::UdpSocket(uint16_t port) : descriptor(socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC, 0)) {
+	if (descriptor < 0)
+		throw;
+
+	sockaddr_in address{};
+	address.sin_family		= AF_INET;
+	address.sin_port		= htons(port);
+	address.sin_addr.s_addr = htonl(INADDR_ANY);
+	if (bind(descriptor, (const sockaddr*)&address, sizeof(address)) != 0) {
+		close(descriptor);
+		throw;
+	}
+	setsockopt(descriptor, SOL_SOCKET, SO_RCVBUF, &UDP_RECEIVE_BUFFER_SIZE,
+			   sizeof(UDP_RECEIVE_BUFFER_SIZE));
+}
+
+UdpSocket::~UdpSocket() {
+	close(descriptor);
+}
+
+uint32_t UdpSocket::Send(std::span<const std::span<const uint8_t>> datagrams) {
+	mmsghdr messages[UDP_SEND_BATCH];
+	iovec vectors[UDP_SEND_BATCH];
+	auto sent = 0u;
+	for (size_t first = 0; first < datagrams.size();) {
+		auto count = (uint32_t)std::min<size_t>(UDP_SEND_BATCH, datagrams.size() - first);
+		for (auto i = 0u; i < count; ++i) {
+			vectors[i]	= iovec{.iov_base = (void*)datagrams[first + i].data(),
+								.iov_len  = datagrams[first + i].size()};
+			messages[i] = mmsghdr{.msg_hdr = msghdr{.msg_iov = &vectors[i], .msg_iovlen = 1}};
+		}
+
+		auto result = sendmmsg(descriptor, messages, count, 0);
+		++send_calls;
+		if (result < 0 && errno == EINTR)
+			continue;
+		if (result <= 0) {
+			++first;
+			continue;
+		}
+		sent += (uint32_t)result;
+		first += (uint32_t)result;
+	}
+	return sent;
+}
+
+uint32_t UdpSocket::Receive(std::span<uint8_t> buffer, uint32_t timeout_milliseconds) {
+	pollfd poll_descriptor{.fd = descriptor, .events = POLLIN};
+	if (poll(&poll_descriptor, 1, (int)timeout_milliseconds) <= 0)
+		return 0;
+	auto size = recv(descriptor, buffer.data(), buffer.size(), 0);
+	return size > 0 ? (uint32_t)size : 0;
+}
+
+uint16_t UdpSocket::GetLocalPort() const {
+	sockaddr_storage address{};
+	socklen_t address_size = sizeof(address);
+	if (getsockname(descriptor, (sockaddr*)&address, &address_size) != 0)
+		return 0;
+	return ntohs(((const sockaddr_in*)&address)->sin_port);
+}
+
+#endif
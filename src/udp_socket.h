@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+
+class UdpSocket {
+  public:
+	UdpSocket(const char* host, uint16_t port);
+	explicit UdpSocket(uint16_t port);
+	~UdpSocket();
+
+	UdpSocket(const UdpSocket&)			   = delete;
+	UdpSocket& operator=(const UdpSocket&) = delete;
+
+	uint32_t Send(std::span<const std::span<const uint8_t>> datagrams);
+	uint32_t Receive(std::span<uint8_t> buffer, uint32_t timeout_milliseconds);
+	uint16_t GetLocalPort() const;
+
+	uint64_t send_calls = 0;
+
+  private:
+#ifdef _WIN32
+	uintptr_t socket_handle;
+#else
+	int descriptor;
+#endif
+};